@@ -0,0 +1,84 @@
+#include "allocation-tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    /**
+     * This is the size of the header placed in front of every block
+     * handed out, in which the size of the block is remembered so that
+     * it can be subtracted again when the block is freed.  It is kept
+     * at the strictest fundamental alignment so that the pointer
+     * returned to the caller stays suitably aligned.
+     */
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> peakBytes{0};
+    std::atomic<size_t> allocations{0};
+
+    void *Allocate(size_t size) {
+        auto *block = static_cast<unsigned char *>(std::malloc(size + HEADER_SIZE));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<size_t *>(block) = size;
+        const auto live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        auto peak = peakBytes.load(std::memory_order_relaxed);
+        while (
+            (live > peak)
+            && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)
+        ) {
+        }
+        (void) allocations.fetch_add(1, std::memory_order_relaxed);
+        return block + HEADER_SIZE;
+    }
+
+    void Free(void *pointer) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        auto *block = static_cast<unsigned char *>(pointer) - HEADER_SIZE;
+        (void) liveBytes.fetch_sub(*reinterpret_cast<size_t *>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void *operator new(size_t size) {
+    return Allocate(size);
+}
+
+void *operator new[](size_t size) {
+    return Allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    Free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    Free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    Free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    Free(pointer);
+}
+
+namespace Bench {
+    AllocationStats GetAllocationStats() {
+        AllocationStats stats;
+        stats.liveBytes = liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = peakBytes.load(std::memory_order_relaxed);
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void ResetPeak() {
+        peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Bench {
+    /**
+     * @brief Snapshot of the heap usage observed by the benchmark's
+     * replacement global allocation functions.
+     */
+    struct AllocationStats {
+        /** @brief Number of bytes currently allocated and not yet freed. */
+        size_t liveBytes = 0;
+
+        /** @brief Highest value of liveBytes since the last ResetPeak(). */
+        size_t peakBytes = 0;
+
+        /** @brief Number of allocations made since the program started. */
+        size_t allocations = 0;
+    };
+
+    /**
+     * This returns the current heap usage of the benchmark process.
+     *
+     * @return
+     *     The current allocation statistics are returned.
+     */
+    AllocationStats GetAllocationStats();
+
+    /**
+     * This lowers the recorded heap high-water mark to the number of
+     * bytes currently live, so that the next peak measured belongs to
+     * the code which runs afterwards.
+     */
+    void ResetPeak();
+}
@@ -0,0 +1,158 @@
+#include "baseline.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+
+namespace {
+    /**
+     * This finds the entry in the given array of results whose
+     * properties named by the given keys match those of the given
+     * entry.
+     *
+     * @return
+     *     A pointer to the matching entry is returned, or nullptr if
+     *     there isn't one.
+     */
+    const Json::Value *FindMatchingEntry(
+        const Json::Value &entries,
+        const Json::Value &entry,
+        const std::string &key1,
+        const std::string &key2
+    ) {
+        for (size_t i = 0; i < entries.GetSize(); ++i) {
+            const auto &candidate = entries[i];
+            if (
+                (candidate[key1] == entry[key1])
+                && (candidate[key2] == entry[key2])
+            ) {
+                return &candidate;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * This compares one section of the results against the same
+     * section of the baseline.
+     *
+     * @param[in] higherIsBetter
+     *     This indicates whether larger values of the metric are
+     *     improvements (throughput) rather than regressions
+     *     (allocation counts).
+     *
+     * @return
+     *     An indication of whether or not the section is free of
+     *     regressions is returned.
+     */
+    bool CompareSection(
+        const Json::Value &baseline,
+        const Json::Value &results,
+        const std::string &section,
+        const std::string &key2,
+        const std::string &metric,
+        bool higherIsBetter,
+        double tolerancePercent
+    ) {
+        bool passed = true;
+        const auto &baselineEntries = baseline[section];
+        const auto &resultEntries = results[section];
+        for (size_t i = 0; i < resultEntries.GetSize(); ++i) {
+            const auto &entry = resultEntries[i];
+            const auto name = (std::string) entry["document"] + "/" + (std::string) entry[key2];
+            const auto *baselineEntry = FindMatchingEntry(baselineEntries, entry, "document", key2);
+            if (baselineEntry == nullptr) {
+                printf("  new       %-40s %s not in baseline\n", name.c_str(), metric.c_str());
+                continue;
+            }
+            const auto expected = (double) (*baselineEntry)[metric];
+            const auto actual = (double) entry[metric];
+            const auto change = (expected == 0.0) ? 0.0 : (actual - expected) / expected * 100.0;
+            const auto regressed = (
+                higherIsBetter
+                    ? (actual < expected * (1.0 - tolerancePercent / 100.0))
+                    : (actual > expected * (1.0 + tolerancePercent / 100.0))
+            );
+            printf(
+                "  %-9s %-40s %-20s %14.2f -> %14.2f (%+.1f%%)\n",
+                regressed ? "REGRESSED" : "ok",
+                name.c_str(),
+                metric.c_str(),
+                expected,
+                actual,
+                change
+            );
+            if (regressed) {
+                passed = false;
+            }
+        }
+        for (size_t i = 0; i < baselineEntries.GetSize(); ++i) {
+            const auto &entry = baselineEntries[i];
+            if (FindMatchingEntry(resultEntries, entry, "document", key2) == nullptr) {
+                printf(
+                    "  missing   %-40s %s not measured\n",
+                    ((std::string) entry["document"] + "/" + (std::string) entry[key2]).c_str(),
+                    metric.c_str()
+                );
+            }
+        }
+        return passed;
+    }
+}
+
+namespace Bench {
+    bool ReadResultsFile(
+        const std::string &path,
+        Json::Value &results
+    ) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        results = Json::Value::FromEncoding(text.str());
+        return (results.GetType() == Json::Value::Type::Object);
+    }
+
+    bool WriteResultsFile(
+        const std::string &path,
+        const Json::Value &results
+    ) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        Json::EncodingOptions options;
+        options.pretty = true;
+        file << results.ToEncoding(options) << "\n";
+        return (bool) file;
+    }
+
+    bool CompareWithBaseline(
+        const Json::Value &baseline,
+        const Json::Value &results,
+        const Tolerances &tolerances
+    ) {
+        printf(
+            "Comparing with baseline (throughput -%.1f%%, allocations +%.1f%%):\n",
+            tolerances.throughputPercent,
+            tolerances.allocationsPercent
+        );
+        bool passed = true;
+        passed &= CompareSection(
+            baseline, results, "throughput", "operation", "relativeThroughput",
+            true, tolerances.throughputPercent
+        );
+        passed &= CompareSection(
+            baseline, results, "throughput", "operation", "allocations",
+            false, tolerances.allocationsPercent
+        );
+        passed &= CompareSection(
+            baseline, results, "memory", "caching", "allocations",
+            false, tolerances.allocationsPercent
+        );
+        printf("%s\n", passed ? "No regressions." : "Performance regressed.");
+        return passed;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <value.h>
+
+namespace Bench {
+    /**
+     * @brief The default allowed drop in relative throughput, in percent.
+     * Timings on shared machines vary by about 20% from run to run, so it
+     * leaves room for that.
+     */
+    constexpr double DEFAULT_THROUGHPUT_TOLERANCE = 50.0;
+
+    /** @brief The default allowed rise in allocation counts, in percent. */
+    constexpr double DEFAULT_ALLOCATION_TOLERANCE = 5.0;
+
+    /**
+     * @brief How far results may fall behind a baseline before they
+     * count as a regression.
+     */
+    struct Tolerances {
+        /** @brief Allowed drop in relative throughput, in percent of the baseline. */
+        double throughputPercent = DEFAULT_THROUGHPUT_TOLERANCE;
+
+        /** @brief Allowed rise in allocation counts, in percent of the baseline. */
+        double allocationsPercent = DEFAULT_ALLOCATION_TOLERANCE;
+    };
+
+    /**
+     * This reads benchmark results previously written by
+     * WriteResultsFile().
+     *
+     * @param[in] path
+     *     This is the path of the file to read.
+     *
+     * @param[out] results
+     *     This is where to store the results read.
+     *
+     * @return
+     *     An indication of whether or not the file could be read and
+     *     holds valid JSON is returned.
+     */
+    bool ReadResultsFile(
+        const std::string &path,
+        Json::Value &results
+    );
+
+    /**
+     * This writes benchmark results to a file as pretty-printed JSON.
+     *
+     * @param[in] path
+     *     This is the path of the file to write.
+     *
+     * @param[in] results
+     *     These are the results to write.
+     *
+     * @return
+     *     An indication of whether or not the file was written is
+     *     returned.
+     */
+    bool WriteResultsFile(
+        const std::string &path,
+        const Json::Value &results
+    );
+
+    /**
+     * This compares benchmark results against a baseline and prints
+     * every measurement which regressed beyond the given tolerances.
+     * Throughput is compared relative to the reference operation
+     * measured in the same run, rather than in megabytes per second, so
+     * that a slower or busier machine doesn't count as a regression.
+     * It is matched on document and operation, allocation
+     * counts of the memory benchmark on document and caching option.
+     * Measurements missing from either side are reported but are not
+     * regressions.
+     *
+     * @param[in] baseline
+     *     These are the baseline results.
+     *
+     * @param[in] results
+     *     These are the results to check.
+     *
+     * @param[in] tolerances
+     *     These say how much worse than the baseline a measurement may
+     *     be before it counts as a regression.
+     *
+     * @return
+     *     An indication of whether or not the results are free of
+     *     regressions is returned.
+     */
+    bool CompareWithBaseline(
+        const Json::Value &baseline,
+        const Json::Value &results,
+        const Tolerances &tolerances
+    );
+}
@@ -0,0 +1,112 @@
+#include "corpus.h"
+
+#include <fstream>
+#include <sstream>
+#include <value.h>
+
+namespace {
+    /**
+     * This builds an array of objects resembling rows exported from
+     * a database.
+     */
+    Json::Value MakeRecords(size_t count) {
+        Json::Value records(Json::Value::Type::Array);
+        for (size_t i = 0; i < count; ++i) {
+            records.Add(Json::Object({
+                {"id", i},
+                {"name", "user-" + std::to_string(i)},
+                {"active", (i % 3) != 0},
+                {"score", (double) i * 0.25 + 0.5},
+                {"tags", Json::Array({"alpha", "beta", (int) (i % 7)})},
+                {"manager", (i % 5 == 0) ? Json::Value(nullptr) : Json::Value(i / 5)},
+            }));
+        }
+        return records;
+    }
+
+    /**
+     * This builds a flat array of integers and floating-point numbers.
+     */
+    Json::Value MakeNumbers(size_t count) {
+        Json::Value numbers(Json::Value::Type::Array);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0) {
+                numbers.Add((intmax_t) (i * 7919) - 100000);
+            } else {
+                numbers.Add((double) i / 3.0);
+            }
+        }
+        return numbers;
+    }
+
+    /**
+     * This builds a flat array of strings, some of which need escaping
+     * or contain non-ASCII characters.
+     */
+    Json::Value MakeStrings(size_t count) {
+        Json::Value strings(Json::Value::Type::Array);
+        for (size_t i = 0; i < count; ++i) {
+            switch (i % 3) {
+                case 0: {
+                    strings.Add("plain ASCII text number " + std::to_string(i));
+                }
+                break;
+
+                case 1: {
+                    strings.Add("needs \"escaping\"\tand\nnewlines " + std::to_string(i));
+                }
+                break;
+
+                default: {
+                    strings.Add("κόσμε and 💩 number " + std::to_string(i));
+                }
+                break;
+            }
+        }
+        return strings;
+    }
+
+    /**
+     * This builds an array of deeply nested objects and arrays.
+     */
+    Json::Value MakeNested(size_t count, size_t depth) {
+        Json::Value nested(Json::Value::Type::Array);
+        for (size_t i = 0; i < count; ++i) {
+            Json::Value inner = Json::Array({(int) i, "leaf"});
+            for (size_t level = 0; level < depth; ++level) {
+                inner = Json::Object({
+                    {"level", level},
+                    {"child", inner},
+                });
+            }
+            nested.Add(std::move(inner));
+        }
+        return nested;
+    }
+}
+
+namespace Bench {
+    std::vector<Document> MakeSyntheticCorpus(size_t scale) {
+        return {
+            {"records", MakeRecords(scale).ToEncoding()},
+            {"numbers", MakeNumbers(scale * 8).ToEncoding()},
+            {"strings", MakeStrings(scale * 2).ToEncoding()},
+            {"nested", MakeNested(scale / 16 + 1, 16).ToEncoding()},
+        };
+    }
+
+    bool LoadCorpusFile(
+        const std::string &path,
+        Document &document
+    ) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        document.name = path;
+        document.text = text.str();
+        return true;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Bench {
+    /**
+     * @brief One JSON text the benchmarks are run against.
+     */
+    struct Document {
+        /** @brief Name used for the document in reports. */
+        std::string name;
+
+        /** @brief The JSON encoding of the document. */
+        std::string text;
+    };
+
+    /**
+     * This generates the built-in corpus, a fixed set of documents with
+     * different shapes (records, numbers, strings, deep nesting) so the
+     * benchmarks can run without any input files.  The documents only
+     * depend on the given scale, so results stay comparable across runs.
+     *
+     * @param[in] scale
+     *     This is the number of records in the largest documents; the
+     *     other documents are sized in proportion to it.
+     *
+     * @return
+     *     The generated documents are returned.
+     */
+    std::vector<Document> MakeSyntheticCorpus(size_t scale);
+
+    /**
+     * This reads a corpus document from a file.
+     *
+     * @param[in] path
+     *     This is the path of the file to read.
+     *
+     * @param[out] document
+     *     This is where to store the document, named after the file.
+     *
+     * @return
+     *     An indication of whether or not the file could be read is
+     *     returned.
+     */
+    bool LoadCorpusFile(
+        const std::string &path,
+        Document &document
+    );
+}
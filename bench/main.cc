@@ -0,0 +1,203 @@
+/**
+ * @file main.cc
+ *
+ * This is the entry point of JsonKitBench, which measures the cost of
+ * parsing and holding JSON documents with JsonKit, and optionally checks
+ * the measurements against a baseline.
+ *
+ * Usage: JsonKitBench [OPTION...] [FILE...]
+ *
+ *   --memory                 Report peak heap and RSS while parsing, heap
+ *                            held by the parsed value, and its ratio to
+ *                            the input size.
+ *   --throughput             Report parse, encode and minify speed and
+ *                            allocation counts.
+ *   --quick                  Use a small corpus and short timings, for the
+ *                            regression gate.
+ *   --scale N                Size of the built-in corpus (default 1000),
+ *                            used when no files are given.
+ *   --seconds S              Time spent on each throughput measurement
+ *                            (default 0.5).
+ *   --json                   Print the results as JSON instead of tables.
+ *   --baseline FILE          Compare the results with FILE and fail if
+ *                            they regressed.
+ *   --write-baseline FILE    Write the results to FILE.
+ *   --tolerance PCT          Allowed drop in throughput relative to the
+ *                            reference operation (default
+ *                            Bench::DEFAULT_THROUGHPUT_TOLERANCE).
+ *   --allocation-tolerance PCT
+ *                            Allowed allocation count rise (default
+ *                            Bench::DEFAULT_ALLOCATION_TOLERANCE).
+ *
+ * When neither --memory nor --throughput is given, both are run.
+ */
+
+#include "baseline.h"
+#include "corpus.h"
+#include "memory-benchmark.h"
+#include "throughput-benchmark.h"
+
+#include <stdio.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This prints how to run the program.
+     */
+    void PrintUsageInformation() {
+        fprintf(
+            stderr,
+            (
+                "Usage: JsonKitBench [OPTION...] [FILE...]\n"
+                "\n"
+                "Measure the cost of parsing JSON documents with JsonKit.\n"
+                "If no files are given, a built-in corpus is generated.\n"
+                "\n"
+                "  --memory                    report peak and held memory per document\n"
+                "  --throughput                report parse/encode/minify speed and allocations\n"
+                "  --quick                     small corpus and short timings\n"
+                "  --scale N                   size of the built-in corpus (default 1000)\n"
+                "  --seconds S                 time per throughput measurement (default 0.5)\n"
+                "  --json                      print results as JSON\n"
+                "  --baseline FILE             fail if results regressed from FILE\n"
+                "  --write-baseline FILE       write results to FILE\n"
+                "  --tolerance PCT             allowed relative throughput drop (default %g)\n"
+                "  --allocation-tolerance PCT  allowed allocation rise (default %g)\n"
+            ),
+            Bench::DEFAULT_THROUGHPUT_TOLERANCE,
+            Bench::DEFAULT_ALLOCATION_TOLERANCE
+        );
+    }
+
+    /**
+     * @brief Settings parsed from the command line.
+     */
+    struct Environment {
+        bool memory = false;
+        bool throughput = false;
+        size_t scale = 1000;
+        double seconds = 0.5;
+        bool json = false;
+        std::string baselinePath;
+        std::string writeBaselinePath;
+        Bench::Tolerances tolerances;
+        std::vector<std::string> files;
+    };
+
+    /**
+     * This parses the command-line arguments of the program.
+     *
+     * @return
+     *     An indication of whether or not the arguments were valid
+     *     is returned.
+     */
+    bool ProcessCommandLineArguments(
+        int argc,
+        char *argv[],
+        Environment &environment
+    ) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            const auto hasValue = (i + 1 < argc);
+            if (arg == "--memory") {
+                environment.memory = true;
+            } else if (arg == "--throughput") {
+                environment.throughput = true;
+            } else if (arg == "--quick") {
+                environment.scale = 100;
+                environment.seconds = 0.05;
+            } else if (arg == "--json") {
+                environment.json = true;
+            } else if ((arg == "--scale") && hasValue) {
+                environment.scale = (size_t) std::stoull(argv[++i]);
+            } else if ((arg == "--seconds") && hasValue) {
+                environment.seconds = std::stod(argv[++i]);
+            } else if ((arg == "--baseline") && hasValue) {
+                environment.baselinePath = argv[++i];
+            } else if ((arg == "--write-baseline") && hasValue) {
+                environment.writeBaselinePath = argv[++i];
+            } else if ((arg == "--tolerance") && hasValue) {
+                environment.tolerances.throughputPercent = std::stod(argv[++i]);
+            } else if ((arg == "--allocation-tolerance") && hasValue) {
+                environment.tolerances.allocationsPercent = std::stod(argv[++i]);
+            } else if (
+                !arg.empty()
+                && (arg[0] == '-')
+            ) {
+                return false;
+            } else {
+                environment.files.push_back(arg);
+            }
+        }
+        if (
+            !environment.memory
+            && !environment.throughput
+        ) {
+            environment.memory = true;
+            environment.throughput = true;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Environment environment;
+    if (!ProcessCommandLineArguments(argc, argv, environment)) {
+        PrintUsageInformation();
+        return EXIT_FAILURE;
+    }
+    std::vector<Bench::Document> corpus;
+    if (environment.files.empty()) {
+        corpus = Bench::MakeSyntheticCorpus(environment.scale);
+    } else {
+        for (const auto &path: environment.files) {
+            Bench::Document document;
+            if (!Bench::LoadCorpusFile(path, document)) {
+                fprintf(stderr, "error: unable to read '%s'\n", path.c_str());
+                return EXIT_FAILURE;
+            }
+            corpus.push_back(std::move(document));
+        }
+    }
+    Json::Value results(Json::Value::Type::Object);
+    if (environment.throughput) {
+        const auto throughputResults = Bench::RunThroughputBenchmark(corpus, environment.seconds);
+        if (!environment.json) {
+            Bench::PrintThroughputResults(throughputResults);
+            printf("\n");
+        }
+        results.Set("throughput", Bench::ThroughputResultsToJson(throughputResults));
+    }
+    if (environment.memory) {
+        const auto memoryResults = Bench::RunMemoryBenchmark(corpus);
+        if (!environment.json) {
+            Bench::PrintMemoryResults(memoryResults);
+            printf("\n");
+        }
+        results.Set("memory", Bench::MemoryResultsToJson(memoryResults));
+    }
+    if (environment.json) {
+        Json::EncodingOptions options;
+        options.pretty = true;
+        printf("%s\n", results.ToEncoding(options).c_str());
+    }
+    if (!environment.writeBaselinePath.empty()) {
+        if (!Bench::WriteResultsFile(environment.writeBaselinePath, results)) {
+            fprintf(stderr, "error: unable to write '%s'\n", environment.writeBaselinePath.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    if (!environment.baselinePath.empty()) {
+        Json::Value baseline;
+        if (!Bench::ReadResultsFile(environment.baselinePath, baseline)) {
+            fprintf(stderr, "error: unable to read baseline '%s'\n", environment.baselinePath.c_str());
+            return EXIT_FAILURE;
+        }
+        if (!Bench::CompareWithBaseline(baseline, results, environment.tolerances)) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#include "allocation-tracker.h"
+#include "memory-benchmark.h"
+#include "process-memory.h"
+
+#include <stdio.h>
+
+namespace {
+    /**
+     * These are the caching options measured for every document.
+     */
+    const char *const CACHING_OPTIONS[] = {
+        "parse",
+        "parse+reencode",
+        "compact",
+        "hashed",
+    };
+
+    /**
+     * This parses the given document into a value of the given type,
+     * re-encoding it if asked to, and records the memory used in the
+     * given result while the value is still held.
+     */
+    template<typename ValueType>
+    void ParseDocument(
+        const Bench::Document &document,
+        bool reencode,
+        const Bench::AllocationStats &before,
+        size_t rssBefore,
+        bool rssResettable,
+        Bench::MemoryResult &result
+    ) {
+        const auto json = ValueType::FromEncoding(document.text);
+        if (reencode) {
+            Json::EncodingOptions options;
+            options.reencode = true;
+            (void) json.ToEncoding(options);
+        }
+        const auto after = Bench::GetAllocationStats();
+        result.peakHeapBytes = after.peakBytes - before.liveBytes;
+        result.heldBytes = after.liveBytes - before.liveBytes;
+        result.allocations = after.allocations - before.allocations;
+        if (rssResettable) {
+            const auto rssPeak = Bench::GetPeakRss();
+            result.peakRssBytes = (rssPeak > rssBefore) ? rssPeak - rssBefore : 0;
+        }
+    }
+
+    /**
+     * This parses the given document with the given caching option,
+     * recording the memory used in the given result.
+     */
+    void MeasureDocument(
+        const Bench::Document &document,
+        const std::string &caching,
+        Bench::MemoryResult &result
+    ) {
+        result.document = document.name;
+        result.caching = caching;
+        result.inputBytes = document.text.size();
+        const auto rssResettable = Bench::ResetPeakRss();
+        const auto rssBefore = Bench::GetCurrentRss();
+        Bench::ResetPeak();
+        const auto before = Bench::GetAllocationStats();
+        if (caching == "compact") {
+            ParseDocument<Json::CompactValue>(document, false, before, rssBefore, rssResettable, result);
+        } else if (caching == "hashed") {
+            ParseDocument<Json::HashedValue>(document, false, before, rssBefore, rssResettable, result);
+        } else {
+            ParseDocument<Json::Value>(document, caching == "parse+reencode", before, rssBefore, rssResettable, result);
+        }
+        if (result.inputBytes > 0) {
+            result.bytesPerInputByte = (double) result.heldBytes / (double) result.inputBytes;
+        }
+    }
+}
+
+namespace Bench {
+    std::vector<MemoryResult> RunMemoryBenchmark(const std::vector<Document> &corpus) {
+        std::vector<MemoryResult> results;
+        for (const auto &document: corpus) {
+            for (const auto caching: CACHING_OPTIONS) {
+                MemoryResult result;
+                MeasureDocument(document, caching, result);
+                results.push_back(result);
+            }
+        }
+        return results;
+    }
+
+    void PrintMemoryResults(const std::vector<MemoryResult> &results) {
+        printf(
+            "%-24s %-16s %12s %14s %14s %14s %12s %10s\n",
+            "document", "caching", "input", "peak heap", "peak RSS", "held", "allocs", "held/in"
+        );
+        for (const auto &result: results) {
+            printf(
+                "%-24s %-16s %12zu %14zu %14zu %14zu %12zu %10.2f\n",
+                result.document.c_str(),
+                result.caching.c_str(),
+                result.inputBytes,
+                result.peakHeapBytes,
+                result.peakRssBytes,
+                result.heldBytes,
+                result.allocations,
+                result.bytesPerInputByte
+            );
+        }
+    }
+
+    Json::Value MemoryResultsToJson(const std::vector<MemoryResult> &results) {
+        Json::Value json(Json::Value::Type::Array);
+        for (const auto &result: results) {
+            json.Add(Json::Object({
+                {"document", result.document},
+                {"caching", result.caching},
+                {"inputBytes", result.inputBytes},
+                {"peakHeapBytes", result.peakHeapBytes},
+                {"peakRssBytes", result.peakRssBytes},
+                {"heldBytes", result.heldBytes},
+                {"allocations", result.allocations},
+                {"bytesPerInputByte", result.bytesPerInputByte},
+            }));
+        }
+        return json;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "corpus.h"
+
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace Bench {
+    /**
+     * @brief Memory used while parsing one document and afterwards
+     * holding the parsed value, for one caching option.
+     */
+    struct MemoryResult {
+        /** @brief Name of the document parsed. */
+        std::string document;
+
+        /**
+         * @brief Caching option measured: "parse" holds the value as
+         * parsed (each node caches its source text), "parse+reencode"
+         * also re-encodes it, so each node caches its canonical encoding.
+         * "compact" parses into a Json::CompactValue, which caches
+         * nothing and keeps objects in sorted vectors, and "hashed"
+         * parses into a Json::HashedValue.
+         */
+        std::string caching;
+
+        /** @brief Size of the document's JSON text. */
+        size_t inputBytes = 0;
+
+        /** @brief Highest heap usage above the starting point while parsing. */
+        size_t peakHeapBytes = 0;
+
+        /**
+         * @brief Resident set high-water mark above the starting point
+         * while parsing, or zero where the platform can't reset it.
+         */
+        size_t peakRssBytes = 0;
+
+        /** @brief Heap bytes held by the parsed value once parsing is done. */
+        size_t heldBytes = 0;
+
+        /** @brief Number of heap allocations made while parsing. */
+        size_t allocations = 0;
+
+        /** @brief heldBytes divided by inputBytes. */
+        double bytesPerInputByte = 0.0;
+    };
+
+    /**
+     * This parses every document of the given corpus once per caching
+     * option and measures the memory used.
+     *
+     * @param[in] corpus
+     *     These are the documents to parse.
+     *
+     * @return
+     *     One result per document and caching option is returned.
+     */
+    std::vector<MemoryResult> RunMemoryBenchmark(const std::vector<Document> &corpus);
+
+    /**
+     * This prints the given results as a table.
+     *
+     * @param[in] results
+     *     These are the results to print.
+     */
+    void PrintMemoryResults(const std::vector<MemoryResult> &results);
+
+    /**
+     * This converts the given results to a JSON array, one object
+     * per result.
+     *
+     * @param[in] results
+     *     These are the results to convert.
+     *
+     * @return
+     *     The JSON array is returned.
+     */
+    Json::Value MemoryResultsToJson(const std::vector<MemoryResult> &results);
+}
@@ -0,0 +1,94 @@
+#include "process-memory.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
+namespace {
+#if defined(__linux__)
+    /**
+     * This reads one of the memory size fields, such as "VmRSS" or
+     * "VmHWM", out of /proc/self/status.
+     *
+     * @param[in] field
+     *     This is the name of the field to read.
+     *
+     * @return
+     *     The value of the field in bytes is returned, or zero if the
+     *     field could not be read.
+     */
+    size_t ReadProcStatusField(const std::string &field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (
+                (line.size() > field.size())
+                && (line.compare(0, field.size(), field) == 0)
+                && (line[field.size()] == ':')
+            ) {
+                return (size_t) std::stoull(line.substr(field.size() + 1)) * 1024;
+            }
+        }
+        return 0;
+    }
+#endif
+}
+
+namespace Bench {
+    size_t GetCurrentRss() {
+#if defined(__linux__)
+        return ReadProcStatusField("VmRSS");
+#elif defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return (size_t) counters.WorkingSetSize;
+#else
+        return 0;
+#endif
+    }
+
+    size_t GetPeakRss() {
+#if defined(__linux__)
+        return ReadProcStatusField("VmHWM");
+#elif defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return (size_t) counters.PeakWorkingSetSize;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return (size_t) usage.ru_maxrss;
+#else
+        return (size_t) usage.ru_maxrss * 1024;
+#endif
+#endif
+    }
+
+    bool ResetPeakRss() {
+#if defined(__linux__)
+        // Writing "5" to clear_refs resets VmHWM to the current RSS
+        // (Linux 4.0 and later).
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.flush();
+        return (bool) clearRefs;
+#else
+        return false;
+#endif
+    }
+}
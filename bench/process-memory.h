@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Bench {
+    /**
+     * This returns the resident set size of the benchmark process.
+     *
+     * @return
+     *     The number of bytes of physical memory currently used by the
+     *     process is returned, or zero if the platform can't tell.
+     */
+    size_t GetCurrentRss();
+
+    /**
+     * This returns the highest resident set size the benchmark process
+     * has reached since it started or since the last successful call to
+     * ResetPeakRss().
+     *
+     * @return
+     *     The resident set high-water mark in bytes is returned, or zero
+     *     if the platform can't tell.
+     */
+    size_t GetPeakRss();
+
+    /**
+     * This asks the operating system to lower the resident set
+     * high-water mark of the process to its current resident set size.
+     *
+     * @return
+     *     An indication of whether or not the high-water mark was reset
+     *     is returned.  Where it can't be reset, GetPeakRss() keeps
+     *     reporting the high-water mark of the whole run.
+     */
+    bool ResetPeakRss();
+}
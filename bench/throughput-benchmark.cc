@@ -0,0 +1,149 @@
+#include "allocation-tracker.h"
+#include "throughput-benchmark.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <transcode.h>
+
+namespace {
+    /**
+     * This receives the checksums computed by the reference operation,
+     * so that the compiler can't leave them out.
+     */
+    volatile uint32_t referenceChecksum = 0;
+
+    /**
+     * This runs the given operation over and over until at least the
+     * given time has passed, and fills in the speed and per-run
+     * allocation count of the given result.
+     */
+    template<typename Operation>
+    void Measure(
+        Operation &&operation,
+        size_t bytesPerRun,
+        double minimumSeconds,
+        Bench::ThroughputResult &result
+    ) {
+        // One untimed run, which also gives a stable allocation count.
+        const auto allocationsBefore = Bench::GetAllocationStats().allocations;
+        operation();
+        result.allocations = Bench::GetAllocationStats().allocations - allocationsBefore;
+        size_t runs = 0;
+        double seconds = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        do {
+            operation();
+            ++runs;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < minimumSeconds);
+        result.megabytesPerSecond = (double) (bytesPerRun * runs) / seconds / 1e6;
+    }
+}
+
+namespace Bench {
+    std::vector<ThroughputResult> RunThroughputBenchmark(
+        const std::vector<Document> &corpus,
+        double minimumSeconds
+    ) {
+        std::vector<ThroughputResult> results;
+        for (const auto &document: corpus) {
+            const auto firstResult = results.size();
+            ThroughputResult reference;
+            reference.document = document.name;
+            reference.operation = "reference";
+            Measure(
+                [&document] {
+                    uint32_t checksum = 0;
+                    for (const auto c: document.text) {
+                        checksum = checksum * 31 + (unsigned char) c;
+                    }
+                    referenceChecksum = checksum;
+                },
+                document.text.size(),
+                minimumSeconds,
+                reference
+            );
+            results.push_back(reference);
+
+            ThroughputResult parse;
+            parse.document = document.name;
+            parse.operation = "parse";
+            Measure(
+                [&document] {
+                    const auto json = Json::Value::FromEncoding(document.text);
+                    (void) json.GetType();
+                },
+                document.text.size(),
+                minimumSeconds,
+                parse
+            );
+            results.push_back(parse);
+
+            const auto json = Json::Value::FromEncoding(document.text);
+            Json::EncodingOptions options;
+            options.reencode = true;
+            ThroughputResult encode;
+            encode.document = document.name;
+            encode.operation = "encode";
+            Measure(
+                [&json, &options] {
+                    (void) json.ToEncoding(options);
+                },
+                document.text.size(),
+                minimumSeconds,
+                encode
+            );
+            results.push_back(encode);
+
+            ThroughputResult minify;
+            minify.document = document.name;
+            minify.operation = "minify";
+            std::string minified;
+            Measure(
+                [&document, &minified] {
+                    minified.clear();
+                    (void) Json::Minify(document.text, minified);
+                },
+                document.text.size(),
+                minimumSeconds,
+                minify
+            );
+            results.push_back(minify);
+
+            for (size_t i = firstResult; i < results.size(); ++i) {
+                results[i].relativeThroughput = results[i].megabytesPerSecond / reference.megabytesPerSecond;
+            }
+        }
+        return results;
+    }
+
+    void PrintThroughputResults(const std::vector<ThroughputResult> &results) {
+        printf("%-24s %-10s %12s %12s %12s\n", "document", "operation", "MB/s", "relative", "allocs");
+        for (const auto &result: results) {
+            printf(
+                "%-24s %-10s %12.2f %12.4f %12zu\n",
+                result.document.c_str(),
+                result.operation.c_str(),
+                result.megabytesPerSecond,
+                result.relativeThroughput,
+                result.allocations
+            );
+        }
+    }
+
+    Json::Value ThroughputResultsToJson(const std::vector<ThroughputResult> &results) {
+        Json::Value json(Json::Value::Type::Array);
+        for (const auto &result: results) {
+            json.Add(Json::Object({
+                {"document", result.document},
+                {"operation", result.operation},
+                {"megabytesPerSecond", result.megabytesPerSecond},
+                {"relativeThroughput", result.relativeThroughput},
+                {"allocations", result.allocations},
+            }));
+        }
+        return json;
+    }
+}
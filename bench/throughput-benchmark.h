@@ -0,0 +1,78 @@
+#pragma once
+
+#include "corpus.h"
+
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace Bench {
+    /**
+     * @brief Speed and allocation count of one operation on one document.
+     */
+    struct ThroughputResult {
+        /** @brief Name of the document processed. */
+        std::string document;
+
+        /**
+         * @brief Operation measured: "parse", "encode", "minify", or
+         * "reference", a simple checksum of the text which gauges the
+         * speed of the machine.
+         */
+        std::string operation;
+
+        /** @brief Megabytes (10^6 bytes) of JSON text processed per second. */
+        double megabytesPerSecond = 0.0;
+
+        /**
+         * @brief Throughput divided by that of the reference operation on
+         * the same document in the same run.  Unlike megabytesPerSecond,
+         * this hardly depends on the machine or on its load, so it is what
+         * baselines are compared on.
+         */
+        double relativeThroughput = 0.0;
+
+        /** @brief Heap allocations made by one run of the operation. */
+        size_t allocations = 0;
+    };
+
+    /**
+     * This repeatedly parses, encodes and minifies every document of the
+     * given corpus and measures how fast it goes, relative to a reference
+     * operation measured on the same document.
+     *
+     * @param[in] corpus
+     *     These are the documents to process.
+     *
+     * @param[in] minimumSeconds
+     *     This is how long to keep repeating each operation on each
+     *     document before taking the measurement.
+     *
+     * @return
+     *     One result per document and operation is returned.
+     */
+    std::vector<ThroughputResult> RunThroughputBenchmark(
+        const std::vector<Document> &corpus,
+        double minimumSeconds
+    );
+
+    /**
+     * This prints the given results as a table.
+     *
+     * @param[in] results
+     *     These are the results to print.
+     */
+    void PrintThroughputResults(const std::vector<ThroughputResult> &results);
+
+    /**
+     * This converts the given results to a JSON array, one object
+     * per result.
+     *
+     * @param[in] results
+     *     These are the results to convert.
+     *
+     * @return
+     *     The JSON array is returned.
+     */
+    Json::Value ThroughputResultsToJson(const std::vector<ThroughputResult> &results);
+}
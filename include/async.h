@@ -0,0 +1,408 @@
+#pragma once
+
+#include "builder.h"
+#include "reader.h"
+#include "value.h"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace Json {
+    /**
+     * @brief The result of a coroutine which produces one value of the
+     * given type, such as ParseAsync().
+     *
+     * The coroutine doesn't start until the task is awaited, or Start()
+     * is called.  Awaiting the task from another coroutine suspends that
+     * coroutine until the result is ready; code outside coroutines calls
+     * Start(), and then checks IsDone() after each event which may have
+     * let the coroutine progress.
+     *
+     * @tparam T The type of value produced.
+     */
+    template<typename T>
+    class Task {
+    public:
+        /**
+         * @brief The coroutine promise of a task.
+         */
+        struct promise_type {
+            /** @brief The value produced, once the coroutine returns. */
+            std::optional<T> result;
+
+            /** @brief The coroutine awaiting the task, if any. */
+            std::coroutine_handle<> continuation;
+
+            /**
+             * @brief Resumes the awaiting coroutine, if any, once the task's
+             * coroutine finishes.
+             */
+            struct FinalAwaiter {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    const auto continuation = handle.promise().continuation;
+                    if (continuation) {
+                        return continuation;
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_value(T value) {
+                result = std::move(value);
+            }
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+
+        ~Task() noexcept {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        Task(const Task &) = delete;
+
+        Task(Task &&other) noexcept
+            : handle(std::exchange(other.handle, nullptr)) {
+        }
+
+        Task &operator=(const Task &) = delete;
+
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Runs the coroutine until it first suspends, for callers
+         * which aren't coroutines themselves.
+         */
+        void Start() {
+            if (
+                handle
+                && !handle.done()
+            ) {
+                handle.resume();
+            }
+        }
+
+        /**
+         * @brief Checks if the coroutine has produced its value.
+         */
+        [[nodiscard]] bool IsDone() const {
+            return (
+                handle
+                && handle.done()
+            );
+        }
+
+        /**
+         * @brief Takes the value the coroutine produced.  Call this only
+         * once IsDone() returns true.
+         */
+        T TakeResult() {
+            return std::move(*handle.promise().result);
+        }
+
+        bool await_ready() const noexcept {
+            return IsDone();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        T await_resume() {
+            return TakeResult();
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle)
+            : handle(handle) {
+        }
+
+        /** @brief The coroutine producing the value. */
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /**
+     * @brief The result of a coroutine which produces a sequence of
+     * values of the given type, such as Elements().
+     *
+     * Another coroutine takes the values one at a time:
+     *
+     * @code
+     * auto elements = Json::Elements(source);
+     * while (auto element = co_await elements.Next()) {
+     *     // use *element
+     * }
+     * @endcode
+     *
+     * @tparam T The type of values produced.
+     */
+    template<typename T>
+    class AsyncGenerator {
+    public:
+        /**
+         * @brief The coroutine promise of a generator.
+         */
+        struct promise_type {
+            /** @brief The value most recently produced, until it's taken. */
+            std::optional<T> current;
+
+            /** @brief The coroutine waiting for the next value. */
+            std::coroutine_handle<> consumer;
+
+            /**
+             * @brief Resumes the waiting coroutine when a value is produced,
+             * or the generator's coroutine finishes.
+             */
+            struct YieldAwaiter {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    const auto consumer = handle.promise().consumer;
+                    if (consumer) {
+                        return consumer;
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+
+            AsyncGenerator get_return_object() {
+                return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            YieldAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            YieldAwaiter yield_value(T value) {
+                current = std::move(value);
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+
+        /**
+         * @brief Awaited to take the next value from the generator.
+         */
+        struct NextAwaiter {
+            /** @brief The generator's coroutine. */
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+                handle.promise().consumer = consumer;
+                return handle;
+            }
+
+            std::optional<T> await_resume() {
+                return std::exchange(handle.promise().current, std::nullopt);
+            }
+        };
+
+        ~AsyncGenerator() noexcept {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        AsyncGenerator(const AsyncGenerator &) = delete;
+
+        AsyncGenerator(AsyncGenerator &&other) noexcept
+            : handle(std::exchange(other.handle, nullptr)) {
+        }
+
+        AsyncGenerator &operator=(const AsyncGenerator &) = delete;
+
+        AsyncGenerator &operator=(AsyncGenerator &&other) noexcept {
+            if (this != &other) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Returns an awaitable which produces the next value, or
+         * std::nullopt once there are no more.
+         */
+        NextAwaiter Next() {
+            return NextAwaiter{handle};
+        }
+
+    private:
+        explicit AsyncGenerator(std::coroutine_handle<promise_type> handle)
+            : handle(handle) {
+        }
+
+        /** @brief The coroutine producing the values. */
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /**
+     * @brief Parses one JSON value from an asynchronous source of text.
+     *
+     * The source is any object whose Read() member function returns an
+     * awaitable producing the next chunk of text, as something
+     * convertible to std::string_view, or an empty chunk at the end of
+     * the input.  A chunk need only remain valid until Read() is called
+     * again.  The coroutine suspends whenever the source does, so one
+     * thread can parse many inputs which arrive slowly.
+     *
+     * The source is read to its end, and must outlive the task.
+     *
+     * @param source The source of the text to parse.
+     * @return A task producing the value parsed, or an invalid value if
+     * the text isn't valid JSON.
+     */
+    template<typename Traits = DefaultTraits, typename Source>
+    Task<BasicValue<Traits>> ParseAsync(Source &source) {
+        Reader reader;
+        Reader::Token token;
+        BasicBuilder<Traits> builder;
+        while (true) {
+            switch (reader.Next(token)) {
+                case Reader::Status::Token: {
+                    if (!builder.Push(token)) {
+                        co_return BasicValue<Traits>();
+                    }
+                }
+                break;
+
+                case Reader::Status::NeedInput: {
+                    // The chunk is kept until it's fed, since it may be a
+                    // temporary, such as a std::string returned by value.
+                    auto &&chunk = co_await source.Read();
+                    const std::string_view text(chunk);
+                    if (text.empty()) {
+                        reader.Finish();
+                    } else {
+                        reader.Feed(text);
+                    }
+                }
+                break;
+
+                case Reader::Status::End: co_return builder.Take();
+
+                default: co_return BasicValue<Traits>();
+            }
+        }
+    }
+
+    /**
+     * @brief Parses the elements of a JSON array from an asynchronous
+     * source of text, producing each element as soon as it has been
+     * parsed.
+     *
+     * The source is as for ParseAsync(), and must outlive the generator.
+     * If the text isn't a valid JSON array, an invalid value is produced
+     * after the elements before the error, and then no more.
+     *
+     * @param source The source of the text to parse.
+     * @return A generator producing the elements of the array.
+     */
+    template<typename Traits = DefaultTraits, typename Source>
+    AsyncGenerator<BasicValue<Traits>> Elements(Source &source) {
+        Reader reader;
+        Reader::Token token;
+        BasicBuilder<Traits> builder;
+        bool started = false;
+        while (true) {
+            switch (reader.Next(token)) {
+                case Reader::Status::Token: {
+                    if (!started) {
+                        if (token.type != Reader::TokenType::BeginArray) {
+                            co_yield BasicValue<Traits>();
+                            co_return;
+                        }
+                        started = true;
+                    } else if (
+                        (reader.GetDepth() == 0)
+                        && (token.type == Reader::TokenType::EndArray)
+                    ) {
+                        // The array is complete; keep reading to check
+                        // nothing follows it.
+                    } else if (!builder.Push(token)) {
+                        co_yield BasicValue<Traits>();
+                        co_return;
+                    } else if (builder.IsComplete()) {
+                        co_yield builder.Take();
+                    }
+                }
+                break;
+
+                case Reader::Status::NeedInput: {
+                    // The chunk is kept until it's fed, since it may be a
+                    // temporary, such as a std::string returned by value.
+                    auto &&chunk = co_await source.Read();
+                    const std::string_view text(chunk);
+                    if (text.empty()) {
+                        reader.Finish();
+                    } else {
+                        reader.Feed(text);
+                    }
+                }
+                break;
+
+                case Reader::Status::End: co_return;
+
+                default: {
+                    co_yield BasicValue<Traits>();
+                    co_return;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "reader.h"
+#include "value.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Assembles a JSON value from the tokens produced by a Reader.
+     *
+     * Push each token returned by Reader::Next() to the builder; once
+     * IsComplete() returns true, Take() returns the value:
+     *
+     * @code
+     * Json::Reader reader;
+     * Json::Builder builder;
+     * Json::Reader::Token token;
+     * reader.Feed(text);
+     * reader.Finish();
+     * while (reader.Next(token) == Json::Reader::Status::Token) {
+     *     if (!builder.Push(token)) {
+     *         break;
+     *     }
+     * }
+     * @endcode
+     *
+     * Values assembled this way don't keep the text from which they were
+     * read, so encoding them always produces the canonical encoding.  If
+     * an object repeats a key, the last value given for the key is kept.
+     *
+     * @tparam Traits The configuration of the values built.
+     */
+    template<typename Traits>
+    class BasicBuilder {
+    public:
+        /**
+         * @brief Adds the given token to the value being built.
+         *
+         * @param token The next token from the reader.
+         * @return True if the token was added, false if its text couldn't
+         * be decoded (an invalid escape sequence, or an integer out of
+         * range), or it arrived after the value was complete.
+         */
+        bool Push(const Reader::Token &token) {
+            if (complete) {
+                return false;
+            }
+            switch (token.type) {
+                case Reader::TokenType::BeginObject: {
+                    return Insert(BasicValue<Traits>(ValueType::Object), true);
+                }
+
+                case Reader::TokenType::BeginArray: {
+                    return Insert(BasicValue<Traits>(ValueType::Array), true);
+                }
+
+                case Reader::TokenType::EndObject:
+                case Reader::TokenType::EndArray: {
+                    if (containers.empty()) {
+                        return false;
+                    }
+                    containers.pop_back();
+                    complete = containers.empty();
+                    return true;
+                }
+
+                case Reader::TokenType::Key: {
+                    key.clear();
+                    return Decode(token, key);
+                }
+
+                case Reader::TokenType::String: {
+                    std::string text;
+                    return (
+                        Decode(token, text)
+                        && Insert(BasicValue<Traits>(text), false)
+                    );
+                }
+
+                case Reader::TokenType::Integer: {
+                    intmax_t integer;
+                    if (
+                        !Reader::DecodeInteger(token.text, integer)
+                        || !std::in_range<typename BasicValue<Traits>::IntegerType>(integer)
+                    ) {
+                        return false;
+                    }
+                    return Insert(BasicValue<Traits>(integer), false);
+                }
+
+                case Reader::TokenType::FloatingPoint: {
+                    double number;
+                    if (!Reader::DecodeFloatingPoint(token.text, number)) {
+                        return false;
+                    }
+                    return Insert(BasicValue<Traits>(number), false);
+                }
+
+                case Reader::TokenType::True: {
+                    return Insert(BasicValue<Traits>(true), false);
+                }
+
+                case Reader::TokenType::False: {
+                    return Insert(BasicValue<Traits>(false), false);
+                }
+
+                case Reader::TokenType::Null: {
+                    return Insert(BasicValue<Traits>(nullptr), false);
+                }
+
+                default: return false;
+            }
+        }
+
+        /**
+         * @brief Adds a whole value to the value being built, in place of
+         * the tokens which would make it up, such as those of a value
+         * passed over with Reader::Skip().
+         *
+         * @param value The value to add.
+         * @return True if the value was added, false if it arrived after
+         * the value being built was complete.
+         */
+        bool PushValue(BasicValue<Traits> &&value) {
+            if (complete) {
+                return false;
+            }
+            return Insert(std::move(value), false);
+        }
+
+        /**
+         * @brief Checks if a complete value has been built.
+         *
+         * @return True if a top-level value has been pushed and all its
+         * arrays and objects ended, false otherwise.
+         */
+        [[nodiscard]] bool IsComplete() const {
+            return complete;
+        }
+
+        /**
+         * @brief Takes the value built, and prepares the builder for
+         * another.
+         *
+         * @return The value built, or an invalid value if it isn't
+         * complete.
+         */
+        BasicValue<Traits> Take() {
+            BasicValue<Traits> value;
+            if (complete) {
+                value = std::move(root);
+            }
+            Reset();
+            return value;
+        }
+
+        /**
+         * @brief Discards the value being built.
+         */
+        void Reset() {
+            root = BasicValue<Traits>();
+            containers.clear();
+            key.clear();
+            complete = false;
+        }
+
+    private:
+        /**
+         * @brief Decodes the text of the given key or string token.
+         */
+        static bool Decode(
+            const Reader::Token &token,
+            std::string &output
+        ) {
+            if (!token.escaped) {
+                output.assign(token.text);
+                return true;
+            }
+            return Reader::DecodeString(token.text, output);
+        }
+
+        /**
+         * @brief Adds the given value to the innermost container, or makes
+         * it the top-level value.
+         */
+        bool Insert(
+            BasicValue<Traits> &&value,
+            bool isContainer
+        ) {
+            BasicValue<Traits> *inserted;
+            if (containers.empty()) {
+                root = std::move(value);
+                inserted = &root;
+                complete = !isContainer;
+            } else if (containers.back()->GetType() == ValueType::Array) {
+                inserted = &containers.back()->Add(std::move(value));
+            } else {
+                inserted = &containers.back()->Set(key, std::move(value));
+            }
+            if (isContainer) {
+                containers.push_back(inserted);
+            }
+            return true;
+        }
+
+        /** @brief The top-level value. */
+        BasicValue<Traits> root;
+
+        /** @brief The arrays and objects started but not ended. */
+        std::vector<BasicValue<Traits> *> containers;
+
+        /** @brief The key of the next member of the innermost object. */
+        std::string key;
+
+        /** @brief Whether the top-level value is complete. */
+        bool complete = false;
+    };
+
+    /** @brief A builder of values in the default configuration. */
+    using Builder = BasicBuilder<DefaultTraits>;
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "builder.h"
+#include "reader.h"
+#include "value.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Reads a sequence of JSON values written one after another,
+     * such as newline-delimited JSON or documents simply concatenated,
+     * from a buffer or a stream.
+     *
+     * Each value is returned as soon as it has been read; the reader's
+     * buffer and the builder are reused from one value to the next, and
+     * the text is taken in chunks, so memory use doesn't grow with the
+     * length of the sequence:
+     *
+     * @code
+     * Json::DocumentStream documents(std::cin);
+     * for (const auto &document: documents) {
+     *     // use document
+     * }
+     * if (documents.HasFailed()) {
+     *     // the text at documents.GetOffset() isn't valid JSON
+     * }
+     * @endcode
+     *
+     * Values may be separated by whitespace or not separated at all,
+     * except where that would make them run together (two numbers, for
+     * example).  Reading stops at the first text which isn't valid JSON.
+     *
+     * @tparam Traits The configuration of the values read.
+     */
+    template<typename Traits>
+    class BasicDocumentStream {
+    public:
+        /**
+         * @brief Iterates over the values of a document stream.  Advancing
+         * the iterator reads the next value.
+         */
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = BasicValue<Traits>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const BasicValue<Traits> *;
+            using reference = const BasicValue<Traits> &;
+
+            Iterator() = default;
+
+            explicit Iterator(BasicDocumentStream *documents)
+                : documents(documents) {
+                ++*this;
+            }
+
+            reference operator*() const {
+                return value;
+            }
+
+            pointer operator->() const {
+                return &value;
+            }
+
+            Iterator &operator++() {
+                if (!documents->Next(value)) {
+                    documents = nullptr;
+                }
+                return *this;
+            }
+
+            void operator++(int) {
+                ++*this;
+            }
+
+            bool operator==(const Iterator &other) const {
+                return (documents == other.documents);
+            }
+
+        private:
+            /** @brief The stream being read, or nullptr at the end. */
+            BasicDocumentStream *documents = nullptr;
+
+            /** @brief The value most recently read. */
+            BasicValue<Traits> value;
+        };
+
+        /**
+         * @brief Constructs a document stream which reads from the given
+         * text.  The text isn't copied, and must remain valid while the
+         * stream is used.
+         *
+         * @param text The JSON texts to read.
+         */
+        explicit BasicDocumentStream(std::string_view text)
+            : text(text) {
+        }
+
+        /**
+         * @brief Constructs a document stream which reads from the given
+         * stream.  Only the characters the stream already holds are taken
+         * where possible, so each value is returned once it has arrived.
+         *
+         * @param stream The stream from which to read the JSON texts.
+         */
+        explicit BasicDocumentStream(std::istream &stream)
+            : stream(&stream)
+              , chunk(CHUNK_SIZE) {
+        }
+
+        /**
+         * @brief Reads the next value.
+         *
+         * @param value Where to store the value.
+         * @return True if a value was read, false at the end of the input
+         * or if the text isn't valid JSON.
+         */
+        bool Next(BasicValue<Traits> &value) {
+            Reader::Token token;
+            while (!failed) {
+                switch (reader.Next(token)) {
+                    case Reader::Status::Token: {
+                        if (!builder.Push(token)) {
+                            failed = true;
+                        } else if (builder.IsComplete()) {
+                            value = builder.Take();
+                            ++count;
+                            return true;
+                        }
+                    }
+                    break;
+
+                    case Reader::Status::NeedInput: {
+                        Refill();
+                    }
+                    break;
+
+                    case Reader::Status::End: return false;
+
+                    default: {
+                        failed = true;
+                    }
+                    break;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Returns an iterator which reads the next value.
+         */
+        Iterator begin() {
+            return Iterator(this);
+        }
+
+        /**
+         * @brief Returns the iterator which marks the end of the values.
+         */
+        Iterator end() {
+            return Iterator();
+        }
+
+        /**
+         * @brief Returns whether reading stopped because the text isn't
+         * valid JSON.
+         */
+        [[nodiscard]] bool HasFailed() const {
+            return failed;
+        }
+
+        /**
+         * @brief Returns the number of values read so far.
+         */
+        [[nodiscard]] size_t GetCount() const {
+            return count;
+        }
+
+        /**
+         * @brief Returns the position in the input up to which text has
+         * been read.  After a failure, this is the position of the text
+         * which isn't valid.
+         */
+        [[nodiscard]] size_t GetOffset() const {
+            return reader.GetOffset();
+        }
+
+    private:
+        /** @brief The amount of text fed to the reader at once. */
+        static constexpr size_t CHUNK_SIZE = 65536;
+
+        /**
+         * @brief Feeds the reader the next chunk of the input, or tells it
+         * that the input is finished.
+         */
+        void Refill() {
+            if (stream == nullptr) {
+                if (text.empty()) {
+                    reader.Finish();
+                } else {
+                    const auto amount = std::min(text.size(), CHUNK_SIZE);
+                    reader.Feed(text.substr(0, amount));
+                    text.remove_prefix(amount);
+                }
+                return;
+            }
+            const auto source = stream->rdbuf();
+
+            // Wait until the stream has something, then take only what it
+            // has, so that reading from a pipe doesn't wait for text past
+            // the end of a value.
+            if (
+                (source == nullptr)
+                || (source->sgetc() == std::char_traits<char>::eof())
+            ) {
+                stream->setstate(std::ios_base::eofbit);
+                reader.Finish();
+                return;
+            }
+            const auto available = std::max(source->in_avail(), (std::streamsize) 1);
+            const auto amount = source->sgetn(
+                chunk.data(),
+                std::min((std::streamsize) chunk.size(), available)
+            );
+            reader.Feed(std::string_view(chunk.data(), (size_t) amount));
+        }
+
+        /** @brief The text not yet fed to the reader, if reading text. */
+        std::string_view text;
+
+        /** @brief The stream being read, if any. */
+        std::istream *stream = nullptr;
+
+        /** @brief The buffer into which text is taken from the stream. */
+        std::vector<char> chunk;
+
+        /** @brief The reader, which accepts multiple values. */
+        Reader reader{true};
+
+        /** @brief The builder, reused for each value. */
+        BasicBuilder<Traits> builder;
+
+        /** @brief The number of values read so far. */
+        size_t count = 0;
+
+        /** @brief Whether reading stopped because of invalid text. */
+        bool failed = false;
+    };
+
+    /** @brief A document stream of values in the default configuration. */
+    using DocumentStream = BasicDocumentStream<DefaultTraits>;
+}
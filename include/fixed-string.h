@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace Json {
+    /**
+     * @brief A string literal captured as a structural type, so it can be
+     * passed as a template argument.
+     *
+     * This lets text known at compile time, such as a JSON literal or a set
+     * of object keys, be processed in constant expressions, for example
+     * `Json::Literal<"[1,2,3]">`.
+     *
+     * @tparam N The size of the captured array, including the terminator.
+     */
+    template<size_t N>
+    struct FixedString {
+        /**
+         * @brief Captures the given string literal.
+         *
+         * @param text The string literal to capture.
+         */
+        constexpr FixedString(const char (&text)[N]) {
+            for (size_t i = 0; i < N; ++i) {
+                characters[i] = text[i];
+            }
+        }
+
+        /**
+         * @brief Returns the number of characters, excluding the terminator.
+         *
+         * @return The length of the string.
+         */
+        [[nodiscard]] constexpr size_t GetSize() const {
+            return N - 1;
+        }
+
+        /**
+         * @brief Returns a view of the characters, excluding the terminator.
+         *
+         * @return A view of the string.
+         */
+        [[nodiscard]] constexpr std::string_view GetView() const {
+            return std::string_view(characters, N - 1);
+        }
+
+        /** @brief The captured characters, including the terminator. */
+        char characters[N] = {};
+    };
+
+    template<size_t N>
+    FixedString(const char (&)[N]) -> FixedString<N>;
+}
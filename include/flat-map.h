@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief An ordered map from strings to values, stored as a sorted
+     * vector of key-value pairs.
+     *
+     * Compared with std::map it keeps all members of an object in one
+     * allocation and iterates them in key order through contiguous
+     * memory, at the cost of linear-time insertion and removal.  It
+     * provides the subset of the std::map interface which JSON values
+     * use, so it can be selected as the object container of a
+     * BasicValue through its traits.
+     *
+     * @tparam V The mapped type.
+     */
+    template<typename V>
+    class FlatMap {
+    public:
+        using key_type = std::string;
+        using mapped_type = V;
+        using value_type = std::pair<std::string, V>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        [[nodiscard]] iterator begin() {
+            return entries.begin();
+        }
+
+        [[nodiscard]] const_iterator begin() const {
+            return entries.begin();
+        }
+
+        [[nodiscard]] iterator end() {
+            return entries.end();
+        }
+
+        [[nodiscard]] const_iterator end() const {
+            return entries.end();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return entries.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return entries.empty();
+        }
+
+        void reserve(size_t capacity) {
+            entries.reserve(capacity);
+        }
+
+        [[nodiscard]] iterator find(std::string_view key) {
+            const auto entry = LowerBound(key);
+            if (
+                (entry == entries.end())
+                || (entry->first != key)
+            ) {
+                return entries.end();
+            }
+            return entry;
+        }
+
+        [[nodiscard]] const_iterator find(std::string_view key) const {
+            return const_cast<FlatMap *>(this)->find(key);
+        }
+
+        /**
+         * @brief Returns the value with the given key, inserting a
+         * default-constructed one first if there isn't one.
+         */
+        V &operator[](const std::string &key) {
+            auto entry = LowerBound(key);
+            if (
+                (entry == entries.end())
+                || (entry->first != key)
+            ) {
+                entry = entries.insert(entry, value_type(key, V()));
+            }
+            return entry->second;
+        }
+
+        /**
+         * @brief Inserts the given entry unless its key is already present.
+         *
+         * @return The position of the entry with the key, and whether the
+         *     given entry was inserted.
+         */
+        std::pair<iterator, bool> insert(value_type &&entry) {
+            auto position = LowerBound(entry.first);
+            if (
+                (position != entries.end())
+                && (position->first == entry.first)
+            ) {
+                return {position, false};
+            }
+            return {entries.insert(position, std::move(entry)), true};
+        }
+
+        std::pair<iterator, bool> insert(const value_type &entry) {
+            return insert(value_type(entry));
+        }
+
+        /**
+         * @brief Removes the entry with the given key, if any.
+         *
+         * @return The number of entries removed.
+         */
+        size_t erase(const std::string &key) {
+            const auto entry = find(key);
+            if (entry == entries.end()) {
+                return 0;
+            }
+            (void) entries.erase(entry);
+            return 1;
+        }
+
+    private:
+        iterator LowerBound(std::string_view key) {
+            return std::lower_bound(
+                entries.begin(),
+                entries.end(),
+                key,
+                [](const value_type &entry, std::string_view k) {
+                    return entry.first < k;
+                }
+            );
+        }
+
+        /** @brief The entries, sorted by key. */
+        std::vector<value_type> entries;
+    };
+}
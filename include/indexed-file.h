@@ -0,0 +1,138 @@
+#pragma once
+
+#include "pointer.h"
+#include "value.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace Json {
+    /**
+     * @brief Options for building an index with IndexFile().
+     */
+    struct IndexOptions {
+        /**
+         * @brief Whether the file holds newline-delimited records rather
+         * than one JSON value.  Defaults to false.
+         */
+        bool lines = false;
+
+        /**
+         * @brief The number of threads indexing records, when lines is
+         * set.  Zero means one per hardware thread.  A single value is
+         * always indexed on one thread.  Defaults to 0.
+         */
+        size_t threads = 0;
+
+        /**
+         * @brief The length of text below which arrays and objects aren't
+         * indexed, since parsing them whole is about as quick as looking
+         * them up.  This keeps the index a small fraction of the size of
+         * the file.  Defaults to 4096.
+         */
+        size_t minimumContainerSize = 4096;
+    };
+
+    /**
+     * @brief Builds a structural index of a JSON file, which IndexedFile
+     * uses to find values without parsing the whole file.
+     *
+     * The index records where each large array and object starts and
+     * ends, where each of its elements starts, and a hash of each of its
+     * keys, and, for newline-delimited records, where each record starts.
+     * It's written beside the file, at the file's path with ".idx"
+     * appended, and holds the size and modification time of the file so
+     * that an index which is out of date isn't used.
+     *
+     * @param path The path of the file to index.
+     * @param options Options controlling what is indexed, and how.
+     * @return True if the index was written, false if the file couldn't
+     * be read, isn't valid JSON, or the index couldn't be written.
+     */
+    bool IndexFile(
+        const std::string &path,
+        const IndexOptions &options = IndexOptions()
+    );
+
+    /**
+     * @brief A JSON file, opened with the index IndexFile() built for it,
+     * from which single values are parsed on demand.
+     *
+     * The file is mapped into memory rather than read, so opening it
+     * costs little however large it is, and each lookup parses only the
+     * value found:
+     *
+     * @code
+     * Json::IndexedFile file;
+     * if (file.Open("export.json")) {
+     *     const auto name = file.Get(Json::Pointer("/users/123456/name"));
+     * }
+     * @endcode
+     *
+     * For newline-delimited records, the file is treated as an array of
+     * its records, so the first token of a pointer is a record number.
+     */
+    class IndexedFile {
+    public:
+        ~IndexedFile() noexcept;
+        IndexedFile(const IndexedFile &) = delete;
+        IndexedFile(IndexedFile &&) noexcept;
+        IndexedFile &operator=(const IndexedFile &) = delete;
+        IndexedFile &operator=(IndexedFile &&) noexcept;
+
+        /**
+         * @brief Constructs an object with no file open.
+         */
+        IndexedFile();
+
+        /**
+         * @brief Opens a file and its index.
+         *
+         * @param path The path of the file.
+         * @return True if the file was opened, false if it or its index
+         * couldn't be read, or the index is out of date.
+         */
+        bool Open(const std::string &path);
+
+        /**
+         * @brief Checks if a file is open.
+         */
+        [[nodiscard]] bool IsOpen() const;
+
+        /**
+         * @brief Returns the number of records in a file of
+         * newline-delimited records, or zero for a file holding one value.
+         */
+        [[nodiscard]] size_t GetRecordCount() const;
+
+        /**
+         * @brief Parses the value at the given pointer.
+         *
+         * @param pointer The pointer to the value.
+         * @return The value, or an invalid value if there's none at the
+         * pointer, or no file is open.
+         */
+        [[nodiscard]] Value Get(const Pointer &pointer) const;
+
+        /**
+         * @brief Parses one record of a file of newline-delimited records.
+         *
+         * @param index The number of the record, counting from zero.
+         * @return The record, or an invalid value if there's no such
+         * record.
+         */
+        [[nodiscard]] Value GetRecord(size_t index) const;
+
+    private:
+        /**
+         * @brief Private implementation details.
+         */
+        struct Impl;
+
+        /**
+         * @brief Unique pointer to the private implementation.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "value.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace Json {
+    /**
+     * @brief Options for keeping a document with JournaledDocument.
+     */
+    struct JournalOptions {
+        /**
+         * @brief The number of bytes of journal written since the last
+         * snapshot at which a new snapshot is started in the background.
+         * Defaults to 64 MiB.
+         */
+        size_t compactionThreshold = 67108864;
+
+        /**
+         * @brief If true, each commit, and each snapshot, is flushed to the
+         * storage device before it counts as written, so that it survives
+         * a crash of the machine and not only of the process.  Defaults to
+         * false.
+         */
+        bool sync = false;
+    };
+
+    /**
+     * @brief A JSON value kept in files as a snapshot plus a journal of
+     * the changes made since, so that saving a change costs about as much
+     * as the change rather than as the whole value.
+     *
+     * The value tracks its changes, as with BasicValue::BeginTracking(),
+     * and each Commit() appends those made since the last one to the
+     * journal, as one line holding a JSON Patch:
+     *
+     * @code
+     * Json::JournaledDocument document;
+     * if (document.Open("state.json")) {
+     *     document.GetValue()["sessions"]["abc"]["seen"] = now;
+     *     (void) document.Commit();
+     * }
+     * @endcode
+     *
+     * The files are named after the path given to Open(), with
+     * ".snapshot.N" and ".journal.N" appended, where N is a generation
+     * number.  Snapshot N holds the value before the changes in journals
+     * N and later.  Once the journals written since the last snapshot grow
+     * past JournalOptions::compactionThreshold, the next generation's
+     * journal is begun, and the next generation's snapshot is written on
+     * another thread, after which the older files are removed.  That
+     * thread reads the snapshot back from the older files rather than
+     * copying the value, so commits aren't held up meanwhile, at the cost
+     * of decoding the older snapshot and journals once more.
+     *
+     * A JournaledDocument may only be used by one thread at a time.
+     */
+    class JournaledDocument {
+    public:
+        /**
+         * @brief Commits any changes not yet committed, and waits for any
+         * snapshot being written.
+         */
+        ~JournaledDocument() noexcept;
+
+        JournaledDocument(const JournaledDocument &) = delete;
+        JournaledDocument(JournaledDocument &&) noexcept;
+        JournaledDocument &operator=(const JournaledDocument &) = delete;
+        JournaledDocument &operator=(JournaledDocument &&) noexcept;
+
+        /**
+         * @brief Constructs an object with no document open.
+         */
+        JournaledDocument();
+
+        /**
+         * @brief Opens a document, reading its latest snapshot and
+         * applying the journals written after it.
+         *
+         * A document with no files yet starts as an empty object.  A
+         * journal's last line, if it was cut short by a crash, is
+         * ignored.  Changes are written to a new journal, so that no
+         * journal is appended to after such a line.
+         *
+         * @param path The path after which the document's files are named.
+         * @param options Options controlling when snapshots are written,
+         * and how.
+         * @return True if the document was opened, false if its snapshot
+         * couldn't be read, or a journal holds a line which isn't a valid
+         * patch for the value.
+         */
+        bool Open(
+            const std::string &path,
+            const JournalOptions &options = JournalOptions()
+        );
+
+        /**
+         * @brief Checks if a document is open.
+         */
+        [[nodiscard]] bool IsOpen() const;
+
+        /**
+         * @brief Returns the document's value, to read or change.
+         *
+         * The value's changes are tracked, so its tracking mustn't be
+         * ended, nor its changes taken, other than by Commit().  An
+         * object moved from returns a null value kept nowhere.
+         */
+        [[nodiscard]] Value &GetValue();
+
+        /**
+         * @brief Returns the document's value.
+         */
+        [[nodiscard]] const Value &GetValue() const;
+
+        /**
+         * @brief Appends the changes made to the value since the last
+         * commit to the journal, and starts writing a snapshot in the
+         * background if the journal has grown enough.
+         *
+         * @return True if the changes were written, false otherwise.  If
+         * the journal can't be written, a snapshot holding the changes is
+         * written instead, and true is returned if that succeeds.  If
+         * that fails too, the changes are kept in the value, and no more
+         * commits are made until Compact() writes a snapshot.
+         */
+        bool Commit();
+
+        /**
+         * @brief Commits any changes not yet committed, and writes a new
+         * snapshot now, waiting for it to be written.
+         *
+         * The snapshot holds any changes not committed, so this is how
+         * commits resume after one failed.
+         *
+         * @return True if the snapshot was written, false otherwise.
+         */
+        bool Compact();
+
+        /**
+         * @brief Commits any changes not yet committed, waits for any
+         * snapshot being written, and closes the document.
+         */
+        void Close();
+
+    private:
+        /**
+         * @brief Private implementation details.
+         */
+        struct Impl;
+
+        /**
+         * @brief Unique pointer to the private implementation.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "fixed-string.h"
+#include "value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace Json {
+    namespace Detail {
+        /**
+         * This is the hash function used by KeySet: 64-bit FNV-1a with
+         * the seed folded into the offset basis, and the high half mixed
+         * into the low half so that masking keeps the best bits.
+         *
+         * @param[in] key
+         *     This is the key to hash.
+         *
+         * @param[in] seed
+         *     This selects one member of the family of hash functions.
+         *
+         * @return
+         *     The hash of the key is returned.
+         */
+        constexpr uint64_t HashKey(
+            std::string_view key,
+            uint64_t seed
+        ) {
+            uint64_t hash = 0xCBF29CE484222325ull ^ (seed * 0x9E3779B97F4A7C15ull);
+            for (const auto c: key) {
+                hash ^= (uint64_t) (unsigned char) c;
+                hash *= 0x100000001B3ull;
+            }
+            return hash ^ (hash >> 32);
+        }
+
+        /**
+         * This is deliberately not constexpr.  Reaching a call to it
+         * while a KeySet is built at compile time makes the compiler
+         * reject the KeySet, and the error message names this function
+         * along with the reason passed to it.
+         *
+         * @param[in] reason
+         *     This describes what is wrong with the KeySet.
+         */
+        void InvalidKeySet(const char *reason);
+
+        /**
+         * @brief The tables of a perfect hash over a fixed set of keys,
+         * built by hash and displace: keys are grouped into buckets by
+         * their hash, and each bucket has its own displacement, which
+         * moves all its keys into slots no other key uses.
+         *
+         * @tparam NumKeys The number of keys.
+         * @tparam NumBuckets The number of buckets, a power of two.
+         * @tparam NumSlots The number of slots, a power of two.
+         */
+        template<size_t NumKeys, size_t NumBuckets, size_t NumSlots>
+        struct PerfectHashTable {
+            /** @brief For each bucket, the displacement of its keys. */
+            uint16_t displacements[NumBuckets] = {};
+
+            /** @brief For each slot, one more than the index of the key in it, or zero. */
+            unsigned char slots[NumSlots] = {};
+        };
+
+        /**
+         * This returns the bucket of a key with the given hash.
+         */
+        constexpr size_t PerfectHashBucket(
+            uint64_t hash,
+            size_t numBuckets
+        ) {
+            return (size_t) (hash >> 48) & (numBuckets - 1);
+        }
+
+        /**
+         * This returns the slot of a key with the given hash, when its
+         * bucket has the given displacement.
+         */
+        constexpr size_t PerfectHashSlot(
+            uint64_t hash,
+            uint16_t displacement,
+            size_t numSlots
+        ) {
+            hash ^= (uint64_t) displacement * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 31;
+            hash *= 0xBF58476D1CE4E5B9ull;
+            hash ^= hash >> 29;
+            return (size_t) hash & (numSlots - 1);
+        }
+
+        /**
+         * This builds a perfect hash table for the given keys.  Buckets
+         * are placed from the largest to the smallest, each with the
+         * first displacement which puts its keys in free slots.  With
+         * twice as many slots as keys, and about two keys per bucket,
+         * a few tries per bucket are enough, so the cost grows about
+         * linearly with the number of keys.
+         *
+         * @param[in] keys
+         *     These are the keys to place.
+         *
+         * @return
+         *     The perfect hash table for the keys is returned.
+         */
+        template<size_t NumKeys, size_t NumBuckets, size_t NumSlots>
+        consteval PerfectHashTable<NumKeys, NumBuckets, NumSlots> MakePerfectHashTable(const std::string_view (&keys)[NumKeys]) {
+            uint64_t hashes[NumKeys] = {};
+            size_t bucketSizes[NumBuckets] = {};
+            size_t largestBucket = 0;
+            for (size_t i = 0; i < NumKeys; ++i) {
+                hashes[i] = HashKey(keys[i], 0);
+                for (size_t j = 0; j < i; ++j) {
+                    if (
+                        (hashes[i] == hashes[j])
+                        && (keys[i] == keys[j])
+                    ) {
+                        InvalidKeySet("duplicate key");
+                    }
+                }
+                const auto bucketSize = ++bucketSizes[PerfectHashBucket(hashes[i], NumBuckets)];
+                if (bucketSize > largestBucket) {
+                    largestBucket = bucketSize;
+                }
+            }
+            PerfectHashTable<NumKeys, NumBuckets, NumSlots> table;
+            size_t members[NumKeys] = {};
+            size_t placed[NumKeys] = {};
+            for (size_t bucketSize = largestBucket; bucketSize > 0; --bucketSize) {
+                for (size_t bucket = 0; bucket < NumBuckets; ++bucket) {
+                    if (bucketSizes[bucket] != bucketSize) {
+                        continue;
+                    }
+                    size_t numMembers = 0;
+                    for (size_t i = 0; i < NumKeys; ++i) {
+                        if (PerfectHashBucket(hashes[i], NumBuckets) == bucket) {
+                            members[numMembers++] = i;
+                        }
+                    }
+                    bool found = false;
+                    for (uint32_t displacement = 0; displacement <= 0xFFFF; ++displacement) {
+                        found = true;
+                        for (size_t i = 0; found && (i < numMembers); ++i) {
+                            placed[i] = PerfectHashSlot(hashes[members[i]], (uint16_t) displacement, NumSlots);
+                            if (table.slots[placed[i]] != 0) {
+                                found = false;
+                            }
+                            for (size_t j = 0; found && (j < i); ++j) {
+                                if (placed[i] == placed[j]) {
+                                    found = false;
+                                }
+                            }
+                        }
+                        if (found) {
+                            table.displacements[bucket] = (uint16_t) displacement;
+                            break;
+                        }
+                    }
+                    if (!found) {
+                        InvalidKeySet("no perfect hash found");
+                    }
+                    for (size_t i = 0; i < numMembers; ++i) {
+                        table.slots[placed[i]] = (unsigned char) (members[i] + 1);
+                    }
+                }
+            }
+            return table;
+        }
+
+        /**
+         * This returns the smallest power of two which is at least the
+         * given number.
+         */
+        constexpr size_t PowerOfTwoAtLeast(size_t number) {
+            size_t power = 1;
+            while (power < number) {
+                power <<= 1;
+            }
+            return power;
+        }
+    }
+
+    /**
+     * @brief A fixed set of object keys, mapped to field indices through a
+     * perfect hash built at compile time.
+     *
+     * Looking up a key costs one hash, one displacement lookup and at most
+     * one string comparison, instead of a map walk per field.  This suits
+     * handlers which read a known set of fields out of many objects:
+     *
+     * @code
+     * using Fields = Json::KeySet<"id", "type", "ts">;
+     * Fields::Dispatch(message, [&](size_t field, const Json::Value &value) {
+     *     switch (field) {
+     *         case Fields::IndexOf("id"): id = (intmax_t) value; break;
+     *         case Fields::IndexOf("type"): type = (std::string) value; break;
+     *         case Fields::IndexOf("ts"): ts = (double) value; break;
+     *     }
+     * });
+     * @endcode
+     *
+     * @tparam Keys The keys in the set, which must be distinct; their
+     *     order defines their indices.  At most 255 keys are supported.
+     */
+    template<FixedString... Keys>
+    class KeySet {
+    public:
+        /** @brief The number of keys in the set. */
+        static constexpr size_t size = sizeof...(Keys);
+
+        /** @brief Returned by Find() for keys which aren't in the set. */
+        static constexpr size_t npos = (size_t) -1;
+
+        static_assert(size > 0, "a KeySet needs at least one key");
+        static_assert(size < 256, "a KeySet supports at most 255 keys");
+
+        /**
+         * @brief Returns the index of the given key in the set.
+         *
+         * @param key The key to look up.
+         * @return The index of the key, or npos if it isn't in the set.
+         */
+        [[nodiscard]] static constexpr size_t Find(std::string_view key) {
+            const auto hash = Detail::HashKey(key, 0);
+            const auto displacement = table.displacements[Detail::PerfectHashBucket(hash, numBuckets)];
+            const auto slot = table.slots[Detail::PerfectHashSlot(hash, displacement, numSlots)];
+            if (
+                (slot == 0)
+                || (keys[slot - 1] != key)
+            ) {
+                return npos;
+            }
+            return (size_t) (slot - 1);
+        }
+
+        /**
+         * @brief Returns the index of a key known to be in the set.
+         *
+         * Use it in constant expressions such as case labels; a key which
+         * isn't in the set fails to compile.
+         *
+         * @param key The key to look up.
+         * @return The index of the key.
+         */
+        [[nodiscard]] static consteval size_t IndexOf(std::string_view key) {
+            const auto index = Find(key);
+            if (index == npos) {
+                Detail::InvalidKeySet("key is not in the set");
+            }
+            return index;
+        }
+
+        /**
+         * @brief Returns the key with the given index.
+         *
+         * @param index The index of the key.
+         * @return The key.
+         */
+        [[nodiscard]] static constexpr std::string_view GetKey(size_t index) {
+            return keys[index];
+        }
+
+        /**
+         * @brief Calls the given function once for every member of the given
+         * JSON object whose key is in the set, walking the object only once.
+         *
+         * Nothing is called if the value isn't an object.
+         *
+         * @param object The JSON object whose members to visit.
+         * @param function The function to call with the index of the key
+         *     and the value of the member.
+         */
+        template<typename Traits, typename Function>
+        static void Dispatch(
+            const BasicValue<Traits> &object,
+            Function &&function
+        ) {
+            if (object.GetType() != ValueType::Object) {
+                return;
+            }
+            for (const auto &entry: object) {
+                const auto index = Find(entry.key());
+                if (index != npos) {
+                    function(index, entry.value());
+                }
+            }
+        }
+
+    private:
+        /** @brief The number of buckets in the perfect hash table. */
+        static constexpr size_t numBuckets = Detail::PowerOfTwoAtLeast((size + 1) / 2);
+
+        /** @brief The number of slots in the perfect hash table. */
+        static constexpr size_t numSlots = Detail::PowerOfTwoAtLeast(size * 2);
+
+        /** @brief The keys in the set, by index. */
+        static constexpr std::string_view keys[size] = {Keys.GetView()...};
+
+        /** @brief The perfect hash table mapping keys to indices. */
+        static constexpr auto table = Detail::MakePerfectHashTable<size, numBuckets, numSlots>(keys);
+    };
+}
@@ -0,0 +1,871 @@
+#pragma once
+
+#include "fixed-string.h"
+#include "value.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+namespace Json {
+    namespace Detail {
+        /**
+         * @brief Enumerates the kinds of tokens a JSON literal is broken
+         * into at compile time.
+         */
+        enum class LiteralTokenKind : unsigned char {
+            BeginArray,
+            EndArray,
+            BeginObject,
+            EndObject,
+            Key,
+            Null,
+            Boolean,
+            Integer,
+            FloatingPoint,
+            String,
+        };
+
+        /**
+         * @brief One token of a JSON literal, fully decoded at compile time.
+         *
+         * Strings and keys are stored decoded (unescaped, UTF-8) in the
+         * string pool of the literal, and referenced by offset and length.
+         */
+        struct LiteralToken {
+            LiteralTokenKind kind = LiteralTokenKind::Null;
+            bool booleanValue = false;
+            intmax_t integerValue = 0;
+            double floatingPointValue = 0.0;
+            size_t stringOffset = 0;
+            size_t stringLength = 0;
+        };
+
+        /**
+         * This is deliberately not constexpr.  Reaching a call to it while
+         * a literal is being parsed at compile time makes the compiler
+         * reject the literal, and the error message names this function
+         * along with the reason passed to it.
+         *
+         * @param[in] reason
+         *     This describes what is wrong with the literal.
+         */
+        void InvalidJsonLiteral(const char *reason);
+
+        /**
+         * @brief Unsigned integer of fixed capacity, used to find the
+         * double nearest a decimal number exactly at compile time.
+         *
+         * The capacity fits the largest numbers DecimalToDouble() works
+         * with, which are bounded by the digits it keeps and the range of
+         * exponents it doesn't settle beforehand.
+         */
+        class LiteralBigInteger {
+        public:
+            /** @brief The number of 32-bit words the integer can hold. */
+            static constexpr size_t NUM_WORDS = 128;
+
+            constexpr explicit LiteralBigInteger(uint32_t value = 0) {
+                if (value != 0) {
+                    words[0] = value;
+                    size = 1;
+                }
+            }
+
+            /** @brief Checks if the integer is zero. */
+            [[nodiscard]] constexpr bool IsZero() const {
+                return (size == 0);
+            }
+
+            /** @brief Returns the number of bits up to the highest one set. */
+            [[nodiscard]] constexpr size_t GetBitLength() const {
+                if (size == 0) {
+                    return 0;
+                }
+                return (size - 1) * 32 + (size_t) std::bit_width(words[size - 1]);
+            }
+
+            /**
+             * @brief Compares the integer with another.
+             *
+             * @return A negative number, zero, or a positive number, if the
+             * integer is less than, equal to, or greater than the other.
+             */
+            [[nodiscard]] constexpr int Compare(const LiteralBigInteger &other) const {
+                if (size != other.size) {
+                    return ((size < other.size) ? -1 : 1);
+                }
+                for (auto i = size; i-- > 0;) {
+                    if (words[i] != other.words[i]) {
+                        return ((words[i] < other.words[i]) ? -1 : 1);
+                    }
+                }
+                return 0;
+            }
+
+            /** @brief Multiplies the integer by one number, and adds another. */
+            constexpr void MultiplyAdd(uint32_t factor, uint32_t addend) {
+                uint64_t carry = addend;
+                for (size_t i = 0; i < size; ++i) {
+                    const auto product = (uint64_t) words[i] * factor + carry;
+                    words[i] = (uint32_t) product;
+                    carry = (product >> 32);
+                }
+                if (carry != 0) {
+                    Grow(size + 1);
+                    words[size - 1] = (uint32_t) carry;
+                }
+                Trim();
+            }
+
+            /** @brief Multiplies the integer by the given power of ten. */
+            constexpr void MultiplyByPowerOfTen(size_t exponent) {
+                for (; exponent >= 9; exponent -= 9) {
+                    MultiplyAdd(1000000000, 0);
+                }
+                uint32_t factor = 1;
+                for (; exponent > 0; --exponent) {
+                    factor *= 10;
+                }
+                MultiplyAdd(factor, 0);
+            }
+
+            /** @brief Multiplies the integer by the given power of two. */
+            constexpr void ShiftLeft(size_t bits) {
+                if (size == 0) {
+                    return;
+                }
+                const auto wordShift = bits / 32;
+                const auto bitShift = bits % 32;
+                const auto oldSize = size;
+                Grow(size + wordShift + 1);
+                for (auto i = size; i-- > 0;) {
+                    uint32_t word = 0;
+                    if (i >= wordShift) {
+                        const auto source = i - wordShift;
+                        if (source < oldSize) {
+                            word = (words[source] << bitShift);
+                        }
+                        if (
+                            (bitShift != 0)
+                            && (source >= 1)
+                            && (source - 1 < oldSize)
+                        ) {
+                            word |= (words[source - 1] >> (32 - bitShift));
+                        }
+                    }
+                    words[i] = word;
+                }
+                Trim();
+            }
+
+            /** @brief Divides the integer by two, dropping the remainder. */
+            constexpr void ShiftRightOne() {
+                for (size_t i = 0; i < size; ++i) {
+                    words[i] = (
+                        (words[i] >> 1)
+                        | ((i + 1 < size) ? (words[i + 1] << 31) : 0)
+                    );
+                }
+                Trim();
+            }
+
+            /** @brief Subtracts another integer, which mustn't be greater. */
+            constexpr void Subtract(const LiteralBigInteger &other) {
+                uint64_t borrow = 0;
+                for (size_t i = 0; i < size; ++i) {
+                    const auto subtrahend = (uint64_t) ((i < other.size) ? other.words[i] : 0) + borrow;
+                    borrow = (((uint64_t) words[i] < subtrahend) ? 1 : 0);
+                    words[i] = (uint32_t) ((uint64_t) words[i] + (borrow << 32) - subtrahend);
+                }
+                Trim();
+            }
+
+            /**
+             * @brief Divides the integer by another, leaving the remainder
+             * in it.
+             *
+             * @param divisor The integer by which to divide.
+             * @return The quotient, which must be less than 2^55.
+             */
+            constexpr uint64_t Divide(LiteralBigInteger divisor) {
+                divisor.ShiftLeft(54);
+                uint64_t quotient = 0;
+                for (auto bit = 55; bit-- > 0;) {
+                    if (Compare(divisor) >= 0) {
+                        Subtract(divisor);
+                        quotient |= ((uint64_t) 1 << bit);
+                    }
+                    divisor.ShiftRightOne();
+                }
+                return quotient;
+            }
+
+        private:
+            constexpr void Grow(size_t newSize) {
+                if (newSize > NUM_WORDS) {
+                    InvalidJsonLiteral("number too long");
+                }
+                for (auto i = size; i < newSize; ++i) {
+                    words[i] = 0;
+                }
+                size = newSize;
+            }
+
+            constexpr void Trim() {
+                while (
+                    (size > 0)
+                    && (words[size - 1] == 0)
+                ) {
+                    --size;
+                }
+            }
+
+            uint32_t words[NUM_WORDS] = {};
+            size_t size = 0;
+        };
+
+        /**
+         * This returns the double nearest the given decimal number,
+         * rounding halfway cases to even, the way Value::FromEncoding
+         * does, and overflowing to infinity.
+         *
+         * @param[in] significand
+         *     These are the significant digits of the number, as an
+         *     integer.
+         *
+         * @param[in] numDigits
+         *     This is the number of significant digits.
+         *
+         * @param[in] exponent
+         *     This is the power of ten by which to multiply them.
+         *
+         * @return
+         *     The double nearest the number is returned.
+         */
+        constexpr double DecimalToDouble(
+            LiteralBigInteger significand,
+            intmax_t numDigits,
+            intmax_t exponent
+        ) {
+            // The number is at least 10^(numDigits + exponent - 1), and
+            // less than 10^(numDigits + exponent), which settles those
+            // beyond the range of doubles without big powers of ten.
+            if (significand.IsZero()) {
+                return 0.0;
+            }
+            if (numDigits + exponent - 1 > std::numeric_limits<double>::max_exponent10) {
+                return std::numeric_limits<double>::infinity();
+            }
+            if (numDigits + exponent < -324) {
+                return 0.0;
+            }
+            LiteralBigInteger denominator(1);
+            if (exponent >= 0) {
+                significand.MultiplyByPowerOfTen((size_t) exponent);
+            } else {
+                denominator.MultiplyByPowerOfTen((size_t) -exponent);
+            }
+
+            // The number is the quotient times 2^binaryExponent, with the
+            // quotient holding the 53 bits of a double's significand, or
+            // fewer for a subnormal.
+            auto binaryExponent = (
+                (intmax_t) significand.GetBitLength()
+                - (intmax_t) denominator.GetBitLength()
+                - 53
+            );
+            while (true) {
+                if (binaryExponent < -1074) {
+                    binaryExponent = -1074;
+                }
+                auto remainder = significand;
+                auto divisor = denominator;
+                if (binaryExponent < 0) {
+                    remainder.ShiftLeft((size_t) -binaryExponent);
+                } else {
+                    divisor.ShiftLeft((size_t) binaryExponent);
+                }
+                auto quotient = remainder.Divide(divisor);
+                if (quotient >= ((uint64_t) 1 << 53)) {
+                    ++binaryExponent;
+                    continue;
+                }
+                remainder.ShiftLeft(1);
+                const auto half = remainder.Compare(divisor);
+                if (
+                    (half > 0)
+                    || (
+                        (half == 0)
+                        && ((quotient & 1) != 0)
+                    )
+                ) {
+                    ++quotient;
+                }
+                if (quotient == ((uint64_t) 1 << 53)) {
+                    quotient >>= 1;
+                    ++binaryExponent;
+                }
+                if (binaryExponent > 971) {
+                    return std::numeric_limits<double>::infinity();
+                }
+                if (quotient < ((uint64_t) 1 << 52)) {
+                    return std::bit_cast<double>(quotient);
+                }
+                return std::bit_cast<double>(
+                    ((uint64_t) (binaryExponent + 1075) << 52)
+                    | (quotient - ((uint64_t) 1 << 52))
+                );
+            }
+        }
+
+        /**
+         * @brief Compile-time parser for JSON literals.
+         *
+         * It follows the same grammar as Value::FromEncoding.  When no
+         * output storage is given, it only counts the tokens and the
+         * string pool bytes needed, so the storage can be sized exactly.
+         */
+        class LiteralParser {
+        public:
+            constexpr LiteralParser(
+                std::string_view text,
+                LiteralToken *tokens,
+                char *pool
+            )
+                : text(text)
+                  , tokens(tokens)
+                  , pool(pool) {
+            }
+
+            /**
+             * This parses the whole literal.
+             */
+            constexpr void Parse() {
+                SkipWhitespace();
+                if (offset == text.size()) {
+                    InvalidJsonLiteral("empty literal");
+                }
+                ParseValue();
+                SkipWhitespace();
+                if (offset != text.size()) {
+                    InvalidJsonLiteral("extra characters after the value");
+                }
+            }
+
+            /** @brief Returns the number of tokens produced. */
+            [[nodiscard]] constexpr size_t GetNumTokens() const {
+                return numTokens;
+            }
+
+            /** @brief Returns the number of string pool bytes produced. */
+            [[nodiscard]] constexpr size_t GetPoolSize() const {
+                return poolSize;
+            }
+
+        private:
+            [[nodiscard]] constexpr bool AtEnd() const {
+                return offset >= text.size();
+            }
+
+            [[nodiscard]] constexpr char Peek() const {
+                return AtEnd() ? '\0' : text[offset];
+            }
+
+            constexpr void Expect(char c) {
+                if (Peek() != c) {
+                    InvalidJsonLiteral("unexpected character");
+                }
+                ++offset;
+            }
+
+            constexpr void SkipWhitespace() {
+                while (
+                    !AtEnd()
+                    && (
+                        (text[offset] == ' ')
+                        || (text[offset] == '\t')
+                        || (text[offset] == '\r')
+                        || (text[offset] == '\n')
+                    )
+                ) {
+                    ++offset;
+                }
+            }
+
+            constexpr LiteralToken &Emit(LiteralTokenKind kind) {
+                if (tokens == nullptr) {
+                    scratch = LiteralToken();
+                    scratch.kind = kind;
+                    ++numTokens;
+                    return scratch;
+                }
+                auto &token = tokens[numTokens++];
+                token.kind = kind;
+                return token;
+            }
+
+            constexpr void PutByte(unsigned char byte) {
+                if (pool != nullptr) {
+                    pool[poolSize] = (char) byte;
+                }
+                ++poolSize;
+            }
+
+            constexpr void PutCodePoint(uint32_t cp) {
+                if (cp < 0x80) {
+                    PutByte((unsigned char) cp);
+                } else if (cp < 0x800) {
+                    PutByte((unsigned char) (0xC0 | (cp >> 6)));
+                    PutByte((unsigned char) (0x80 | (cp & 0x3F)));
+                } else if (cp < 0x10000) {
+                    PutByte((unsigned char) (0xE0 | (cp >> 12)));
+                    PutByte((unsigned char) (0x80 | ((cp >> 6) & 0x3F)));
+                    PutByte((unsigned char) (0x80 | (cp & 0x3F)));
+                } else {
+                    PutByte((unsigned char) (0xF0 | (cp >> 18)));
+                    PutByte((unsigned char) (0x80 | ((cp >> 12) & 0x3F)));
+                    PutByte((unsigned char) (0x80 | ((cp >> 6) & 0x3F)));
+                    PutByte((unsigned char) (0x80 | (cp & 0x3F)));
+                }
+            }
+
+            constexpr void ParseValue() {
+                switch (Peek()) {
+                    case '{': {
+                        ParseObject();
+                    }
+                    break;
+
+                    case '[': {
+                        ParseArray();
+                    }
+                    break;
+
+                    case '"': {
+                        ParseString(LiteralTokenKind::String);
+                    }
+                    break;
+
+                    case 't': {
+                        ParseWord("true");
+                        Emit(LiteralTokenKind::Boolean).booleanValue = true;
+                    }
+                    break;
+
+                    case 'f': {
+                        ParseWord("false");
+                        Emit(LiteralTokenKind::Boolean).booleanValue = false;
+                    }
+                    break;
+
+                    case 'n': {
+                        ParseWord("null");
+                        (void) Emit(LiteralTokenKind::Null);
+                    }
+                    break;
+
+                    default: {
+                        ParseNumber();
+                    }
+                    break;
+                }
+            }
+
+            constexpr void ParseObject() {
+                Expect('{');
+                (void) Emit(LiteralTokenKind::BeginObject);
+                SkipWhitespace();
+                if (Peek() == '}') {
+                    ++offset;
+                    (void) Emit(LiteralTokenKind::EndObject);
+                    return;
+                }
+                for (;;) {
+                    SkipWhitespace();
+                    if (Peek() != '"') {
+                        InvalidJsonLiteral("object key is not a string");
+                    }
+                    ParseString(LiteralTokenKind::Key);
+                    SkipWhitespace();
+                    Expect(':');
+                    SkipWhitespace();
+                    ParseValue();
+                    SkipWhitespace();
+                    if (Peek() == ',') {
+                        ++offset;
+                    } else {
+                        Expect('}');
+                        (void) Emit(LiteralTokenKind::EndObject);
+                        return;
+                    }
+                }
+            }
+
+            constexpr void ParseArray() {
+                Expect('[');
+                (void) Emit(LiteralTokenKind::BeginArray);
+                SkipWhitespace();
+                if (Peek() == ']') {
+                    ++offset;
+                    (void) Emit(LiteralTokenKind::EndArray);
+                    return;
+                }
+                for (;;) {
+                    SkipWhitespace();
+                    ParseValue();
+                    SkipWhitespace();
+                    if (Peek() == ',') {
+                        ++offset;
+                    } else {
+                        Expect(']');
+                        (void) Emit(LiteralTokenKind::EndArray);
+                        return;
+                    }
+                }
+            }
+
+            constexpr void ParseWord(std::string_view word) {
+                if (text.substr(offset, word.size()) != word) {
+                    InvalidJsonLiteral("unknown literal name");
+                }
+                offset += word.size();
+            }
+
+            constexpr uint32_t ParseFourHexDigits() {
+                uint32_t cp = 0;
+                for (size_t i = 0; i < 4; ++i) {
+                    const auto c = Peek();
+                    cp <<= 4;
+                    if ((c >= '0') && (c <= '9')) {
+                        cp += (uint32_t) (c - '0');
+                    } else if ((c >= 'A') && (c <= 'F')) {
+                        cp += (uint32_t) (c - 'A' + 10);
+                    } else if ((c >= 'a') && (c <= 'f')) {
+                        cp += (uint32_t) (c - 'a' + 10);
+                    } else {
+                        InvalidJsonLiteral("bad \\u escape");
+                    }
+                    ++offset;
+                }
+                return cp;
+            }
+
+            constexpr void ParseString(LiteralTokenKind kind) {
+                Expect('"');
+                const auto stringOffset = poolSize;
+                for (;;) {
+                    if (AtEnd()) {
+                        InvalidJsonLiteral("unterminated string");
+                    }
+                    const auto c = text[offset++];
+                    if (c == '"') {
+                        break;
+                    }
+                    if (c != '\\') {
+                        PutByte((unsigned char) c);
+                        continue;
+                    }
+                    const auto escape = Peek();
+                    ++offset;
+                    switch (escape) {
+                        case '"': PutByte('"');
+                            break;
+                        case '\\': PutByte('\\');
+                            break;
+                        case '/': PutByte('/');
+                            break;
+                        case 'b': PutByte('\b');
+                            break;
+                        case 'f': PutByte('\f');
+                            break;
+                        case 'n': PutByte('\n');
+                            break;
+                        case 'r': PutByte('\r');
+                            break;
+                        case 't': PutByte('\t');
+                            break;
+                        case 'u': {
+                            auto cp = ParseFourHexDigits();
+                            if ((cp >= 0xDC00) && (cp <= 0xDFFF)) {
+                                InvalidJsonLiteral("unpaired UTF-16 surrogate");
+                            }
+                            if ((cp >= 0xD800) && (cp <= 0xDBFF)) {
+                                Expect('\\');
+                                Expect('u');
+                                const auto low = ParseFourHexDigits();
+                                if ((low < 0xDC00) || (low > 0xDFFF)) {
+                                    InvalidJsonLiteral("unpaired UTF-16 surrogate");
+                                }
+                                cp = ((cp - 0xD800) << 10) + (low - 0xDC00) + 0x10000;
+                            }
+                            PutCodePoint(cp);
+                        }
+                        break;
+                        default: {
+                            InvalidJsonLiteral("bad escape sequence");
+                        }
+                        break;
+                    }
+                }
+                auto &token = Emit(kind);
+                token.stringOffset = stringOffset;
+                token.stringLength = poolSize - stringOffset;
+            }
+
+            [[nodiscard]] constexpr bool AtDigit() const {
+                return (Peek() >= '0') && (Peek() <= '9');
+            }
+
+            /**
+             * This is the number of significant digits of a number kept
+             * to decode it.  Halfway between two doubles never takes more
+             * than 767, so a digit standing for any dropped digits that
+             * aren't zero makes up for the rest.
+             */
+            static constexpr intmax_t MAX_SIGNIFICANT_DIGITS = 800;
+
+            constexpr void ParseNumber() {
+                const auto negative = (Peek() == '-');
+                if (negative) {
+                    ++offset;
+                }
+                if (!AtDigit()) {
+                    InvalidJsonLiteral("bad number");
+                }
+                intmax_t integer = 0;
+                LiteralBigInteger significand;
+                intmax_t numDigits = 0;
+                intmax_t scale = 0;
+                auto dropped = false;
+                const auto addDigit = [&](intmax_t digit, bool inFraction){
+                    if (numDigits >= MAX_SIGNIFICANT_DIGITS) {
+                        dropped = (dropped || (digit != 0));
+                        if (!inFraction) {
+                            ++scale;
+                        }
+                        return;
+                    }
+                    if (
+                        (numDigits > 0)
+                        || (digit != 0)
+                    ) {
+                        significand.MultiplyAdd(10, (uint32_t) digit);
+                        ++numDigits;
+                    }
+                    if (inFraction) {
+                        --scale;
+                    }
+                };
+                if (Peek() == '0') {
+                    ++offset;
+                    if (AtDigit()) {
+                        InvalidJsonLiteral("number has leading zeros");
+                    }
+                } else {
+                    while (AtDigit()) {
+                        const auto digit = (intmax_t) (Peek() - '0');
+                        if (
+                            negative
+                                ? (integer < (std::numeric_limits<intmax_t>::lowest() + digit) / 10)
+                                : (integer > (std::numeric_limits<intmax_t>::max() - digit) / 10)
+                        ) {
+                            InvalidJsonLiteral("number out of range");
+                        }
+                        integer = integer * 10 + (negative ? -digit : digit);
+                        addDigit(digit, false);
+                        ++offset;
+                    }
+                }
+                if (
+                    (Peek() != '.')
+                    && (Peek() != 'e')
+                    && (Peek() != 'E')
+                ) {
+                    Emit(LiteralTokenKind::Integer).integerValue = integer;
+                    return;
+                }
+                if (Peek() == '.') {
+                    ++offset;
+                    if (!AtDigit()) {
+                        InvalidJsonLiteral("bad fraction");
+                    }
+                    while (AtDigit()) {
+                        addDigit((intmax_t) (Peek() - '0'), true);
+                        ++offset;
+                    }
+                }
+                if (dropped) {
+                    significand.MultiplyAdd(10, 1);
+                    ++numDigits;
+                    --scale;
+                }
+                intmax_t exponent = 0;
+                if (
+                    (Peek() == 'e')
+                    || (Peek() == 'E')
+                ) {
+                    ++offset;
+                    auto negativeExponent = false;
+                    if (Peek() == '-') {
+                        negativeExponent = true;
+                        ++offset;
+                    } else if (Peek() == '+') {
+                        ++offset;
+                    }
+                    if (!AtDigit()) {
+                        InvalidJsonLiteral("bad exponent");
+                    }
+                    while (AtDigit()) {
+                        // Exponents this large make any number infinite or
+                        // zero, so further digits needn't be counted.
+                        if (exponent < 100000) {
+                            exponent = exponent * 10 + (intmax_t) (Peek() - '0');
+                        }
+                        ++offset;
+                    }
+                    if (negativeExponent) {
+                        exponent = -exponent;
+                    }
+                }
+                const auto magnitude = DecimalToDouble(significand, numDigits, scale + exponent);
+                Emit(LiteralTokenKind::FloatingPoint).floatingPointValue = (negative ? -magnitude : magnitude);
+            }
+
+            std::string_view text;
+            size_t offset = 0;
+            LiteralToken *tokens = nullptr;
+            size_t numTokens = 0;
+            LiteralToken scratch;
+            char *pool = nullptr;
+            size_t poolSize = 0;
+        };
+
+        /**
+         * @brief The tokens and string pool of a JSON literal, sized
+         * exactly for it.
+         */
+        template<size_t NumTokens, size_t PoolSize>
+        struct LiteralDocument {
+            LiteralToken tokens[NumTokens];
+            char pool[PoolSize + 1] = {};
+        };
+
+        /**
+         * This measures how much storage the given JSON literal needs.
+         *
+         * @param[in] text
+         *     This is the JSON literal.
+         *
+         * @return
+         *     The number of tokens and the number of string pool bytes
+         *     needed are returned.
+         */
+        consteval std::pair<size_t, size_t> MeasureLiteral(std::string_view text) {
+            LiteralParser parser(text, nullptr, nullptr);
+            parser.Parse();
+            return {parser.GetNumTokens(), parser.GetPoolSize()};
+        }
+
+        /**
+         * This parses the given JSON literal into tokens.
+         *
+         * @param[in] text
+         *     This is the JSON literal.
+         *
+         * @return
+         *     The tokens and string pool of the literal are returned.
+         */
+        template<size_t NumTokens, size_t PoolSize>
+        consteval LiteralDocument<NumTokens, PoolSize> ParseLiteral(std::string_view text) {
+            LiteralDocument<NumTokens, PoolSize> document;
+            LiteralParser parser(text, document.tokens, document.pool);
+            parser.Parse();
+            return document;
+        }
+
+        /**
+         * This constructs a JSON value from the tokens of a literal
+         * parsed at compile time.  No text is parsed.
+         *
+         * @param[in] tokens
+         *     These are the tokens of the literal.
+         *
+         * @param[in] numTokens
+         *     This is the number of tokens.
+         *
+         * @param[in] pool
+         *     This holds the decoded strings referenced by the tokens.
+         *
+         * @return
+         *     The constructed JSON value is returned.
+         */
+        Value BuildLiteral(
+            const LiteralToken *tokens,
+            size_t numTokens,
+            const char *pool
+        );
+    }
+
+    /**
+     * @brief A JSON text checked and parsed at compile time.
+     *
+     * A malformed literal fails to compile, with an error pointing at
+     * Json::Detail::InvalidJsonLiteral and the reason.  At run time
+     * the value is constructed straight from the tokens decoded at
+     * compile time, without parsing any text:
+     *
+     * @code
+     * const Json::Value &defaults = Json::Literal<R"({"retries": 3})">::Get();
+     * @endcode
+     *
+     * @tparam Text The JSON text.
+     */
+    template<FixedString Text>
+    class Literal {
+    public:
+        /**
+         * @brief Constructs a new JSON value holding the literal.
+         *
+         * @return The constructed JSON value.
+         */
+        static Value Build() {
+            return Detail::BuildLiteral(document.tokens, size.first, document.pool);
+        }
+
+        /**
+         * @brief Returns a shared, read-only JSON value holding the
+         * literal, constructed the first time it's needed.
+         *
+         * @return A reference to the shared JSON value.
+         */
+        static const Value &Get() {
+            static const Value value = Build();
+            return value;
+        }
+
+    private:
+        /** @brief The number of tokens and string pool bytes of the literal. */
+        static constexpr auto size = Detail::MeasureLiteral(Text.GetView());
+
+        /** @brief The tokens and string pool of the literal. */
+        static constexpr auto document = Detail::ParseLiteral<size.first, size.second>(Text.GetView());
+    };
+
+    namespace Literals {
+        /**
+         * This constructs a JSON value from a JSON literal checked and
+         * parsed at compile time, for example `R"({"a": [1, 2]})"_json`.
+         *
+         * @return
+         *     The constructed JSON value is returned.
+         */
+        template<FixedString Text>
+        Value operator""_json() {
+            return Literal<Text>::Build();
+        }
+    }
+}
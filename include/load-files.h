@@ -0,0 +1,56 @@
+#pragma once
+
+#include "value.h"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Options for loading many files at once with LoadFiles().
+     */
+    struct LoadOptions {
+        /**
+         * @brief The number of threads reading files, and so the number
+         * of reads in flight at once.  Loading many small files is bound
+         * by the latency of each read, so this is well above the number
+         * of cores.  Defaults to 16.
+         */
+        size_t readThreads = 16;
+
+        /**
+         * @brief The number of threads parsing files which have been read.
+         * Zero means one per hardware thread.  Defaults to 0.
+         */
+        size_t parseThreads = 0;
+
+        /**
+         * @brief The number of files which may be read but not yet parsed.
+         * Their buffers are reused, so this bounds the memory held by
+         * file contents.  Defaults to 64.
+         */
+        size_t maxPendingFiles = 64;
+    };
+
+    /**
+     * @brief Reads and parses many JSON files.
+     *
+     * Files are read by a pool of threads into a bounded set of reused
+     * buffers, and parsed by another pool as soon as each read completes,
+     * while further reads are still in flight.  Each file must hold
+     * exactly one JSON value, as for BasicValue::FromEncoding().
+     *
+     * @param paths The paths of the files to load.
+     * @param options Options controlling the threads and buffers used.
+     * @return The values parsed, in the order of the paths.  The value
+     * for a file which can't be read, or doesn't hold valid JSON, is
+     * invalid.
+     */
+    template<typename Traits = DefaultTraits>
+    std::vector<BasicValue<Traits>> LoadFiles(
+        std::span<const std::string> paths,
+        const LoadOptions &options = LoadOptions()
+    );
+}
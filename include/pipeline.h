@@ -0,0 +1,245 @@
+#pragma once
+
+#include "value.h"
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Options for running a Pipeline.
+     */
+    struct PipelineOptions {
+        /**
+         * @brief The number of records passed between stages at a time.
+         * Larger batches cost fewer hand-offs between threads.  Defaults
+         * to 256.
+         */
+        size_t batchSize = 256;
+
+        /**
+         * @brief The number of batches which may wait between one stage
+         * and the next.  Once a queue is full, the stage before it waits,
+         * so a slow stage holds back the ones before it rather than
+         * letting memory grow.  Defaults to 16.
+         */
+        size_t queueCapacity = 16;
+
+        /**
+         * @brief Whether records are output in the order in which they
+         * were read.  If not, each batch is output as soon as it's ready.
+         * Defaults to true.
+         */
+        bool preserveOrder = true;
+    };
+
+    /**
+     * @brief The outcome of running a Pipeline.
+     */
+    struct PipelineResult {
+        /**
+         * @brief Whether the pipeline was complete and its output was
+         * written without error.
+         */
+        bool succeeded = false;
+
+        /** @brief The number of non-blank lines read. */
+        size_t recordsRead = 0;
+
+        /** @brief The number of lines which weren't valid JSON. */
+        size_t recordsInvalid = 0;
+
+        /** @brief The number of records dropped by transforms. */
+        size_t recordsDropped = 0;
+
+        /** @brief The number of records output. */
+        size_t recordsWritten = 0;
+    };
+
+    /**
+     * @brief Processes newline-delimited JSON records in stages, each
+     * stage running on its own threads.
+     *
+     * Records pass between stages in batches, through bounded queues.
+     * A pipeline has one source, any stages, and one sink:
+     *
+     * @code
+     * std::ifstream input("events.ndjson");
+     * const auto result = Json::Pipeline()
+     *     .ReadLines(input)
+     *     .Parse(4)
+     *     .Transform([](Json::Value &record){ record.Remove("debug"); return true; }, 2)
+     *     .Encode(2)
+     *     .WriteFile("events.out.ndjson")
+     *     .Run();
+     * @endcode
+     *
+     * Parse() turns lines into values, and Encode() turns values back into
+     * lines, so Transform() stages come between them, and ForEach() takes
+     * values where WriteLines() and WriteFile() take lines.  The pipeline
+     * and everything given to it must outlive Run().
+     */
+    class Pipeline {
+    public:
+        /**
+         * @brief The type of function which transforms one record in
+         * place, returning false to drop it.
+         */
+        using Transformer = std::function<bool(Value &record)>;
+
+        /**
+         * @brief The type of function which receives each record at the
+         * end of a pipeline.
+         */
+        using Consumer = std::function<void(Value &&record)>;
+
+        /**
+         * @brief Constructs an empty pipeline.
+         *
+         * @param options Options controlling batches and queues.
+         */
+        explicit Pipeline(const PipelineOptions &options = PipelineOptions());
+
+        /**
+         * @brief Reads records from a stream, one per line.  Blank lines
+         * are skipped.
+         *
+         * @param input The stream from which to read.
+         */
+        Pipeline &ReadLines(std::istream &input);
+
+        /**
+         * @brief Reads records from text, one per line.  Blank lines are
+         * skipped.
+         *
+         * @param text The text from which to read.
+         */
+        Pipeline &ReadLines(std::string_view text);
+
+        /**
+         * @brief Parses each line into a value.  Lines which aren't valid
+         * JSON are dropped and counted.
+         *
+         * @param threads The number of threads parsing, or zero for one
+         *     per hardware thread.
+         */
+        Pipeline &Parse(size_t threads = 1);
+
+        /**
+         * @brief Applies a function to each value.
+         *
+         * @param transformer The function to apply, which may be called
+         *     from several threads at once.
+         * @param threads The number of threads applying it, or zero for
+         *     one per hardware thread.
+         */
+        Pipeline &Transform(
+            Transformer transformer,
+            size_t threads = 1
+        );
+
+        /**
+         * @brief Encodes each value into a line.
+         *
+         * @param threads The number of threads encoding, or zero for one
+         *     per hardware thread.
+         * @param options Encoding options; "pretty" must not be set, so
+         *     that each record stays on one line.  Parts of records which
+         *     weren't changed keep their original text unless "reencode"
+         *     is set.
+         */
+        Pipeline &Encode(
+            size_t threads = 1,
+            const EncodingOptions &options = EncodingOptions()
+        );
+
+        /**
+         * @brief Writes each line, followed by a newline, to a stream.
+         *
+         * @param output The stream to which to write.
+         */
+        Pipeline &WriteLines(std::ostream &output);
+
+        /**
+         * @brief Writes each line, followed by a newline, to a file,
+         * through a large buffer.
+         *
+         * @param path The path of the file, which is replaced.
+         */
+        Pipeline &WriteFile(const std::string &path);
+
+        /**
+         * @brief Passes each value to a function, on the thread which
+         * called Run().
+         *
+         * @param consumer The function to which to pass the values.
+         */
+        Pipeline &ForEach(Consumer consumer);
+
+        /**
+         * @brief Runs the pipeline until its source is exhausted.
+         *
+         * @return What happened.  If the pipeline has no source or sink,
+         * or its stages are out of order, nothing is run.
+         */
+        PipelineResult Run();
+
+    private:
+        /**
+         * @brief The kinds of stage between the source and the sink.
+         */
+        enum class StageKind {
+            Parse,
+            Transform,
+            Encode,
+        };
+
+        /**
+         * @brief One stage between the source and the sink.
+         */
+        struct Stage {
+            /** @brief What the stage does. */
+            StageKind kind = StageKind::Parse;
+
+            /** @brief The number of threads running the stage. */
+            size_t threads = 1;
+
+            /** @brief For Transform, the function to apply. */
+            Transformer transformer;
+
+            /** @brief For Encode, the encoding options. */
+            EncodingOptions encodingOptions;
+        };
+
+        /** @brief Options controlling batches and queues. */
+        PipelineOptions options;
+
+        /** @brief The stream from which to read, if any. */
+        std::istream *input = nullptr;
+
+        /** @brief The text from which to read, if not a stream. */
+        std::string_view text;
+
+        /** @brief Whether a source has been given. */
+        bool hasSource = false;
+
+        /** @brief The stages, in order. */
+        std::vector<Stage> stages;
+
+        /** @brief The stream to which to write lines, if any. */
+        std::ostream *output = nullptr;
+
+        /** @brief The path of the file to which to write lines, if any. */
+        std::string outputPath;
+
+        /** @brief The function to which to pass values, if any. */
+        Consumer consumer;
+
+        /** @brief The number of sinks given. */
+        size_t sinks = 0;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief A JSON Pointer (RFC 6901), identifying one value within a
+     * JSON document.
+     *
+     * A pointer is a sequence of reference tokens, each naming an object
+     * member or an array index.  Its string form is "" for the whole
+     * document, or each token prefixed by '/', with '~' escaped as "~0"
+     * and '/' escaped as "~1":
+     *
+     * @code
+     * const Json::Pointer pointer("/servers/0/host");
+     * const auto host = config.Get<std::string_view>(pointer);
+     * @endcode
+     */
+    class Pointer {
+    public:
+        /**
+         * @brief Constructs a pointer to the whole document.
+         */
+        Pointer() = default;
+
+        /**
+         * @brief Constructs a pointer from its string form.
+         *
+         * If the string isn't a valid JSON Pointer, the pointer is
+         * invalid and resolves to nothing.
+         *
+         * @param text The string form of the pointer.
+         */
+        explicit Pointer(std::string_view text);
+
+        /**
+         * @brief Constructs a pointer from its reference tokens.
+         *
+         * @param tokens The unescaped reference tokens.
+         * @return The pointer.
+         */
+        static Pointer FromTokens(std::vector<std::string> tokens);
+
+        /**
+         * @brief Checks if the pointer was constructed from a valid string.
+         *
+         * @return True if the pointer is valid, false otherwise.
+         */
+        [[nodiscard]] bool IsValid() const;
+
+        /**
+         * @brief Returns the unescaped reference tokens of the pointer.
+         *
+         * @return The reference tokens, outermost first.
+         */
+        [[nodiscard]] const std::vector<std::string> &GetTokens() const;
+
+        /**
+         * @brief Returns the string form of the pointer.
+         *
+         * @return The string form of the pointer.
+         */
+        [[nodiscard]] std::string ToString() const;
+
+        /**
+         * @brief Returns a pointer to a member or element of the value
+         * this pointer identifies.
+         *
+         * @param token The unescaped key or array index to append.
+         * @return The extended pointer.
+         */
+        [[nodiscard]] Pointer Append(std::string_view token) const;
+
+        /**
+         * @brief Returns a pointer to an element of the array this
+         * pointer identifies.
+         *
+         * @param index The array index to append.
+         * @return The extended pointer.
+         */
+        [[nodiscard]] Pointer Append(size_t index) const;
+
+        /**
+         * @brief Checks if two pointers are equal.
+         *
+         * @param other The other pointer to compare with.
+         * @return True if the pointers are equal, false otherwise.
+         */
+        bool operator==(const Pointer &other) const = default;
+
+        /**
+         * @brief Interprets a reference token as an array index.
+         *
+         * As RFC 6901 requires, the index must be decimal digits
+         * without leading zeros.  The token "-", which refers past the
+         * end of an array, isn't accepted.
+         *
+         * @param token The reference token to interpret.
+         * @param index Where to store the index.
+         * @return True if the token is an array index, false otherwise.
+         */
+        static bool ParseIndex(
+            std::string_view token,
+            size_t &index
+        );
+
+    private:
+        /** @brief The unescaped reference tokens, outermost first. */
+        std::vector<std::string> tokens;
+
+        /** @brief Whether the pointer was constructed from a valid string. */
+        bool valid = true;
+    };
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Splits JSON text into tokens as the text arrives, without
+     * building a Value.
+     *
+     * The text may be fed in chunks of any size; a token split across
+     * chunks is returned once all of it has arrived.  The caller pulls
+     * one token at a time:
+     *
+     * @code
+     * Json::Reader reader;
+     * Json::Reader::Token token;
+     * while (true) {
+     *     const auto status = reader.Next(token);
+     *     if (status == Json::Reader::Status::Token) {
+     *         // use token
+     *     } else if (status == Json::Reader::Status::NeedInput) {
+     *         // reader.Feed(more) or reader.Finish()
+     *     } else {
+     *         break;  // End or Error
+     *     }
+     * }
+     * @endcode
+     *
+     * The reader checks the structure of the text: brackets, commas,
+     * colons, keys, and the syntax of numbers and literals.  Escape
+     * sequences in strings are checked when the strings are decoded.
+     *
+     * By default the text must hold exactly one value.  A reader
+     * constructed to read multiple values instead accepts any number of
+     * values back to back, with or without whitespace between them.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief The results of asking the reader for the next token.
+         */
+        enum class Status {
+            /** @brief A token was returned. */
+            Token,
+            /** @brief More text must be fed, or Finish() called, to continue. */
+            NeedInput,
+            /** @brief The value is complete and the input finished. */
+            End,
+            /** @brief The text isn't valid JSON. */
+            Error,
+        };
+
+        /**
+         * @brief Enumerates the kinds of tokens.
+         */
+        enum class TokenType {
+            BeginObject,
+            EndObject,
+            BeginArray,
+            EndArray,
+            Key,
+            String,
+            Integer,
+            FloatingPoint,
+            True,
+            False,
+            Null,
+        };
+
+        /**
+         * @brief One token of JSON text.
+         */
+        struct Token {
+            /** @brief The kind of token. */
+            TokenType type = TokenType::Null;
+
+            /**
+             * @brief The text of the token.  For keys and strings this is
+             * the text between the quotation marks, still escaped.  It
+             * remains valid until the next call to Feed().
+             */
+            std::string_view text;
+
+            /** @brief The position of the token in the whole input. */
+            size_t offset = 0;
+
+            /** @brief For keys and strings, whether the text contains escapes. */
+            bool escaped = false;
+        };
+
+        /**
+         * @brief Constructs a reader.
+         *
+         * @param multipleValues If true, the text may hold any number of
+         *     values, one after another; otherwise it must hold exactly
+         *     one.
+         * @param trailingCommas If true, the last element of an array or
+         *     member of an object may be followed by a comma, as
+         *     Value::FromEncoding() allows.
+         */
+        explicit Reader(
+            bool multipleValues = false,
+            bool trailingCommas = false
+        );
+
+        /**
+         * @brief Appends text to the input.
+         *
+         * @param chunk The text to append.
+         */
+        void Feed(std::string_view chunk);
+
+        /**
+         * @brief Marks the end of the input.
+         */
+        void Finish();
+
+        /**
+         * @brief Reads the next token.
+         *
+         * @param token Where to store the token.
+         * @return Status::Token if a token was stored, otherwise the
+         * reason why not.
+         */
+        Status Next(Token &token);
+
+        /**
+         * @brief Skips the next value, including everything nested in it.
+         * If a key is next, the key and its value are skipped.
+         *
+         * If this returns Status::NeedInput, feed more text and call it
+         * again to continue skipping the same value.
+         *
+         * @return Status::Token once the value has been skipped, otherwise
+         * the reason why not.
+         */
+        Status Skip();
+
+        /**
+         * @brief Returns the number of arrays and objects which have been
+         * started but not ended.
+         */
+        [[nodiscard]] size_t GetDepth() const;
+
+        /**
+         * @brief Returns the position in the whole input up to which text
+         * has been read.  After Status::Error, this is the position of
+         * the text which isn't valid.
+         */
+        [[nodiscard]] size_t GetOffset() const;
+
+        /**
+         * @brief Returns the text which has been fed but not yet read.
+         */
+        [[nodiscard]] std::string_view GetUnread() const;
+
+        /**
+         * @brief Returns whether a complete top-level value has been read,
+         * and the next one, if any, hasn't been started.
+         */
+        [[nodiscard]] bool IsComplete() const;
+
+        /**
+         * @brief Prepares the reader for a new input, reading multiple
+         * values if it did before.
+         */
+        void Reset();
+
+        /**
+         * @brief Decodes the text of a key or string token.
+         *
+         * @param text The text between the quotation marks.
+         * @param output Where to append the decoded string.
+         * @return True if the escape sequences were valid, false otherwise.
+         */
+        static bool DecodeString(
+            std::string_view text,
+            std::string &output
+        );
+
+        /**
+         * @brief Decodes the text of an integer token.
+         *
+         * @param text The text of the token.
+         * @param value Where to store the integer.
+         * @return True if the integer is within range, false otherwise.
+         */
+        static bool DecodeInteger(
+            std::string_view text,
+            intmax_t &value
+        );
+
+        /**
+         * @brief Decodes the text of a floating-point token.
+         *
+         * @param text The text of the token.
+         * @param value Where to store the number.
+         * @return True if the text is a valid number, false otherwise.
+         */
+        static bool DecodeFloatingPoint(
+            std::string_view text,
+            double &value
+        );
+
+    private:
+        /**
+         * @brief What the reader expects to find next.
+         */
+        enum class Expect {
+            Value,
+            ValueOrEnd,
+            Key,
+            KeyOrEnd,
+            Colon,
+            CommaOrEnd,
+            Nothing,
+        };
+
+        /**
+         * @brief Reads the next token, without any skipping.
+         */
+        Status Scan(Token &token);
+
+        /**
+         * @brief Sets the expectation which follows a complete value.
+         */
+        void EndValue();
+
+        /**
+         * @brief Records an error at the current position.
+         */
+        Status Fail();
+
+        /** @brief The text fed but not yet discarded. */
+        std::string buffer;
+
+        /** @brief The position in the buffer up to which text has been read. */
+        size_t position = 0;
+
+        /** @brief The position in the whole input of the start of the buffer. */
+        size_t bufferOffset = 0;
+
+        /** @brief For each array or object started but not ended, whether it's an object. */
+        std::vector<bool> containers;
+
+        /** @brief What is expected next. */
+        Expect expect = Expect::Value;
+
+        /** @brief Whether the text may hold more than one value. */
+        bool multipleValues = false;
+
+        /** @brief Whether a comma may come before the end of a container. */
+        bool trailingCommas = false;
+
+        /** @brief Whether Finish() has been called. */
+        bool finished = false;
+
+        /** @brief Whether an error has been found. */
+        bool failed = false;
+
+        /** @brief While skipping, the depth at which the skipped value started. */
+        size_t skipDepth = 0;
+
+        /** @brief Whether Skip() is in progress. */
+        bool skipping = false;
+
+        /**
+         * @brief How much of a string which hasn't fully arrived has
+         * already been scanned, so it needn't be scanned again.
+         */
+        size_t scanned = 0;
+
+        /** @brief Whether the scanned part of the string contains escapes. */
+        bool scannedEscape = false;
+    };
+}
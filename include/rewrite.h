@@ -0,0 +1,208 @@
+#pragma once
+
+#include "pointer.h"
+#include "value.h"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief A set of changes for Rewrite() to make to JSON text.
+     *
+     * Each rule applies either to the value at a JSON Pointer, or to
+     * every object member with a given key, at any depth:
+     *
+     * @code
+     * Json::RewriteRules rules;
+     * rules.DropKey("password")
+     *     .ReplaceKey("email", "***")
+     *     .Rename(Json::Pointer("/user/ssn"), "taxId");
+     * @endcode
+     *
+     * Pointers refer to the keys of the input, before any renaming.  If
+     * more than one rule applies to a value, the one added first is used.
+     */
+    class RewriteRules {
+    public:
+        /**
+         * @brief The type of function which computes the replacement for
+         * a value.
+         */
+        using Transformer = std::function<Value(const Value &value)>;
+
+        /**
+         * @brief One change to make.
+         */
+        struct Rule {
+            /**
+             * @brief The kinds of change.
+             */
+            enum class Action {
+                /** @brief Remove the member or element. */
+                Drop,
+                /** @brief Replace the value with a given one. */
+                Replace,
+                /** @brief Keep the value but give the member a new key. */
+                Rename,
+                /** @brief Replace the value with the result of a function. */
+                Transform,
+            };
+
+            /** @brief The kind of change. */
+            Action action = Action::Drop;
+
+            /** @brief Whether the rule applies to a key rather than a pointer. */
+            bool byKey = false;
+
+            /** @brief The pointer to the value to which the rule applies. */
+            Pointer pointer;
+
+            /** @brief The key of the members to which the rule applies. */
+            std::string key;
+
+            /** @brief For Replace, the replacement value. */
+            Value replacement;
+
+            /** @brief For Rename, the new key. */
+            std::string newKey;
+
+            /** @brief For Transform, the function computing the replacement. */
+            Transformer transformer;
+        };
+
+        /**
+         * @brief Removes the value at the given pointer.  The root
+         * value can't be removed, so a rule for it has no effect.
+         *
+         * @param pointer The pointer to the value.
+         */
+        RewriteRules &Drop(const Pointer &pointer);
+
+        /**
+         * @brief Removes every member with the given key.
+         *
+         * @param key The key of the members.
+         */
+        RewriteRules &DropKey(std::string_view key);
+
+        /**
+         * @brief Replaces the value at the given pointer.
+         *
+         * @param pointer The pointer to the value.
+         * @param replacement The value with which to replace it.
+         */
+        RewriteRules &Replace(
+            const Pointer &pointer,
+            const Value &replacement
+        );
+
+        /**
+         * @brief Replaces the value of every member with the given key.
+         *
+         * @param key The key of the members.
+         * @param replacement The value with which to replace theirs.
+         */
+        RewriteRules &ReplaceKey(
+            std::string_view key,
+            const Value &replacement
+        );
+
+        /**
+         * @brief Gives the member at the given pointer a new key.  If the
+         * pointer refers to an array element, the rule has no effect.
+         *
+         * @param pointer The pointer to the member.
+         * @param newKey The new key.
+         */
+        RewriteRules &Rename(
+            const Pointer &pointer,
+            std::string_view newKey
+        );
+
+        /**
+         * @brief Gives every member with the given key a new key.
+         *
+         * @param key The key of the members.
+         * @param newKey The new key.
+         */
+        RewriteRules &RenameKey(
+            std::string_view key,
+            std::string_view newKey
+        );
+
+        /**
+         * @brief Replaces the value at the given pointer with the result
+         * of the given function.  Only this value is parsed into a Value.
+         *
+         * @param pointer The pointer to the value.
+         * @param transformer The function computing the replacement.
+         */
+        RewriteRules &Transform(
+            const Pointer &pointer,
+            Transformer transformer
+        );
+
+        /**
+         * @brief Replaces the value of every member with the given key
+         * with the result of the given function.
+         *
+         * @param key The key of the members.
+         * @param transformer The function computing the replacement.
+         */
+        RewriteRules &TransformKey(
+            std::string_view key,
+            Transformer transformer
+        );
+
+        /**
+         * @brief Returns the rules, in the order in which they were added.
+         */
+        [[nodiscard]] const std::vector<Rule> &GetRules() const;
+
+    private:
+        /** @brief The rules, in the order in which they were added. */
+        std::vector<Rule> rules;
+    };
+
+    /**
+     * @brief Copies JSON text, making the changes given by the rules.
+     *
+     * The text is copied one token at a time, as by Minify(), in a single
+     * pass; only values given to a Transform rule are parsed.
+     *
+     * @param input The JSON text to copy.
+     * @param output Where to append the rewritten text.
+     * @param rules The changes to make.
+     * @param options Encoding options, as for Reformat().
+     * @return True if the input is valid JSON, false otherwise, in which
+     * case the output holds the text copied before the error.
+     */
+    bool Rewrite(
+        std::string_view input,
+        std::string &output,
+        const RewriteRules &rules,
+        const EncodingOptions &options = EncodingOptions()
+    );
+
+    /**
+     * @brief Copies JSON text from one stream to another, making the
+     * changes given by the rules, as for the other overload.  Memory use
+     * doesn't depend on the length of the text.
+     *
+     * @param input The stream from which to read the JSON text.
+     * @param output The stream to which to write the rewritten text.
+     * @param rules The changes to make.
+     * @param options Encoding options, as for Reformat().
+     * @return True if the input is valid JSON, false otherwise.
+     */
+    bool Rewrite(
+        std::istream &input,
+        std::ostream &output,
+        const RewriteRules &rules,
+        const EncodingOptions &options = EncodingOptions()
+    );
+}
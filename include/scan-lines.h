@@ -0,0 +1,154 @@
+#pragma once
+
+#include "pointer.h"
+#include "value.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief A compiled set of conditions on the values in a JSON record,
+     * used by ScanLines() to select records without parsing them.
+     *
+     * A record matches if every condition holds.  Conditions may be
+     * parsed from text, joined by "&&":
+     *
+     * @code
+     * const auto filter = Json::Filter::Parse(R"(/level == "error" && /latency_ms > 500)");
+     * @endcode
+     *
+     * Each condition compares the value at a JSON Pointer with a string,
+     * number, boolean or null.  Numbers compare by value, whether integer
+     * or floating-point, and strings compare by their UTF-8 bytes.  A
+     * condition on a value which isn't present never holds; a condition
+     * comparing values of different types holds only for "!=".
+     */
+    class Filter {
+    public:
+        /**
+         * @brief The ways in which a condition compares two values.
+         */
+        enum class Operator {
+            Equal,
+            NotEqual,
+            Less,
+            LessOrEqual,
+            Greater,
+            GreaterOrEqual,
+        };
+
+        /**
+         * @brief One condition of a filter.
+         */
+        struct Condition {
+            /** @brief The pointer to the value compared. */
+            Pointer pointer;
+
+            /** @brief How the values are compared. */
+            Operator op = Operator::Equal;
+
+            /** @brief The value with which to compare. */
+            Value operand;
+        };
+
+        /**
+         * @brief Compiles a filter from its text form.
+         *
+         * @param expression Conditions of the form "pointer op value",
+         *     where op is one of ==, !=, <, <=, > or >=, and value is a
+         *     JSON string, number, boolean or null, joined by "&&".
+         * @return The filter, which is invalid if the text isn't.
+         */
+        static Filter Parse(std::string_view expression);
+
+        /**
+         * @brief Adds a condition to the filter.
+         *
+         * @param pointer The pointer to the value to compare.
+         * @param op How the values are compared.
+         * @param operand The value with which to compare, which must be
+         *     a string, number, boolean or null.
+         */
+        Filter &Where(
+            const Pointer &pointer,
+            Operator op,
+            const Value &operand
+        );
+
+        /**
+         * @brief Checks if the filter was compiled from valid conditions.
+         */
+        [[nodiscard]] bool IsValid() const;
+
+        /**
+         * @brief Returns the conditions of the filter.
+         */
+        [[nodiscard]] const std::vector<Condition> &GetConditions() const;
+
+        /**
+         * @brief Checks if the given JSON record matches the filter,
+         * reading only as much of it as is needed to decide.
+         *
+         * @param record The JSON text of the record.
+         * @return True if the record matches and is valid JSON, false
+         * otherwise.
+         */
+        [[nodiscard]] bool Matches(std::string_view record) const;
+
+    private:
+        /** @brief The conditions, all of which must hold. */
+        std::vector<Condition> conditions;
+
+        /** @brief Whether every condition is valid. */
+        bool valid = true;
+    };
+
+    /**
+     * @brief Options for scanning records with ScanLines().
+     */
+    struct ScanOptions {
+        /**
+         * @brief The number of threads scanning the text.  Zero means one
+         * per hardware thread.  Defaults to 0.
+         */
+        size_t threads = 0;
+
+        /**
+         * @brief The amount of text each thread takes at a time.  Chunks
+         * are extended to the end of a line.  Defaults to 1 MiB.
+         */
+        size_t chunkSize = 1048576;
+    };
+
+    /**
+     * @brief Finds the records which match a filter in newline-delimited
+     * JSON text, parsing only those records.
+     *
+     * Each line is first checked for text which a match must contain,
+     * then, if that is found, read one token at a time, skipping
+     * everything the conditions don't refer to, until the filter either
+     * holds or fails.  Threads take line-aligned chunks of the text, but
+     * the callback is called on the calling thread, in the order of the
+     * lines.  Blank lines, and lines which aren't valid JSON, never match.
+     *
+     * @param buffer The text to scan.
+     * @param filter The conditions records must meet.
+     * @param callback The function to call with the number of each
+     *     matching line, counting from 1, and its parsed record.
+     * @param options Options controlling the threads used.
+     * @return The number of records which matched, or zero if the filter
+     * is invalid.
+     */
+    template<typename Traits = DefaultTraits>
+    size_t ScanLines(
+        std::string_view buffer,
+        const Filter &filter,
+        const std::type_identity_t<std::function<void(size_t lineNumber, BasicValue<Traits> &&record)>> &callback,
+        const ScanOptions &options = ScanOptions()
+    );
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Estimates the number of distinct strings added to it, with a
+     * HyperLogLog of 4096 registers, whose error is about 1.6%.
+     *
+     * Sketches of different strings merge into the sketch of all of them,
+     * so they may be filled on separate threads and combined.  No memory
+     * is used until the first string is added.
+     */
+    class CardinalitySketch {
+    public:
+        /**
+         * @brief Adds a string to the sketch.
+         *
+         * @param value The string to add.
+         */
+        void Add(std::string_view value);
+
+        /**
+         * @brief Adds the strings added to another sketch to this one.
+         *
+         * @param other The other sketch.
+         */
+        void Merge(const CardinalitySketch &other);
+
+        /**
+         * @brief Returns the estimated number of distinct strings added.
+         */
+        [[nodiscard]] uint64_t Estimate() const;
+
+    private:
+        /**
+         * @brief For each register, the most leading zeros, plus one, seen
+         * in the hashes which select it.
+         */
+        std::vector<uint8_t> registers;
+    };
+
+    /**
+     * @brief A summary of the values found at one place in many
+     * documents, such as the top level, or a member of the objects there.
+     *
+     * Summaries merge into the summary of all the values of both, so
+     * they may be built on separate threads and combined.  An empty
+     * summary leaves what it's merged into unchanged.
+     */
+    struct ShapeSketch {
+        /** @brief The number of values. */
+        uint64_t count = 0;
+
+        /** @brief The number of nulls. */
+        uint64_t nulls = 0;
+
+        /** @brief The number of booleans. */
+        uint64_t booleans = 0;
+
+        /** @brief The number of integers. */
+        uint64_t integers = 0;
+
+        /**
+         * @brief The number of floating-point numbers, including integers
+         * too large for intmax_t.
+         */
+        uint64_t floatingPoints = 0;
+
+        /** @brief The number of strings. */
+        uint64_t strings = 0;
+
+        /** @brief The number of arrays. */
+        uint64_t arrays = 0;
+
+        /** @brief The number of objects. */
+        uint64_t objects = 0;
+
+        /** @brief The least integer. */
+        intmax_t minimumInteger = std::numeric_limits<intmax_t>::max();
+
+        /** @brief The greatest integer. */
+        intmax_t maximumInteger = std::numeric_limits<intmax_t>::min();
+
+        /** @brief The least number, whether integer or floating-point. */
+        double minimumNumber = std::numeric_limits<double>::infinity();
+
+        /** @brief The greatest number, whether integer or floating-point. */
+        double maximumNumber = -std::numeric_limits<double>::infinity();
+
+        /** @brief The length of the shortest string, in bytes of UTF-8. */
+        size_t minimumStringLength = std::numeric_limits<size_t>::max();
+
+        /** @brief The length of the longest string, in bytes of UTF-8. */
+        size_t maximumStringLength = 0;
+
+        /** @brief The number of distinct strings. */
+        CardinalitySketch distinctStrings;
+
+        /** @brief The number of elements of the shortest array. */
+        size_t minimumArrayLength = std::numeric_limits<size_t>::max();
+
+        /** @brief The number of elements of the longest array. */
+        size_t maximumArrayLength = 0;
+
+        /**
+         * @brief The number of arrays whose elements are all of one type,
+         * including empty arrays.  Integers and floating-point numbers
+         * count as different types.
+         */
+        uint64_t homogeneousArrays = 0;
+
+        /** @brief The summary of the elements of all the arrays. */
+        std::unique_ptr<ShapeSketch> elements;
+
+        /**
+         * @brief The summaries of the members of all the objects, by key.
+         * A member is in every object if its count is the number of
+         * objects.
+         */
+        std::map<std::string, ShapeSketch, std::less<>> members;
+
+        /**
+         * @brief The summary of the members whose keys were found after
+         * the limit on the number of keys was reached, as in objects used
+         * as maps with keys of their own.
+         */
+        std::unique_ptr<ShapeSketch> otherMembers;
+
+        /** @brief The number of distinct keys of those other members. */
+        CardinalitySketch otherKeys;
+
+        /**
+         * @brief Adds the values summarized by another summary to this
+         * one.
+         *
+         * @param other The other summary.
+         * @param maxMembers The most keys to keep in members, after which
+         *     members with other keys are added to otherMembers instead.
+         */
+        void Merge(
+            const ShapeSketch &other,
+            size_t maxMembers
+        );
+
+        /**
+         * @brief Returns the summary as a JSON value.
+         *
+         * The value is an object with "count" and, for each type found, a
+         * count in "types".  Depending on the types found, it also has
+         * "integers" and "numbers" (each with "minimum" and "maximum"),
+         * "strings" ("distinct", "minimumLength", "maximumLength"),
+         * "arrays" ("minimumLength", "maximumLength", "homogeneous",
+         * "items") and "objects" ("properties", "required", and, if any,
+         * "otherProperties" and "otherKeys").
+         */
+        [[nodiscard]] Value ToValue() const;
+    };
+
+    /**
+     * @brief Options for inferring a schema with InferSchema().
+     */
+    struct InferenceOptions {
+        /**
+         * @brief The number of threads reading documents.  Zero means one
+         * per hardware thread.  Defaults to 0.
+         */
+        size_t threads = 0;
+
+        /**
+         * @brief The amount of text each thread takes at a time.  With
+         * more than one thread, chunks are extended to the end of a line.
+         * Defaults to 1 MiB.
+         */
+        size_t chunkSize = 1048576;
+
+        /**
+         * @brief The most keys for which the members of objects in the
+         * same place are summarized separately.  Defaults to 1000.
+         */
+        size_t maxMembers = 1000;
+    };
+
+    /**
+     * @brief The result of inferring a schema from many documents.
+     */
+    struct SchemaSketch {
+        /** @brief The summary of the documents. */
+        ShapeSketch root;
+
+        /**
+         * @brief The number of records which weren't valid JSON, and were
+         * skipped up to the end of their line.
+         */
+        uint64_t invalidRecords = 0;
+
+        /**
+         * @brief The most keys for which members are summarized
+         * separately.
+         */
+        size_t maxMembers = InferenceOptions().maxMembers;
+
+        /**
+         * @brief Adds the documents summarized by another sketch to this
+         * one.
+         *
+         * @param other The other sketch.
+         */
+        void Merge(const SchemaSketch &other);
+
+        /**
+         * @brief Returns the sketch as a JSON value: the summary of the
+         * documents, as returned by ShapeSketch::ToValue(), with
+         * "invalidRecords" added.
+         */
+        [[nodiscard]] Value ToValue() const;
+    };
+
+    /**
+     * @brief Summarizes the shapes of the documents in the given text,
+     * such as newline-delimited JSON, on many threads, without building
+     * any values.
+     *
+     * The documents may be separated by whitespace or not separated at
+     * all, as for DocumentStream.  One thread reads the text in order, so
+     * documents may span lines, as pretty-printed ones do.  More threads
+     * take line-aligned chunks of the text, so no document may span
+     * lines; one which does is counted as invalid.  Each thread
+     * summarizes its documents separately, and the summaries are merged.
+     *
+     * @param text The text holding the documents.
+     * @param options Options controlling the threads used, and the
+     *     summaries made.
+     * @return The summary of the documents.
+     */
+    SchemaSketch InferSchema(
+        std::string_view text,
+        const InferenceOptions &options = InferenceOptions()
+    );
+
+    /**
+     * @brief Summarizes the shapes of the documents in the given text,
+     * such as newline-delimited JSON, on the given number of threads.
+     *
+     * @param text The text holding the documents.
+     * @param threads The number of threads, or zero for one per hardware
+     *     thread.
+     * @return The summary of the documents.
+     */
+    SchemaSketch InferSchema(
+        std::string_view text,
+        size_t threads
+    );
+
+    /**
+     * @brief Summarizes the shapes of the documents read from the given
+     * stream, as InferSchema() does for text.  The stream is read on the
+     * calling thread, a chunk at a time, so memory use doesn't grow with
+     * the length of the stream, but with that of the longest document.
+     * As for text, documents may span lines only when one thread is
+     * used.
+     *
+     * @param stream The stream holding the documents.
+     * @param options Options controlling the threads used, and the
+     *     summaries made.
+     * @return The summary of the documents.
+     */
+    SchemaSketch InferSchema(
+        std::istream &stream,
+        const InferenceOptions &options = InferenceOptions()
+    );
+
+    /**
+     * @brief Summarizes the shapes of the documents read from the given
+     * stream on the given number of threads.
+     *
+     * @param stream The stream holding the documents.
+     * @param threads The number of threads, or zero for one per hardware
+     *     thread.
+     * @return The summary of the documents.
+     */
+    SchemaSketch InferSchema(
+        std::istream &stream,
+        size_t threads
+    );
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "value.h"
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace Json {
+    /**
+     * @brief Copies JSON text, removing all whitespace between tokens.
+     *
+     * The text is copied one token at a time, without building a value,
+     * and checked as it's copied.  Strings and numbers are copied as
+     * written, including any escape sequences.
+     *
+     * @param input The JSON text to copy.
+     * @param output Where to append the minified text.
+     * @return True if the input is valid JSON, false otherwise, in which
+     * case the output holds the text copied before the error.
+     */
+    bool Minify(
+        std::string_view input,
+        std::string &output
+    );
+
+    /**
+     * @brief Copies JSON text from one stream to another, removing all
+     * whitespace between tokens.  Memory use doesn't depend on the
+     * length of the text.
+     *
+     * @param input The stream from which to read the JSON text.
+     * @param output The stream to which to write the minified text.
+     * @return True if the input is valid JSON, false otherwise.
+     */
+    bool Minify(
+        std::istream &input,
+        std::ostream &output
+    );
+
+    /**
+     * @brief Copies JSON text, laying it out according to the given
+     * encoding options.
+     *
+     * The text is copied one token at a time, as for Minify().  When
+     * pretty printing, every non-empty array and object is broken over
+     * lines, as by Writer.  If "escapeNonAscii" is set, strings holding
+     * characters outside ASCII are re-encoded; other strings are copied
+     * as written.
+     *
+     * @param input The JSON text to copy.
+     * @param output Where to append the reformatted text.
+     * @param options Encoding options; "pretty",
+     *     "spacesPerIndentationLevel", "numIndentationLevels" and
+     *     "escapeNonAscii" are used.
+     * @return True if the input is valid JSON, false otherwise, in which
+     * case the output holds the text copied before the error.
+     */
+    bool Reformat(
+        std::string_view input,
+        std::string &output,
+        const EncodingOptions &options
+    );
+
+    /**
+     * @brief Copies JSON text from one stream to another, laying it out
+     * according to the given encoding options, as for the other
+     * overload.  Memory use doesn't depend on the length of the text.
+     *
+     * @param input The stream from which to read the JSON text.
+     * @param output The stream to which to write the reformatted text.
+     * @param options Encoding options, as for the other overload.
+     * @return True if the input is valid JSON, false otherwise.
+     */
+    bool Reformat(
+        std::istream &input,
+        std::ostream &output,
+        const EncodingOptions &options
+    );
+}
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <concepts>
+#include <functional>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "flat-map.h"
+#include "pointer.h"
+
 namespace Json {
     /**
      * @brief Configuration options for encoding JSON values into strings.
@@ -71,6 +81,262 @@ namespace Json {
         size_t numIndentationLevels = 0;
     };
 
+    /**
+     * @brief Options for writing the encoding of a JSON value to a file
+     * with BasicValue::ToFile().
+     */
+    struct WriteOptions {
+        /**
+         * @brief If true, the file's contents are flushed to the storage
+         * device before the file replaces any existing one, and the
+         * replacement itself is flushed too, so that a crash leaves either
+         * the old file or the new one.  Defaults to false.
+         */
+        bool sync = false;
+
+        /**
+         * @brief If true, space for the file is reserved up front, using
+         * an estimate of the size of the encoding, to reduce fragmentation
+         * of large files.  Defaults to false.
+         */
+        bool preallocate = false;
+
+        /**
+         * @brief The amount of the encoding collected before it's written
+         * to the file.  Defaults to 1 MiB.
+         */
+        size_t bufferSize = 1048576;
+    };
+
+    /**
+     * @brief Describes one edit of JSON text, for BasicValue::Reparse().
+     *
+     * The edit replaced the oldLength characters at offset in the old
+     * text with the newLength characters at the same offset in the new
+     * text.
+     */
+    struct EditRange {
+        /** @brief The position of the first character changed. */
+        size_t offset = 0;
+
+        /** @brief The number of characters replaced in the old text. */
+        size_t oldLength = 0;
+
+        /** @brief The number of characters which replaced them. */
+        size_t newLength = 0;
+
+        /**
+         * @brief Combines this edit with one made after it.
+         *
+         * @param next The later edit, with positions in the text this
+         *     edit produced.
+         * @return One edit, with positions in the text before this edit,
+         *     which covers both.
+         */
+        [[nodiscard]] EditRange Then(const EditRange &next) const;
+    };
+
+    /**
+     * @brief Options for BasicValue::FreezeColdSubtrees().
+     */
+    struct FreezeOptions {
+        /**
+         * @brief The number of sweeps since an array or object was last
+         * accessed after which it's cold.  Defaults to 1, meaning that
+         * what wasn't accessed since the last sweep is cold.
+         */
+        unsigned int idleSweeps = 1;
+
+        /**
+         * @brief The number of values, counting the array or object
+         * itself and everything in it, below which a cold array or object
+         * isn't frozen, since its blob would save little.  Defaults to
+         * 64.
+         */
+        size_t minimumValues = 64;
+    };
+
+    /**
+     * @brief Names an access profile, which learns which parts of the
+     * documents parsed with it are used, so that later documents parsed
+     * with it decode only those parts up front.
+     *
+     * Profiles are shared by the whole process, and safe to use from
+     * several threads at once.  Give each consumer with its own access
+     * pattern a profile of its own.
+     */
+    struct ProfileId {
+        /** @brief The name of the profile. */
+        std::string name;
+    };
+
+    /**
+     * @brief Returns what an access profile has learned.
+     *
+     * @param profile The profile.
+     * @return The JSON Pointers of the arrays and objects, other than
+     * the top-level value, which were accessed in documents parsed with
+     * the profile, in sorted order.  The token "*" stands for any element
+     * of an array.
+     */
+    std::vector<std::string> GetProfiledPaths(const ProfileId &profile);
+
+    /**
+     * @brief Forgets what an access profile has learned.
+     *
+     * @param profile The profile.
+     */
+    void ResetProfile(const ProfileId &profile);
+
+    /**
+     * @brief Enumerates the different types of JSON values.
+     */
+    enum class ValueType {
+        /** @brief An invalid JSON value. */
+        Invalid,
+        /** @brief A null JSON value. */
+        Null,
+        /** @brief A boolean JSON value (true or false). */
+        Boolean,
+        /** @brief A string JSON value. */
+        String,
+        /** @brief An integer JSON value. */
+        Integer,
+        /** @brief A floating-point JSON value. */
+        FloatingPoint,
+        /** @brief An array JSON value. */
+        Array,
+        /** @brief An object JSON value. */
+        Object,
+    };
+
+    /**
+     * @brief Passed to the visitor given to BasicValue::Visit() when
+     * the visited value is invalid.
+     */
+    struct InvalidValue {
+    };
+
+    /**
+     * @brief The default configuration of JSON values.
+     *
+     * A traits class selects, at compile time, how a BasicValue stores its
+     * data.  To configure values differently, derive from this class and
+     * override the members which should change:
+     *
+     * - IntegerType: the integral type in which integers are stored.
+     * - FloatingPointType: the floating-point type in which numbers with a
+     *   fraction or exponent are stored.
+     * - ArrayType: the container of array elements, given the value type.
+     * - ObjectType: the container of object members, given the value
+     *   type.  It must offer the subset of the std::map interface which
+     *   FlatMap implements; iteration order is the encoding order.  If
+     *   its find() accepts std::string_view, lookups by std::string_view
+     *   don't copy the key.
+     * - cacheEncoding: whether each value keeps the last encoding made
+     *   of it, or parsed into it, so that it can be returned again
+     *   without re-encoding.
+     * - keepSourceSpans: whether each value parsed from text keeps
+     *   where in the text it was, so that BasicValue::Reparse() can
+     *   parse again only the part of the text which was edited.
+     * - freezeColdSubtrees: whether each value notes when it was last
+     *   accessed, so that BasicValue::FreezeColdSubtrees() can encode
+     *   arrays and objects which aren't being used into compact blobs.
+     *
+     * Containers take the allocator of the deployment through ArrayType
+     * and ObjectType.
+     */
+    struct DefaultTraits {
+        using IntegerType = intmax_t;
+        using FloatingPointType = double;
+
+        template<typename V>
+        using ArrayType = std::vector<V>;
+
+        template<typename V>
+        using ObjectType = std::map<std::string, V, std::less<>>;
+
+        static constexpr bool cacheEncoding = true;
+
+        static constexpr bool keepSourceSpans = false;
+
+        static constexpr bool freezeColdSubtrees = false;
+    };
+
+    /**
+     * @brief A configuration for memory-constrained targets: objects are
+     * kept in sorted vectors rather than trees, and no encodings are
+     * cached in the values.
+     */
+    struct CompactTraits : DefaultTraits {
+        template<typename V>
+        using ObjectType = FlatMap<V>;
+
+        static constexpr bool cacheEncoding = false;
+    };
+
+    /**
+     * @brief A hash function for strings which also accepts string views,
+     * so that hash tables keyed by strings can be searched without
+     * copying the key.
+     */
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view key) const {
+            return std::hash<std::string_view>()(key);
+        }
+    };
+
+    /**
+     * @brief A configuration for lookup-heavy workloads: objects are kept
+     * in hash tables, so member lookups take constant time but members
+     * are encoded in no particular order.
+     */
+    struct HashedTraits : DefaultTraits {
+        template<typename V>
+        using ObjectType = std::unordered_map<std::string, V, StringHash, std::equal_to<>>;
+    };
+
+    /**
+     * @brief A configuration for documents which are edited as text and
+     * parsed again after each edit: values keep where they were in the
+     * text, instead of caching encodings, so that BasicValue::Reparse()
+     * reuses everything the edit didn't touch.
+     */
+    struct EditableTraits : DefaultTraits {
+        static constexpr bool cacheEncoding = false;
+
+        static constexpr bool keepSourceSpans = true;
+    };
+
+    /**
+     * @brief A configuration for very large documents of which little is
+     * used at a time: arrays and objects which haven't been accessed for a
+     * while are frozen into compact blobs by
+     * BasicValue::FreezeColdSubtrees(), and thawed when next accessed.
+     * Values parsed with an access profile likewise keep the arrays and
+     * objects which the profile doesn't expect to be used as text until
+     * they're accessed.
+     *
+     * Blobs are passed through Compress() when frozen and Decompress()
+     * when thawed, which here leave them as they are.  Derive from this
+     * class and override both to compress blobs, for instance with LZ4 or
+     * zstd.
+     */
+    struct TieredTraits : DefaultTraits {
+        static constexpr bool cacheEncoding = false;
+
+        static constexpr bool freezeColdSubtrees = true;
+
+        static std::string Compress(std::string &&blob) {
+            return std::move(blob);
+        }
+
+        static std::string Decompress(std::string &&blob) {
+            return std::move(blob);
+        }
+    };
 
     /**
      * @brief Represents a JSON value, supporting various data types.
@@ -79,30 +345,33 @@ namespace Json {
      * including null, boolean, string, integer, floating-point, array, and
      * object types. It provides methods for accessing, modifying, and
      * serializing JSON data.
+     *
+     * The representation is selected at compile time by the traits; see
+     * DefaultTraits.  The member functions are defined in the library,
+     * which instantiates this template for DefaultTraits, CompactTraits,
+     * HashedTraits, EditableTraits and TieredTraits, and for the traits
+     * named by the
+     * JSONKIT_CUSTOM_TRAITS build setting, if any.
+     *
+     * @tparam Traits The configuration of the value's representation.
      */
-    class Value {
+    template<typename Traits>
+    class BasicValue {
     public:
-        /**
-         * @brief Enumerates the different types of JSON values.
-         */
-        enum class Type {
-            /** @brief An invalid JSON value. */
-            Invalid,
-            /** @brief A null JSON value. */
-            Null,
-            /** @brief A boolean JSON value (true or false). */
-            Boolean,
-            /** @brief A string JSON value. */
-            String,
-            /** @brief An integer JSON value. */
-            Integer,
-            /** @brief A floating-point JSON value. */
-            FloatingPoint,
-            /** @brief An array JSON value. */
-            Array,
-            /** @brief An object JSON value. */
-            Object,
-        };
+        /** @brief The types of JSON values. */
+        using Type = ValueType;
+
+        /** @brief The type in which integers are stored. */
+        using IntegerType = typename Traits::IntegerType;
+
+        /** @brief The type in which floating-point numbers are stored. */
+        using FloatingPointType = typename Traits::FloatingPointType;
+
+        /** @brief The container of array elements. */
+        using ArrayType = typename Traits::template ArrayType<BasicValue>;
+
+        /** @brief The container of object members. */
+        using ObjectType = typename Traits::template ObjectType<BasicValue>;
 
         /**
          * @brief Iterator for traversing JSON arrays and objects.
@@ -120,8 +389,8 @@ namespace Json {
              * @param nextArrayEntry Iterator pointing to the initial position.
              */
             Iterator(
-                const Value *container,
-                std::vector<Value>::const_iterator &&nextArrayEntry
+                const BasicValue *container,
+                typename ArrayType::const_iterator &&nextArrayEntry
             );
 
             /**
@@ -131,8 +400,8 @@ namespace Json {
              * @param nextObjectEntry Iterator pointing to the initial position.
              */
             Iterator(
-                const Json::Value *container,
-                std::map<std::string, Value>::const_iterator &&nextObjectEntry
+                const BasicValue *container,
+                typename ObjectType::const_iterator &&nextObjectEntry
             );
 
             /**
@@ -167,94 +436,186 @@ namespace Json {
              *
              * @return The value of the current element.
              */
-            [[nodiscard]] const Value &value() const;
+            [[nodiscard]] const BasicValue &value() const;
 
         private:
             /** @brief Pointer to the JSON array or object being iterated. */
-            const Value *container = nullptr;
+            const BasicValue *container = nullptr;
             /** @brief Iterator for the current position in a JSON array. */
-            std::vector<Value>::const_iterator nextArrayEntry;
+            typename ArrayType::const_iterator nextArrayEntry;
             /** @brief Iterator for the current position in a JSON object. */
-            std::map<std::string, Value>::const_iterator nextObjectEntry;
+            typename ObjectType::const_iterator nextObjectEntry;
+        };
+
+        /**
+         * @brief A read-only view of the elements of a JSON array, passed
+         * to the visitor given to Visit().
+         */
+        class ArrayView {
+        public:
+            explicit ArrayView(const ArrayType &elements)
+                : elements(&elements) {
+            }
+
+            [[nodiscard]] typename ArrayType::const_iterator begin() const {
+                return elements->begin();
+            }
+
+            [[nodiscard]] typename ArrayType::const_iterator end() const {
+                return elements->end();
+            }
+
+            [[nodiscard]] size_t size() const {
+                return elements->size();
+            }
+
+            [[nodiscard]] bool empty() const {
+                return elements->empty();
+            }
+
+            const BasicValue &operator[](size_t index) const {
+                return (*elements)[index];
+            }
+
+        private:
+            /** @brief The elements of the array. */
+            const ArrayType *elements;
+        };
+
+        /**
+         * @brief A read-only view of the members of a JSON object, passed
+         * to the visitor given to Visit().  Iterating it yields key-value
+         * pairs.
+         */
+        class ObjectView {
+        public:
+            explicit ObjectView(const ObjectType &members)
+                : members(&members) {
+            }
+
+            [[nodiscard]] typename ObjectType::const_iterator begin() const {
+                return members->begin();
+            }
+
+            [[nodiscard]] typename ObjectType::const_iterator end() const {
+                return members->end();
+            }
+
+            [[nodiscard]] size_t size() const {
+                return members->size();
+            }
+
+            [[nodiscard]] bool empty() const {
+                return members->empty();
+            }
+
+        private:
+            /** @brief The members of the object. */
+            const ObjectType *members;
+        };
+
+        /**
+         * @brief Describes one value reached by Walk().
+         */
+        struct WalkEntry {
+            /** @brief The value reached. */
+            const BasicValue &value;
+
+            /** @brief The array or object holding the value, or nullptr for the root. */
+            const BasicValue *parent;
+
+            /** @brief The key of the value, if its parent is an object. */
+            std::string_view key;
+
+            /** @brief The position of the value within its parent. */
+            size_t index;
+
+            /** @brief The number of containers enclosing the value. */
+            size_t depth;
         };
 
         /** @brief Destructor. */
-        ~Value() noexcept;
+        ~BasicValue() noexcept;
 
         /** @brief Copy constructor. */
-        Value(const Value &);
+        BasicValue(const BasicValue &);
 
         /** @brief Move constructor. */
-        Value(Value &&) noexcept;
+        BasicValue(BasicValue &&) noexcept;
 
         /** @brief Copy assignment operator. */
-        Value &operator=(const Value &);
+        BasicValue &operator=(const BasicValue &);
 
-        /** @brief Move assignment operator. */
-        Value &operator=(Value &&) noexcept;
+        /**
+         * @brief Move assignment operator.
+         *
+         * This isn't noexcept, since replacing a value tracked for
+         * changes records the replacement, which allocates.
+         */
+        BasicValue &operator=(BasicValue &&);
 
         /**
        * @brief Constructs a JSON value of the specified type.
        *
        * @param type The type of JSON value to create.
        */
-        Value(Type type = Type::Invalid);
+        BasicValue(Type type = Type::Invalid);
 
         /**
          * @brief Constructs a JSON null value.
          *
          * @param null The null value.
          */
-        Value(std::nullptr_t);
+        BasicValue(std::nullptr_t);
 
         /**
          * @brief Constructs a JSON boolean value.
          *
          * @param value The boolean value.
          */
-        Value(bool value);
+        BasicValue(bool value);
 
         /**
          * @brief Constructs a JSON integer value.
          *
          * @param value The integer value.
          */
-        Value(int value);
+        BasicValue(int value);
 
         /**
          * @brief Constructs a JSON maximum-sized integer value.
          *
          * @param value The maximum-sized integer value.
          */
-        Value(intmax_t value);
+        BasicValue(intmax_t value);
 
         /**
          * @brief Constructs a JSON size value.
          *
          * @param value The size value.
          */
-        Value(size_t value);
+        BasicValue(size_t value);
 
         /**
          * @brief Constructs a JSON floating-point value.
          *
          * @param value The floating-point value.
          */
-        Value(double value);
+        BasicValue(double value);
 
         /**
          * @brief Constructs a JSON string value from a C-style string.
          *
          * @param value The C-style string value.
          */
-        Value(const char *value);
+        BasicValue(const char *value);
 
         /**
          * @brief Constructs a JSON string value from a C++ string.
          *
          * @param value The C++ string value.
          */
-        Value(const std::string &value);
+        BasicValue(const std::string &value);
 
         /**
          * @brief Checks if two JSON values are equal.
@@ -262,7 +623,7 @@ namespace Json {
          * @param other The other JSON value to compare with.
          * @return True if the values are equal, false otherwise.
          */
-        bool operator==(const Value &other) const;
+        bool operator==(const BasicValue &other) const;
 
         /**
          * @brief Checks if two JSON values are not equal.
@@ -270,7 +631,7 @@ namespace Json {
          * @param other The other JSON value to compare with.
          * @return True if the values are not equal, false otherwise.
          */
-        bool operator!=(const Value &other) const;
+        bool operator!=(const BasicValue &other) const;
 
         /**
          * @brief Checks if a JSON value is less than another JSON value.
@@ -278,7 +639,7 @@ namespace Json {
          * @param other The other JSON value to compare with.
          * @return True if the value is less than the other value, false otherwise.
          */
-        bool operator<(const Value &other) const;
+        bool operator<(const BasicValue &other) const;
 
         /**
         * @brief Typecast operator to boolean
@@ -359,7 +720,7 @@ namespace Json {
          * special null value if the index is out of range or the value is
          * not an array.
          */
-        const Value &operator[](size_t index) const;
+        const BasicValue &operator[](size_t index) const;
 
         /**
          * @brief Returns a const reference to the element at the given index
@@ -370,7 +731,7 @@ namespace Json {
          * special null value if the index is out of range or the value is
          * not an array.
          */
-        const Value &operator[](int index) const;
+        const BasicValue &operator[](int index) const;
 
         /**
          * @brief Returns a const reference to the element with the given key
@@ -381,7 +742,7 @@ namespace Json {
          * special null value if the key is not found or the value is not an
          * object.
          */
-        const Value &operator[](const std::string &key) const;
+        const BasicValue &operator[](const std::string &key) const;
 
         /**
          * @brief Returns a const reference to the element with the given key
@@ -392,7 +753,7 @@ namespace Json {
          * special null value if the key is not found or the value is not an
          * object.
          */
-        const Value &operator[](const char *key) const;
+        const BasicValue &operator[](const char *key) const;
 
         /**
          * @brief Returns a reference to the element at the given index in a
@@ -402,7 +763,7 @@ namespace Json {
          * @return A reference to the element, creating a null value if the
          * index is out of range.
          */
-        Value &operator[](size_t index);
+        BasicValue &operator[](size_t index);
 
         /**
          * @brief Returns a reference to the element at the given index in a
@@ -412,7 +773,7 @@ namespace Json {
          * @return A reference to the element, creating a null value if the
          * index is out of range or negative.
          */
-        Value &operator[](int index);
+        BasicValue &operator[](int index);
 
         /**
          * @brief Returns a reference to the element with the given key in a
@@ -422,7 +783,7 @@ namespace Json {
          * @return A reference to the element, creating a null value if the
          * key is not found.
          */
-        Value &operator[](const std::string &key);
+        BasicValue &operator[](const std::string &key);
 
         /**
          * @brief Returns a reference to the element with the given key in a
@@ -432,7 +793,116 @@ namespace Json {
          * @return A reference to the element, creating a null value if the
          * key is not found or null.
          */
-        Value &operator[](const char *key);
+        BasicValue &operator[](const char *key);
+
+        /**
+         * @brief Returns the element with the given key in a JSON object.
+         *
+         * @param key The key of the element.
+         * @return A pointer to the element, or nullptr if the key is not
+         * found or the value is not an object.
+         */
+        [[nodiscard]] const BasicValue *Find(std::string_view key) const;
+
+        /**
+         * @brief Returns the element at the given index in a JSON array.
+         *
+         * @param index The index of the element.
+         * @return A pointer to the element, or nullptr if the index is out
+         * of range or the value is not an array.
+         */
+        [[nodiscard]] const BasicValue *Find(size_t index) const;
+
+        /**
+         * @brief Returns the value identified by the given JSON Pointer,
+         * relative to this value.
+         *
+         * @param pointer The pointer to resolve.
+         * @return A pointer to the value, or nullptr if there is no such
+         * value or the JSON Pointer is invalid.
+         */
+        [[nodiscard]] const BasicValue *Find(const Pointer &pointer) const;
+
+        /**
+         * @brief Returns the element with the given key in a JSON object,
+         * converted to the given type.
+         *
+         * Unlike the typecast operators, this doesn't substitute a default
+         * when the element is missing or has another type, and it looks the
+         * key up only once.  T may be bool, an integral type (the element
+         * must be an integer in its range), a floating-point type (the
+         * element may be an integer or floating-point number),
+         * std::string, or std::string_view (which refers to the string
+         * held by the element).
+         *
+         * @param key The key of the element.
+         * @return The converted element, or std::nullopt if it is missing
+         * or doesn't convert to the given type.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> Get(std::string_view key) const {
+            return Convert<T>(Find(key));
+        }
+
+        /**
+         * @brief Returns the element at the given index in a JSON array,
+         * converted to the given type.
+         *
+         * @param index The index of the element.
+         * @return The converted element, or std::nullopt if it is missing
+         * or doesn't convert to the given type.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> Get(size_t index) const {
+            return Convert<T>(Find(index));
+        }
+
+        /**
+         * @brief Returns the value identified by the given JSON Pointer,
+         * converted to the given type.
+         *
+         * @param pointer The pointer to resolve.
+         * @return The converted value, or std::nullopt if it is missing
+         * or doesn't convert to the given type.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> Get(const Pointer &pointer) const {
+            return Convert<T>(Find(pointer));
+        }
+
+        /**
+         * @brief Stores the value of a JSON boolean.
+         *
+         * @param value Where to store the value.
+         * @return True if the value is a boolean, false otherwise.
+         */
+        bool TryGet(bool &value) const;
+
+        /**
+         * @brief Stores the value of a JSON integer.
+         *
+         * @param value Where to store the value.
+         * @return True if the value is an integer, false otherwise.
+         */
+        bool TryGet(intmax_t &value) const;
+
+        /**
+         * @brief Stores the value of a JSON integer or floating-point
+         * number.
+         *
+         * @param value Where to store the value.
+         * @return True if the value is a number, false otherwise.
+         */
+        bool TryGet(double &value) const;
+
+        /**
+         * @brief Stores a view of the value of a JSON string.
+         *
+         * @param value Where to store the view, which is valid until the
+         * string is modified or destroyed.
+         * @return True if the value is a string, false otherwise.
+         */
+        bool TryGet(std::string_view &value) const;
 
         /**
          * @brief Adds a copy of the given value to the end of the JSON array.
@@ -440,7 +910,7 @@ namespace Json {
          * @param value The value to add.
          * @return A reference to the added value.
          */
-        Value &Add(const Value &value);
+        BasicValue &Add(const BasicValue &value);
 
         /**
          * @brief Adds a move of the given value to the end of the JSON array.
@@ -448,7 +918,7 @@ namespace Json {
          * @param value The value to add.
          * @return A reference to the added value.
          */
-        Value &Add(Value &&value);
+        BasicValue &Add(BasicValue &&value);
 
         /**
          * @brief Inserts a copy of the given value at the given index in a
@@ -458,7 +928,7 @@ namespace Json {
          * @param index The index to insert at.
          * @return A reference to the inserted value.
          */
-        Value &Insert(const Value &value, size_t index);
+        BasicValue &Insert(const BasicValue &value, size_t index);
 
         /**
          * @brief Inserts a move of the given value at the given index in a
@@ -468,7 +938,7 @@ namespace Json {
          * @param index The index to insert at.
          * @return A reference to the inserted value.
          */
-        Value &Insert(Value &&value, size_t index);
+        BasicValue &Insert(BasicValue &&value, size_t index);
 
         /**
          * @brief Sets a copy of the given value with the given key in a
@@ -478,9 +948,22 @@ namespace Json {
          * @param value The value to set.
          * @return A reference to the set value.
          */
-        Value &Set(
+        BasicValue &Set(
             const std::string &key,
-            const Value &value
+            const BasicValue &value
+        );
+
+        /**
+         * @brief Sets a move of the given value with the given key in a
+         * JSON object.
+         *
+         * @param key The key to set the value with.
+         * @param value The value to set.
+         * @return A reference to the set value.
+         */
+        BasicValue &Set(
+            const std::string &key,
+            BasicValue &&value
         );
 
         /**
@@ -497,6 +980,76 @@ namespace Json {
          */
         void Remove(const std::string &key);
 
+        /**
+         * @brief Starts recording the changes made to the value, as a
+         * JSON Patch (RFC 6902).
+         *
+         * From now on, Set(), Add(), Insert(), Remove(), and assignments
+         * through operator[], to this value or any value reached from it
+         * through the non-const operator[], Set(), Add() or Insert(), are
+         * recorded as "add", "remove" and "replace" operations, with
+         * paths from this value.  References to nested values taken
+         * before tracking began aren't tracked.  Recording a change costs
+         * a copy of the value set, and a walk up to this value, so the
+         * changes are had without comparing snapshots.  If tracking has
+         * already begun, the changes recorded so far are discarded.
+         * Tracking a value within one already tracked isn't supported.
+         */
+        void BeginTracking();
+
+        /**
+         * @brief Returns the changes recorded since tracking began, or
+         * since the last call, and clears them.  Tracking continues.
+         *
+         * @return An array of JSON Patch operations, which ApplyPatch()
+         * applies to a copy of the value as it was, to bring it up to
+         * date.  It's empty if tracking hasn't begun.
+         */
+        BasicValue TakeChanges();
+
+        /**
+         * @brief Stops recording changes, discarding any not yet taken.
+         */
+        void EndTracking();
+
+        /**
+         * @brief Applies a JSON Patch (RFC 6902) to the value.
+         *
+         * All six operations are supported: "add", "remove", "replace",
+         * "move", "copy" and "test".  Changes made are recorded if the
+         * value is tracked.
+         *
+         * @param patch The array of operations to apply, in order.
+         * @return True if every operation was applied, false if one was
+         * malformed, named a value which doesn't exist, or failed its
+         * test, in which case the operations before it remain applied.
+         */
+        bool ApplyPatch(const BasicValue &patch);
+
+        /**
+         * @brief Freezes the arrays and objects within the value which
+         * haven't been accessed lately, including the value itself, into
+         * compact binary blobs.
+         *
+         * A frozen array or object is thawed, transparently, the next
+         * time it's accessed, through operator[], iteration, or any other
+         * member function.  Each call is a sweep, and an array or object
+         * is cold once FreezeOptions::idleSweeps sweeps have passed
+         * without it, or anything in it, being accessed.  Only the
+         * largest cold arrays and objects are frozen, so that one blob
+         * holds each cold branch.  References to values within an array
+         * or object become invalid when it's frozen.
+         *
+         * This does nothing unless the traits' freezeColdSubtrees is set,
+         * as it is for TieredTraits.  Since accessing a value may thaw
+         * it, such values may not be accessed by several threads at once,
+         * even to read them.
+         *
+         * @param options Options controlling what is frozen.
+         * @return The number of arrays and objects frozen.
+         */
+        size_t FreezeColdSubtrees(const FreezeOptions &options = FreezeOptions());
+
         /**
          * @brief Returns an iterator to the beginning of the JSON array or object.
          *
@@ -511,6 +1064,101 @@ namespace Json {
          */
         [[nodiscard]] Iterator end() const;
 
+        /**
+         * @brief Calls the given visitor with the content of the value,
+         * selected by a single switch on its type.
+         *
+         * The visitor is called once, with std::nullptr_t for null, bool,
+         * IntegerType, FloatingPointType, std::string_view, ArrayView,
+         * ObjectView, or InvalidValue for an invalid value.  Every call
+         * must return the same type, which Visit() returns.
+         *
+         * @param visitor The callable to call, usually a generic lambda or
+         * a set of overloads.
+         * @return The result of the visitor.
+         */
+        template<typename Visitor>
+        decltype(auto) Visit(Visitor &&visitor) const {
+            switch (GetType()) {
+                case Type::Null: return visitor(nullptr);
+                case Type::Boolean: return visitor(GetBooleanUnchecked());
+                case Type::Integer: return visitor(GetIntegerUnchecked());
+                case Type::FloatingPoint: return visitor(GetFloatingPointUnchecked());
+                case Type::String: return visitor(GetStringUnchecked());
+                case Type::Array: return visitor(ArrayView(GetArrayUnchecked()));
+                case Type::Object: return visitor(ObjectView(GetObjectUnchecked()));
+                default: return visitor(InvalidValue());
+            }
+        }
+
+        /**
+         * @brief Calls the given visitor for this value and every value
+         * nested in it, in document order, parents before children.
+         *
+         * The walk keeps its own stack rather than recursing, so deeply
+         * nested documents don't exhaust the call stack.  If the visitor
+         * returns bool, returning false skips the children of the value
+         * it was given.
+         *
+         * @param visitor The callable to call with a WalkEntry for each
+         * value.
+         */
+        template<typename Visitor>
+        void Walk(Visitor &&visitor) const {
+            struct Frame {
+                const BasicValue *container;
+                Iterator next;
+                Iterator end;
+                size_t index;
+            };
+            const auto enter = [&visitor](const WalkEntry &entry) {
+                if constexpr (std::is_same_v<decltype(visitor(entry)), bool>) {
+                    return visitor(entry);
+                } else {
+                    visitor(entry);
+                    return true;
+                }
+            };
+            const auto hasChildren = [](const BasicValue &value) {
+                return (
+                    (
+                        (value.GetType() == Type::Array)
+                        || (value.GetType() == Type::Object)
+                    )
+                    && (value.GetSize() > 0)
+                );
+            };
+            std::vector<Frame> stack;
+            if (
+                enter(WalkEntry{*this, nullptr, {}, 0, 0})
+                && hasChildren(*this)
+            ) {
+                stack.push_back(Frame{this, begin(), end(), 0});
+            }
+            while (!stack.empty()) {
+                auto &frame = stack.back();
+                if (!(frame.next != frame.end)) {
+                    stack.pop_back();
+                    continue;
+                }
+                const auto container = frame.container;
+                const auto &value = (*frame.next).value();
+                const std::string_view key = (
+                    (container->GetType() == Type::Object)
+                    ? std::string_view((*frame.next).key())
+                    : std::string_view()
+                );
+                const auto index = frame.index++;
+                ++frame.next;
+                if (
+                    enter(WalkEntry{value, container, key, index, stack.size()})
+                    && hasChildren(value)
+                ) {
+                    stack.push_back(Frame{&value, value.begin(), value.end(), 0});
+                }
+            }
+        }
+
         /**
          * @brief Encodes the JSON value to a string.
          *
@@ -525,7 +1173,7 @@ namespace Json {
          * @param encodingBeforeTrim The encoded JSON value.
          * @return The decoded JSON value.
          */
-        static Value FromEncoding(const std::vector<uint32_t> &encodingBeforeTrim);
+        static BasicValue FromEncoding(const std::vector<uint32_t> &encodingBeforeTrim);
 
         /**
          * @brief Decodes a JSON value from a string.
@@ -533,9 +1181,181 @@ namespace Json {
          * @param encodingBeforeTrim The encoded JSON value.
          * @return The decoded JSON value.
          */
-        static Value FromEncoding(const std::string &encodingBeforeTrim);
+        static BasicValue FromEncoding(const std::string &encodingBeforeTrim);
+
+        /**
+         * @brief Decodes a JSON value from a string, guided by what the
+         * given access profile has learned.
+         *
+         * Arrays and objects which were accessed in documents parsed
+         * before with the profile are decoded, and the others are only
+         * checked and kept as text, to be decoded the first time they're
+         * accessed.  Decoding one then adds it to the profile, so that
+         * it's decoded up front in later documents.  Encoding, copying
+         * or comparing the value doesn't decode what's kept as text, and
+         * so teaches the profile nothing.  Like frozen arrays
+         * and objects, those kept as text are decoded transparently, and
+         * the value can't be used by several threads at once.
+         *
+         * This only decodes lazily if the traits' freezeColdSubtrees is
+         * set, as it is for TieredTraits.  Otherwise the whole value is
+         * decoded, as by FromEncoding(), and the profile isn't used.
+         *
+         * @param encodingBeforeTrim The encoded JSON value.
+         * @param profile The access profile which guides decoding.
+         * @return The decoded JSON value.
+         */
+        static BasicValue FromEncoding(
+            const std::string &encodingBeforeTrim,
+            const ProfileId &profile
+        );
+
+        /**
+         * @brief Writes the encoding of the JSON value to a stream.
+         *
+         * The text written is the same as ToEncoding() returns, but it's
+         * passed to the stream through a fixed-size buffer, so the whole
+         * encoding is never held in memory at once.  Encodings cached in
+         * the value are used, but not updated.
+         *
+         * @param stream The stream to which to write.
+         * @param options Encoding options.
+         */
+        void Write(
+            std::ostream &stream,
+            const EncodingOptions &options = EncodingOptions()
+        ) const;
+
+        /**
+         * @brief Writes the encoding of the JSON value to a file, replacing
+         * the file atomically.
+         *
+         * The encoding is streamed through a buffer into a temporary file
+         * next to the given path, which is then renamed over it, so that
+         * readers of the file see either its old contents or the whole of
+         * the new ones.  The text written is the same as ToEncoding()
+         * returns, but the whole encoding is never held in memory at once,
+         * and no encodings are cached.  A file being replaced keeps its
+         * permissions.
+         *
+         * @param path The path of the file to write.
+         * @param options Encoding options.
+         * @param writeOptions Options controlling how the file is written.
+         * @return True if the file was written, false otherwise, in which
+         * case any existing file is left as it was.
+         */
+        bool ToFile(
+            const std::string &path,
+            const EncodingOptions &options = EncodingOptions(),
+            const WriteOptions &writeOptions = WriteOptions()
+        ) const;
+
+        /**
+         * @brief Reads one JSON value from a stream.
+         *
+         * The stream is read through a fixed-size buffer, taking only
+         * the characters already available where possible, and any
+         * characters read past the end of the value are put back.  The
+         * value returned doesn't keep the text from which it was read.
+         *
+         * @param stream The stream from which to read.
+         * @return The value read, or an invalid value if the text isn't
+         * valid JSON.
+         */
+        static BasicValue Read(std::istream &stream);
+
+        /**
+         * @brief Parses text again after an edit, reusing the values
+         * parsed from the text which the edit didn't touch.
+         *
+         * Only the smallest array or object enclosing the edit is parsed
+         * again, with each of its elements or members which lies wholly
+         * outside the edit taken from the previous value rather than
+         * parsed; if the edit leaves that array or object malformed, the
+         * one enclosing it is tried, and so on out to the whole text.
+         * Values reused are moved, not copied, so a keystroke in a large
+         * document costs about as much as parsing the array or object
+         * typed in.
+         *
+         * This needs traits which keep source spans, such as
+         * EditableTraits, and a previous value which came from
+         * FromEncoding() or Reparse() of the old text.  With other
+         * traits, the new text is parsed in full, and so it is if the
+         * previous value was changed since, or a member or element of it
+         * was reached through the non-const operator[], since that may
+         * have changed it; read through a const reference to keep
+         * reparsing incremental.
+         *
+         * @param previous The value parsed from the old text.  It's moved
+         *     from, unless the new text isn't valid JSON, in which case it
+         *     is left as it was, so that the next edit can be applied to
+         *     it with an EditRange combined by EditRange::Then().
+         * @param newText The whole of the new text.
+         * @param changed Where the old text was edited.
+         * @return The value parsed from the new text, or an invalid value
+         *     if the new text isn't valid JSON.
+         */
+        static BasicValue Reparse(
+            BasicValue &&previous,
+            std::string_view newText,
+            const EditRange &changed
+        );
 
     private:
+        /**
+         * @brief Return the content of the value, for Visit(), which has
+         * already checked the type.
+         */
+        [[nodiscard]] bool GetBooleanUnchecked() const;
+        [[nodiscard]] IntegerType GetIntegerUnchecked() const;
+        [[nodiscard]] FloatingPointType GetFloatingPointUnchecked() const;
+        [[nodiscard]] std::string_view GetStringUnchecked() const;
+        [[nodiscard]] const ArrayType &GetArrayUnchecked() const;
+        [[nodiscard]] const ObjectType &GetObjectUnchecked() const;
+
+        /**
+         * @brief Converts the given value to the given type, for Get().
+         *
+         * @param value The value to convert, or nullptr.
+         * @return The converted value, or std::nullopt.
+         */
+        template<typename T>
+        static std::optional<T> Convert(const BasicValue *value) {
+            if (value == nullptr) {
+                return std::nullopt;
+            }
+            if constexpr (std::is_same_v<T, bool>) {
+                bool boolean;
+                if (value->TryGet(boolean)) {
+                    return boolean;
+                }
+            } else if constexpr (std::integral<T>) {
+                intmax_t integer;
+                if (
+                    value->TryGet(integer)
+                    && std::in_range<T>(integer)
+                ) {
+                    return (T) integer;
+                }
+            } else if constexpr (std::floating_point<T>) {
+                double number;
+                if (value->TryGet(number)) {
+                    return (T) number;
+                }
+            } else if constexpr (
+                std::is_same_v<T, std::string>
+                || std::is_same_v<T, std::string_view>
+            ) {
+                std::string_view string;
+                if (value->TryGet(string)) {
+                    return T(string);
+                }
+            } else {
+                static_assert(!sizeof(T), "Get() doesn't support this type");
+            }
+            return std::nullopt;
+        }
+
         /**
         * @brief Private implementation details.
         */
@@ -546,6 +1366,27 @@ namespace Json {
         std::unique_ptr<Impl> impl_;
     };
 
+    /** @brief A JSON value in the default configuration. */
+    using Value = BasicValue<DefaultTraits>;
+
+    /** @brief A JSON value in the compact configuration. */
+    using CompactValue = BasicValue<CompactTraits>;
+
+    /** @brief A JSON value in the hashed configuration. */
+    using HashedValue = BasicValue<HashedTraits>;
+
+    /** @brief A JSON value in the editable configuration. */
+    using EditableValue = BasicValue<EditableTraits>;
+
+    /** @brief A JSON value in the tiered configuration. */
+    using TieredValue = BasicValue<TieredTraits>;
+
+    extern template class BasicValue<DefaultTraits>;
+    extern template class BasicValue<CompactTraits>;
+    extern template class BasicValue<HashedTraits>;
+    extern template class BasicValue<EditableTraits>;
+    extern template class BasicValue<TieredTraits>;
+
     /**
      * This constructs a JSON array containing copies of the
      * elements in the given initializer list.
@@ -582,7 +1423,7 @@ namespace Json {
      *     Json::Type value.
      */
     void PrintTo(
-        Value::Type type,
+        ValueType type,
         std::ostream *os
     );
 
@@ -597,8 +1438,48 @@ namespace Json {
      *     This points to the stream to which to print the
      *     Json value.
      */
+    template<typename Traits>
     void PrintTo(
-        const Value &json,
+        const BasicValue<Traits> &json,
         std::ostream *os
     );
+
+    /**
+     * This writes the encoding of the given JSON value to the given
+     * stream, using the default encoding options.
+     *
+     * @param[in] stream
+     *     This is the stream to which to write.
+     *
+     * @param[in] json
+     *     This is the JSON value to write.
+     *
+     * @return
+     *     The stream is returned.
+     */
+    template<typename Traits>
+    std::ostream &operator<<(
+        std::ostream &stream,
+        const BasicValue<Traits> &json
+    );
+
+    /**
+     * This reads one JSON value from the given stream.  If the text
+     * isn't valid JSON, the stream's failbit is set, and the value
+     * is left invalid.
+     *
+     * @param[in] stream
+     *     This is the stream from which to read.
+     *
+     * @param[out] json
+     *     This is where to store the value read.
+     *
+     * @return
+     *     The stream is returned.
+     */
+    template<typename Traits>
+    std::istream &operator>>(
+        std::istream &stream,
+        BasicValue<Traits> &json
+    );
 }
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "value.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+    /**
+     * @brief Produces JSON text directly from a sequence of calls, without
+     * building a Value first.
+     *
+     * Each call appends the encoding of one token to the output, so the
+     * memory used doesn't grow with the size of the document:
+     *
+     * @code
+     * std::string text;
+     * Json::Writer writer(text);
+     * writer.BeginObject()
+     *     .Key("id").Int(42)
+     *     .Key("tags").BeginArray().String("a").String("b").EndArray()
+     *     .EndObject();
+     * @endcode
+     *
+     * Strings and numbers are encoded exactly as Value::ToEncoding()
+     * encodes them.  When pretty printing, every non-empty array and object
+     * is broken over lines, since the writer can't look ahead to decide
+     * whether a container would fit within the wrap threshold.
+     *
+     * Calls which would produce invalid JSON, such as a value in an
+     * object without a key, write nothing, and the writer is marked as
+     * failed.  Nothing is written by any call after that, so the output
+     * ends where the first refused call was made.  In debug builds, they
+     * also fail an assertion.
+     */
+    class Writer {
+    public:
+        /**
+         * @brief The type of function which receives the output of a
+         * writer, one chunk at a time.
+         */
+        using Sink = std::function<void(std::string_view chunk)>;
+
+        /**
+         * @brief Constructs a writer which appends to the given string.
+         *
+         * @param output The string to which to append the JSON text.
+         * @param options Encoding options; "pretty",
+         *     "spacesPerIndentationLevel", "numIndentationLevels" and
+         *     "escapeNonAscii" are used.
+         */
+        explicit Writer(
+            std::string &output,
+            const EncodingOptions &options = EncodingOptions()
+        );
+
+        /**
+         * @brief Constructs a writer which passes its output to the given
+         * function, in chunks of about the given size.
+         *
+         * @param sink The function to which to pass the JSON text.
+         * @param options Encoding options, as for the other constructor.
+         * @param bufferSize The amount of text to collect before passing
+         *     it to the sink.
+         */
+        explicit Writer(
+            Sink sink,
+            const EncodingOptions &options = EncodingOptions(),
+            size_t bufferSize = 65536
+        );
+
+        /** @brief Destructor; passes any remaining output to the sink. */
+        ~Writer() noexcept;
+
+        Writer(const Writer &) = delete;
+        Writer(Writer &&) noexcept = delete;
+        Writer &operator=(const Writer &) = delete;
+        Writer &operator=(Writer &&) noexcept = delete;
+
+        /** @brief Starts a JSON object. */
+        Writer &BeginObject();
+
+        /** @brief Ends the innermost JSON object. */
+        Writer &EndObject();
+
+        /** @brief Starts a JSON array. */
+        Writer &BeginArray();
+
+        /** @brief Ends the innermost JSON array. */
+        Writer &EndArray();
+
+        /**
+         * @brief Writes the key of the next member of the innermost object.
+         *
+         * @param key The key, which is escaped as needed.
+         */
+        Writer &Key(std::string_view key);
+
+        /**
+         * @brief Writes the given text verbatim as the key of the next
+         * member of the innermost object.
+         *
+         * Use this for keys which are already encoded, including their
+         * quotation marks; the text isn't checked.
+         *
+         * @param encoding The JSON encoding of the key.
+         */
+        Writer &RawKey(std::string_view encoding);
+
+        /** @brief Writes a null value. */
+        Writer &Null();
+
+        /**
+         * @brief Writes a boolean value.
+         *
+         * @param value The value to write.
+         */
+        Writer &Bool(bool value);
+
+        /**
+         * @brief Writes an integer value.
+         *
+         * @param value The value to write.
+         */
+        Writer &Int(intmax_t value);
+
+        /**
+         * @brief Writes a floating-point value.
+         *
+         * @param value The value to write.
+         */
+        Writer &Double(double value);
+
+        /**
+         * @brief Writes a string value.
+         *
+         * @param value The string, which is escaped as needed.
+         */
+        Writer &String(std::string_view value);
+
+        /**
+         * @brief Writes the given text verbatim as the next value.
+         *
+         * Use this for values which are already encoded; the text isn't
+         * checked.
+         *
+         * @param encoding The JSON encoding of the value.
+         */
+        Writer &RawValue(std::string_view encoding);
+
+        /**
+         * @brief Writes the encoding of the given JSON value as the next
+         * value.
+         *
+         * @param value The value to write.
+         */
+        template<typename Traits>
+        Writer &Write(const BasicValue<Traits> &value) {
+            if (failed) {
+                return *this;
+            }
+            auto nestedOptions = options;
+            nestedOptions.numIndentationLevels += frames.size();
+            return RawValue(value.ToEncoding(nestedOptions));
+        }
+
+        /**
+         * @brief Passes all output so far to the sink, if there is one.
+         */
+        void Flush();
+
+        /**
+         * @brief Checks if a complete JSON value has been written.
+         *
+         * @return True if one value has been written, all arrays and
+         * objects have been ended and no call was refused, false
+         * otherwise.
+         */
+        [[nodiscard]] bool IsComplete() const;
+
+        /**
+         * @brief Returns whether a call was refused because it would have
+         * produced invalid JSON.
+         */
+        [[nodiscard]] bool HasFailed() const {
+            return failed;
+        }
+
+    private:
+        /** @brief An array or object which has been started but not ended. */
+        struct Frame {
+            /** @brief Whether the container is an object rather than an array. */
+            bool isObject = false;
+
+            /** @brief The number of elements or members written so far. */
+            size_t count = 0;
+
+            /** @brief Whether a key has been written which awaits its value. */
+            bool haveKey = false;
+        };
+
+        /**
+         * @brief Writes whatever must precede the next key, returning
+         * false if a key isn't allowed here.
+         */
+        bool BeginKey();
+
+        /**
+         * @brief Writes whatever must precede the next value, returning
+         * false if a value isn't allowed here.
+         */
+        bool BeginValue();
+
+        /**
+         * @brief Writes a line break and the indentation for the given
+         * number of nesting levels.
+         */
+        void NewLine(size_t levels);
+
+        /**
+         * @brief Ends the innermost container.
+         */
+        Writer &EndContainer(
+            bool isObject,
+            char delimiter
+        );
+
+        /**
+         * @brief Passes the buffered output to the sink once enough of it
+         * has been collected.
+         */
+        void MaybeFlush();
+
+        /** @brief The text being appended to. */
+        std::string *output;
+
+        /** @brief The buffer used when writing to a sink. */
+        std::string buffer;
+
+        /** @brief The function receiving the output, if any. */
+        Sink sink;
+
+        /** @brief The amount of output to buffer for the sink. */
+        size_t bufferSize = 0;
+
+        /** @brief The encoding options. */
+        EncodingOptions options;
+
+        /** @brief The containers which have been started but not ended. */
+        std::vector<Frame> frames;
+
+        /** @brief Whether a complete top-level value has been written. */
+        bool complete = false;
+
+        /** @brief Whether a call was refused. */
+        bool failed = false;
+    };
+}
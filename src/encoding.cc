@@ -0,0 +1,172 @@
+#include "encoding.h"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <StringExtensions/StringExtensions.hpp>
+#include <Utf8/Utf8.hpp>
+
+namespace {
+    /**
+     * This maps special characters to their escaped representations.
+     */
+    const std::map<Utf8::UnicodeCodePoint, Utf8::UnicodeCodePoint> SPECIAL_ESCAPE_ENCODINGS{
+        {0x22, 0x22}, // '"'
+        {0x5C, 0x5C}, // '\\'
+        {0x2F, 0x2F}, // '\\'
+        {0x08, 0x62}, // '\b'
+        {0x0C, 0x66}, // '\f'
+        {0x0A, 0x6E}, // '\n'
+        {0x0D, 0x72}, // '\r'
+        {0x09, 0x74}, // '\t'
+    };
+
+    /**
+     * This function appends the four hex digits matching the given
+     * code point in hexadecimal to the given output.
+     *
+     * @param[in,out] output
+     *     This is the text to which to append the hex digits.
+     *
+     * @param[in] cp
+     *     This is the code point to render as four hex digits.
+     */
+    void AppendFourHexDigits(
+        std::string &output,
+        Utf8::UnicodeCodePoint cp
+    ) {
+        for (size_t i = 0; i < 4; ++i) {
+            const auto nibble = ((cp >> (4 * (3 - i))) & 0x0F);
+            if (nibble < 10) {
+                output += (char) nibble + '0';
+            } else {
+                output += (char) (nibble - 10) + 'A';
+            }
+        }
+    }
+
+    /**
+     * This function appends the escaped form of the given code point,
+     * which must be a quotation mark, reverse solidus, or control
+     * character, to the given output.
+     *
+     * @param[in,out] output
+     *     This is the text to which to append the escape.
+     *
+     * @param[in] cp
+     *     This is the code point to escape.
+     */
+    void AppendEscape(
+        std::string &output,
+        Utf8::UnicodeCodePoint cp
+    ) {
+        output += '\\';
+        const auto entry = SPECIAL_ESCAPE_ENCODINGS.find(cp);
+        if (entry == SPECIAL_ESCAPE_ENCODINGS.end()) {
+            output += 'u';
+            AppendFourHexDigits(output, cp);
+        } else {
+            output += (char) entry->second;
+        }
+    }
+
+    /**
+     * This function returns an indication of whether or not the given
+     * code point must be escaped in every JSON string.
+     *
+     * @param[in] cp
+     *     This is the code point to check.
+     *
+     * @return
+     *     An indication of whether or not the code point must be
+     *     escaped is returned.
+     */
+    bool MustEscape(Utf8::UnicodeCodePoint cp) {
+        return (
+            (cp == 0x22)
+            || (cp == 0x5C)
+            || (cp < 0x20)
+        );
+    }
+}
+
+namespace Json {
+    namespace Detail {
+        void AppendEncodedString(
+            std::string &output,
+            std::string_view value,
+            const EncodingOptions &options
+        ) {
+            output += '"';
+
+            // ASCII needs no decoding, so handle it directly, and only
+            // decode from the first non-ASCII character onwards.
+            size_t offset = 0;
+            while (
+                (offset < value.size())
+                && ((unsigned char) value[offset] < 0x80)
+            ) {
+                const auto cp = (Utf8::UnicodeCodePoint) value[offset];
+                if (MustEscape(cp)) {
+                    AppendEscape(output, cp);
+                } else {
+                    output += value[offset];
+                }
+                ++offset;
+            }
+            if (offset < value.size()) {
+                Utf8::Utf8 utf8;
+                for (const auto cp: utf8.Decode(std::string(value.substr(offset)))) {
+                    if (MustEscape(cp)) {
+                        AppendEscape(output, cp);
+                    } else if (
+                        options.escapeNonAscii
+                        && (cp > 0x7F)
+                    ) {
+                        if (cp > 0xFFFF) {
+                            output += "\\u";
+                            AppendFourHexDigits(output, 0xD800 + (((cp - 0x10000) >> 10) & 0x3FF));
+                            output += "\\u";
+                            AppendFourHexDigits(output, 0xDC00 + ((cp - 0x10000) & 0x3FF));
+                        } else {
+                            output += "\\u";
+                            AppendFourHexDigits(output, cp);
+                        }
+                    } else {
+                        const auto encoding = utf8.Encode({cp});
+                        output.append(
+                            encoding.begin(),
+                            encoding.end()
+                        );
+                    }
+                }
+            }
+            output += '"';
+        }
+
+        void AppendEncodedInteger(
+            std::string &output,
+            intmax_t value
+        ) {
+            char digits[24];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            output.append(digits, result.ptr);
+        }
+
+        void AppendEncodedFloatingPoint(
+            std::string &output,
+            double value
+        ) {
+            auto encoding = StringExtensions::sprintf("%.15lg", value);
+            if (encoding.find_first_not_of("0123456789-") == std::string::npos) {
+                encoding += ".0";
+            }
+            std::replace(
+                encoding.begin(),
+                encoding.end(),
+                ',', '.'
+            );
+            output += encoding;
+        }
+    }
+}
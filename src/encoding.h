@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <value.h>
+
+namespace Json {
+    namespace Detail {
+        /**
+         * This appends the JSON encoding of the given string, including
+         * the surrounding quotation marks, to the given output.
+         *
+         * @param[in,out] output
+         *     This is the text to which to append the encoding.
+         *
+         * @param[in] value
+         *     This is the string to encode.
+         *
+         * @param[in] options
+         *     This is used to configure various options having to do with
+         *     encoding a Json value into its string format.
+         */
+        void AppendEncodedString(
+            std::string &output,
+            std::string_view value,
+            const EncodingOptions &options
+        );
+
+        /**
+         * This appends the JSON encoding of the given integer to the
+         * given output.
+         *
+         * @param[in,out] output
+         *     This is the text to which to append the encoding.
+         *
+         * @param[in] value
+         *     This is the integer to encode.
+         */
+        void AppendEncodedInteger(
+            std::string &output,
+            intmax_t value
+        );
+
+        /**
+         * This appends the JSON encoding of the given floating-point
+         * number to the given output.  Numbers with integral values
+         * are given a ".0" suffix so that they decode as floating-point
+         * numbers again.
+         *
+         * @param[in,out] output
+         *     This is the text to which to append the encoding.
+         *
+         * @param[in] value
+         *     This is the number to encode.
+         */
+        void AppendEncodedFloatingPoint(
+            std::string &output,
+            double value
+        );
+    }
+}
@@ -0,0 +1,1059 @@
+#include <algorithm>
+#include <builder.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <indexed-file.h>
+#include <reader.h>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * This identifies an index file, and the version of its format.
+     */
+    constexpr uint64_t INDEX_MAGIC = 0x3158444954494b4a; // "JKITIDX1"
+
+    /**
+     * This is the number of words in the header of an index file.
+     */
+    constexpr size_t HEADER_WORDS = 7;
+
+    /**
+     * This is the number of words in each node of an index file.
+     */
+    constexpr size_t NODE_WORDS = 4;
+
+    /**
+     * This flag in the last word of a node marks an object.
+     */
+    constexpr uint64_t NODE_OBJECT = (uint64_t) 1 << 63;
+
+    /**
+     * This flag in the header of an index marks a file of
+     * newline-delimited records.
+     */
+    constexpr uint64_t INDEX_LINES = 1;
+
+    /**
+     * This is the amount of text fed to a reader at a time when indexing
+     * a single value.
+     */
+    constexpr size_t INDEX_CHUNK_SIZE = 1048576;
+
+    /**
+     * This is the amount of text fed to a reader first when parsing a
+     * value found through the index.  It doubles each time more is
+     * needed, so small values don't cost a large copy.
+     */
+    constexpr size_t FIRST_PARSE_CHUNK_SIZE = 4096;
+
+    /**
+     * This is an array or object in the index.
+     */
+    struct Node {
+        /**
+         * This is the offset of its opening bracket.
+         */
+        uint64_t offset = 0;
+
+        /**
+         * This is the index of its first word in the table of children.
+         * An array has one word per element: the offset of the element.
+         * An object has two per member, the hash of the key and the
+         * offset of the key, sorted by hash.
+         */
+        uint64_t firstWord = 0;
+
+        /**
+         * This is the number of its elements or members.
+         */
+        uint64_t count = 0;
+
+        /**
+         * This indicates whether it's an object.
+         */
+        bool isObject = false;
+    };
+
+    /**
+     * This is the index of part of a file.
+     */
+    struct IndexPart {
+        /**
+         * These are the arrays and objects indexed, in order of offset.
+         */
+        std::vector<Node> nodes;
+
+        /**
+         * This is the table of children of the nodes.
+         */
+        std::vector<uint64_t> words;
+
+        /**
+         * These are the offsets of newline-delimited records.
+         */
+        std::vector<uint64_t> records;
+    };
+
+    /**
+     * This function computes the hash of a key stored in an index.  It's
+     * FNV-1a, which is stable from one build and platform to the next.
+     */
+    uint64_t HashKey(std::string_view key) {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (const auto c: key) {
+            hash ^= (unsigned char) c;
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    /**
+     * This builds the index of values from their tokens.
+     */
+    class Indexer {
+    public:
+        Indexer(
+            IndexPart &part,
+            uint64_t minimumContainerSize
+        )
+            : part(part)
+              , minimumContainerSize(minimumContainerSize) {
+        }
+
+        /**
+         * This adds the next token to the index.
+         *
+         * @param[in] token
+         *     This is the token to add.
+         *
+         * @param[in] base
+         *     This is the offset in the file of the text whose offsets
+         *     the token's offset counts.
+         *
+         * @return
+         *     An indication of whether the token is valid is returned.
+         */
+        bool Add(
+            const Json::Reader::Token &token,
+            uint64_t base
+        ) {
+            const auto offset = base + token.offset;
+            switch (token.type) {
+                case Json::Reader::TokenType::Key: {
+                    auto &container = open.back();
+                    if (token.escaped) {
+                        scratch.clear();
+                        if (!Json::Reader::DecodeString(token.text, scratch)) {
+                            return false;
+                        }
+                        container.members.emplace_back(HashKey(scratch), offset);
+                    } else {
+                        container.members.emplace_back(HashKey(token.text), offset);
+                    }
+                }
+                return true;
+
+                case Json::Reader::TokenType::EndObject:
+                case Json::Reader::TokenType::EndArray: {
+                    Close(offset + 1);
+                }
+                return true;
+
+                default: break;
+            }
+            if (
+                !open.empty()
+                && !open.back().isObject
+            ) {
+                open.back().elements.push_back(offset);
+            }
+            if (
+                (token.type == Json::Reader::TokenType::BeginObject)
+                || (token.type == Json::Reader::TokenType::BeginArray)
+            ) {
+                open.push_back(
+                    Container{
+                        offset,
+                        token.type == Json::Reader::TokenType::BeginObject,
+                        std::vector<uint64_t>(),
+                        std::vector<std::pair<uint64_t, uint64_t>>()
+                    }
+                );
+            }
+            return true;
+        }
+
+        /**
+         * This discards any arrays and objects which weren't ended, as
+         * after an error.
+         */
+        void Abandon() {
+            open.clear();
+        }
+
+        /**
+         * This puts the nodes of the index in order of offset, since
+         * they're added as they end rather than as they start.
+         */
+        void Finish() {
+            std::sort(
+                part.nodes.begin(),
+                part.nodes.end(),
+                [](const Node &lhs, const Node &rhs){
+                    return (lhs.offset < rhs.offset);
+                }
+            );
+        }
+
+    private:
+        /**
+         * This is an array or object which has been started but not
+         * ended.
+         */
+        struct Container {
+            /**
+             * This is the offset of its opening bracket.
+             */
+            uint64_t offset = 0;
+
+            /**
+             * This indicates whether it's an object.
+             */
+            bool isObject = false;
+
+            /**
+             * For an array, these are the offsets of its elements.
+             */
+            std::vector<uint64_t> elements;
+
+            /**
+             * For an object, these are the hashes and offsets of its keys.
+             */
+            std::vector<std::pair<uint64_t, uint64_t>> members;
+        };
+
+        /**
+         * This ends the innermost open array or object, adding it to the
+         * index if it's large enough.
+         */
+        void Close(uint64_t end) {
+            auto container = std::move(open.back());
+            open.pop_back();
+            if (end - container.offset < minimumContainerSize) {
+                return;
+            }
+            Node node;
+            node.offset = container.offset;
+            node.firstWord = part.words.size();
+            node.isObject = container.isObject;
+            if (container.isObject) {
+                // Members with the same key keep their order, so that the
+                // last one, which a parse would keep, can be found.
+                std::stable_sort(
+                    container.members.begin(),
+                    container.members.end(),
+                    [](const auto &lhs, const auto &rhs){
+                        return (lhs.first < rhs.first);
+                    }
+                );
+                for (const auto &member: container.members) {
+                    part.words.push_back(member.first);
+                    part.words.push_back(member.second);
+                }
+                node.count = container.members.size();
+            } else {
+                part.words.insert(part.words.end(), container.elements.begin(), container.elements.end());
+                node.count = container.elements.size();
+            }
+            part.nodes.push_back(node);
+        }
+
+        /**
+         * This is where to store the index.
+         */
+        IndexPart &part;
+
+        /**
+         * This is the length of text below which arrays and objects
+         * aren't indexed.
+         */
+        const uint64_t minimumContainerSize;
+
+        /**
+         * These are the arrays and objects started but not ended.
+         */
+        std::vector<Container> open;
+
+        /**
+         * This is a buffer reused to decode keys.
+         */
+        std::string scratch;
+    };
+
+    /**
+     * This is a file mapped read-only into memory.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile() noexcept {
+            Close();
+        }
+
+        /**
+         * This maps the file at the given path.
+         *
+         * @return
+         *     An indication of whether the file was mapped is returned.
+         */
+        bool Open(const std::string &path) {
+            Close();
+#ifdef _WIN32
+            file = CreateFileA(
+                path.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                NULL,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                NULL
+            );
+            if (file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize)) {
+                Close();
+                return false;
+            }
+            size = (size_t) fileSize.QuadPart;
+            if (size == 0) {
+                return true;
+            }
+            mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping == NULL) {
+                Close();
+                return false;
+            }
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data == nullptr) {
+                Close();
+                return false;
+            }
+#else
+            file = open(path.c_str(), O_RDONLY);
+            if (file < 0) {
+                return false;
+            }
+            struct stat status;
+            if (fstat(file, &status) != 0) {
+                Close();
+                return false;
+            }
+            size = (size_t) status.st_size;
+            if (size == 0) {
+                return true;
+            }
+            data = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                Close();
+                return false;
+            }
+#endif
+            return true;
+        }
+
+        /**
+         * This unmaps the file, if it's mapped.
+         */
+        void Close() {
+#ifdef _WIN32
+            if (data != nullptr) {
+                (void) UnmapViewOfFile(data);
+            }
+            if (mapping != NULL) {
+                (void) CloseHandle(mapping);
+                mapping = NULL;
+            }
+            if (file != INVALID_HANDLE_VALUE) {
+                (void) CloseHandle(file);
+                file = INVALID_HANDLE_VALUE;
+            }
+#else
+            if (data != nullptr) {
+                (void) munmap(data, size);
+            }
+            if (file >= 0) {
+                (void) close(file);
+                file = -1;
+            }
+#endif
+            data = nullptr;
+            size = 0;
+        }
+
+        /**
+         * This returns the contents of the file.
+         */
+        std::string_view GetText() const {
+            if (data == nullptr) {
+                return {};
+            }
+            return std::string_view((const char *) data, size);
+        }
+
+    private:
+#ifdef _WIN32
+        /**
+         * This is the handle of the open file.
+         */
+        HANDLE file = INVALID_HANDLE_VALUE;
+
+        /**
+         * This is the handle of the file mapping.
+         */
+        HANDLE mapping = NULL;
+#else
+        /**
+         * This is the descriptor of the open file.
+         */
+        int file = -1;
+#endif
+
+        /**
+         * This is where the file is mapped.
+         */
+        void *data = nullptr;
+
+        /**
+         * This is the size of the file.
+         */
+        size_t size = 0;
+    };
+
+    /**
+     * This function returns the path of the index of the file at the
+     * given path.
+     */
+    std::string IndexPath(const std::string &path) {
+        return path + ".idx";
+    }
+
+    /**
+     * This function returns the size and modification time of the file
+     * at the given path, which an index records so that it isn't used
+     * once the file has changed.
+     *
+     * @return
+     *     An indication of whether the file's details were found is
+     *     returned.
+     */
+    bool GetFileStamp(
+        const std::string &path,
+        uint64_t &size,
+        uint64_t &time
+    ) {
+        std::error_code error;
+        size = (uint64_t) std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+        time = (uint64_t) std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        return !error;
+    }
+
+    /**
+     * This function indexes a file holding one JSON value.
+     *
+     * @return
+     *     An indication of whether the text is valid JSON is returned.
+     */
+    bool IndexValue(
+        std::string_view text,
+        const Json::IndexOptions &options,
+        IndexPart &part
+    ) {
+        Indexer indexer(part, options.minimumContainerSize);
+        Json::Reader reader;
+        Json::Reader::Token token;
+        size_t fed = 0;
+        while (true) {
+            switch (reader.Next(token)) {
+                case Json::Reader::Status::Token: {
+                    if (!indexer.Add(token, 0)) {
+                        return false;
+                    }
+                }
+                break;
+
+                case Json::Reader::Status::NeedInput: {
+                    if (fed == text.size()) {
+                        reader.Finish();
+                    } else {
+                        const auto chunk = std::min(INDEX_CHUNK_SIZE, text.size() - fed);
+                        reader.Feed(text.substr(fed, chunk));
+                        fed += chunk;
+                    }
+                }
+                break;
+
+                case Json::Reader::Status::End: {
+                    indexer.Finish();
+                }
+                return true;
+
+                default: return false;
+            }
+        }
+    }
+
+    /**
+     * This function indexes whole lines of a file of newline-delimited
+     * records.  Lines which aren't valid JSON are still indexed as
+     * records, but nothing within them is.
+     *
+     * @param[in] text
+     *     This is the text of the lines.
+     *
+     * @param[in] base
+     *     This is the offset of the text in the file.
+     */
+    void IndexLines(
+        std::string_view text,
+        uint64_t base,
+        const Json::IndexOptions &options,
+        IndexPart &part
+    ) {
+        Indexer indexer(part, options.minimumContainerSize);
+        Json::Reader reader;
+        Json::Reader::Token token;
+        size_t start = 0;
+        while (start < text.size()) {
+            auto end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            const auto line = text.substr(start, end - start);
+            const auto first = line.find_first_not_of(" \t\r");
+            if (first != std::string_view::npos) {
+                part.records.push_back(base + start + first);
+                reader.Reset();
+                reader.Feed(line);
+                reader.Finish();
+                while (reader.Next(token) == Json::Reader::Status::Token) {
+                    if (!indexer.Add(token, base + start)) {
+                        break;
+                    }
+                }
+                indexer.Abandon();
+            }
+            start = end + 1;
+        }
+        indexer.Finish();
+    }
+
+    /**
+     * This function indexes a file of newline-delimited records, using
+     * several threads, each taking whole lines.
+     */
+    void IndexRecords(
+        std::string_view text,
+        const Json::IndexOptions &options,
+        IndexPart &index
+    ) {
+        auto threads = options.threads;
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        threads = std::clamp(threads, (size_t) 1, std::max(text.size() / INDEX_CHUNK_SIZE, (size_t) 1));
+        std::vector<size_t> bounds{0};
+        for (size_t i = 1; i < threads; ++i) {
+            const auto newline = text.find('\n', std::max(text.size() * i / threads, bounds.back()));
+            if (newline == std::string_view::npos) {
+                break;
+            }
+            bounds.push_back(newline + 1);
+        }
+        bounds.push_back(text.size());
+        std::vector<IndexPart> parts(bounds.size() - 1);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < parts.size(); ++i) {
+            workers.emplace_back(
+                [&, i]{
+                    IndexLines(text.substr(bounds[i], bounds[i + 1] - bounds[i]), bounds[i], options, parts[i]);
+                }
+            );
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+
+        // The parts are in order of offset, so joining them keeps the
+        // nodes in order; only their positions in the table of children
+        // change.
+        for (auto &part: parts) {
+            const auto wordBase = index.words.size();
+            for (auto node: part.nodes) {
+                node.firstWord += wordBase;
+                index.nodes.push_back(node);
+            }
+            index.words.insert(index.words.end(), part.words.begin(), part.words.end());
+            index.records.insert(index.records.end(), part.records.begin(), part.records.end());
+        }
+    }
+
+    /**
+     * This function writes an index to the given file, replacing it only
+     * once the whole index has been written.
+     */
+    bool WriteIndex(
+        const std::string &path,
+        const std::vector<uint64_t> &header,
+        const IndexPart &index
+    ) {
+        const auto temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            const auto write = [&file](const uint64_t *words, size_t count){
+                (void) file.write((const char *) words, (std::streamsize) (count * sizeof(uint64_t)));
+            };
+            write(header.data(), header.size());
+            for (const auto &node: index.nodes) {
+                const uint64_t words[NODE_WORDS] = {
+                    node.offset,
+                    node.firstWord,
+                    node.count,
+                    node.isObject ? NODE_OBJECT : 0,
+                };
+                write(words, NODE_WORDS);
+            }
+            write(index.words.data(), index.words.size());
+            write(index.records.data(), index.records.size());
+            file.close();
+            if (!file) {
+                std::error_code error;
+                (void) std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            (void) std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace Json {
+    bool IndexFile(
+        const std::string &path,
+        const IndexOptions &options
+    ) {
+        uint64_t size = 0;
+        uint64_t time = 0;
+        if (!GetFileStamp(path, size, time)) {
+            return false;
+        }
+        MappedFile file;
+        if (!file.Open(path)) {
+            return false;
+        }
+        IndexPart index;
+        if (options.lines) {
+            IndexRecords(file.GetText(), options, index);
+        } else if (!IndexValue(file.GetText(), options, index)) {
+            return false;
+        }
+        const std::vector<uint64_t> header{
+            INDEX_MAGIC,
+            size,
+            time,
+            options.lines ? INDEX_LINES : 0,
+            (uint64_t) index.nodes.size(),
+            (uint64_t) index.words.size(),
+            (uint64_t) index.records.size(),
+        };
+        return WriteIndex(IndexPath(path), header, index);
+    }
+
+    /**
+     * This contains the private properties of an IndexedFile instance.
+     */
+    struct IndexedFile::Impl {
+        /**
+         * This is the file.
+         */
+        MappedFile file;
+
+        /**
+         * This is the index of the file.
+         */
+        MappedFile index;
+
+        /**
+         * This indicates whether the file holds newline-delimited
+         * records.
+         */
+        bool lines = false;
+
+        /**
+         * This is the number of nodes in the index.
+         */
+        size_t nodeCount = 0;
+
+        /**
+         * This is the number of words in the table of children.
+         */
+        size_t wordCount = 0;
+
+        /**
+         * This is the number of records in the file.
+         */
+        size_t recordCount = 0;
+
+        /**
+         * This returns the word at the given position in the index.
+         */
+        uint64_t Word(size_t position) const {
+            uint64_t word;
+            (void) memcpy(&word, index.GetText().data() + position * sizeof(uint64_t), sizeof(word));
+            return word;
+        }
+
+        /**
+         * This returns the given word of the given node.
+         */
+        uint64_t NodeWord(
+            size_t node,
+            size_t word
+        ) const {
+            return Word(HEADER_WORDS + node * NODE_WORDS + word);
+        }
+
+        /**
+         * This returns the given word of the table of children.
+         */
+        uint64_t ChildWord(size_t word) const {
+            return Word(HEADER_WORDS + nodeCount * NODE_WORDS + word);
+        }
+
+        /**
+         * This returns the offset of the given record.
+         */
+        uint64_t RecordOffset(size_t record) const {
+            return Word(HEADER_WORDS + nodeCount * NODE_WORDS + wordCount + record);
+        }
+
+        /**
+         * This finds the node of the array or object which starts at the
+         * given offset.
+         *
+         * @return
+         *     The number of the node is returned, or nodeCount if the
+         *     value there isn't indexed.
+         */
+        size_t FindNode(uint64_t offset) const {
+            size_t low = 0;
+            size_t high = nodeCount;
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                if (NodeWord(middle, 0) < offset) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            if (
+                (low < nodeCount)
+                && (NodeWord(low, 0) == offset)
+            ) {
+                return low;
+            }
+            return nodeCount;
+        }
+
+        /**
+         * This parses the value which starts at the given offset, reading
+         * no further than the given limit.
+         */
+        Value Parse(
+            uint64_t offset,
+            size_t limit
+        ) const {
+            const auto text = file.GetText().substr(0, limit);
+            Reader reader;
+            Builder builder;
+            Reader::Token token;
+            size_t fed = (size_t) std::min(offset, (uint64_t) text.size());
+            size_t chunkSize = FIRST_PARSE_CHUNK_SIZE;
+            while (true) {
+                switch (reader.Next(token)) {
+                    case Reader::Status::Token: {
+                        if (!builder.Push(token)) {
+                            return Value();
+                        }
+                        if (builder.IsComplete()) {
+                            return builder.Take();
+                        }
+                    }
+                    break;
+
+                    case Reader::Status::NeedInput: {
+                        if (fed == text.size()) {
+                            reader.Finish();
+                        } else {
+                            const auto chunk = std::min(chunkSize, text.size() - fed);
+                            reader.Feed(text.substr(fed, chunk));
+                            fed += chunk;
+                            chunkSize = std::min(chunkSize * 2, INDEX_CHUNK_SIZE);
+                        }
+                    }
+                    break;
+
+                    default: return Value();
+                }
+            }
+        }
+
+        /**
+         * This finds the member with the given key in the object at the
+         * given node.
+         *
+         * @param[in] node
+         *     This is the node of the object.
+         *
+         * @param[in] key
+         *     This is the key of the member to find.
+         *
+         * @param[out] offset
+         *     This is where to store the offset of the member's value.
+         *
+         * @return
+         *     An indication of whether the member was found is returned.
+         */
+        bool FindMember(
+            size_t node,
+            const std::string &key,
+            uint64_t &offset
+        ) const {
+            const auto hash = HashKey(key);
+            const auto firstWord = (size_t) NodeWord(node, 1);
+            size_t low = 0;
+            size_t high = (size_t) NodeWord(node, 2);
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                if (ChildWord(firstWord + middle * 2) <= hash) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+
+            // Check the members with the same hash, last first, since
+            // the last of members with the same key is the one kept.
+            const auto text = file.GetText();
+            std::string decoded;
+            while (
+                (low > 0)
+                && (ChildWord(firstWord + (low - 1) * 2) == hash)
+            ) {
+                --low;
+                const auto keyOffset = (size_t) ChildWord(firstWord + low * 2 + 1);
+                Reader reader;
+                Reader::Token token;
+                reader.Feed(text.substr(keyOffset, std::min(text.size() - keyOffset, key.size() * 6 + 2)));
+                reader.Finish();
+                if (
+                    (reader.Next(token) != Reader::Status::Token)
+                    || (token.type != Reader::TokenType::String)
+                ) {
+                    continue;
+                }
+                decoded.clear();
+                if (
+                    !Reader::DecodeString(token.text, decoded)
+                    || (decoded != key)
+                ) {
+                    continue;
+                }
+                const auto colon = text.find(':', keyOffset + token.text.size() + 2);
+                if (colon == std::string_view::npos) {
+                    return false;
+                }
+                const auto value = text.find_first_not_of(" \t\r\n", colon + 1);
+                if (value == std::string_view::npos) {
+                    return false;
+                }
+                offset = value;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * This finds and parses the value at the given reference tokens
+         * within the value at the given offset, which extends no further
+         * than the given limit.
+         */
+        Value Resolve(
+            uint64_t offset,
+            size_t limit,
+            const std::vector<std::string> &tokens,
+            size_t firstToken
+        ) const {
+            for (size_t i = firstToken; i < tokens.size(); ++i) {
+                const auto node = FindNode(offset);
+                if (node == nodeCount) {
+                    // The value isn't indexed, so it's small enough to
+                    // parse whole.
+                    const auto value = Parse(offset, limit);
+                    const auto found = value.Find(
+                        Pointer::FromTokens(
+                            std::vector<std::string>(tokens.begin() + (ptrdiff_t) i, tokens.end())
+                        )
+                    );
+                    return (found == nullptr) ? Value() : *found;
+                }
+                if (NodeWord(node, 3) & NODE_OBJECT) {
+                    if (!FindMember(node, tokens[i], offset)) {
+                        return Value();
+                    }
+                } else {
+                    size_t index = 0;
+                    if (
+                        !Pointer::ParseIndex(tokens[i], index)
+                        || (index >= NodeWord(node, 2))
+                    ) {
+                        return Value();
+                    }
+                    offset = ChildWord((size_t) NodeWord(node, 1) + index);
+                }
+            }
+            return Parse(offset, limit);
+        }
+
+        /**
+         * This returns the offset just past the end of the line of the
+         * given record.
+         */
+        size_t RecordEnd(uint64_t offset) const {
+            const auto text = file.GetText();
+            const auto end = text.find('\n', (size_t) offset);
+            return (end == std::string_view::npos) ? text.size() : end;
+        }
+    };
+
+    IndexedFile::~IndexedFile() noexcept = default;
+    IndexedFile::IndexedFile(IndexedFile &&) noexcept = default;
+    IndexedFile &IndexedFile::operator=(IndexedFile &&) noexcept = default;
+
+    IndexedFile::IndexedFile()
+        : impl_(new Impl) {
+    }
+
+    bool IndexedFile::Open(const std::string &path) {
+        impl_.reset(new Impl);
+        uint64_t size = 0;
+        uint64_t time = 0;
+        if (
+            !GetFileStamp(path, size, time)
+            || !impl_->index.Open(IndexPath(path))
+            || (impl_->index.GetText().size() < HEADER_WORDS * sizeof(uint64_t))
+            || (impl_->Word(0) != INDEX_MAGIC)
+            || (impl_->Word(1) != size)
+            || (impl_->Word(2) != time)
+        ) {
+            impl_.reset(new Impl);
+            return false;
+        }
+        impl_->lines = ((impl_->Word(3) & INDEX_LINES) != 0);
+        impl_->nodeCount = (size_t) impl_->Word(4);
+        impl_->wordCount = (size_t) impl_->Word(5);
+        impl_->recordCount = (size_t) impl_->Word(6);
+        const auto expectedWords = (
+            HEADER_WORDS
+            + impl_->nodeCount * NODE_WORDS
+            + impl_->wordCount
+            + impl_->recordCount
+        );
+        if (
+            (impl_->index.GetText().size() != expectedWords * sizeof(uint64_t))
+            || !impl_->file.Open(path)
+            || (impl_->file.GetText().size() != size)
+        ) {
+            impl_.reset(new Impl);
+            return false;
+        }
+        return true;
+    }
+
+    bool IndexedFile::IsOpen() const {
+        return (impl_->index.GetText().size() > 0);
+    }
+
+    size_t IndexedFile::GetRecordCount() const {
+        return impl_->recordCount;
+    }
+
+    Value IndexedFile::Get(const Pointer &pointer) const {
+        if (
+            !IsOpen()
+            || !pointer.IsValid()
+        ) {
+            return Value();
+        }
+        const auto &tokens = pointer.GetTokens();
+        const auto text = impl_->file.GetText();
+        if (!impl_->lines) {
+            const auto root = std::min(text.find_first_not_of(" \t\r\n"), text.size());
+            return impl_->Resolve(root, text.size(), tokens, 0);
+        }
+        if (tokens.empty()) {
+            return Value();
+        }
+        size_t record = 0;
+        if (
+            !Pointer::ParseIndex(tokens[0], record)
+            || (record >= impl_->recordCount)
+        ) {
+            return Value();
+        }
+        const auto offset = impl_->RecordOffset(record);
+        return impl_->Resolve(offset, impl_->RecordEnd(offset), tokens, 1);
+    }
+
+    Value IndexedFile::GetRecord(size_t index) const {
+        if (
+            !IsOpen()
+            || !impl_->lines
+            || (index >= impl_->recordCount)
+        ) {
+            return Value();
+        }
+        const auto offset = impl_->RecordOffset(index);
+        return impl_->Parse(offset, impl_->RecordEnd(offset));
+    }
+}
@@ -0,0 +1,552 @@
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <journaled-document.h>
+#include <map>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /**
+     * This is appended to the path of a document, followed by the
+     * generation number, to name its snapshots.
+     */
+    constexpr std::string_view SNAPSHOT_SUFFIX = ".snapshot.";
+
+    /**
+     * This is appended to the path of a document, followed by the
+     * generation number, to name its journals.
+     */
+    constexpr std::string_view JOURNAL_SUFFIX = ".journal.";
+
+    /**
+     * These are the files of a document, by generation number.
+     */
+    struct DocumentFiles {
+        std::map<uint64_t, std::filesystem::path> snapshots;
+        std::map<uint64_t, std::filesystem::path> journals;
+    };
+
+    /**
+     * This flushes the given file's contents to its storage device.
+     *
+     * @return
+     *     An indication of whether or not the contents were flushed
+     *     is returned.
+     */
+    bool SyncFile(FILE *file) {
+#ifdef _WIN32
+        return (_commit(_fileno(file)) == 0);
+#else
+        return (fsync(fileno(file)) == 0);
+#endif
+    }
+
+    /**
+     * This flushes the entries of the given directory to its storage
+     * device, so that a file created in it stays there after a crash.
+     * Windows has no equivalent, and needs none.
+     */
+    void SyncDirectory(const std::filesystem::path &directory) {
+#ifndef _WIN32
+        const auto fd = open(
+            (directory.empty() ? "." : directory.c_str()),
+            O_RDONLY
+        );
+        if (fd >= 0) {
+            (void) fsync(fd);
+            (void) close(fd);
+        }
+#else
+        (void) directory;
+#endif
+    }
+
+    /**
+     * This returns the name of the given file of a document.
+     */
+    std::string FilePath(
+        const std::string &path,
+        std::string_view suffix,
+        uint64_t generation
+    ) {
+        return path + std::string(suffix) + std::to_string(generation);
+    }
+
+    /**
+     * This finds the snapshots and journals of the document with the
+     * given path.
+     */
+    DocumentFiles FindFiles(const std::string &path) {
+        DocumentFiles files;
+        const std::filesystem::path documentPath(path);
+        const auto directory = documentPath.parent_path();
+        const auto name = documentPath.filename().string();
+        std::error_code error;
+        for (
+            std::filesystem::directory_iterator entry(
+                (directory.empty() ? std::filesystem::path(".") : directory),
+                error
+            ), end;
+            !error && (entry != end);
+            entry.increment(error)
+        ) {
+            const auto fileName = entry->path().filename().string();
+            if (fileName.compare(0, name.size(), name) != 0) {
+                continue;
+            }
+            const auto rest = std::string_view(fileName).substr(name.size());
+            for (const auto suffix: {SNAPSHOT_SUFFIX, JOURNAL_SUFFIX}) {
+                if (rest.substr(0, suffix.size()) != suffix) {
+                    continue;
+                }
+                const auto number = rest.substr(suffix.size());
+                uint64_t generation;
+                const auto result = std::from_chars(number.data(), number.data() + number.size(), generation);
+                if (
+                    number.empty()
+                    || (result.ec != std::errc())
+                    || (result.ptr != number.data() + number.size())
+                ) {
+                    continue;
+                }
+                auto &found = ((suffix == SNAPSHOT_SUFFIX) ? files.snapshots : files.journals);
+                found[generation] = documentPath.parent_path() / fileName;
+            }
+        }
+        return files;
+    }
+
+    /**
+     * This applies the patches in the given journal to the given value.
+     *
+     * @param[in] path
+     *     This is the path of the journal.
+     *
+     * @param[in,out] value
+     *     This is the value to which to apply the patches.
+     *
+     * @return
+     *     An indication of whether or not the journal was applied is
+     *     returned.  A last line which doesn't end in a newline was cut
+     *     short, and is ignored, but any other line which isn't a valid
+     *     patch fails the whole journal.
+     */
+    bool ReplayJournal(
+        const std::filesystem::path &path,
+        Json::Value &value
+    ) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (file.eof()) {
+                break;
+            }
+            if (line.empty()) {
+                continue;
+            }
+            if (!value.ApplyPatch(Json::Value::FromEncoding(line))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * This reads the value a document had at the end of the journal of
+     * the given generation, from the latest snapshot up to then and the
+     * journals written after it.
+     *
+     * @param[in] files
+     *     These are the files of the document.
+     *
+     * @param[in] generation
+     *     This is the generation of the last journal to apply.
+     *
+     * @param[out] value
+     *     This is where to store the value.
+     *
+     * @return
+     *     An indication of whether or not the value was read is
+     *     returned.
+     */
+    bool LoadValue(
+        const DocumentFiles &files,
+        uint64_t generation,
+        Json::Value &value
+    ) {
+        uint64_t first = 0;
+        auto snapshot = files.snapshots.upper_bound(generation);
+        if (snapshot == files.snapshots.begin()) {
+            value = Json::Value(Json::Value::Type::Object);
+        } else {
+            --snapshot;
+            first = snapshot->first;
+            std::ifstream file(snapshot->second, std::ios::binary);
+            value = Json::Value::Read(file);
+            if (value.GetType() == Json::Value::Type::Invalid) {
+                return false;
+            }
+        }
+        for (
+            auto journal = files.journals.lower_bound(first);
+            (journal != files.journals.end()) && (journal->first <= generation);
+            ++journal
+        ) {
+            if (!ReplayJournal(journal->second, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+namespace Json {
+    /**
+     * This contains the private properties of a JournaledDocument
+     * instance.
+     */
+    struct JournaledDocument::Impl {
+        /**
+         * This is the path after which the document's files are named.
+         */
+        std::string path;
+
+        /**
+         * These are the options given when the document was opened.
+         */
+        JournalOptions options;
+
+        /**
+         * This is the document's value.
+         */
+        Value value;
+
+        /**
+         * This indicates whether a document is open.
+         */
+        bool open = false;
+
+        /**
+         * This is the generation of the journal being written.
+         */
+        uint64_t generation = 0;
+
+        /**
+         * This is the journal being written, if it has been created.
+         */
+        FILE *journal = nullptr;
+
+        /**
+         * This is the number of bytes of journal written since the last
+         * snapshot was started.
+         */
+        size_t journalSize = 0;
+
+        /**
+         * This is the thread writing a snapshot, if one has been started.
+         */
+        std::thread compaction;
+
+        /**
+         * This indicates whether the snapshot thread is still writing.
+         */
+        std::atomic<bool> compacting = false;
+
+        /**
+         * This indicates whether a commit could neither be appended to
+         * the journal nor written as a snapshot.  The journal may then
+         * end in part of a line, so nothing more is committed until a
+         * snapshot is written.
+         */
+        bool failed = false;
+
+        ~Impl() noexcept {
+            WaitForCompaction();
+            CloseJournal();
+        }
+
+        /**
+         * This function closes the journal being written, if any.
+         */
+        void CloseJournal() {
+            if (journal != nullptr) {
+                (void) fclose(journal);
+                journal = nullptr;
+            }
+        }
+
+        /**
+         * This function waits for the snapshot thread, if any, to finish.
+         */
+        void WaitForCompaction() {
+            if (compaction.joinable()) {
+                compaction.join();
+            }
+        }
+
+        /**
+         * This function writes the given value as the snapshot of the
+         * given generation, and then removes the files it replaces.
+         *
+         * @param[in] path
+         *     This is the path after which the document's files are
+         *     named.
+         *
+         * @param[in] snapshot
+         *     This is the value to write.
+         *
+         * @param[in] generation
+         *     This is the generation of the snapshot.
+         *
+         * @param[in] sync
+         *     This indicates whether to flush the snapshot to the
+         *     storage device.
+         *
+         * @return
+         *     An indication of whether or not the snapshot was written
+         *     is returned.
+         */
+        static bool WriteSnapshot(
+            const std::string &path,
+            const Value &snapshot,
+            uint64_t generation,
+            bool sync
+        ) {
+            WriteOptions writeOptions;
+            writeOptions.sync = sync;
+            if (!snapshot.ToFile(FilePath(path, SNAPSHOT_SUFFIX, generation), EncodingOptions(), writeOptions)) {
+                return false;
+            }
+            const auto files = FindFiles(path);
+            std::error_code error;
+            for (const auto *found: {&files.snapshots, &files.journals}) {
+                for (const auto &file: *found) {
+                    if (file.first < generation) {
+                        (void) std::filesystem::remove(file.second, error);
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This function writes a snapshot of the value for the next
+         * generation, and begins that generation's journal.
+         *
+         * In the background, the snapshot is read back from the files
+         * written up to the journal being closed, so the value needn't
+         * be copied, and commits go on meanwhile.  Otherwise, the value
+         * as it is now, including any changes not committed, is written,
+         * and the next generation is only begun once it's written.
+         *
+         * @param[in] background
+         *     This indicates whether to write the snapshot on another
+         *     thread, rather than waiting for it.
+         *
+         * @return
+         *     An indication of whether or not the snapshot was written,
+         *     or started, is returned.
+         */
+        bool StartCompaction(bool background) {
+            WaitForCompaction();
+            CloseJournal();
+            if (!background) {
+                if (!WriteSnapshot(path, value, generation + 1, options.sync)) {
+                    return false;
+                }
+                ++generation;
+                journalSize = 0;
+                (void) value.TakeChanges();
+                failed = false;
+                return true;
+            }
+            const auto last = generation++;
+            journalSize = 0;
+            compacting = true;
+            compaction = std::thread(
+                [this, last]{
+                    Value snapshot;
+                    if (LoadValue(FindFiles(path), last, snapshot)) {
+                        (void) WriteSnapshot(path, snapshot, last + 1, options.sync);
+                    }
+                    compacting = false;
+                }
+            );
+            return true;
+        }
+
+        /**
+         * This function appends the given text to the journal being
+         * written, creating it if need be.
+         *
+         * @param[in] text
+         *     This is the text to append.
+         *
+         * @return
+         *     An indication of whether or not the text was written is
+         *     returned.
+         */
+        bool AppendToJournal(const std::string &text) {
+            if (journal == nullptr) {
+                const auto journalPath = FilePath(path, JOURNAL_SUFFIX, generation);
+                journal = fopen(journalPath.c_str(), "ab");
+                if (journal == nullptr) {
+                    return false;
+                }
+                if (options.sync) {
+                    SyncDirectory(std::filesystem::path(journalPath).parent_path());
+                }
+            }
+            return (
+                (fwrite(text.data(), 1, text.size(), journal) == text.size())
+                && (fflush(journal) == 0)
+                && (
+                    !options.sync
+                    || SyncFile(journal)
+                )
+            );
+        }
+    };
+
+    JournaledDocument::~JournaledDocument() noexcept {
+        Close();
+    }
+
+    JournaledDocument::JournaledDocument(JournaledDocument &&) noexcept = default;
+
+    JournaledDocument &JournaledDocument::operator=(JournaledDocument &&other) noexcept {
+        if (this != &other) {
+            Close();
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    JournaledDocument::JournaledDocument()
+        : impl_(new Impl) {
+    }
+
+    bool JournaledDocument::Open(
+        const std::string &path,
+        const JournalOptions &options
+    ) {
+        Close();
+        impl_.reset(new Impl);
+        impl_->path = path;
+        impl_->options = options;
+        const auto files = FindFiles(path);
+        if (!LoadValue(files, UINT64_MAX, impl_->value)) {
+            impl_.reset(new Impl);
+            return false;
+        }
+        uint64_t generation = 0;
+        if (!files.snapshots.empty()) {
+            generation = files.snapshots.rbegin()->first;
+        }
+        if (
+            !files.journals.empty()
+            && (files.journals.rbegin()->first >= generation)
+        ) {
+            generation = files.journals.rbegin()->first + 1;
+        }
+        impl_->generation = generation;
+        impl_->value.BeginTracking();
+        impl_->open = true;
+        return true;
+    }
+
+    bool JournaledDocument::IsOpen() const {
+        return (
+            (impl_ != nullptr)
+            && impl_->open
+        );
+    }
+
+    Value &JournaledDocument::GetValue() {
+        if (impl_ == nullptr) {
+            // The document was moved from, and has no value left.
+            impl_.reset(new Impl);
+        }
+        return impl_->value;
+    }
+
+    const Value &JournaledDocument::GetValue() const {
+        if (impl_ == nullptr) {
+            static const Value none;
+            return none;
+        }
+        return impl_->value;
+    }
+
+    bool JournaledDocument::Commit() {
+        if (
+            !IsOpen()
+            || impl_->failed
+        ) {
+            return false;
+        }
+        const auto changes = impl_->value.TakeChanges();
+        if (changes.GetSize() == 0) {
+            return true;
+        }
+        const auto line = changes.ToEncoding() + "\n";
+        if (!impl_->AppendToJournal(line)) {
+            // The journal may now end in part of the line, so it's left
+            // behind, and a snapshot holding the changes replaces it.
+            // The changes stay in the value if that fails too, for
+            // Compact() to write them.
+            if (!impl_->StartCompaction(false)) {
+                impl_->failed = true;
+                return false;
+            }
+            return true;
+        }
+        impl_->journalSize += line.size();
+        if (
+            (impl_->journalSize >= impl_->options.compactionThreshold)
+            && !impl_->compacting
+        ) {
+            return impl_->StartCompaction(true);
+        }
+        return true;
+    }
+
+    bool JournaledDocument::Compact() {
+        if (!IsOpen()) {
+            return false;
+        }
+        (void) Commit();
+        return impl_->StartCompaction(false);
+    }
+
+    void JournaledDocument::Close() {
+        if (!IsOpen()) {
+            return;
+        }
+        if (impl_->failed) {
+            (void) impl_->StartCompaction(false);
+        } else {
+            (void) Commit();
+        }
+        impl_->WaitForCompaction();
+        impl_->CloseJournal();
+        impl_->open = false;
+    }
+}
@@ -0,0 +1,8 @@
+#include <key-set.h>
+
+namespace Json {
+    namespace Detail {
+        void InvalidKeySet(const char *) {
+        }
+    }
+}
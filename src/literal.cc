@@ -0,0 +1,87 @@
+#include <literal.h>
+#include <string>
+#include <vector>
+
+namespace Json {
+    namespace Detail {
+        void InvalidJsonLiteral(const char *) {
+        }
+
+        Value BuildLiteral(
+            const LiteralToken *tokens,
+            size_t numTokens,
+            const char *pool
+        ) {
+            Value root;
+            std::vector<Value *> containers;
+            std::string key;
+            for (size_t i = 0; i < numTokens; ++i) {
+                const auto &token = tokens[i];
+                Value value;
+                switch (token.kind) {
+                    case LiteralTokenKind::EndArray:
+                    case LiteralTokenKind::EndObject: {
+                        containers.pop_back();
+                    }
+                    continue;
+
+                    case LiteralTokenKind::Key: {
+                        key.assign(pool + token.stringOffset, token.stringLength);
+                    }
+                    continue;
+
+                    case LiteralTokenKind::BeginArray: {
+                        value = Value(Value::Type::Array);
+                    }
+                    break;
+
+                    case LiteralTokenKind::BeginObject: {
+                        value = Value(Value::Type::Object);
+                    }
+                    break;
+
+                    case LiteralTokenKind::Null: {
+                        value = nullptr;
+                    }
+                    break;
+
+                    case LiteralTokenKind::Boolean: {
+                        value = token.booleanValue;
+                    }
+                    break;
+
+                    case LiteralTokenKind::Integer: {
+                        value = token.integerValue;
+                    }
+                    break;
+
+                    case LiteralTokenKind::FloatingPoint: {
+                        value = token.floatingPointValue;
+                    }
+                    break;
+
+                    case LiteralTokenKind::String: {
+                        value = std::string(pool + token.stringOffset, token.stringLength);
+                    }
+                    break;
+                }
+                Value *placed;
+                if (containers.empty()) {
+                    root = std::move(value);
+                    placed = &root;
+                } else if (containers.back()->GetType() == Value::Type::Array) {
+                    placed = &containers.back()->Add(std::move(value));
+                } else {
+                    placed = &containers.back()->Set(key, std::move(value));
+                }
+                if (
+                    (token.kind == LiteralTokenKind::BeginArray)
+                    || (token.kind == LiteralTokenKind::BeginObject)
+                ) {
+                    containers.push_back(placed);
+                }
+            }
+            return root;
+        }
+    }
+}
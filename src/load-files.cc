@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <load-files.h>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef JSONKIT_CUSTOM_TRAITS_HEADER
+#include JSONKIT_CUSTOM_TRAITS_HEADER
+#endif
+
+namespace {
+    /**
+     * This reads the whole of the given file into the given buffer,
+     * reusing the buffer's memory where possible.
+     *
+     * @param[in] path
+     *     This is the path of the file to read.
+     *
+     * @param[out] buffer
+     *     This is where to store the contents of the file.
+     *
+     * @return
+     *     An indication of whether or not the file was read is returned.
+     */
+    bool ReadFile(
+        const std::string &path,
+        std::string &buffer
+    ) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        buffer.clear();
+        if (!error) {
+            buffer.resize((size_t) size);
+            (void) file.read(buffer.data(), (std::streamsize) buffer.size());
+            buffer.resize((size_t) file.gcount());
+        }
+
+        // Take anything past the size reported, in case the file grew,
+        // or its size couldn't be determined.
+        char chunk[4096];
+        while (file.read(chunk, sizeof(chunk)) || (file.gcount() > 0)) {
+            buffer.append(chunk, (size_t) file.gcount());
+        }
+        return !file.bad();
+    }
+}
+
+namespace Json {
+    template<typename Traits>
+    std::vector<BasicValue<Traits>> LoadFiles(
+        std::span<const std::string> paths,
+        const LoadOptions &options
+    ) {
+        std::vector<BasicValue<Traits>> values(paths.size());
+        if (paths.empty()) {
+            return values;
+        }
+        const auto readThreads = std::clamp(options.readThreads, (size_t) 1, paths.size());
+        auto parseThreads = options.parseThreads;
+        if (parseThreads == 0) {
+            parseThreads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        parseThreads = std::min(parseThreads, paths.size());
+
+        // Every buffer is either free, being read into, waiting to be
+        // parsed, or being parsed, so the number of buffers bounds the
+        // memory held by file contents.
+        std::mutex mutex;
+        std::condition_variable bufferFreed;
+        std::condition_variable fileRead;
+        std::vector<std::string> freeBuffers(std::max(options.maxPendingFiles, (size_t) 1));
+        std::deque<std::pair<size_t, std::string>> readFiles;
+        size_t readersLeft = readThreads;
+        std::atomic<size_t> nextPath{0};
+        const auto read = [&]{
+            while (true) {
+                const auto index = nextPath++;
+                if (index >= paths.size()) {
+                    break;
+                }
+                std::string buffer;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    bufferFreed.wait(lock, [&]{ return !freeBuffers.empty(); });
+                    buffer = std::move(freeBuffers.back());
+                    freeBuffers.pop_back();
+                }
+                if (ReadFile(paths[index], buffer)) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        readFiles.emplace_back(index, std::move(buffer));
+                    }
+                    fileRead.notify_one();
+                } else {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        freeBuffers.push_back(std::move(buffer));
+                    }
+                    bufferFreed.notify_one();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --readersLeft;
+            }
+            fileRead.notify_all();
+        };
+        const auto parse = [&]{
+            while (true) {
+                std::pair<size_t, std::string> file;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    fileRead.wait(
+                        lock,
+                        [&]{
+                            return (
+                                !readFiles.empty()
+                                || (readersLeft == 0)
+                            );
+                        }
+                    );
+                    if (readFiles.empty()) {
+                        break;
+                    }
+                    file = std::move(readFiles.front());
+                    readFiles.pop_front();
+                }
+                values[file.first] = BasicValue<Traits>::FromEncoding(file.second);
+                file.second.clear();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    freeBuffers.push_back(std::move(file.second));
+                }
+                bufferFreed.notify_one();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < readThreads; ++i) {
+            threads.emplace_back(read);
+        }
+        for (size_t i = 0; i < parseThreads; ++i) {
+            threads.emplace_back(parse);
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        return values;
+    }
+
+    template std::vector<BasicValue<DefaultTraits>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+    template std::vector<BasicValue<CompactTraits>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+    template std::vector<BasicValue<HashedTraits>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+    template std::vector<BasicValue<EditableTraits>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+    template std::vector<BasicValue<TieredTraits>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+
+#ifdef JSONKIT_CUSTOM_TRAITS
+    template std::vector<BasicValue<JSONKIT_CUSTOM_TRAITS>> LoadFiles(std::span<const std::string>, const LoadOptions &);
+#endif
+}
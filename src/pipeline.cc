@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <pipeline.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    /**
+     * This is the size of the buffer through which WriteFile() writes.
+     */
+    constexpr size_t FILE_BUFFER_SIZE = 1048576;
+
+    /**
+     * This is a group of records passed from one stage to the next.
+     */
+    struct Batch {
+        /**
+         * This is the position of the batch in the input.
+         */
+        size_t sequence = 0;
+
+        /**
+         * These are the records as lines of text, before Parse() and
+         * after Encode().
+         */
+        std::vector<std::string> lines;
+
+        /**
+         * These are the records as values, after Parse() and before
+         * Encode().
+         */
+        std::vector<Json::Value> values;
+    };
+
+    /**
+     * This is a queue of batches between stages, which makes producers
+     * wait while it's full and consumers wait while it's empty.
+     */
+    class BatchQueue {
+    public:
+        /**
+         * This constructs the queue.
+         *
+         * @param[in] capacity
+         *     This is the number of batches the queue can hold.
+         *
+         * @param[in] producers
+         *     This is the number of threads which push batches; once each
+         *     has called Close(), consumers find the queue exhausted.
+         */
+        BatchQueue(
+            size_t capacity,
+            size_t producers
+        )
+            : capacity(std::max(capacity, (size_t) 1))
+              , producers(producers) {
+        }
+
+        /**
+         * This adds a batch to the queue, waiting for room if needed.
+         */
+        void Push(Batch &&batch) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [this]{ return (batches.size() < capacity); });
+                batches.push_back(std::move(batch));
+            }
+            notEmpty.notify_one();
+        }
+
+        /**
+         * This takes a batch from the queue, waiting for one if needed.
+         *
+         * @return
+         *     An indication of whether a batch was taken, rather than the
+         *     queue being exhausted, is returned.
+         */
+        bool Pop(Batch &batch) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(
+                    lock,
+                    [this]{
+                        return (
+                            !batches.empty()
+                            || (producers == 0)
+                        );
+                    }
+                );
+                if (batches.empty()) {
+                    return false;
+                }
+                batch = std::move(batches.front());
+                batches.pop_front();
+            }
+            notFull.notify_one();
+            return true;
+        }
+
+        /**
+         * This is called by each producer once it will push no more.
+         */
+        void Close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --producers;
+            }
+            notEmpty.notify_all();
+        }
+
+    private:
+        /**
+         * This is the number of batches the queue can hold.
+         */
+        const size_t capacity;
+
+        /**
+         * This is the number of producers which haven't closed the queue.
+         */
+        size_t producers;
+
+        /**
+         * These are the batches waiting to be taken.
+         */
+        std::deque<Batch> batches;
+
+        /**
+         * This synchronizes access to the queue.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is notified when a batch is taken.
+         */
+        std::condition_variable notFull;
+
+        /**
+         * This is notified when a batch is added or a producer closes.
+         */
+        std::condition_variable notEmpty;
+    };
+
+    /**
+     * This function returns the number of threads to use for a stage.
+     */
+    size_t ThreadCount(size_t requested) {
+        if (requested == 0) {
+            return std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        return requested;
+    }
+
+    /**
+     * This function determines whether the given line holds anything
+     * other than whitespace.
+     */
+    bool IsBlank(std::string_view line) {
+        return (line.find_first_not_of(" \t\r") == std::string_view::npos);
+    }
+}
+
+namespace Json {
+    Pipeline::Pipeline(const PipelineOptions &options)
+        : options(options) {
+    }
+
+    Pipeline &Pipeline::ReadLines(std::istream &input) {
+        this->input = &input;
+        hasSource = true;
+        return *this;
+    }
+
+    Pipeline &Pipeline::ReadLines(std::string_view text) {
+        input = nullptr;
+        this->text = text;
+        hasSource = true;
+        return *this;
+    }
+
+    Pipeline &Pipeline::Parse(size_t threads) {
+        Stage stage;
+        stage.kind = StageKind::Parse;
+        stage.threads = ThreadCount(threads);
+        stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    Pipeline &Pipeline::Transform(
+        Transformer transformer,
+        size_t threads
+    ) {
+        Stage stage;
+        stage.kind = StageKind::Transform;
+        stage.threads = ThreadCount(threads);
+        stage.transformer = std::move(transformer);
+        stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    Pipeline &Pipeline::Encode(
+        size_t threads,
+        const EncodingOptions &options
+    ) {
+        Stage stage;
+        stage.kind = StageKind::Encode;
+        stage.threads = ThreadCount(threads);
+        stage.encodingOptions = options;
+        stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    Pipeline &Pipeline::WriteLines(std::ostream &output) {
+        this->output = &output;
+        ++sinks;
+        return *this;
+    }
+
+    Pipeline &Pipeline::WriteFile(const std::string &path) {
+        outputPath = path;
+        ++sinks;
+        return *this;
+    }
+
+    Pipeline &Pipeline::ForEach(Consumer consumer) {
+        this->consumer = std::move(consumer);
+        ++sinks;
+        return *this;
+    }
+
+    PipelineResult Pipeline::Run() {
+        PipelineResult result;
+
+        // Check that each stage gets records in the form it takes.
+        if (
+            !hasSource
+            || (sinks != 1)
+        ) {
+            return result;
+        }
+        bool parsed = false;
+        for (const auto &stage: stages) {
+            if (parsed != (stage.kind != StageKind::Parse)) {
+                return result;
+            }
+            parsed = (stage.kind != StageKind::Encode);
+        }
+        if (parsed != (consumer != nullptr)) {
+            return result;
+        }
+
+        // Open the file, if that's the sink.
+        std::unique_ptr<char[]> fileBuffer;
+        std::ofstream file;
+        auto out = output;
+        if (!outputPath.empty()) {
+            fileBuffer.reset(new char[FILE_BUFFER_SIZE]);
+            (void) file.rdbuf()->pubsetbuf(fileBuffer.get(), (std::streamsize) FILE_BUFFER_SIZE);
+            file.open(outputPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return result;
+            }
+            out = &file;
+        }
+
+        // There's a queue before each stage and before the sink.  The
+        // source may only start a batch once fewer than a fixed number
+        // are between it and the sink, so that batches held back to keep
+        // them in order can't pile up without limit.
+        std::vector<std::unique_ptr<BatchQueue>> queues;
+        queues.push_back(std::make_unique<BatchQueue>(options.queueCapacity, 1));
+        size_t maxInFlight = options.queueCapacity;
+        for (const auto &stage: stages) {
+            queues.push_back(std::make_unique<BatchQueue>(options.queueCapacity, stage.threads));
+            maxInFlight += options.queueCapacity + stage.threads;
+        }
+        std::mutex inFlightMutex;
+        std::condition_variable inFlightChanged;
+        size_t inFlight = 0;
+        std::atomic<size_t> recordsInvalid{0};
+        std::atomic<size_t> recordsDropped{0};
+        const auto batchSize = std::max(options.batchSize, (size_t) 1);
+        std::vector<std::thread> threads;
+        threads.emplace_back(
+            [&]{
+                size_t sequence = 0;
+                Batch batch;
+                const auto send = [&]{
+                    {
+                        std::unique_lock<std::mutex> lock(inFlightMutex);
+                        inFlightChanged.wait(lock, [&]{ return (inFlight < maxInFlight); });
+                        ++inFlight;
+                    }
+                    result.recordsRead += batch.lines.size();
+                    batch.sequence = sequence++;
+                    queues.front()->Push(std::move(batch));
+                    batch = Batch();
+                    batch.lines.reserve(batchSize);
+                };
+                batch.lines.reserve(batchSize);
+                if (input == nullptr) {
+                    auto remaining = text;
+                    while (!remaining.empty()) {
+                        const auto end = remaining.find('\n');
+                        const auto line = remaining.substr(0, end);
+                        remaining.remove_prefix((end == std::string_view::npos) ? remaining.size() : end + 1);
+                        if (IsBlank(line)) {
+                            continue;
+                        }
+                        batch.lines.emplace_back(line);
+                        if (batch.lines.size() == batchSize) {
+                            send();
+                        }
+                    }
+                } else {
+                    std::string line;
+                    while (std::getline(*input, line)) {
+                        if (IsBlank(line)) {
+                            continue;
+                        }
+                        batch.lines.push_back(std::move(line));
+                        line.clear();
+                        if (batch.lines.size() == batchSize) {
+                            send();
+                        }
+                    }
+                }
+                if (!batch.lines.empty()) {
+                    send();
+                }
+                queues.front()->Close();
+            }
+        );
+        for (size_t i = 0; i < stages.size(); ++i) {
+            const auto &stage = stages[i];
+            auto &from = *queues[i];
+            auto &to = *queues[i + 1];
+            for (size_t j = 0; j < stage.threads; ++j) {
+                threads.emplace_back(
+                    [&]{
+                        Batch batch;
+                        while (from.Pop(batch)) {
+                            switch (stage.kind) {
+                                case StageKind::Parse: {
+                                    batch.values.reserve(batch.lines.size());
+                                    for (const auto &line: batch.lines) {
+                                        auto value = Value::FromEncoding(line);
+                                        if (value.GetType() == ValueType::Invalid) {
+                                            ++recordsInvalid;
+                                        } else {
+                                            batch.values.push_back(std::move(value));
+                                        }
+                                    }
+                                    batch.lines.clear();
+                                }
+                                break;
+
+                                case StageKind::Transform: {
+                                    const auto kept = std::remove_if(
+                                        batch.values.begin(),
+                                        batch.values.end(),
+                                        [&](Value &value){
+                                            return !stage.transformer(value);
+                                        }
+                                    );
+                                    recordsDropped += (size_t) (batch.values.end() - kept);
+                                    (void) batch.values.erase(kept, batch.values.end());
+                                }
+                                break;
+
+                                case StageKind::Encode: {
+                                    batch.lines.reserve(batch.values.size());
+                                    for (const auto &value: batch.values) {
+                                        batch.lines.push_back(value.ToEncoding(stage.encodingOptions));
+                                    }
+                                    batch.values.clear();
+                                }
+                                break;
+
+                                default: break;
+                            }
+                            to.Push(std::move(batch));
+                            batch = Batch();
+                        }
+                        to.Close();
+                    }
+                );
+            }
+        }
+
+        // The sink runs on this thread.
+        const auto sink = [&](Batch &batch){
+            if (consumer == nullptr) {
+                for (const auto &line: batch.lines) {
+                    (void) out->write(line.data(), (std::streamsize) line.size());
+                    (void) out->put('\n');
+                }
+                result.recordsWritten += batch.lines.size();
+            } else {
+                for (auto &value: batch.values) {
+                    consumer(std::move(value));
+                }
+                result.recordsWritten += batch.values.size();
+            }
+            {
+                std::lock_guard<std::mutex> lock(inFlightMutex);
+                --inFlight;
+            }
+            inFlightChanged.notify_one();
+        };
+        std::map<size_t, Batch> heldBack;
+        size_t nextSequence = 0;
+        Batch batch;
+        while (queues.back()->Pop(batch)) {
+            if (!options.preserveOrder) {
+                sink(batch);
+                continue;
+            }
+            const auto sequence = batch.sequence;
+            (void) heldBack.emplace(sequence, std::move(batch));
+            for (
+                auto next = heldBack.begin();
+                (next != heldBack.end()) && (next->first == nextSequence);
+                next = heldBack.erase(next), ++nextSequence
+            ) {
+                sink(next->second);
+            }
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        result.recordsInvalid = recordsInvalid;
+        result.recordsDropped = recordsDropped;
+        if (out != nullptr) {
+            (void) out->flush();
+            result.succeeded = !out->fail();
+        } else {
+            result.succeeded = true;
+        }
+        if (file.is_open()) {
+            file.close();
+            result.succeeded = (result.succeeded && !file.fail());
+        }
+        return result;
+    }
+}
@@ -0,0 +1,136 @@
+#include <limits>
+#include <pointer.h>
+#include <string>
+#include <utility>
+
+namespace {
+    /**
+     * This function returns the escaped form of the given reference
+     * token, as it appears in the string form of a JSON Pointer.
+     *
+     * @param[in] token
+     *     This is the reference token to escape.
+     *
+     * @return
+     *     The escaped reference token is returned.
+     */
+    std::string EscapeToken(const std::string &token) {
+        std::string escaped;
+        escaped.reserve(token.size());
+        for (const auto c: token) {
+            if (c == '~') {
+                escaped += "~0";
+            } else if (c == '/') {
+                escaped += "~1";
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+}
+
+namespace Json {
+    Pointer::Pointer(std::string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        if (text[0] != '/') {
+            valid = false;
+            return;
+        }
+        std::string token;
+        for (size_t i = 1; i <= text.size(); ++i) {
+            if (
+                (i == text.size())
+                || (text[i] == '/')
+            ) {
+                tokens.push_back(std::move(token));
+                token.clear();
+            } else if (text[i] == '~') {
+                if (
+                    (i + 1 < text.size())
+                    && (text[i + 1] == '0')
+                ) {
+                    token += '~';
+                } else if (
+                    (i + 1 < text.size())
+                    && (text[i + 1] == '1')
+                ) {
+                    token += '/';
+                } else {
+                    tokens.clear();
+                    valid = false;
+                    return;
+                }
+                ++i;
+            } else {
+                token += text[i];
+            }
+        }
+    }
+
+    Pointer Pointer::FromTokens(std::vector<std::string> tokens) {
+        Pointer pointer;
+        pointer.tokens = std::move(tokens);
+        return pointer;
+    }
+
+    bool Pointer::IsValid() const {
+        return valid;
+    }
+
+    const std::vector<std::string> &Pointer::GetTokens() const {
+        return tokens;
+    }
+
+    std::string Pointer::ToString() const {
+        std::string text;
+        for (const auto &token: tokens) {
+            text += '/';
+            text += EscapeToken(token);
+        }
+        return text;
+    }
+
+    Pointer Pointer::Append(std::string_view token) const {
+        auto pointer = *this;
+        pointer.tokens.emplace_back(token);
+        return pointer;
+    }
+
+    Pointer Pointer::Append(size_t index) const {
+        return Append(std::to_string(index));
+    }
+
+    bool Pointer::ParseIndex(
+        std::string_view token,
+        size_t &index
+    ) {
+        if (
+            token.empty()
+            || (
+                (token.size() > 1)
+                && (token[0] == '0')
+            )
+        ) {
+            return false;
+        }
+        size_t value = 0;
+        for (const auto c: token) {
+            if (
+                (c < '0')
+                || (c > '9')
+            ) {
+                return false;
+            }
+            const auto digit = (size_t) (c - '0');
+            if (value > (std::numeric_limits<size_t>::max() - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+        index = value;
+        return true;
+    }
+}
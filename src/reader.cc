@@ -0,0 +1,680 @@
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <reader.h>
+#include <utility>
+
+namespace {
+    /**
+     * These are the literal tokens, with their types.
+     */
+    struct Literal {
+        std::string_view text;
+        Json::Reader::TokenType type;
+    };
+    constexpr Literal LITERALS[] = {
+        {"true", Json::Reader::TokenType::True},
+        {"false", Json::Reader::TokenType::False},
+        {"null", Json::Reader::TokenType::Null},
+    };
+
+    /**
+     * This function returns an indication of whether or not the given
+     * character is considered "whitespace" by the JSON standard
+     * (RFC 7159).
+     */
+    bool IsWhitespace(char c) {
+        return (
+            (c == ' ')
+            || (c == '\t')
+            || (c == '\r')
+            || (c == '\n')
+        );
+    }
+
+    /**
+     * This function returns an indication of whether or not the given
+     * character can appear in a number.
+     */
+    bool IsNumberCharacter(char c) {
+        return (
+            ((c >= '0') && (c <= '9'))
+            || (c == '-')
+            || (c == '+')
+            || (c == '.')
+            || (c == 'e')
+            || (c == 'E')
+        );
+    }
+
+    /**
+     * This function checks the given text against the number grammar
+     * of RFC 7159.
+     *
+     * @param[in] text
+     *     This is the text to check.
+     *
+     * @param[out] isInteger
+     *     This is where to store whether the number has neither a
+     *     fraction nor an exponent.
+     *
+     * @return
+     *     An indication of whether or not the text is a valid number
+     *     is returned.
+     */
+    bool CheckNumber(
+        std::string_view text,
+        bool &isInteger
+    ) {
+        size_t i = 0;
+        const auto digits = [&text, &i]{
+            const auto start = i;
+            while (
+                (i < text.size())
+                && (text[i] >= '0')
+                && (text[i] <= '9')
+            ) {
+                ++i;
+            }
+            return i - start;
+        };
+        if (
+            (i < text.size())
+            && (text[i] == '-')
+        ) {
+            ++i;
+        }
+        if (
+            (i < text.size())
+            && (text[i] == '0')
+        ) {
+            ++i;
+        } else if (digits() == 0) {
+            return false;
+        }
+        isInteger = true;
+        if (
+            (i < text.size())
+            && (text[i] == '.')
+        ) {
+            ++i;
+            isInteger = false;
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        if (
+            (i < text.size())
+            && (
+                (text[i] == 'e')
+                || (text[i] == 'E')
+            )
+        ) {
+            ++i;
+            isInteger = false;
+            if (
+                (i < text.size())
+                && (
+                    (text[i] == '+')
+                    || (text[i] == '-')
+                )
+            ) {
+                ++i;
+            }
+            if (digits() == 0) {
+                return false;
+            }
+        }
+        return (i == text.size());
+    }
+
+    /**
+     * This function appends the UTF-8 encoding of the given code point
+     * to the given output.
+     */
+    void AppendUtf8(
+        std::string &output,
+        uint32_t cp
+    ) {
+        if (cp < 0x80) {
+            output += (char) cp;
+        } else if (cp < 0x800) {
+            output += (char) (0xC0 | (cp >> 6));
+            output += (char) (0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            output += (char) (0xE0 | (cp >> 12));
+            output += (char) (0x80 | ((cp >> 6) & 0x3F));
+            output += (char) (0x80 | (cp & 0x3F));
+        } else {
+            output += (char) (0xF0 | (cp >> 18));
+            output += (char) (0x80 | ((cp >> 12) & 0x3F));
+            output += (char) (0x80 | ((cp >> 6) & 0x3F));
+            output += (char) (0x80 | (cp & 0x3F));
+        }
+    }
+
+    /**
+     * This function decodes the four hex digits at the given position
+     * of the given text.
+     *
+     * @return
+     *     An indication of whether or not there were four hex digits
+     *     is returned.
+     */
+    bool DecodeFourHexDigits(
+        std::string_view text,
+        size_t offset,
+        uint32_t &cp
+    ) {
+        if (offset + 4 > text.size()) {
+            return false;
+        }
+        cp = 0;
+        for (size_t i = offset; i < offset + 4; ++i) {
+            const auto c = text[i];
+            cp <<= 4;
+            if (
+                (c >= '0')
+                && (c <= '9')
+            ) {
+                cp += (uint32_t) (c - '0');
+            } else if (
+                (c >= 'A')
+                && (c <= 'F')
+            ) {
+                cp += (uint32_t) (c - 'A' + 10);
+            } else if (
+                (c >= 'a')
+                && (c <= 'f')
+            ) {
+                cp += (uint32_t) (c - 'a' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * This function indicates whether the number with the given text,
+     * which std::from_chars found out of range, is too large to hold,
+     * rather than too small.  It compares the power of ten of the
+     * number's first significant digit with zero.
+     *
+     * @param[in] text
+     *     This is the text of the number, checked to be valid JSON.
+     *
+     * @return
+     *     An indication of whether the number is too large is returned.
+     */
+    bool IsTooLarge(std::string_view text) {
+        size_t i = ((!text.empty() && (text[0] == '-')) ? 1 : 0);
+        intmax_t magnitude = 0;
+        bool significant = false;
+        const auto isDigit = [&]{
+            return (
+                (i < text.size())
+                && (text[i] >= '0')
+                && (text[i] <= '9')
+            );
+        };
+        for (; isDigit(); ++i) {
+            if (
+                significant
+                || (text[i] != '0')
+            ) {
+                significant = true;
+                ++magnitude;
+            }
+        }
+        if (
+            (i < text.size())
+            && (text[i] == '.')
+        ) {
+            for (++i; isDigit(); ++i) {
+                if (!significant) {
+                    if (text[i] == '0') {
+                        --magnitude;
+                    } else {
+                        significant = true;
+                    }
+                }
+            }
+        }
+        if (
+            (i >= text.size())
+            || ((text[i] != 'e') && (text[i] != 'E'))
+        ) {
+            return (magnitude > 0);
+        }
+        ++i;
+        bool negativeExponent = false;
+        if (
+            (i < text.size())
+            && ((text[i] == '+') || (text[i] == '-'))
+        ) {
+            negativeExponent = (text[i] == '-');
+            ++i;
+        }
+        intmax_t exponent = 0;
+        const auto end = text.data() + text.size();
+        if (std::from_chars(text.data() + i, end, exponent).ec != std::errc()) {
+            // An exponent this large settles the question by itself.
+            return !negativeExponent;
+        }
+        return ((negativeExponent ? (magnitude - exponent) : (magnitude + exponent)) > 0);
+    }
+}
+
+namespace Json {
+    Reader::Reader(
+        bool multipleValues,
+        bool trailingCommas
+    )
+        : multipleValues(multipleValues)
+          , trailingCommas(trailingCommas) {
+    }
+
+    void Reader::Feed(std::string_view chunk) {
+        buffer.erase(0, position);
+        bufferOffset += position;
+        position = 0;
+        buffer.append(chunk);
+    }
+
+    void Reader::Finish() {
+        finished = true;
+    }
+
+    auto Reader::Next(Token &token) -> Status {
+        return Scan(token);
+    }
+
+    auto Reader::Skip() -> Status {
+        if (!skipping) {
+            skipping = true;
+            skipDepth = containers.size();
+        }
+        Token token;
+        while (true) {
+            const auto status = Scan(token);
+            if (status != Status::Token) {
+                if (status != Status::NeedInput) {
+                    skipping = false;
+                }
+                return status;
+            }
+            if (
+                (token.type != TokenType::Key)
+                && (containers.size() <= skipDepth)
+            ) {
+                skipping = false;
+                return Status::Token;
+            }
+        }
+    }
+
+    size_t Reader::GetDepth() const {
+        return containers.size();
+    }
+
+    size_t Reader::GetOffset() const {
+        return bufferOffset + position;
+    }
+
+    std::string_view Reader::GetUnread() const {
+        return std::string_view(buffer).substr(position);
+    }
+
+    bool Reader::IsComplete() const {
+        return (expect == Expect::Nothing);
+    }
+
+    void Reader::Reset() {
+        // Keep the memory of the buffer and container stack, since a
+        // reader is often reset to read many small inputs in turn.
+        auto oldBuffer = std::move(buffer);
+        auto oldContainers = std::move(containers);
+        *this = Reader(multipleValues, trailingCommas);
+        oldBuffer.clear();
+        oldContainers.clear();
+        buffer = std::move(oldBuffer);
+        containers = std::move(oldContainers);
+    }
+
+    bool Reader::DecodeString(
+        std::string_view text,
+        std::string &output
+    ) {
+        size_t offset = 0;
+        while (offset < text.size()) {
+            const auto escape = text.find('\\', offset);
+            if (escape == std::string_view::npos) {
+                output.append(text.substr(offset));
+                break;
+            }
+            output.append(text.substr(offset, escape - offset));
+            if (escape + 1 >= text.size()) {
+                return false;
+            }
+            offset = escape + 2;
+            switch (text[escape + 1]) {
+                case '"': output += '"'; break;
+                case '\\': output += '\\'; break;
+                case '/': output += '/'; break;
+                case 'b': output += '\b'; break;
+                case 'f': output += '\f'; break;
+                case 'n': output += '\n'; break;
+                case 'r': output += '\r'; break;
+                case 't': output += '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!DecodeFourHexDigits(text, offset, cp)) {
+                        return false;
+                    }
+                    offset += 4;
+                    if (
+                        (cp >= 0xDC00)
+                        && (cp <= 0xDFFF)
+                    ) {
+                        return false;
+                    }
+                    if (
+                        (cp >= 0xD800)
+                        && (cp <= 0xDBFF)
+                    ) {
+                        uint32_t low;
+                        if (
+                            (offset + 2 > text.size())
+                            || (text[offset] != '\\')
+                            || (text[offset + 1] != 'u')
+                            || !DecodeFourHexDigits(text, offset + 2, low)
+                            || (low < 0xDC00)
+                            || (low > 0xDFFF)
+                        ) {
+                            return false;
+                        }
+                        offset += 6;
+                        cp = ((cp - 0xD800) << 10) + (low - 0xDC00) + 0x10000;
+                    }
+                    AppendUtf8(output, cp);
+                }
+                break;
+
+                default: return false;
+            }
+        }
+        return true;
+    }
+
+    bool Reader::DecodeInteger(
+        std::string_view text,
+        intmax_t &value
+    ) {
+        const auto end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        return (
+            (result.ec == std::errc())
+            && (result.ptr == end)
+        );
+    }
+
+    bool Reader::DecodeFloatingPoint(
+        std::string_view text,
+        double &value
+    ) {
+        const auto end = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        if (result.ptr != end) {
+            return false;
+        }
+        if (result.ec == std::errc::result_out_of_range) {
+            // Like FromEncoding(), take numbers too large to hold as
+            // infinite, and those too small as zero, keeping the sign.
+            value = std::copysign(
+                (IsTooLarge(text) ? std::numeric_limits<double>::infinity() : 0.0),
+                ((text[0] == '-') ? -1.0 : 1.0)
+            );
+            return true;
+        }
+        return (result.ec == std::errc());
+    }
+
+    auto Reader::Scan(Token &token) -> Status {
+        if (failed) {
+            return Status::Error;
+        }
+        while (true) {
+            while (
+                (position < buffer.size())
+                && IsWhitespace(buffer[position])
+            ) {
+                ++position;
+            }
+            if (position == buffer.size()) {
+                if (!finished) {
+                    return Status::NeedInput;
+                }
+                if (
+                    (expect == Expect::Nothing)
+                    || (
+                        multipleValues
+                        && (expect == Expect::Value)
+                        && containers.empty()
+                    )
+                ) {
+                    return Status::End;
+                }
+                return Fail();
+            }
+            const auto c = buffer[position];
+            switch (expect) {
+                case Expect::Nothing: {
+                    if (!multipleValues) {
+                        return Fail();
+                    }
+                    expect = Expect::Value;
+                }
+                break;
+
+                case Expect::Colon: {
+                    if (c != ':') {
+                        return Fail();
+                    }
+                    ++position;
+                    expect = Expect::Value;
+                }
+                continue;
+
+                case Expect::CommaOrEnd: {
+                    if (c == ',') {
+                        ++position;
+                        if (trailingCommas) {
+                            expect = (containers.back() ? Expect::KeyOrEnd : Expect::ValueOrEnd);
+                        } else {
+                            expect = (containers.back() ? Expect::Key : Expect::Value);
+                        }
+                        continue;
+                    }
+                }
+                break;
+
+                case Expect::Key: {
+                    if (c != '"') {
+                        return Fail();
+                    }
+                }
+                break;
+
+                case Expect::KeyOrEnd: {
+                    if (
+                        (c != '"')
+                        && (c != '}')
+                    ) {
+                        return Fail();
+                    }
+                }
+                break;
+
+                default: break;
+            }
+            break;
+        }
+
+        // At this point the next token is a value, a key, or the end of
+        // a container.
+        const auto c = buffer[position];
+        token.offset = bufferOffset + position;
+        token.escaped = false;
+        if (
+            (c == '}')
+            || (c == ']')
+        ) {
+            if (
+                (expect == Expect::Value)
+                || (expect == Expect::Key)
+                || containers.empty()
+                || (containers.back() != (c == '}'))
+            ) {
+                return Fail();
+            }
+            token.type = ((c == '}') ? TokenType::EndObject : TokenType::EndArray);
+            token.text = std::string_view(buffer).substr(position, 1);
+            ++position;
+            containers.pop_back();
+            EndValue();
+            return Status::Token;
+        }
+        if (expect == Expect::CommaOrEnd) {
+            return Fail();
+        }
+        const auto isKey = (
+            (expect == Expect::Key)
+            || (expect == Expect::KeyOrEnd)
+        );
+        if (c == '"') {
+            auto i = position + 1 + scanned;
+            auto escaped = scannedEscape;
+            auto complete = false;
+            while (true) {
+                i = buffer.find_first_of("\"\\", i);
+                if (i == std::string::npos) {
+                    i = buffer.size();
+                    break;
+                }
+                if (buffer[i] == '"') {
+                    complete = true;
+                    break;
+                }
+                escaped = true;
+
+                // If the escape sequence hasn't fully arrived, resume
+                // scanning from its backslash.
+                if (i + 1 >= buffer.size()) {
+                    break;
+                }
+                i += 2;
+            }
+            if (!complete) {
+                if (finished) {
+                    return Fail();
+                }
+                scanned = i - position - 1;
+                scannedEscape = escaped;
+                return Status::NeedInput;
+            }
+            scanned = 0;
+            scannedEscape = false;
+            token.type = (isKey ? TokenType::Key : TokenType::String);
+            token.text = std::string_view(buffer).substr(position + 1, i - position - 1);
+            token.escaped = escaped;
+            position = i + 1;
+            if (isKey) {
+                expect = Expect::Colon;
+            } else {
+                EndValue();
+            }
+            return Status::Token;
+        }
+        if (isKey) {
+            return Fail();
+        }
+        if (
+            (c == '{')
+            || (c == '[')
+        ) {
+            token.type = ((c == '{') ? TokenType::BeginObject : TokenType::BeginArray);
+            token.text = std::string_view(buffer).substr(position, 1);
+            ++position;
+            containers.push_back(c == '{');
+            expect = ((c == '{') ? Expect::KeyOrEnd : Expect::ValueOrEnd);
+            return Status::Token;
+        }
+        if (
+            (c == '-')
+            || (
+                (c >= '0')
+                && (c <= '9')
+            )
+        ) {
+            auto i = position;
+            while (
+                (i < buffer.size())
+                && IsNumberCharacter(buffer[i])
+            ) {
+                ++i;
+            }
+            if (
+                (i == buffer.size())
+                && !finished
+            ) {
+                return Status::NeedInput;
+            }
+            const auto text = std::string_view(buffer).substr(position, i - position);
+            bool isInteger;
+            if (!CheckNumber(text, isInteger)) {
+                return Fail();
+            }
+            token.type = (isInteger ? TokenType::Integer : TokenType::FloatingPoint);
+            token.text = text;
+            position = i;
+            EndValue();
+            return Status::Token;
+        }
+        for (const auto &literal: LITERALS) {
+            if (c != literal.text[0]) {
+                continue;
+            }
+            const auto available = std::string_view(buffer).substr(position, literal.text.size());
+            if (available != literal.text.substr(0, available.size())) {
+                return Fail();
+            }
+            if (available.size() < literal.text.size()) {
+                if (finished) {
+                    return Fail();
+                }
+                return Status::NeedInput;
+            }
+            token.type = literal.type;
+            token.text = available;
+            position += literal.text.size();
+            EndValue();
+            return Status::Token;
+        }
+        return Fail();
+    }
+
+    void Reader::EndValue() {
+        if (containers.empty()) {
+            expect = Expect::Nothing;
+        } else {
+            expect = Expect::CommaOrEnd;
+        }
+    }
+
+    auto Reader::Fail() -> Status {
+        failed = true;
+        return Status::Error;
+    }
+}
@@ -0,0 +1,436 @@
+#include "token-stream.h"
+
+#include <algorithm>
+#include <builder.h>
+#include <ostream>
+#include <rewrite.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <writer.h>
+
+namespace {
+    using Rule = Json::RewriteRules::Rule;
+
+    /**
+     * This copies JSON text from a token source to a writer, applying
+     * a set of rewrite rules.
+     */
+    class Rewriter {
+    public:
+        Rewriter(
+            Json::Detail::TokenSource &source,
+            Json::Writer &writer,
+            const Json::RewriteRules &rules,
+            const Json::EncodingOptions &options
+        )
+            : source(source)
+              , writer(writer)
+              , rules(rules.GetRules())
+              , escapeNonAscii(options.escapeNonAscii) {
+            for (const auto &rule: this->rules) {
+                if (!rule.byKey) {
+                    maxPointerDepth = std::max(maxPointerDepth, rule.pointer.GetTokens().size() + 1);
+                }
+            }
+        }
+
+        /**
+         * This copies the whole of the text.
+         *
+         * @return
+         *     An indication of whether or not the text is valid JSON
+         *     is returned.
+         */
+        bool Run() {
+            Json::Reader::Token token;
+            const Rule *memberRule = nullptr;
+            while (true) {
+                switch (source.Next(token)) {
+                    case Json::Reader::Status::Token: break;
+                    case Json::Reader::Status::End: return true;
+                    default: return false;
+                }
+                switch (token.type) {
+                    case Json::Reader::TokenType::Key: {
+                        auto &key = frames.back().key;
+                        key.clear();
+                        if (token.escaped) {
+                            if (!Json::Reader::DecodeString(token.text, key)) {
+                                return false;
+                            }
+                        } else {
+                            key.assign(token.text);
+                        }
+                        memberRule = Match(true);
+                        if (
+                            (memberRule != nullptr)
+                            && (memberRule->action == Rule::Action::Drop)
+                        ) {
+                            if (source.Skip() != Json::Reader::Status::Token) {
+                                return false;
+                            }
+                            memberRule = nullptr;
+                        } else if (
+                            (memberRule != nullptr)
+                            && (memberRule->action == Rule::Action::Rename)
+                        ) {
+                            (void) writer.Key(memberRule->newKey);
+                            memberRule = nullptr;
+                        } else if (!Json::Detail::CopyToken(token, writer, escapeNonAscii, scratch)) {
+                            return false;
+                        }
+                    }
+                    continue;
+
+                    case Json::Reader::TokenType::EndObject:
+                    case Json::Reader::TokenType::EndArray: {
+                        (void) Json::Detail::CopyToken(token, writer, escapeNonAscii, scratch);
+                        frames.pop_back();
+                    }
+                    continue;
+
+                    default: break;
+                }
+
+                // The token starts a value.  The rule for an object member
+                // was found from its key; otherwise find it now.
+                const Rule *rule = nullptr;
+                if (
+                    !frames.empty()
+                    && frames.back().isObject
+                ) {
+                    rule = std::exchange(memberRule, nullptr);
+                } else {
+                    if (!frames.empty()) {
+                        auto &frame = frames.back();
+                        if (frames.size() < maxPointerDepth) {
+                            frame.key = std::to_string(frame.index);
+                        }
+                        ++frame.index;
+                    }
+                    rule = Match(false);
+                    if (
+                        (rule != nullptr)
+                        && (
+                            (rule->action == Rule::Action::Rename)
+                            || (
+                                frames.empty()
+                                && (rule->action == Rule::Action::Drop)
+                            )
+                        )
+                    ) {
+                        rule = nullptr;
+                    }
+                }
+                if (rule != nullptr) {
+                    switch (rule->action) {
+                        case Rule::Action::Drop: {
+                            if (!SkipRest(token)) {
+                                return false;
+                            }
+                        }
+                        break;
+
+                        case Rule::Action::Replace: {
+                            if (!SkipRest(token)) {
+                                return false;
+                            }
+                            (void) writer.Write(rule->replacement);
+                        }
+                        break;
+
+                        case Rule::Action::Transform: {
+                            Json::Value value;
+                            if (!BuildRest(token, value)) {
+                                return false;
+                            }
+                            (void) writer.Write(rule->transformer(value));
+                        }
+                        break;
+
+                        default: break;
+                    }
+                    continue;
+                }
+                if (!Json::Detail::CopyToken(token, writer, escapeNonAscii, scratch)) {
+                    return false;
+                }
+                if (
+                    (token.type == Json::Reader::TokenType::BeginObject)
+                    || (token.type == Json::Reader::TokenType::BeginArray)
+                ) {
+                    frames.push_back(Frame{token.type == Json::Reader::TokenType::BeginObject, std::string(), 0});
+                }
+            }
+        }
+
+    private:
+        /**
+         * This is an array or object being copied.
+         */
+        struct Frame {
+            /**
+             * This indicates whether the container is an object.
+             */
+            bool isObject = false;
+
+            /**
+             * This is the key of the current member, or the index of
+             * the current element as a pointer token.
+             */
+            std::string key;
+
+            /**
+             * This is the index of the next element of an array.
+             */
+            size_t index = 0;
+        };
+
+        /**
+         * This returns the first rule applying to the current value,
+         * or nullptr if none does.
+         *
+         * @param[in] isMember
+         *     This indicates whether the value is an object member, to
+         *     which rules by key may apply.
+         */
+        const Rule *Match(bool isMember) const {
+            for (const auto &rule: rules) {
+                if (rule.byKey) {
+                    if (
+                        isMember
+                        && (rule.key == frames.back().key)
+                    ) {
+                        return &rule;
+                    }
+                    continue;
+                }
+                const auto &tokens = rule.pointer.GetTokens();
+                if (
+                    rule.pointer.IsValid()
+                    && (tokens.size() == frames.size())
+                    && std::equal(
+                        tokens.rbegin(),
+                        tokens.rend(),
+                        frames.rbegin(),
+                        [](const std::string &token, const Frame &frame){
+                            return (token == frame.key);
+                        }
+                    )
+                ) {
+                    return &rule;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * This reads the rest of the value which starts with the given
+         * token, without copying it.
+         */
+        bool SkipRest(const Json::Reader::Token &first) {
+            if (
+                (first.type != Json::Reader::TokenType::BeginObject)
+                && (first.type != Json::Reader::TokenType::BeginArray)
+            ) {
+                return true;
+            }
+            const auto depth = source.GetReader().GetDepth() - 1;
+            Json::Reader::Token token;
+            while (source.GetReader().GetDepth() > depth) {
+                if (source.Next(token) != Json::Reader::Status::Token) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This parses the value which starts with the given token.
+         */
+        bool BuildRest(
+            const Json::Reader::Token &first,
+            Json::Value &value
+        ) {
+            Json::Builder builder;
+            auto token = first;
+            while (true) {
+                if (!builder.Push(token)) {
+                    return false;
+                }
+                if (builder.IsComplete()) {
+                    break;
+                }
+                if (source.Next(token) != Json::Reader::Status::Token) {
+                    return false;
+                }
+            }
+            value = builder.Take();
+            return true;
+        }
+
+        /**
+         * This is the source of the text.
+         */
+        Json::Detail::TokenSource &source;
+
+        /**
+         * This is the writer of the rewritten text.
+         */
+        Json::Writer &writer;
+
+        /**
+         * These are the rules to apply.
+         */
+        const std::vector<Rule> &rules;
+
+        /**
+         * This indicates whether strings with non-ASCII characters
+         * are re-encoded.
+         */
+        bool escapeNonAscii = false;
+
+        /**
+         * This is one more than the greatest number of tokens of any
+         * pointer in the rules, or zero if there are none.  Array
+         * indexes are only tracked at depths less than this.
+         */
+        size_t maxPointerDepth = 0;
+
+        /**
+         * These are the arrays and objects being copied.
+         */
+        std::vector<Frame> frames;
+
+        /**
+         * This is a buffer reused when copying tokens.
+         */
+        std::string scratch;
+    };
+}
+
+namespace Json {
+    RewriteRules &RewriteRules::Drop(const Pointer &pointer) {
+        Rule rule;
+        rule.action = Rule::Action::Drop;
+        rule.pointer = pointer;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::DropKey(std::string_view key) {
+        Rule rule;
+        rule.action = Rule::Action::Drop;
+        rule.byKey = true;
+        rule.key = key;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::Replace(
+        const Pointer &pointer,
+        const Value &replacement
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Replace;
+        rule.pointer = pointer;
+        rule.replacement = replacement;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::ReplaceKey(
+        std::string_view key,
+        const Value &replacement
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Replace;
+        rule.byKey = true;
+        rule.key = key;
+        rule.replacement = replacement;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::Rename(
+        const Pointer &pointer,
+        std::string_view newKey
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Rename;
+        rule.pointer = pointer;
+        rule.newKey = newKey;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::RenameKey(
+        std::string_view key,
+        std::string_view newKey
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Rename;
+        rule.byKey = true;
+        rule.key = key;
+        rule.newKey = newKey;
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::Transform(
+        const Pointer &pointer,
+        Transformer transformer
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Transform;
+        rule.pointer = pointer;
+        rule.transformer = std::move(transformer);
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    RewriteRules &RewriteRules::TransformKey(
+        std::string_view key,
+        Transformer transformer
+    ) {
+        Rule rule;
+        rule.action = Rule::Action::Transform;
+        rule.byKey = true;
+        rule.key = key;
+        rule.transformer = std::move(transformer);
+        rules.push_back(std::move(rule));
+        return *this;
+    }
+
+    auto RewriteRules::GetRules() const -> const std::vector<Rule> & {
+        return rules;
+    }
+
+    bool Rewrite(
+        std::string_view input,
+        std::string &output,
+        const RewriteRules &rules,
+        const EncodingOptions &options
+    ) {
+        Detail::TokenSource source(input);
+        Writer writer(output, options);
+        return Rewriter(source, writer, rules, options).Run();
+    }
+
+    bool Rewrite(
+        std::istream &input,
+        std::ostream &output,
+        const RewriteRules &rules,
+        const EncodingOptions &options
+    ) {
+        Detail::TokenSource source(input);
+        Writer writer(
+            [&output](std::string_view chunk){
+                (void) output.write(chunk.data(), (std::streamsize) chunk.size());
+            },
+            options
+        );
+        return Rewriter(source, writer, rules, options).Run();
+    }
+}
@@ -0,0 +1,807 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <reader.h>
+#include <scan-lines.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef JSONKIT_CUSTOM_TRAITS_HEADER
+#include JSONKIT_CUSTOM_TRAITS_HEADER
+#endif
+
+namespace {
+    /**
+     * This function returns -1, 0 or 1 according to whether the first
+     * given value is less than, equal to, or greater than the second.
+     */
+    template<typename T>
+    int Order(
+        const T &lhs,
+        const T &rhs
+    ) {
+        if (lhs < rhs) {
+            return -1;
+        } else if (rhs < lhs) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+
+    /**
+     * This function compares the scalar value of the given token with
+     * the given operand.
+     *
+     * @param[in] token
+     *     This is the token holding the value to compare.
+     *
+     * @param[in] operand
+     *     This is the value with which to compare it.
+     *
+     * @param[in] operandText
+     *     If the operand is a string, this is its text.
+     *
+     * @param[in,out] scratch
+     *     This is a buffer reused to decode strings with escapes.
+     *
+     * @return
+     *     -1, 0 or 1 is returned according to whether the token's value
+     *     is less than, equal to, or greater than the operand, or
+     *     std::nullopt if they can't be compared.
+     */
+    std::optional<int> Compare(
+        const Json::Reader::Token &token,
+        const Json::Value &operand,
+        std::string_view operandText,
+        std::string &scratch
+    ) {
+        using TokenType = Json::Reader::TokenType;
+        switch (operand.GetType()) {
+            case Json::ValueType::String: {
+                if (token.type != TokenType::String) {
+                    return std::nullopt;
+                }
+                std::string_view text = token.text;
+                if (token.escaped) {
+                    scratch.clear();
+                    if (!Json::Reader::DecodeString(token.text, scratch)) {
+                        return std::nullopt;
+                    }
+                    text = scratch;
+                }
+                return Order(text, operandText);
+            }
+
+            case Json::ValueType::Integer:
+            case Json::ValueType::FloatingPoint: {
+                if (
+                    (token.type == TokenType::Integer)
+                    && (operand.GetType() == Json::ValueType::Integer)
+                ) {
+                    intmax_t value = 0;
+                    if (Json::Reader::DecodeInteger(token.text, value)) {
+                        return Order(value, (intmax_t) operand);
+                    }
+                }
+                if (
+                    (token.type != TokenType::Integer)
+                    && (token.type != TokenType::FloatingPoint)
+                ) {
+                    return std::nullopt;
+                }
+                double value = 0.0;
+                if (!Json::Reader::DecodeFloatingPoint(token.text, value)) {
+                    return std::nullopt;
+                }
+                return Order(value, (double) operand);
+            }
+
+            case Json::ValueType::Boolean: {
+                if (
+                    (token.type != TokenType::True)
+                    && (token.type != TokenType::False)
+                ) {
+                    return std::nullopt;
+                }
+                return Order(token.type == TokenType::True, (bool) operand);
+            }
+
+            case Json::ValueType::Null: {
+                if (token.type != TokenType::Null) {
+                    return std::nullopt;
+                }
+                return 0;
+            }
+
+            default: return std::nullopt;
+        }
+    }
+
+    /**
+     * This function determines whether a condition holds, given the
+     * result of comparing the values.
+     *
+     * @param[in] op
+     *     This is how the condition compares the values.
+     *
+     * @param[in] order
+     *     This is the result of Compare().
+     *
+     * @return
+     *     An indication of whether the condition holds is returned.
+     */
+    bool Holds(
+        Json::Filter::Operator op,
+        std::optional<int> order
+    ) {
+        if (!order) {
+            return (op == Json::Filter::Operator::NotEqual);
+        }
+        switch (op) {
+            case Json::Filter::Operator::Equal: return (*order == 0);
+            case Json::Filter::Operator::NotEqual: return (*order != 0);
+            case Json::Filter::Operator::Less: return (*order < 0);
+            case Json::Filter::Operator::LessOrEqual: return (*order <= 0);
+            case Json::Filter::Operator::Greater: return (*order > 0);
+            case Json::Filter::Operator::GreaterOrEqual: return (*order >= 0);
+            default: return false;
+        }
+    }
+
+    /**
+     * This function determines whether the given value may be the
+     * operand of a condition.
+     */
+    bool IsScalar(const Json::Value &value) {
+        switch (value.GetType()) {
+            case Json::ValueType::Null:
+            case Json::ValueType::Boolean:
+            case Json::ValueType::String:
+            case Json::ValueType::Integer:
+            case Json::ValueType::FloatingPoint: return true;
+            default: return false;
+        }
+    }
+
+    /**
+     * This function returns the given string within quotation marks,
+     * as it appears in JSON text which doesn't use escapes, or an empty
+     * string if the string can't appear without escapes.
+     */
+    std::string QuoteIfPlain(std::string_view text) {
+        for (const auto c: text) {
+            if (
+                (c == '"')
+                || (c == '\\')
+                || ((unsigned char) c < 0x20)
+            ) {
+                return "";
+            }
+        }
+        std::string quoted = "\"";
+        quoted += text;
+        quoted += '"';
+        return quoted;
+    }
+
+    /**
+     * This decides whether records match a filter, reading each one
+     * token by token, and only as far as it must.  Each thread uses its
+     * own matcher, so that its memory is reused from one record to the
+     * next.
+     */
+    class Matcher {
+    public:
+        explicit Matcher(const Json::Filter &filter)
+            : conditions(filter.GetConditions()) {
+            for (const auto &condition: conditions) {
+                operandTexts.push_back((std::string) condition.operand);
+                std::string needle;
+                const auto operandType = condition.operand.GetType();
+                if (condition.op == Json::Filter::Operator::Equal) {
+                    if (operandType == Json::ValueType::String) {
+                        needle = QuoteIfPlain(operandTexts.back());
+                    } else if (
+                        (operandType == Json::ValueType::Boolean)
+                        || (operandType == Json::ValueType::Null)
+                    ) {
+                        needle = condition.operand.ToEncoding();
+                    }
+                }
+                const auto &tokens = condition.pointer.GetTokens();
+                if (
+                    needle.empty()
+                    && !tokens.empty()
+                    && !std::all_of(
+                        tokens.back().begin(),
+                        tokens.back().end(),
+                        [](char c){ return ((c >= '0') && (c <= '9')); }
+                    )
+                ) {
+                    needle = QuoteIfPlain(tokens.back());
+                }
+                if (!needle.empty()) {
+                    needles.push_back(std::move(needle));
+                }
+            }
+        }
+
+        /**
+         * This checks whether the given record matches the filter.
+         *
+         * @param[in] record
+         *     This is the JSON text of the record.
+         *
+         * @return
+         *     An indication of whether the record matches is returned.
+         *     If it does, the rest of the record may not have been read,
+         *     so it may not be valid JSON.
+         */
+        bool Matches(std::string_view record) {
+            // Text without escapes which matches must contain each
+            // needle verbatim, which is far quicker to check than to
+            // read the record.
+            for (const auto &needle: needles) {
+                if (record.find(needle) == std::string_view::npos) {
+                    if (record.find('\\') == std::string_view::npos) {
+                        return false;
+                    }
+                    break;
+                }
+            }
+            reader.Reset();
+            reader.Feed(record);
+            reader.Finish();
+            frames.clear();
+            resolved.assign(conditions.size(), false);
+            auto remaining = conditions.size();
+            if (remaining == 0) {
+                return true;
+            }
+            Json::Reader::Token token;
+            while (true) {
+                if (reader.Next(token) != Json::Reader::Status::Token) {
+                    return false;
+                }
+                switch (token.type) {
+                    case Json::Reader::TokenType::Key: {
+                        auto &key = frames.back().key;
+                        key.clear();
+                        if (token.escaped) {
+                            if (!Json::Reader::DecodeString(token.text, key)) {
+                                return false;
+                            }
+                        } else {
+                            key.assign(token.text);
+                        }
+                        if (
+                            !IsReferenced(frames.size())
+                            && (reader.Skip() != Json::Reader::Status::Token)
+                        ) {
+                            return false;
+                        }
+                    }
+                    continue;
+
+                    case Json::Reader::TokenType::EndObject:
+                    case Json::Reader::TokenType::EndArray: {
+                        frames.pop_back();
+                    }
+                    continue;
+
+                    default: break;
+                }
+
+                // The token starts a value.  Elements of arrays are
+                // skipped here, since their keys are only known now.
+                if (
+                    !frames.empty()
+                    && !frames.back().isObject
+                ) {
+                    auto &frame = frames.back();
+                    frame.key = std::to_string(frame.index++);
+                    if (!IsReferenced(frames.size())) {
+                        if (!SkipRest(token)) {
+                            return false;
+                        }
+                        continue;
+                    }
+                }
+                for (size_t i = 0; i < conditions.size(); ++i) {
+                    if (
+                        !resolved[i]
+                        && (conditions[i].pointer.GetTokens().size() == frames.size())
+                        && IsOnPath(conditions[i], frames.size())
+                    ) {
+                        if (!Holds(conditions[i].op, Compare(token, conditions[i].operand, operandTexts[i], scratch))) {
+                            return false;
+                        }
+                        resolved[i] = true;
+                        if (--remaining == 0) {
+                            return true;
+                        }
+                    }
+                }
+                if (
+                    (token.type == Json::Reader::TokenType::BeginObject)
+                    || (token.type == Json::Reader::TokenType::BeginArray)
+                ) {
+                    if (IsReferenced(frames.size() + 1)) {
+                        frames.push_back(Frame{token.type == Json::Reader::TokenType::BeginObject, std::string(), 0});
+                    } else if (!SkipRest(token)) {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        /**
+         * This reads the rest of the record after Matches() returns true,
+         * to check that it's valid JSON.
+         */
+        bool Validate() {
+            Json::Reader::Token token;
+            while (true) {
+                switch (reader.Next(token)) {
+                    case Json::Reader::Status::Token: break;
+                    case Json::Reader::Status::End: return true;
+                    default: return false;
+                }
+            }
+        }
+
+    private:
+        /**
+         * This is an array or object being read.
+         */
+        struct Frame {
+            /**
+             * This indicates whether the container is an object.
+             */
+            bool isObject = false;
+
+            /**
+             * This is the key of the current member, or the index of
+             * the current element as a pointer token.
+             */
+            std::string key;
+
+            /**
+             * This is the index of the next element of an array.
+             */
+            size_t index = 0;
+        };
+
+        /**
+         * This determines whether the pointer of the given condition
+         * starts with the keys of the given number of outermost frames.
+         */
+        bool IsOnPath(
+            const Json::Filter::Condition &condition,
+            size_t depth
+        ) const {
+            const auto &tokens = condition.pointer.GetTokens();
+            for (size_t i = 0; i < depth; ++i) {
+                if (tokens[i] != frames[i].key) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This determines whether any condition not yet resolved refers
+         * to a value at or within the given depth of the current path.
+         */
+        bool IsReferenced(size_t depth) const {
+            for (size_t i = 0; i < conditions.size(); ++i) {
+                if (
+                    !resolved[i]
+                    && (conditions[i].pointer.GetTokens().size() >= depth)
+                    && IsOnPath(conditions[i], std::min(depth, frames.size()))
+                ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * This reads the rest of the value which starts with the given
+         * token.
+         */
+        bool SkipRest(const Json::Reader::Token &first) {
+            if (
+                (first.type != Json::Reader::TokenType::BeginObject)
+                && (first.type != Json::Reader::TokenType::BeginArray)
+            ) {
+                return true;
+            }
+            const auto depth = reader.GetDepth() - 1;
+            Json::Reader::Token token;
+            while (reader.GetDepth() > depth) {
+                if (reader.Next(token) != Json::Reader::Status::Token) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * These are the conditions of the filter.
+         */
+        const std::vector<Json::Filter::Condition> &conditions;
+
+        /**
+         * For each condition whose operand is a string, this is the
+         * text of the string.
+         */
+        std::vector<std::string> operandTexts;
+
+        /**
+         * This is text which a record without escapes must contain in
+         * order to match.
+         */
+        std::vector<std::string> needles;
+
+        /**
+         * This is used to read each record.
+         */
+        Json::Reader reader;
+
+        /**
+         * These are the arrays and objects being read.
+         */
+        std::vector<Frame> frames;
+
+        /**
+         * For each condition, this indicates whether it has been found
+         * to hold in the current record.
+         */
+        std::vector<bool> resolved;
+
+        /**
+         * This is a buffer reused to decode strings.
+         */
+        std::string scratch;
+    };
+
+    /**
+     * This holds the records found in one chunk of text.
+     */
+    template<typename Traits>
+    struct ChunkResult {
+        /**
+         * This indicates whether the chunk has been scanned.
+         */
+        bool done = false;
+
+        /**
+         * This is the number of lines in the chunk.
+         */
+        size_t lines = 0;
+
+        /**
+         * These are the records which match, with their line numbers
+         * within the chunk.
+         */
+        std::vector<std::pair<size_t, Json::BasicValue<Traits>>> records;
+    };
+
+    /**
+     * This function finds the records which match in one chunk of text.
+     *
+     * @param[in] chunk
+     *     This is the text to scan, which is whole lines.
+     *
+     * @param[in,out] matcher
+     *     This is used to check each line against the filter.
+     *
+     * @param[out] result
+     *     This is where to store the lines found.
+     */
+    template<typename Traits>
+    void ScanChunk(
+        std::string_view chunk,
+        Matcher &matcher,
+        ChunkResult<Traits> &result
+    ) {
+        size_t lineNumber = 0;
+        std::string line;
+        while (!chunk.empty()) {
+            const auto end = chunk.find('\n');
+            const auto lineView = chunk.substr(0, end);
+            chunk.remove_prefix((end == std::string_view::npos) ? chunk.size() : end + 1);
+            ++lineNumber;
+            if (lineView.find_first_not_of(" \t\r") == std::string_view::npos) {
+                continue;
+            }
+            if (!matcher.Matches(lineView)) {
+                continue;
+            }
+            line.assign(lineView);
+            auto record = Json::BasicValue<Traits>::FromEncoding(line);
+            if (record.GetType() != Json::ValueType::Invalid) {
+                result.records.emplace_back(lineNumber, std::move(record));
+            }
+        }
+        result.lines = lineNumber;
+        result.done = true;
+    }
+
+    /**
+     * This function returns the end of the chunk of text which starts
+     * at the given position, extended to the end of a line.
+     */
+    size_t FindChunkEnd(
+        std::string_view buffer,
+        size_t start,
+        size_t chunkSize
+    ) {
+        if (buffer.size() - start <= chunkSize) {
+            return buffer.size();
+        }
+        const auto newline = buffer.find('\n', start + chunkSize - 1);
+        if (newline == std::string_view::npos) {
+            return buffer.size();
+        }
+        return newline + 1;
+    }
+}
+
+namespace Json {
+    Filter Filter::Parse(std::string_view expression) {
+        Filter filter;
+        const auto skipWhitespace = [&expression]{
+            while (
+                !expression.empty()
+                && ((expression[0] == ' ') || (expression[0] == '\t'))
+            ) {
+                expression.remove_prefix(1);
+            }
+        };
+        while (true) {
+            // The pointer extends up to whitespace or the operator.
+            skipWhitespace();
+            const auto pointerEnd = std::min(
+                expression.find_first_of(" \t=!<>"),
+                expression.size()
+            );
+            const Pointer pointer(expression.substr(0, pointerEnd));
+            expression.remove_prefix(pointerEnd);
+            skipWhitespace();
+
+            // The longer operators are checked first, so that "<=" isn't
+            // taken for "<".
+            static const std::pair<std::string_view, Operator> operators[] = {
+                {"==", Operator::Equal},
+                {"!=", Operator::NotEqual},
+                {"<=", Operator::LessOrEqual},
+                {">=", Operator::GreaterOrEqual},
+                {"<", Operator::Less},
+                {">", Operator::Greater},
+            };
+            const auto op = std::find_if(
+                std::begin(operators),
+                std::end(operators),
+                [&expression](const auto &entry){
+                    return (expression.substr(0, entry.first.size()) == entry.first);
+                }
+            );
+            if (op == std::end(operators)) {
+                filter.valid = false;
+                return filter;
+            }
+            expression.remove_prefix(op->first.size());
+            skipWhitespace();
+
+            // A string operand ends at its closing quotation mark, and
+            // any other at whitespace or the start of "&&".
+            size_t operandEnd = 0;
+            if (
+                !expression.empty()
+                && (expression[0] == '"')
+            ) {
+                operandEnd = 1;
+                while (
+                    (operandEnd < expression.size())
+                    && (expression[operandEnd] != '"')
+                ) {
+                    operandEnd += ((expression[operandEnd] == '\\') ? 2 : 1);
+                }
+                operandEnd = std::min(operandEnd + 1, expression.size());
+            } else {
+                operandEnd = std::min(
+                    expression.find_first_of(" \t&"),
+                    expression.size()
+                );
+            }
+            (void) filter.Where(
+                pointer,
+                op->second,
+                Value::FromEncoding(std::string(expression.substr(0, operandEnd)))
+            );
+            expression.remove_prefix(operandEnd);
+            skipWhitespace();
+            if (expression.empty()) {
+                break;
+            }
+            if (expression.substr(0, 2) != "&&") {
+                filter.valid = false;
+                break;
+            }
+            expression.remove_prefix(2);
+        }
+        return filter;
+    }
+
+    Filter &Filter::Where(
+        const Pointer &pointer,
+        Operator op,
+        const Value &operand
+    ) {
+        if (
+            !pointer.IsValid()
+            || !IsScalar(operand)
+        ) {
+            valid = false;
+        }
+        conditions.push_back(Condition{pointer, op, operand});
+        return *this;
+    }
+
+    bool Filter::IsValid() const {
+        return valid;
+    }
+
+    auto Filter::GetConditions() const -> const std::vector<Condition> & {
+        return conditions;
+    }
+
+    bool Filter::Matches(std::string_view record) const {
+        if (!valid) {
+            return false;
+        }
+        Matcher matcher(*this);
+        return (
+            matcher.Matches(record)
+            && matcher.Validate()
+        );
+    }
+
+    template<typename Traits>
+    size_t ScanLines(
+        std::string_view buffer,
+        const Filter &filter,
+        const std::type_identity_t<std::function<void(size_t lineNumber, BasicValue<Traits> &&record)>> &callback,
+        const ScanOptions &options
+    ) {
+        if (!filter.IsValid()) {
+            return 0;
+        }
+        const auto chunkSize = std::max(options.chunkSize, (size_t) 1);
+        auto threads = options.threads;
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        size_t matches = 0;
+        size_t linesBefore = 0;
+        const auto deliver = [&](ChunkResult<Traits> &result){
+            for (auto &record: result.records) {
+                callback(linesBefore + record.first, std::move(record.second));
+                ++matches;
+            }
+            linesBefore += result.lines;
+        };
+
+        // Small inputs aren't worth the threads.
+        if (
+            (threads == 1)
+            || (buffer.size() <= chunkSize)
+        ) {
+            Matcher matcher(filter);
+            size_t start = 0;
+            while (start < buffer.size()) {
+                const auto end = FindChunkEnd(buffer, start, chunkSize);
+                ChunkResult<Traits> result;
+                ScanChunk(buffer.substr(start, end - start), matcher, result);
+                deliver(result);
+                start = end;
+            }
+            return matches;
+        }
+
+        // Workers may run only a bounded number of chunks ahead of the
+        // calling thread, which delivers results in order, so memory
+        // use doesn't grow with the size of the input.
+        const auto window = threads * 2;
+        std::vector<ChunkResult<Traits>> slots(window);
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t nextStart = 0;
+        size_t nextChunk = 0;
+        size_t delivered = 0;
+        const auto scan = [&]{
+            Matcher matcher(filter);
+            while (true) {
+                size_t index = 0;
+                size_t start = 0;
+                size_t end = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(
+                        lock,
+                        [&]{
+                            return (
+                                (nextStart >= buffer.size())
+                                || (nextChunk < delivered + window)
+                            );
+                        }
+                    );
+                    if (nextStart >= buffer.size()) {
+                        break;
+                    }
+                    index = nextChunk++;
+                    start = nextStart;
+                    end = FindChunkEnd(buffer, start, chunkSize);
+                    nextStart = end;
+                }
+                ChunkResult<Traits> result;
+                ScanChunk(buffer.substr(start, end - start), matcher, result);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slots[index % window] = std::move(result);
+                }
+                changed.notify_all();
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(scan);
+        }
+        for (size_t index = 0;; ++index) {
+            ChunkResult<Traits> result;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(
+                    lock,
+                    [&]{
+                        return (
+                            slots[index % window].done
+                            || (
+                                (nextStart >= buffer.size())
+                                && (index >= nextChunk)
+                            )
+                        );
+                    }
+                );
+                if (!slots[index % window].done) {
+                    break;
+                }
+                result = std::move(slots[index % window]);
+                slots[index % window] = ChunkResult<Traits>();
+                ++delivered;
+            }
+            changed.notify_all();
+            deliver(result);
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        return matches;
+    }
+
+    template size_t ScanLines<DefaultTraits>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<DefaultTraits> &&)> &, const ScanOptions &);
+    template size_t ScanLines<CompactTraits>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<CompactTraits> &&)> &, const ScanOptions &);
+    template size_t ScanLines<HashedTraits>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<HashedTraits> &&)> &, const ScanOptions &);
+    template size_t ScanLines<EditableTraits>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<EditableTraits> &&)> &, const ScanOptions &);
+    template size_t ScanLines<TieredTraits>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<TieredTraits> &&)> &, const ScanOptions &);
+
+#ifdef JSONKIT_CUSTOM_TRAITS
+    template size_t ScanLines<JSONKIT_CUSTOM_TRAITS>(std::string_view, const Filter &, const std::function<void(size_t, BasicValue<JSONKIT_CUSTOM_TRAITS> &&)> &, const ScanOptions &);
+#endif
+}
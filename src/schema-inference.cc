@@ -0,0 +1,839 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <reader.h>
+#include <schema-inference.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    /**
+     * This is the number of bits of a hash which select a register of a
+     * cardinality sketch.
+     */
+    constexpr int REGISTER_BITS = 12;
+
+    /**
+     * This is the number of registers of a cardinality sketch.
+     */
+    constexpr size_t REGISTERS = (size_t) 1 << REGISTER_BITS;
+
+    /**
+     * These are the bits which stand for each type of value, in the set
+     * of types found among the elements of an array.
+     */
+    enum Kind : unsigned int {
+        NULL_KIND = 1,
+        BOOLEAN_KIND = 2,
+        INTEGER_KIND = 4,
+        FLOATING_POINT_KIND = 8,
+        STRING_KIND = 16,
+        ARRAY_KIND = 32,
+        OBJECT_KIND = 64,
+    };
+
+    /**
+     * This function mixes the bits of the given hash, so that every bit
+     * of the result depends on every bit of the hash, as HyperLogLog
+     * needs and std::hash doesn't promise.
+     *
+     * @param[in] hash
+     *     This is the hash to mix.
+     *
+     * @return
+     *     The mixed hash is returned.
+     */
+    uint64_t Mix(uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94d049bb133111ebULL;
+        hash ^= hash >> 31;
+        return hash;
+    }
+
+    /**
+     * This function returns the end of the chunk of text which starts
+     * at the given position, extended to the end of a line.
+     */
+    size_t FindChunkEnd(
+        std::string_view buffer,
+        size_t start,
+        size_t chunkSize
+    ) {
+        if (buffer.size() - start <= chunkSize) {
+            return buffer.size();
+        }
+        const auto newline = buffer.find('\n', start + chunkSize - 1);
+        if (newline == std::string_view::npos) {
+            return buffer.size();
+        }
+        return newline + 1;
+    }
+
+    /**
+     * This function returns the number of threads to use, given the
+     * number asked for.
+     */
+    size_t CountThreads(size_t threads) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        return threads;
+    }
+
+    /**
+     * This summarizes the documents in chunks of text, one thread's
+     * worth, into a sketch of their shapes.
+     */
+    class Analyzer {
+    public:
+        /**
+         * This is the sketch of the documents summarized so far.
+         */
+        Json::SchemaSketch sketch;
+
+        /**
+         * This is the constructor.
+         *
+         * @param[in] maxMembers
+         *     This is the most keys for which members are summarized
+         *     separately.
+         */
+        explicit Analyzer(size_t maxMembers)
+            : reader(true)
+        {
+            sketch.maxMembers = maxMembers;
+        }
+
+        /**
+         * This function summarizes the documents in the given text.
+         * Records which aren't valid JSON are counted and skipped up to
+         * the end of the line on which they start.
+         *
+         * @param[in] chunk
+         *     This is the text holding the documents.
+         *
+         * @param[in] final
+         *     This indicates whether the text ends the input.  If not,
+         *     a record left incomplete at the end of the text isn't
+         *     summarized, and must be passed again at the start of the
+         *     next chunk.
+         *
+         * @return
+         *     The number of characters used is returned: all of them if
+         *     the text ends the input, or otherwise up to the start of
+         *     any incomplete record at its end.
+         */
+        size_t Analyze(
+            std::string_view chunk,
+            bool final
+        ) {
+            size_t base = 0;
+            if (skippingLine) {
+                const auto newline = chunk.find('\n');
+                if (newline == std::string_view::npos) {
+                    return chunk.size();
+                }
+                skippingLine = false;
+                base = newline + 1;
+            }
+            const auto start = [&]{
+                reader.Reset();
+                reader.Feed(chunk.substr(base));
+                if (final) {
+                    reader.Finish();
+                }
+            };
+            start();
+            tokens.clear();
+            size_t depth = 0;
+            Json::Reader::Token token;
+            while (true) {
+                const auto status = reader.Next(token);
+                if (status == Json::Reader::Status::Token) {
+                    tokens.push_back(token);
+                    switch (token.type) {
+                        case Json::Reader::TokenType::BeginArray:
+                        case Json::Reader::TokenType::BeginObject: {
+                            ++depth;
+                        } break;
+
+                        case Json::Reader::TokenType::EndArray:
+                        case Json::Reader::TokenType::EndObject: {
+                            --depth;
+                        } break;
+
+                        default: break;
+                    }
+                    if (depth == 0) {
+                        Apply();
+                        tokens.clear();
+                    }
+                } else if (status == Json::Reader::Status::Error) {
+                    ++sketch.invalidRecords;
+                    const auto recordStart = base + (
+                        tokens.empty()
+                        ? reader.GetOffset()
+                        : tokens.front().offset
+                    );
+                    tokens.clear();
+                    depth = 0;
+                    const auto newline = chunk.find('\n', recordStart);
+                    if (newline == std::string_view::npos) {
+                        // The rest of the line is in the next chunk.
+                        skippingLine = !final;
+                        return chunk.size();
+                    }
+                    base = newline + 1;
+                    start();
+                } else if (status == Json::Reader::Status::NeedInput) {
+                    // A partly read token is left unread, so the offset
+                    // is where it starts.
+                    return base + (
+                        tokens.empty()
+                        ? reader.GetOffset()
+                        : tokens.front().offset
+                    );
+                } else {
+                    return chunk.size();
+                }
+            }
+        }
+
+    private:
+        /**
+         * This holds what is known about an array or object whose
+         * tokens are being applied to the sketch.
+         */
+        struct Frame {
+            /**
+             * This is the summary of the array or object.
+             */
+            Json::ShapeSketch *shape = nullptr;
+
+            /**
+             * This is the summary of the value of the member whose key
+             * was just read, if the frame is an object.
+             */
+            Json::ShapeSketch *member = nullptr;
+
+            /**
+             * This is the number of elements read so far, if the frame
+             * is an array.
+             */
+            size_t length = 0;
+
+            /**
+             * This is the set of kinds of elements read so far, if the
+             * frame is an array.
+             */
+            unsigned int kinds = 0;
+
+            /**
+             * This indicates whether the frame is an array, rather than
+             * an object.
+             */
+            bool array = false;
+        };
+
+        /**
+         * This function returns the summary of the member with the given
+         * key of the objects summarized by the given sketch, adding it if
+         * there's room, or otherwise the summary of the other members.
+         */
+        Json::ShapeSketch &GetMember(
+            Json::ShapeSketch &shape,
+            std::string_view key
+        ) {
+            const auto member = shape.members.find(key);
+            if (member != shape.members.end()) {
+                return member->second;
+            }
+            if (shape.members.size() < sketch.maxMembers) {
+                return shape.members[std::string(key)];
+            }
+            shape.otherKeys.Add(key);
+            if (shape.otherMembers == nullptr) {
+                shape.otherMembers = std::make_unique<Json::ShapeSketch>();
+            }
+            return *shape.otherMembers;
+        }
+
+        /**
+         * This function adds the document whose tokens are buffered to
+         * the sketch.
+         */
+        void Apply() {
+            frames.clear();
+            for (const auto &token: tokens) {
+                unsigned int kind = 0;
+                if (token.type == Json::Reader::TokenType::Key) {
+                    std::string_view key = token.text;
+                    if (token.escaped) {
+                        decoded.clear();
+                        (void) Json::Reader::DecodeString(token.text, decoded);
+                        key = decoded;
+                    }
+                    frames.back().member = &GetMember(*frames.back().shape, key);
+                    continue;
+                } else if (
+                    (token.type == Json::Reader::TokenType::EndArray)
+                    || (token.type == Json::Reader::TokenType::EndObject)
+                ) {
+                    const auto frame = frames.back();
+                    frames.pop_back();
+                    if (frame.array) {
+                        auto &shape = *frame.shape;
+                        shape.minimumArrayLength = std::min(shape.minimumArrayLength, frame.length);
+                        shape.maximumArrayLength = std::max(shape.maximumArrayLength, frame.length);
+                        if ((frame.kinds & (frame.kinds - 1)) == 0) {
+                            ++shape.homogeneousArrays;
+                        }
+                        kind = ARRAY_KIND;
+                    } else {
+                        kind = OBJECT_KIND;
+                    }
+                } else {
+                    Json::ShapeSketch *shape = &sketch.root;
+                    if (!frames.empty()) {
+                        if (frames.back().array) {
+                            auto &elements = frames.back().shape->elements;
+                            if (elements == nullptr) {
+                                elements = std::make_unique<Json::ShapeSketch>();
+                            }
+                            shape = elements.get();
+                        } else {
+                            shape = frames.back().member;
+                        }
+                    }
+                    ++shape->count;
+                    switch (token.type) {
+                        case Json::Reader::TokenType::BeginArray: {
+                            ++shape->arrays;
+                            Frame frame;
+                            frame.shape = shape;
+                            frame.array = true;
+                            frames.push_back(frame);
+                        } continue;
+
+                        case Json::Reader::TokenType::BeginObject: {
+                            ++shape->objects;
+                            Frame frame;
+                            frame.shape = shape;
+                            frames.push_back(frame);
+                        } continue;
+
+                        case Json::Reader::TokenType::Null: {
+                            ++shape->nulls;
+                            kind = NULL_KIND;
+                        } break;
+
+                        case Json::Reader::TokenType::True:
+                        case Json::Reader::TokenType::False: {
+                            ++shape->booleans;
+                            kind = BOOLEAN_KIND;
+                        } break;
+
+                        case Json::Reader::TokenType::Integer:
+                        case Json::Reader::TokenType::FloatingPoint: {
+                            intmax_t integer = 0;
+                            double number = 0.0;
+                            if (
+                                (token.type == Json::Reader::TokenType::Integer)
+                                && Json::Reader::DecodeInteger(token.text, integer)
+                            ) {
+                                ++shape->integers;
+                                shape->minimumInteger = std::min(shape->minimumInteger, integer);
+                                shape->maximumInteger = std::max(shape->maximumInteger, integer);
+                                number = (double) integer;
+                                kind = INTEGER_KIND;
+                            } else if (Json::Reader::DecodeFloatingPoint(token.text, number)) {
+                                ++shape->floatingPoints;
+                                kind = FLOATING_POINT_KIND;
+                            } else {
+                                // A number which can't be decoded is left
+                                // out, rather than counted as zero.
+                                --shape->count;
+                                break;
+                            }
+                            shape->minimumNumber = std::min(shape->minimumNumber, number);
+                            shape->maximumNumber = std::max(shape->maximumNumber, number);
+                        } break;
+
+                        case Json::Reader::TokenType::String: {
+                            std::string_view value = token.text;
+                            if (token.escaped) {
+                                decoded.clear();
+                                (void) Json::Reader::DecodeString(token.text, decoded);
+                                value = decoded;
+                            }
+                            ++shape->strings;
+                            shape->minimumStringLength = std::min(shape->minimumStringLength, value.size());
+                            shape->maximumStringLength = std::max(shape->maximumStringLength, value.size());
+                            shape->distinctStrings.Add(value);
+                            kind = STRING_KIND;
+                        } break;
+
+                        default: break;
+                    }
+                }
+                if (
+                    !frames.empty()
+                    && frames.back().array
+                ) {
+                    frames.back().kinds |= kind;
+                    ++frames.back().length;
+                }
+            }
+        }
+
+        /**
+         * This splits the text into tokens.
+         */
+        Json::Reader reader;
+
+        /**
+         * These are the tokens of the document being read.
+         */
+        std::vector<Json::Reader::Token> tokens;
+
+        /**
+         * These are the arrays and objects entered while applying a
+         * document to the sketch.
+         */
+        std::vector<Frame> frames;
+
+        /**
+         * This is a buffer reused to decode keys and strings with
+         * escapes.
+         */
+        std::string decoded;
+
+        /**
+         * This indicates whether the line holding an invalid record
+         * continues into the next chunk, which is then skipped up to the
+         * end of the line.
+         */
+        bool skippingLine = false;
+    };
+
+    /**
+     * This function adds a summary of the given ranges to the given
+     * object, if the ranges aren't empty.
+     */
+    template<typename T>
+    void AddRange(
+        Json::Value &summary,
+        const std::string &name,
+        uint64_t count,
+        T minimum,
+        T maximum
+    ) {
+        if (count == 0) {
+            return;
+        }
+        auto range = Json::Value(Json::Value::Type::Object);
+        range.Set("minimum", minimum);
+        range.Set("maximum", maximum);
+        summary.Set(name, std::move(range));
+    }
+}
+
+namespace Json {
+    void CardinalitySketch::Add(std::string_view value) {
+        if (registers.empty()) {
+            registers.resize(REGISTERS);
+        }
+        const auto hash = Mix(std::hash<std::string_view>()(value));
+        const auto index = (size_t) (hash >> (64 - REGISTER_BITS));
+
+        // The bit set below the hash's remaining bits bounds the count
+        // of leading zeros when they are all zero.
+        const auto rank = (uint8_t) (
+            std::countl_zero((hash << REGISTER_BITS) | ((uint64_t) 1 << (REGISTER_BITS - 1))) + 1
+        );
+        registers[index] = std::max(registers[index], rank);
+    }
+
+    void CardinalitySketch::Merge(const CardinalitySketch &other) {
+        if (other.registers.empty()) {
+            return;
+        }
+        if (registers.empty()) {
+            registers = other.registers;
+            return;
+        }
+        for (size_t i = 0; i < REGISTERS; ++i) {
+            registers[i] = std::max(registers[i], other.registers[i]);
+        }
+    }
+
+    uint64_t CardinalitySketch::Estimate() const {
+        if (registers.empty()) {
+            return 0;
+        }
+        const auto m = (double) REGISTERS;
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (const auto rank: registers) {
+            sum += std::ldexp(1.0, -(int) rank);
+            if (rank == 0) {
+                ++zeros;
+            }
+        }
+        const auto alpha = 0.7213 / (1.0 + 1.079 / m);
+        auto estimate = alpha * m * m / sum;
+
+        // Linear counting is far more accurate while many registers are
+        // still empty.
+        if (
+            (estimate <= 2.5 * m)
+            && (zeros > 0)
+        ) {
+            estimate = m * std::log(m / (double) zeros);
+        }
+        return (uint64_t) std::llround(estimate);
+    }
+
+    void ShapeSketch::Merge(
+        const ShapeSketch &other,
+        size_t maxMembers
+    ) {
+        count += other.count;
+        nulls += other.nulls;
+        booleans += other.booleans;
+        integers += other.integers;
+        floatingPoints += other.floatingPoints;
+        strings += other.strings;
+        arrays += other.arrays;
+        objects += other.objects;
+        minimumInteger = std::min(minimumInteger, other.minimumInteger);
+        maximumInteger = std::max(maximumInteger, other.maximumInteger);
+        minimumNumber = std::min(minimumNumber, other.minimumNumber);
+        maximumNumber = std::max(maximumNumber, other.maximumNumber);
+        minimumStringLength = std::min(minimumStringLength, other.minimumStringLength);
+        maximumStringLength = std::max(maximumStringLength, other.maximumStringLength);
+        distinctStrings.Merge(other.distinctStrings);
+        minimumArrayLength = std::min(minimumArrayLength, other.minimumArrayLength);
+        maximumArrayLength = std::max(maximumArrayLength, other.maximumArrayLength);
+        homogeneousArrays += other.homogeneousArrays;
+        if (other.elements != nullptr) {
+            if (elements == nullptr) {
+                elements = std::make_unique<ShapeSketch>();
+            }
+            elements->Merge(*other.elements, maxMembers);
+        }
+        for (const auto &member: other.members) {
+            auto existing = members.find(member.first);
+            if (existing != members.end()) {
+                existing->second.Merge(member.second, maxMembers);
+            } else if (members.size() < maxMembers) {
+                members[member.first].Merge(member.second, maxMembers);
+            } else {
+                otherKeys.Add(member.first);
+                if (otherMembers == nullptr) {
+                    otherMembers = std::make_unique<ShapeSketch>();
+                }
+                otherMembers->Merge(member.second, maxMembers);
+            }
+        }
+        if (other.otherMembers != nullptr) {
+            if (otherMembers == nullptr) {
+                otherMembers = std::make_unique<ShapeSketch>();
+            }
+            otherMembers->Merge(*other.otherMembers, maxMembers);
+        }
+        otherKeys.Merge(other.otherKeys);
+    }
+
+    Value ShapeSketch::ToValue() const {
+        auto summary = Value(Value::Type::Object);
+        summary.Set("count", (intmax_t) count);
+        auto types = Value(Value::Type::Object);
+        for (
+            const auto &type: {
+                std::make_pair("null", nulls),
+                std::make_pair("boolean", booleans),
+                std::make_pair("integer", integers),
+                std::make_pair("number", floatingPoints),
+                std::make_pair("string", strings),
+                std::make_pair("array", arrays),
+                std::make_pair("object", objects),
+            }
+        ) {
+            if (type.second > 0) {
+                types.Set(type.first, (intmax_t) type.second);
+            }
+        }
+        summary.Set("types", std::move(types));
+        AddRange(summary, "integers", integers, minimumInteger, maximumInteger);
+        AddRange(summary, "numbers", integers + floatingPoints, minimumNumber, maximumNumber);
+        if (strings > 0) {
+            auto stringSummary = Value(Value::Type::Object);
+            stringSummary.Set("distinct", (intmax_t) distinctStrings.Estimate());
+            stringSummary.Set("minimumLength", (intmax_t) minimumStringLength);
+            stringSummary.Set("maximumLength", (intmax_t) maximumStringLength);
+            summary.Set("strings", std::move(stringSummary));
+        }
+        if (arrays > 0) {
+            auto arraySummary = Value(Value::Type::Object);
+            arraySummary.Set("minimumLength", (intmax_t) minimumArrayLength);
+            arraySummary.Set("maximumLength", (intmax_t) maximumArrayLength);
+            arraySummary.Set("homogeneous", (intmax_t) homogeneousArrays);
+            if (elements != nullptr) {
+                arraySummary.Set("items", elements->ToValue());
+            }
+            summary.Set("arrays", std::move(arraySummary));
+        }
+        if (objects > 0) {
+            auto objectSummary = Value(Value::Type::Object);
+            auto properties = Value(Value::Type::Object);
+            auto required = Value(Value::Type::Array);
+            for (const auto &member: members) {
+                properties.Set(member.first, member.second.ToValue());
+                if (member.second.count >= objects) {
+                    required.Add(member.first);
+                }
+            }
+            objectSummary.Set("properties", std::move(properties));
+            objectSummary.Set("required", std::move(required));
+            if (otherMembers != nullptr) {
+                objectSummary.Set("otherProperties", otherMembers->ToValue());
+                objectSummary.Set("otherKeys", (intmax_t) otherKeys.Estimate());
+            }
+            summary.Set("objects", std::move(objectSummary));
+        }
+        return summary;
+    }
+
+    void SchemaSketch::Merge(const SchemaSketch &other) {
+        root.Merge(other.root, maxMembers);
+        invalidRecords += other.invalidRecords;
+    }
+
+    Value SchemaSketch::ToValue() const {
+        auto summary = root.ToValue();
+        summary.Set("invalidRecords", (intmax_t) invalidRecords);
+        return summary;
+    }
+
+    SchemaSketch InferSchema(
+        std::string_view text,
+        const InferenceOptions &options
+    ) {
+        const auto chunkSize = std::max(options.chunkSize, (size_t) 1);
+        const auto threads = CountThreads(options.threads);
+
+        // Small inputs aren't worth the threads.  One thread reads the
+        // text in order, so documents may span lines and chunks.
+        if (
+            (threads == 1)
+            || (text.size() <= chunkSize)
+        ) {
+            Analyzer analyzer(options.maxMembers);
+            size_t start = 0;
+            size_t length = chunkSize;
+            while (start < text.size()) {
+                const auto end = ((text.size() - start <= length) ? text.size() : (start + length));
+                const auto used = analyzer.Analyze(text.substr(start, end - start), (end == text.size()));
+
+                // A record longer than a chunk is read again with twice
+                // as much text, so the cost stays linear in its length.
+                length = ((used == 0) ? (length * 2) : chunkSize);
+                start += used;
+            }
+            return std::move(analyzer.sketch);
+        }
+
+        // Each worker summarizes the chunks it takes into its own
+        // sketch, and the sketches are merged once all are done, so
+        // the workers share nothing but where the next chunk starts.
+        std::mutex mutex;
+        size_t nextStart = 0;
+        std::vector<std::unique_ptr<Analyzer>> analyzers;
+        for (size_t i = 0; i < threads; ++i) {
+            analyzers.push_back(std::make_unique<Analyzer>(options.maxMembers));
+        }
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(
+                [&, i]{
+                    auto &analyzer = *analyzers[i];
+                    while (true) {
+                        size_t start = 0;
+                        size_t end = 0;
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (nextStart >= text.size()) {
+                                break;
+                            }
+                            start = nextStart;
+                            end = FindChunkEnd(text, start, chunkSize);
+                            nextStart = end;
+                        }
+                        (void) analyzer.Analyze(text.substr(start, end - start), true);
+                    }
+                }
+            );
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        auto sketch = std::move(analyzers[0]->sketch);
+        for (size_t i = 1; i < threads; ++i) {
+            sketch.Merge(analyzers[i]->sketch);
+        }
+        return sketch;
+    }
+
+    SchemaSketch InferSchema(
+        std::string_view text,
+        size_t threads
+    ) {
+        InferenceOptions options;
+        options.threads = threads;
+        return InferSchema(text, options);
+    }
+
+    SchemaSketch InferSchema(
+        std::istream &stream,
+        const InferenceOptions &options
+    ) {
+        const auto chunkSize = std::max(options.chunkSize, (size_t) 1);
+        const auto threads = CountThreads(options.threads);
+
+        // One thread reads the stream in order, carrying a record left
+        // incomplete at the end of one chunk over to the next, so
+        // documents may span lines and chunks.
+        if (threads == 1) {
+            Analyzer analyzer(options.maxMembers);
+            std::string chunk;
+            while (true) {
+                const auto size = chunk.size();
+
+                // A record longer than a chunk is read again with twice
+                // as much text, so the cost stays linear in its length.
+                const auto amount = std::max(chunkSize, size);
+                chunk.resize(size + amount);
+                (void) stream.read(chunk.data() + size, (std::streamsize) amount);
+                chunk.resize(size + (size_t) stream.gcount());
+                const auto final = !stream;
+                const auto used = analyzer.Analyze(chunk, final);
+                if (final) {
+                    break;
+                }
+                chunk.erase(0, used);
+            }
+            return std::move(analyzer.sketch);
+        }
+
+        // The calling thread reads the stream into chunks ending at the
+        // end of a line, carrying what follows the last newline over to
+        // the next chunk.
+        std::string carry;
+        const auto readChunk = [&]{
+            auto chunk = std::move(carry);
+            carry.clear();
+            while (stream) {
+                const auto size = chunk.size();
+                chunk.resize(size + chunkSize);
+                (void) stream.read(chunk.data() + size, (std::streamsize) chunkSize);
+                chunk.resize(size + (size_t) stream.gcount());
+                const auto newline = chunk.rfind('\n');
+                if (
+                    stream
+                    && (newline != std::string::npos)
+                ) {
+                    carry = chunk.substr(newline + 1);
+                    chunk.resize(newline + 1);
+                    break;
+                }
+            }
+            return chunk;
+        };
+        // Chunks wait in a bounded queue, so a slow thread holds back
+        // the reading rather than memory use growing with the input.
+        const auto window = threads * 2;
+        std::deque<std::string> queue;
+        bool finished = false;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<std::unique_ptr<Analyzer>> analyzers;
+        for (size_t i = 0; i < threads; ++i) {
+            analyzers.push_back(std::make_unique<Analyzer>(options.maxMembers));
+        }
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(
+                [&, i]{
+                    auto &analyzer = *analyzers[i];
+                    while (true) {
+                        std::string chunk;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            changed.wait(
+                                lock,
+                                [&]{
+                                    return (
+                                        finished
+                                        || !queue.empty()
+                                    );
+                                }
+                            );
+                            if (queue.empty()) {
+                                break;
+                            }
+                            chunk = std::move(queue.front());
+                            queue.pop_front();
+                        }
+                        changed.notify_all();
+                        (void) analyzer.Analyze(chunk, true);
+                    }
+                }
+            );
+        }
+        while (true) {
+            auto chunk = readChunk();
+            std::unique_lock<std::mutex> lock(mutex);
+            if (chunk.empty()) {
+                finished = true;
+                lock.unlock();
+                changed.notify_all();
+                break;
+            }
+            changed.wait(
+                lock,
+                [&]{
+                    return (queue.size() < window);
+                }
+            );
+            queue.push_back(std::move(chunk));
+            lock.unlock();
+            changed.notify_all();
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        auto sketch = std::move(analyzers[0]->sketch);
+        for (size_t i = 1; i < threads; ++i) {
+            sketch.Merge(analyzers[i]->sketch);
+        }
+        return sketch;
+    }
+
+    SchemaSketch InferSchema(
+        std::istream &stream,
+        size_t threads
+    ) {
+        InferenceOptions options;
+        options.threads = threads;
+        return InferSchema(stream, options);
+    }
+}
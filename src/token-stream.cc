@@ -0,0 +1,150 @@
+#include "token-stream.h"
+
+#include <algorithm>
+#include <istream>
+
+namespace {
+    /**
+     * This is the amount of text fed to the reader at once.
+     */
+    constexpr size_t CHUNK_SIZE = 65536;
+
+    /**
+     * This returns an indication of whether or not the given text
+     * holds any characters outside ASCII.
+     */
+    bool HasNonAscii(std::string_view text) {
+        return std::any_of(
+            text.begin(),
+            text.end(),
+            [](char c){ return ((unsigned char) c >= 0x80); }
+        );
+    }
+}
+
+namespace Json {
+    namespace Detail {
+        TokenSource::TokenSource(std::string_view text)
+            : text(text) {
+        }
+
+        TokenSource::TokenSource(std::istream &stream)
+            : stream(&stream)
+              , chunk(CHUNK_SIZE) {
+        }
+
+        Reader::Status TokenSource::Next(Reader::Token &token) {
+            while (true) {
+                const auto status = reader.Next(token);
+                if (status != Reader::Status::NeedInput) {
+                    return status;
+                }
+                Refill();
+            }
+        }
+
+        Reader::Status TokenSource::Skip() {
+            while (true) {
+                const auto status = reader.Skip();
+                if (status != Reader::Status::NeedInput) {
+                    return status;
+                }
+                Refill();
+            }
+        }
+
+        const Reader &TokenSource::GetReader() const {
+            return reader;
+        }
+
+        void TokenSource::Refill() {
+            if (stream == nullptr) {
+                if (text.empty()) {
+                    reader.Finish();
+                } else {
+                    const auto amount = std::min(text.size(), CHUNK_SIZE);
+                    reader.Feed(text.substr(0, amount));
+                    text.remove_prefix(amount);
+                }
+                return;
+            }
+            (void) stream->read(chunk.data(), (std::streamsize) chunk.size());
+            const auto amount = (size_t) stream->gcount();
+            if (amount == 0) {
+                reader.Finish();
+            } else {
+                reader.Feed(std::string_view(chunk.data(), amount));
+            }
+        }
+
+        bool CopyToken(
+            const Reader::Token &token,
+            Writer &writer,
+            bool escapeNonAscii,
+            std::string &scratch
+        ) {
+            switch (token.type) {
+                case Reader::TokenType::BeginObject: {
+                    (void) writer.BeginObject();
+                }
+                break;
+
+                case Reader::TokenType::EndObject: {
+                    (void) writer.EndObject();
+                }
+                break;
+
+                case Reader::TokenType::BeginArray: {
+                    (void) writer.BeginArray();
+                }
+                break;
+
+                case Reader::TokenType::EndArray: {
+                    (void) writer.EndArray();
+                }
+                break;
+
+                case Reader::TokenType::Key:
+                case Reader::TokenType::String: {
+                    const auto isKey = (token.type == Reader::TokenType::Key);
+                    const auto reencode = (
+                        escapeNonAscii
+                        && HasNonAscii(token.text)
+                    );
+                    if (
+                        token.escaped
+                        || reencode
+                    ) {
+                        scratch.clear();
+                        if (!Reader::DecodeString(token.text, scratch)) {
+                            return false;
+                        }
+                        if (reencode) {
+                            if (isKey) {
+                                (void) writer.Key(scratch);
+                            } else {
+                                (void) writer.String(scratch);
+                            }
+                            break;
+                        }
+                    }
+                    scratch.assign(1, '"');
+                    scratch += token.text;
+                    scratch += '"';
+                    if (isKey) {
+                        (void) writer.RawKey(scratch);
+                    } else {
+                        (void) writer.RawValue(scratch);
+                    }
+                }
+                break;
+
+                default: {
+                    (void) writer.RawValue(token.text);
+                }
+                break;
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <iosfwd>
+#include <reader.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <writer.h>
+
+namespace Json {
+    namespace Detail {
+        /**
+         * This reads the tokens of JSON text held in a string or read
+         * from a stream, feeding the reader in fixed-size chunks, so that
+         * memory use doesn't depend on the length of the text.
+         */
+        class TokenSource {
+        public:
+            /**
+             * This constructs a source reading the given text, which must
+             * remain valid while the source is used.
+             */
+            explicit TokenSource(std::string_view text);
+
+            /**
+             * This constructs a source reading the given stream.
+             */
+            explicit TokenSource(std::istream &stream);
+
+            /**
+             * This reads the next token.
+             *
+             * @param[out] token
+             *     This is where to store the token.
+             *
+             * @return
+             *     Reader::Status::Token if a token was stored, otherwise
+             *     Reader::Status::End or Reader::Status::Error is returned.
+             */
+            Reader::Status Next(Reader::Token &token);
+
+            /**
+             * This skips the next value, as Reader::Skip() does.
+             *
+             * @return
+             *     Reader::Status::Token once the value has been skipped,
+             *     otherwise Reader::Status::End or Reader::Status::Error
+             *     is returned.
+             */
+            Reader::Status Skip();
+
+            /**
+             * This returns the reader, for its depth and position.
+             */
+            const Reader &GetReader() const;
+
+        private:
+            /**
+             * This feeds the reader the next chunk of the input, or tells
+             * it that the input is finished.
+             */
+            void Refill();
+
+            /**
+             * This is the text not yet fed to the reader, if reading text.
+             */
+            std::string_view text;
+
+            /**
+             * This is the stream being read, if any.
+             */
+            std::istream *stream = nullptr;
+
+            /**
+             * This is the buffer into which text is read from the stream.
+             */
+            std::vector<char> chunk;
+
+            /**
+             * This splits the text into tokens.
+             */
+            Reader reader;
+        };
+
+        /**
+         * This writes the given token to the given writer, checking the
+         * escape sequences of strings and keys and otherwise copying
+         * their text as written.
+         *
+         * @param[in] token
+         *     This is the token to write.
+         *
+         * @param[in,out] writer
+         *     This is the writer to which to write the token.
+         *
+         * @param[in] escapeNonAscii
+         *     This indicates whether strings and keys holding non-ASCII
+         *     characters should be re-encoded with them escaped.
+         *
+         * @param[in,out] scratch
+         *     This is a buffer reused between calls.
+         *
+         * @return
+         *     An indication of whether or not the token is valid is
+         *     returned.
+         */
+        bool CopyToken(
+            const Reader::Token &token,
+            Writer &writer,
+            bool escapeNonAscii,
+            std::string &scratch
+        );
+    }
+}
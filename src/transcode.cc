@@ -0,0 +1,93 @@
+#include "token-stream.h"
+
+#include <ostream>
+#include <transcode.h>
+#include <writer.h>
+
+namespace {
+    /**
+     * This copies the JSON text from the given source to the given
+     * writer, one token at a time.
+     *
+     * @param[in,out] source
+     *     This is the source of the JSON text.
+     *
+     * @param[in,out] writer
+     *     This is the writer to which to copy the text.
+     *
+     * @param[in] options
+     *     These are the options with which the writer was constructed.
+     *
+     * @return
+     *     An indication of whether or not the text is valid JSON
+     *     is returned.
+     */
+    bool Transcode(
+        Json::Detail::TokenSource &source,
+        Json::Writer &writer,
+        const Json::EncodingOptions &options
+    ) {
+        Json::Reader::Token token;
+        std::string scratch;
+        while (true) {
+            switch (source.Next(token)) {
+                case Json::Reader::Status::Token: {
+                    if (!Json::Detail::CopyToken(token, writer, options.escapeNonAscii, scratch)) {
+                        return false;
+                    }
+                }
+                break;
+
+                case Json::Reader::Status::End: return true;
+
+                default: return false;
+            }
+        }
+    }
+
+    /**
+     * This returns a function which writes its text to the given stream,
+     * for a writer to use as its sink.
+     */
+    Json::Writer::Sink StreamSink(std::ostream &stream) {
+        return [&stream](std::string_view chunk){
+            (void) stream.write(chunk.data(), (std::streamsize) chunk.size());
+        };
+    }
+}
+
+namespace Json {
+    bool Minify(
+        std::string_view input,
+        std::string &output
+    ) {
+        return Reformat(input, output, EncodingOptions());
+    }
+
+    bool Minify(
+        std::istream &input,
+        std::ostream &output
+    ) {
+        return Reformat(input, output, EncodingOptions());
+    }
+
+    bool Reformat(
+        std::string_view input,
+        std::string &output,
+        const EncodingOptions &options
+    ) {
+        Detail::TokenSource source(input);
+        Writer writer(output, options);
+        return Transcode(source, writer, options);
+    }
+
+    bool Reformat(
+        std::istream &input,
+        std::ostream &output,
+        const EncodingOptions &options
+    ) {
+        Detail::TokenSource source(input);
+        Writer writer(StreamSink(output), options);
+        return Transcode(source, writer, options);
+    }
+}
@@ -1,22 +1,429 @@
 #include <algorithm>
-#include <cinttypes>
+#include <builder.h>
+#include <charconv>
+#include <istream>
 #include <value.h>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include "encoding.h"
+#include <pointer.h>
+#include <random>
+#include <reader.h>
 #include <set>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <StringExtensions/StringExtensions.hpp>
 #include <Utf8/Utf8.hpp>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef JSONKIT_CUSTOM_TRAITS_HEADER
+#include JSONKIT_CUSTOM_TRAITS_HEADER
+#endif
+
 namespace {
     /**
-     * This is returned from indexers when indexed values are
-     * not found.  Trying to modify it has no effect.
+     * This returns the value returned from indexers when indexed
+     * values are not found.  Trying to modify it has no effect.
+     *
+     * @return
+     *     The null value shared by all values of the given
+     *     configuration is returned.
+     */
+    template<typename Traits>
+    Json::BasicValue<Traits> &NullValue() {
+        static Json::BasicValue<Traits> null(nullptr);
+        return null;
+    }
+
+    /**
+     * This is the amount of text collected before it's passed to or
+     * taken from a stream.
+     */
+    constexpr size_t STREAM_BUFFER_SIZE = 65536;
+
+    /**
+     * This appends the given number to the given blob, seven bits at a
+     * time, least significant first, with the top bit of each byte set
+     * if more follow.
+     */
+    void AppendVarint(
+        std::string &blob,
+        uint64_t number
+    ) {
+        while (number >= 0x80) {
+            blob += (char) ((number & 0x7F) | 0x80);
+            number >>= 7;
+        }
+        blob += (char) number;
+    }
+
+    /**
+     * This reads a number appended by AppendVarint() from the front of
+     * the given blob.
+     *
+     * @return
+     *     An indication of whether or not a whole number was read is
+     *     returned.
+     */
+    bool ReadVarint(
+        std::string_view &blob,
+        uint64_t &number
+    ) {
+        number = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            if (blob.empty()) {
+                return false;
+            }
+            const auto byte = (uint8_t) blob[0];
+            blob.remove_prefix(1);
+            number |= (uint64_t) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * This reads a string appended as its length, by AppendVarint(),
+     * followed by its characters, from the front of the given blob.
+     *
+     * @return
+     *     An indication of whether or not a whole string was read is
+     *     returned.
+     */
+    bool ReadBlobString(
+        std::string_view &blob,
+        std::string_view &string
+    ) {
+        uint64_t length;
+        if (
+            !ReadVarint(blob, length)
+            || (length > blob.size())
+        ) {
+            return false;
+        }
+        string = blob.substr(0, (size_t) length);
+        blob.remove_prefix((size_t) length);
+        return true;
+    }
+
+    /**
+     * This is a node in the tree of paths learned by an access profile,
+     * standing for an array or object which was accessed.  Nodes are
+     * never changed once shared, so that a parse can use them without
+     * holding the profile's lock; learning a path copies the nodes along
+     * it instead.
+     */
+    struct ProfileNode {
+        /**
+         * These are the members of an object which were accessed, by
+         * key.
+         */
+        std::map<std::string, std::shared_ptr<const ProfileNode>, std::less<>> members;
+
+        /**
+         * This stands for the elements of an array which were accessed.
+         */
+        std::shared_ptr<const ProfileNode> elements;
+    };
+
+    /**
+     * This is what an access profile has learned.
+     */
+    struct AccessProfile {
+        std::mutex mutex;
+        std::shared_ptr<const ProfileNode> root;
+    };
+
+    /**
+     * This is the path of an array or object from the top-level value,
+     * with each step the key of a member, or nullopt for an element of
+     * an array.
+     */
+    using ProfilePath = std::vector<std::optional<std::string>>;
+
+    /**
+     * This is an array or object parsed with an access profile which
+     * didn't expect it to be accessed, kept as its text until it is.
+     */
+    struct LazyText {
+        /**
+         * This is the profile with which the value was parsed, if any.
+         */
+        std::shared_ptr<AccessProfile> profile;
+
+        /**
+         * This is the path of the value in the document parsed with
+         * the profile.
+         */
+        ProfilePath path;
+
+        /**
+         * This is the text of the value, which has been checked to be
+         * valid.
+         */
+        std::string text;
+    };
+
+    /**
+     * This returns the access profile with the given name, creating it
+     * if need be.
+     */
+    std::shared_ptr<AccessProfile> GetAccessProfile(const std::string &name) {
+        struct Profiles {
+            std::mutex mutex;
+            std::map<std::string, std::shared_ptr<AccessProfile>, std::less<>> byName;
+        };
+
+        // This is never destroyed, since values may outlive it.
+        static const auto profiles = new Profiles;
+        std::lock_guard<std::mutex> lock(profiles->mutex);
+        auto &profile = profiles->byName[name];
+        if (profile == nullptr) {
+            profile = std::make_shared<AccessProfile>();
+        }
+        return profile;
+    }
+
+    /**
+     * This returns a copy of the given profile node, or a new one if
+     * there isn't one, with the given path below it added.
+     *
+     * @param[in] node
+     *     This is the node to which to add the path, if any.
+     *
+     * @param[in] path
+     *     This is the path being added.
+     *
+     * @param[in] depth
+     *     This is the number of steps of the path leading to the node.
+     *
+     * @param[out] added
+     *     This is where to store the node at the end of the path.
+     *
+     * @return
+     *     The node with the path added is returned.
+     */
+    std::shared_ptr<const ProfileNode> AddProfilePath(
+        const std::shared_ptr<const ProfileNode> &node,
+        const ProfilePath &path,
+        size_t depth,
+        std::shared_ptr<const ProfileNode> &added
+    ) {
+        auto copy = (
+            (node == nullptr)
+            ? std::make_shared<ProfileNode>()
+            : std::make_shared<ProfileNode>(*node)
+        );
+        if (depth == path.size()) {
+            added = copy;
+            return copy;
+        }
+        auto &child = (
+            path[depth].has_value()
+            ? copy->members[*path[depth]]
+            : copy->elements
+        );
+        child = AddProfilePath(child, path, depth + 1, added);
+        return copy;
+    }
+
+    /**
+     * This notes that the array or object with the given path was
+     * accessed in a document parsed with the given access profile.
+     *
+     * @return
+     *     The profile's node for the path is returned.
+     */
+    std::shared_ptr<const ProfileNode> RecordAccess(
+        AccessProfile &profile,
+        const ProfilePath &path
+    ) {
+        std::lock_guard<std::mutex> lock(profile.mutex);
+        auto node = profile.root;
+        for (const auto &step: path) {
+            if (node == nullptr) {
+                break;
+            }
+            if (step.has_value()) {
+                const auto member = node->members.find(*step);
+                node = ((member == node->members.end()) ? nullptr : member->second);
+            } else {
+                node = node->elements;
+            }
+        }
+        if (node == nullptr) {
+            profile.root = AddProfilePath(profile.root, path, 0, node);
+        }
+        return node;
+    }
+
+    /**
+     * This appends the JSON Pointers of the arrays and objects below the
+     * given profile node to the given list.
+     *
+     * @param[in] node
+     *     This is the profile node.
+     *
+     * @param[in,out] tokens
+     *     These are the tokens of the pointer to the node.
+     *
+     * @param[in,out] paths
+     *     This is the list to which to append the pointers.
+     */
+    void CollectProfiledPaths(
+        const ProfileNode &node,
+        std::vector<std::string> &tokens,
+        std::vector<std::string> &paths
+    ) {
+        const auto collect = [&](const std::string &token, const ProfileNode &child) {
+            tokens.push_back(token);
+            paths.push_back(Json::Pointer::FromTokens(tokens).ToString());
+            CollectProfiledPaths(child, tokens, paths);
+            tokens.pop_back();
+        };
+        if (node.elements != nullptr) {
+            collect("*", *node.elements);
+        }
+        for (const auto &member: node.members) {
+            collect(member.first, *member.second);
+        }
+    }
+
+    /**
+     * This collects text to be written out, passing it to the sink
+     * in chunks of about the given size.
+     */
+    struct StreamBuffer {
+        std::function<void(std::string_view)> sink;
+        size_t size = STREAM_BUFFER_SIZE;
+        std::string text;
+
+        explicit StreamBuffer(
+            std::function<void(std::string_view)> sink,
+            size_t size = STREAM_BUFFER_SIZE
+        )
+            : sink(std::move(sink))
+              , size(size) {
+        }
+
+        void Flush() {
+            if (!text.empty()) {
+                sink(text);
+                text.clear();
+            }
+        }
+
+        void MaybeFlush() {
+            if (text.size() >= size) {
+                Flush();
+            }
+        }
+    };
+
+    /**
+     * This flushes the given file's contents to its storage device.
+     *
+     * @return
+     *     An indication of whether or not the contents were flushed
+     *     is returned.
+     */
+    bool SyncFile(FILE *file) {
+#ifdef _WIN32
+        return (_commit(_fileno(file)) == 0);
+#else
+        return (fsync(fileno(file)) == 0);
+#endif
+    }
+
+    /**
+     * This flushes the entries of the given directory to its storage
+     * device, so that a file renamed into it stays renamed after a
+     * crash.  Windows has no equivalent, and needs none.
+     */
+    void SyncDirectory(const std::filesystem::path &directory) {
+#ifndef _WIN32
+        const auto fd = open(
+            (directory.empty() ? "." : directory.c_str()),
+            O_RDONLY
+        );
+        if (fd >= 0) {
+            (void) fsync(fd);
+            (void) close(fd);
+        }
+#else
+        (void) directory;
+#endif
+    }
+
+    /**
+     * This gives the given file the permissions of the file at the
+     * given path, if there is one, so that a file replacing it keeps
+     * them.  On Windows, files replacing others keep the defaults.
+     */
+    void CopyFileMode(
+        const std::filesystem::path &original,
+        FILE *file
+    ) {
+#ifndef _WIN32
+        struct stat status;
+        if (stat(original.c_str(), &status) == 0) {
+            (void) fchmod(fileno(file), status.st_mode & 07777);
+        }
+#else
+        (void) original;
+        (void) file;
+#endif
+    }
+
+    /**
+     * This reserves space for the given file, if the platform
+     * supports it.
+     *
+     * @return
+     *     An indication of whether or not space was reserved is
+     *     returned.
      */
-    Json::Value null(nullptr);
+    bool PreallocateFile(
+        FILE *file,
+        size_t size
+    ) {
+#if defined(_WIN32) || defined(__APPLE__)
+        (void) file;
+        (void) size;
+        return false;
+#else
+        return (
+            (size > 0)
+            && (posix_fallocate(fileno(file), 0, (off_t) size) == 0)
+        );
+#endif
+    }
 
     /**
      * These are the character that are considered "whitespace"
@@ -44,20 +451,6 @@ namespace {
         {0x74, 0x09}, // '\t'
     };
 
-    /**
-     * This maps special characters to their escaped representations.
-     */
-    const std::map<Utf8::UnicodeCodePoint, Utf8::UnicodeCodePoint> SPECIAL_ESCAPE_ENCODINGS{
-        {0x22, 0x22}, // '"'
-        {0x5C, 0x5C}, // '\\'
-        {0x2F, 0x2F}, // '\\'
-        {0x08, 0x62}, // '\b'
-        {0x0C, 0x66}, // '\f'
-        {0x0A, 0x6E}, // '\n'
-        {0x0D, 0x72}, // '\r'
-        {0x09, 0x74}, // '\t'
-    };
-
     /**
      * This method finds the offset of the first code point in the
      * given vector of code points that is not in the given search set.
@@ -103,86 +496,6 @@ namespace {
         }
     }
 
-    /**
-     * This function returns a string consisting of the four hex digits
-     * matching the given code point in hexadecimal.
-     *
-     * @param[in] cp
-     *     This is the code point to render as four hex digits.
-     *
-     * @return
-     *     This is the four hex digit rendering of the given code point.
-     */
-    std::string CodePointToFourHexDigits(Utf8::UnicodeCodePoint cp) {
-        std::string rendering;
-        for (size_t i = 0; i < 4; ++i) {
-            const auto nibble = ((cp >> (4 * (3 - i))) & 0x0F);
-            if (nibble < 10) {
-                rendering += (char) nibble + '0';
-            } else {
-                rendering += (char) (nibble - 10) + 'A';
-            }
-        }
-        return rendering;
-    }
-
-    /**
-     * This function returns the JSON encoding of the given string.
-     *
-     * @param[in] s
-     *     This is the string which needs to be escaped.
-     *
-     * @param[in] options
-     *     This is used to configure various options having to do with
-     *     encoding a Json value into its string format.
-     *
-     * @return
-     *     The encoded string is returned.
-     */
-    std::string EncodeString(
-        const std::string &s,
-        const Json::EncodingOptions &options
-    ) {
-        Utf8::Utf8 utf8;
-        std::string output;
-        for (const auto cp: utf8.Decode(s)) {
-            if (
-                (cp == 0x22)
-                || (cp == 0x5C)
-                || (cp < 0x20)
-            ) {
-                output += '\\';
-                const auto entry = SPECIAL_ESCAPE_ENCODINGS.find(cp);
-                if (entry == SPECIAL_ESCAPE_ENCODINGS.end()) {
-                    output += 'u';
-                    output += CodePointToFourHexDigits(cp);
-                } else {
-                    output += (char) entry->second;
-                }
-            } else if (
-                options.escapeNonAscii
-                && (cp > 0x7F)
-            ) {
-                if (cp > 0xFFFF) {
-                    output += "\\u";
-                    output += CodePointToFourHexDigits(0xD800 + (((cp - 0x10000) >> 10) & 0x3FF));
-                    output += "\\u";
-                    output += CodePointToFourHexDigits(0xDC00 + ((cp - 0x10000) & 0x3FF));
-                } else {
-                    output += "\\u";
-                    output += CodePointToFourHexDigits(cp);
-                }
-            } else {
-                const auto encoding = utf8.Encode({cp});
-                output += std::string(
-                    encoding.begin(),
-                    encoding.end()
-                );
-            }
-        }
-        return output;
-    }
-
     /**
      * This function return the JSON decoding of the given string.
      *
@@ -333,9 +646,10 @@ namespace {
      *     arrays of JSON values are considered equalivalent
      *     is returned.
      */
+    template<typename ArrayType>
     bool CompareJsonArrays(
-        const std::vector<Json::Value> &lhs,
-        const std::vector<Json::Value> &rhs
+        const ArrayType &lhs,
+        const ArrayType &rhs
     ) {
         if (lhs.size() != rhs.size()) {
             return false;
@@ -364,9 +678,10 @@ namespace {
      *     JSON objects are considered equalivalent
      *     is returned.
      */
+    template<typename ObjectType>
     bool CompareJsonObjects(
-        const std::map<std::string, Json::Value> &lhs,
-        const std::map<std::string, Json::Value> &rhs
+        const ObjectType &lhs,
+        const ObjectType &rhs
     ) {
         std::set<std::string> keys;
         for (const auto &entry: lhs) {
@@ -397,48 +712,55 @@ namespace {
 }
 
 namespace Json {
-    Value::Iterator::Iterator(
-        const Json::Value *container,
-        std::vector<Value>::const_iterator &&nextArrayEntry
+    template<typename Traits>
+    BasicValue<Traits>::Iterator::Iterator(
+        const BasicValue *container,
+        typename ArrayType::const_iterator &&nextArrayEntry
     )
         : container(container)
           , nextArrayEntry(std::move(nextArrayEntry)) {
     }
 
-    Value::Iterator::Iterator(
-        const Json::Value *container,
-        std::map<std::string, Value>::const_iterator &&nextObjectEntry
+    template<typename Traits>
+    BasicValue<Traits>::Iterator::Iterator(
+        const BasicValue *container,
+        typename ObjectType::const_iterator &&nextObjectEntry
     )
         : container(container)
           , nextObjectEntry(std::move(nextObjectEntry)) {
     }
 
-    void Value::Iterator::operator++() {
-        if (container->GetType() == Value::Type::Array) {
+    template<typename Traits>
+    void BasicValue<Traits>::Iterator::operator++() {
+        if (container->GetType() == Type::Array) {
             ++nextArrayEntry;
         } else {
             ++nextObjectEntry;
         }
     }
 
-    bool Value::Iterator::operator!=(const Iterator &other) const {
-        if (container->GetType() == Value::Type::Array) {
+    template<typename Traits>
+    bool BasicValue<Traits>::Iterator::operator!=(const Iterator &other) const {
+        if (container->GetType() == Type::Array) {
             return nextArrayEntry != other.nextArrayEntry;
         } else {
             return nextObjectEntry != other.nextObjectEntry;
         }
     }
 
-    auto Value::Iterator::operator*() -> Iterator & {
+    template<typename Traits>
+    auto BasicValue<Traits>::Iterator::operator*() -> Iterator & {
         return *this;
     }
 
-    const std::string &Value::Iterator::key() const {
+    template<typename Traits>
+    const std::string &BasicValue<Traits>::Iterator::key() const {
         return nextObjectEntry->first;
     }
 
-    const Json::Value &Value::Iterator::value() const {
-        if (container->GetType() == Value::Type::Array) {
+    template<typename Traits>
+    const BasicValue<Traits> &BasicValue<Traits>::Iterator::value() const {
+        if (container->GetType() == Type::Array) {
             return *nextArrayEntry;
         } else {
             return nextObjectEntry->second;
@@ -446,9 +768,10 @@ namespace Json {
     }
 
     /**
-     * This contains the private properties of a Value instance.
+     * This contains the private properties of a BasicValue instance.
      */
-    struct Value::Impl {
+    template<typename Traits>
+    struct BasicValue<Traits>::Impl {
         // Properties
 
         /**
@@ -457,28 +780,123 @@ namespace Json {
          */
         Type type = Type::Invalid;
 
+        /**
+         * This indicates whether changes to the value are recorded,
+         * in which case its link is kept by GetTracking().  It sits in
+         * what would otherwise be padding after the type.
+         */
+        bool tracked = false;
+
         /**
          * This holds the actual value represented by the JSON
          * value.  Use the member that matches the type.
+         *
+         * An invalid value uses stringValue to hold the text which
+         * failed to parse, if any.
          */
         union {
             bool booleanValue;
-            std::string *stringValue;
-            std::vector<Value> *arrayValue;
-            std::map<std::string, Value> *objectValue;
-            intmax_t integerValue;
-            double floatingPointValue;
+            std::string *stringValue = nullptr;
+            ArrayType *arrayValue;
+            ObjectType *objectValue;
+            LazyText *lazyValue;
+            IntegerType integerValue;
+            FloatingPointType floatingPointValue;
+        };
+
+        /**
+         * This takes the place of the encoding cache in
+         * configurations which don't cache encodings.
+         */
+        struct NoEncodingCache {
         };
 
         /**
          * This is a cache of the encoding of the value.
          */
-        std::string encoding;
+        [[no_unique_address]] std::conditional_t<
+            Traits::cacheEncoding,
+            std::string,
+            NoEncodingCache
+        > encoding;
+
+        /**
+         * This is where the value was in the text from which it was
+         * parsed.  The offset is from the start of the array or object
+         * holding the value, or from the start of the text for the
+         * top-level value, so that an edit moves only what follows it
+         * in the same array or object.  A length of zero means the
+         * value wasn't parsed from text.
+         */
+        struct SourceSpan {
+            size_t offset = 0;
+            size_t length = 0;
+        };
+
+        /**
+         * This takes the place of the source span in
+         * configurations which don't keep source spans.
+         */
+        struct NoSourceSpan {
+        };
+
+        /**
+         * This is where the value was in the text from which it was
+         * parsed, if it was.
+         */
+        [[no_unique_address]] std::conditional_t<
+            Traits::keepSourceSpans,
+            SourceSpan,
+            NoSourceSpan
+        > span;
+
+        /**
+         * This is how long an array or object has been idle, as the
+         * number of sweeps made of the document holding it since it was
+         * last accessed, and whether it's frozen, in which case
+         * stringValue holds its blob in place of arrayValue or
+         * objectValue, or not yet parsed, in which case lazyValue holds
+         * its text.  Counting sweeps per value, rather than for all
+         * values of a configuration, keeps sweeping one document from
+         * aging another.
+         */
+        struct AccessState {
+            uint32_t sweepsSinceAccess = 0;
+            bool frozen = false;
+            bool lazy = false;
+        };
+
+        /**
+         * This takes the place of the access state in configurations
+         * which don't freeze cold subtrees.
+         */
+        struct NoAccessState {
+        };
+
+        /**
+         * This is when the value was last accessed, and whether it's
+         * frozen.
+         */
+        [[no_unique_address]] std::conditional_t<
+            Traits::freezeColdSubtrees,
+            AccessState,
+            NoAccessState
+        > access;
 
         // Lifecycle management
 
         ~Impl() noexcept {
+            Untrack();
+            if (IsFrozen()) {
+                delete stringValue;
+                return;
+            }
+            if (IsLazy()) {
+                delete lazyValue;
+                return;
+            }
             switch (type) {
+                case Type::Invalid:
                 case Type::String: {
                     delete stringValue;
                 }
@@ -514,435 +932,2784 @@ namespace Json {
         Impl() = default;
 
         /**
-         * This method builds the JSON value up as a copy
-         * of another JSON value.
-         *
-         * @param[in] other
-         *     This is the other JSON value to copy.
+         * This method discards the cached encoding of the value,
+         * if there is one.
          */
-        void CopyFrom(const std::unique_ptr<Impl> &other) {
-            type = other->type;
-            switch (type) {
-                case Type::Boolean: {
-                    booleanValue = other->booleanValue;
-                }
-                break;
-
-                case Type::Integer: {
-                    integerValue = other->integerValue;
-                }
-                break;
+        void ClearEncoding() {
+            if constexpr (Traits::cacheEncoding) {
+                encoding.clear();
+            }
+        }
 
-                case Type::FloatingPoint: {
-                    floatingPointValue = other->floatingPointValue;
-                }
-                break;
+        /**
+         * This method forgets where the value was in the text from which
+         * it was parsed, if it keeps that, so that Reparse() doesn't
+         * reuse it, or anything holding it, in place of the new text.
+         * It's called on each array or object changed, and on each one
+         * through which a member or element may be changed, and since
+         * the values holding a nested value are reached on the way to
+         * it, all of them are cleared too.
+         */
+        void ClearSpan() {
+            if constexpr (Traits::keepSourceSpans) {
+                span = SourceSpan{};
+            }
+        }
 
-                case Type::String: {
+        /**
+         * This function indicates whether the value is a frozen array or
+         * object.
+         *
+         * @return
+         *     An indication of whether or not the value is frozen is
+         *     returned.
+         */
+        bool IsFrozen() const {
+            if constexpr (Traits::freezeColdSubtrees) {
+                return access.frozen;
+            } else {
+                return false;
+            }
+        }
+
+        /**
+         * This function indicates whether the value is an array or
+         * object which hasn't yet been parsed from its text.
+         *
+         * @return
+         *     An indication of whether or not the value is lazy is
+         *     returned.
+         */
+        bool IsLazy() const {
+            if constexpr (Traits::freezeColdSubtrees) {
+                return access.lazy;
+            } else {
+                return false;
+            }
+        }
+
+        /**
+         * This function notes that the value was accessed, if it's an
+         * array or object, and thaws it if it's frozen or lazy.  Other values
+         * aren't noted, so that the shared null value is never written.
+         */
+        void Touch() {
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (
+                    (type == Type::Array)
+                    || (type == Type::Object)
+                ) {
+                    access.sweepsSinceAccess = 0;
+                    if (
+                        access.frozen
+                        || access.lazy
+                    ) {
+                        Thaw();
+                    }
+                }
+            }
+        }
+
+        /**
+         * This function appends the given value, marked with its type,
+         * to the given blob.
+         *
+         * @param[in,out] blob
+         *     This is the blob to which to append the value.
+         *
+         * @param[in] impl
+         *     This is the value to append.
+         */
+        static void AppendToBlob(
+            std::string &blob,
+            const Impl &impl
+        ) {
+            if (impl.IsFrozen()) {
+                blob += ((impl.type == Type::Array) ? 'A' : 'O');
+                AppendVarint(blob, impl.stringValue->size());
+                blob += *impl.stringValue;
+                return;
+            }
+            if (impl.IsLazy()) {
+                // The profile with which the value was parsed isn't kept.
+                blob += 'j';
+                AppendVarint(blob, impl.lazyValue->text.size());
+                blob += impl.lazyValue->text;
+                return;
+            }
+            switch (impl.type) {
+                case Type::Null: {
+                    blob += 'n';
+                } break;
+
+                case Type::Boolean: {
+                    blob += (impl.booleanValue ? 't' : 'f');
+                } break;
+
+                case Type::Integer: {
+                    // Integers are zigzag-encoded, so that small negative
+                    // ones take few bytes too.
+                    const auto integer = (int64_t) impl.integerValue;
+                    blob += 'i';
+                    AppendVarint(blob, ((uint64_t) integer << 1) ^ (uint64_t) (integer >> 63));
+                } break;
+
+                case Type::FloatingPoint: {
+                    const auto number = (double) impl.floatingPointValue;
+                    char bytes[sizeof(number)];
+                    (void) memcpy(bytes, &number, sizeof(number));
+                    blob += 'd';
+                    blob.append(bytes, sizeof(bytes));
+                } break;
+
+                case Type::String: {
+                    blob += 's';
+                    AppendVarint(blob, impl.stringValue->size());
+                    blob += *impl.stringValue;
+                } break;
+
+                case Type::Array: {
+                    blob += 'a';
+                    AppendContentsToBlob(blob, impl);
+                } break;
+
+                case Type::Object: {
+                    blob += 'o';
+                    AppendContentsToBlob(blob, impl);
+                } break;
+
+                default: {
+                    const auto text = (impl.stringValue == nullptr) ? std::string() : *impl.stringValue;
+                    blob += 'x';
+                    AppendVarint(blob, text.size());
+                    blob += text;
+                } break;
+            }
+        }
+
+        /**
+         * This function appends the number of elements or members of
+         * the given array or object, followed by each of them, to the
+         * given blob.
+         *
+         * @param[in,out] blob
+         *     This is the blob to which to append the contents.
+         *
+         * @param[in] impl
+         *     This is the array or object.
+         */
+        static void AppendContentsToBlob(
+            std::string &blob,
+            const Impl &impl
+        ) {
+            if (impl.type == Type::Array) {
+                AppendVarint(blob, impl.arrayValue->size());
+                for (const auto &element: *impl.arrayValue) {
+                    AppendToBlob(blob, *element.impl_);
+                }
+            } else {
+                AppendVarint(blob, impl.objectValue->size());
+                for (const auto &entry: *impl.objectValue) {
+                    AppendVarint(blob, entry.first.size());
+                    blob += entry.first;
+                    AppendToBlob(blob, *entry.second.impl_);
+                }
+            }
+        }
+
+        /**
+         * This function reads a value appended by AppendToBlob() from
+         * the front of the given blob.
+         *
+         * @param[in,out] blob
+         *     This is the blob from which to read the value.
+         *
+         * @param[out] impl
+         *     This is where to store the value.
+         *
+         * @return
+         *     An indication of whether or not a whole value was read is
+         *     returned.
+         */
+        static bool ReadFromBlob(
+            std::string_view &blob,
+            Impl &impl
+        ) {
+            if (blob.empty()) {
+                return false;
+            }
+            const auto tag = blob[0];
+            blob.remove_prefix(1);
+            std::string_view string;
+            switch (tag) {
+                case 'n': {
+                    impl.type = Type::Null;
+                } break;
+
+                case 't':
+                case 'f': {
+                    impl.type = Type::Boolean;
+                    impl.booleanValue = (tag == 't');
+                } break;
+
+                case 'i': {
+                    uint64_t zigzag;
+                    if (!ReadVarint(blob, zigzag)) {
+                        return false;
+                    }
+                    impl.type = Type::Integer;
+                    impl.integerValue = (IntegerType) ((int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1));
+                } break;
+
+                case 'd': {
+                    double number;
+                    if (blob.size() < sizeof(number)) {
+                        return false;
+                    }
+                    (void) memcpy(&number, blob.data(), sizeof(number));
+                    blob.remove_prefix(sizeof(number));
+                    impl.type = Type::FloatingPoint;
+                    impl.floatingPointValue = (FloatingPointType) number;
+                } break;
+
+                case 's':
+                case 'x': {
+                    if (!ReadBlobString(blob, string)) {
+                        return false;
+                    }
+                    impl.type = ((tag == 's') ? Type::String : Type::Invalid);
+                    if (
+                        (tag == 's')
+                        || !string.empty()
+                    ) {
+                        impl.stringValue = new std::string(string);
+                    }
+                } break;
+
+                case 'a':
+                case 'o': {
+                    impl.type = ((tag == 'a') ? Type::Array : Type::Object);
+                    return ReadContentsFromBlob(blob, impl);
+                }
+
+                case 'A':
+                case 'O': {
+                    if (!ReadBlobString(blob, string)) {
+                        return false;
+                    }
+                    if constexpr (Traits::freezeColdSubtrees) {
+                        impl.type = ((tag == 'A') ? Type::Array : Type::Object);
+                        impl.stringValue = new std::string(string);
+                        impl.access.frozen = true;
+                    }
+                } break;
+
+                case 'j': {
+                    if (
+                        !ReadBlobString(blob, string)
+                        || string.empty()
+                    ) {
+                        return false;
+                    }
+                    if constexpr (Traits::freezeColdSubtrees) {
+                        impl.type = ((string[0] == '[') ? Type::Array : Type::Object);
+                        impl.lazyValue = new LazyText{nullptr, {}, std::string(string)};
+                        impl.access.lazy = true;
+                    }
+                } break;
+
+                default: return false;
+            }
+            return true;
+        }
+
+        /**
+         * This function reads the contents of an array or object,
+         * appended by AppendContentsToBlob(), from the front of the given
+         * blob.
+         *
+         * @param[in,out] blob
+         *     This is the blob from which to read the contents.
+         *
+         * @param[in,out] impl
+         *     This is the array or object, whose type is set, and which
+         *     doesn't yet hold a container.
+         *
+         * @return
+         *     An indication of whether or not all the contents were read
+         *     is returned.  If not, the array or object holds those which
+         *     were.
+         */
+        static bool ReadContentsFromBlob(
+            std::string_view &blob,
+            Impl &impl
+        ) {
+            uint64_t count = 0;
+            const auto counted = ReadVarint(blob, count);
+            if (impl.type == Type::Array) {
+                impl.arrayValue = new ArrayType;
+                if (!counted) {
+                    return false;
+                }
+                impl.arrayValue->reserve((size_t) std::min(count, (uint64_t) blob.size()));
+                for (uint64_t i = 0; i < count; ++i) {
+                    BasicValue element;
+                    if (!ReadFromBlob(blob, *element.impl_)) {
+                        return false;
+                    }
+                    impl.arrayValue->push_back(std::move(element));
+                }
+            } else {
+                impl.objectValue = new ObjectType;
+                if (!counted) {
+                    return false;
+                }
+                for (uint64_t i = 0; i < count; ++i) {
+                    std::string_view key;
+                    BasicValue value;
+                    if (
+                        !ReadBlobString(blob, key)
+                        || !ReadFromBlob(blob, *value.impl_)
+                    ) {
+                        return false;
+                    }
+                    (*impl.objectValue)[std::string(key)] = std::move(value);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This function encodes the contents of the array or object into
+         * a blob, which replaces them.
+         */
+        void Freeze() {
+            if constexpr (Traits::freezeColdSubtrees) {
+                std::string blob;
+                AppendContentsToBlob(blob, *this);
+                const auto frozen = new std::string(Traits::Compress(std::move(blob)));
+                if (type == Type::Array) {
+                    delete arrayValue;
+                } else {
+                    delete objectValue;
+                }
+                stringValue = frozen;
+                access.frozen = true;
+            }
+        }
+
+        /**
+         * This function returns the contents of the given lazy array or
+         * object, parsed in full from its text into a separate value.
+         * The lazy value is left as it is, and the profile with which it
+         * was parsed isn't taught anything, so that encoding or comparing
+         * a value doesn't count as accessing all of it.
+         *
+         * @param[in] impl
+         *     This is the lazy value.
+         *
+         * @return
+         *     The contents of the lazy value are returned.
+         */
+        static BasicValue ParseLazyText(const Impl &impl) {
+            return FromEncoding(impl.lazyValue->text);
+        }
+
+        /**
+         * This function decodes the contents of the frozen array or
+         * object from its blob, or parses those of the lazy one from its
+         * text, which they replace.  Parsing a lazy one teaches the
+         * profile with which it was parsed, if any, that it's accessed.
+         */
+        void Thaw() {
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (access.lazy) {
+                    const std::unique_ptr<LazyText> lazy(lazyValue);
+                    access.lazy = false;
+                    std::shared_ptr<const ProfileNode> node;
+                    if (lazy->profile != nullptr) {
+                        node = RecordAccess(*lazy->profile, lazy->path);
+                    }
+                    BasicValue json;
+                    if (
+                        !ParseProfiled(lazy->text, node, lazy->profile, std::move(lazy->path), json)
+                        || (json.impl_->type != type)
+                    ) {
+                        // The text was checked when it was set aside, so
+                        // this doesn't happen.
+                        if (type == Type::Array) {
+                            arrayValue = new ArrayType;
+                        } else {
+                            objectValue = new ObjectType;
+                        }
+                        return;
+                    }
+                    if (type == Type::Array) {
+                        arrayValue = json.impl_->arrayValue;
+                    } else {
+                        objectValue = json.impl_->objectValue;
+                    }
+                    json.impl_->type = Type::Null;
+                    return;
+                }
+                const auto blob = Traits::Decompress(std::move(*stringValue));
+                delete stringValue;
+                access.frozen = false;
+                std::string_view contents(blob);
+                (void) ReadContentsFromBlob(contents, *this);
+            }
+        }
+
+        /**
+         * This is the outcome of sweeping an array or object, or another
+         * value, for cold subtrees.
+         */
+        struct SweepResult {
+            /**
+             * This indicates whether neither the value nor anything in
+             * it was accessed lately.
+             */
+            bool cold = true;
+
+            /**
+             * This is the number of values swept, counting the value
+             * itself and everything in it.
+             */
+            size_t values = 1;
+        };
+
+        /**
+         * This function freezes the largest cold arrays and objects
+         * within the given value, but not the value itself, since only
+         * what holds it knows whether it's part of a larger cold
+         * subtree.
+         *
+         * @param[in,out] impl
+         *     This is the value to sweep.
+         *
+         * @param[in] options
+         *     These are the options controlling what is frozen.
+         *
+         * @param[in,out] frozen
+         *     This counts the arrays and objects frozen.
+         *
+         * @return
+         *     Whether the value is cold, and how many values it holds,
+         *     is returned.
+         */
+        static SweepResult Sweep(
+            Impl &impl,
+            const FreezeOptions &options,
+            size_t &frozen
+        ) {
+            SweepResult result;
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (impl.access.lazy) {
+                    // What's lazy is already held compactly, and counts
+                    // as what's frozen does.
+                    result.values = options.minimumValues;
+                    return result;
+                }
+                if (impl.access.frozen) {
+                    // What's frozen was large enough to freeze, so it
+                    // counts as large enough to freeze again with
+                    // whatever holds it.
+                    result.values = options.minimumValues;
+                    return result;
+                }
+                if (
+                    (impl.type != Type::Array)
+                    && (impl.type != Type::Object)
+                ) {
+                    return result;
+                }
+                result.cold = (impl.access.sweepsSinceAccess >= options.idleSweeps);
+                if (impl.access.sweepsSinceAccess < std::numeric_limits<uint32_t>::max()) {
+                    ++impl.access.sweepsSinceAccess;
+                }
+                std::vector<Impl *> coldChildren;
+                ForEachChildValue(
+                    impl,
+                    [&](BasicValue &child){
+                        if (child.impl_ == nullptr) {
+                            return;
+                        }
+                        const auto childResult = Sweep(*child.impl_, options, frozen);
+                        result.values += childResult.values;
+                        if (!childResult.cold) {
+                            result.cold = false;
+                        } else if (child.impl_->IsFreezable(childResult, options)) {
+                            coldChildren.push_back(child.impl_.get());
+                        }
+                    }
+                );
+                if (!result.cold) {
+                    for (auto child: coldChildren) {
+                        child->Freeze();
+                        ++frozen;
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * This function indicates whether the value, having been swept,
+         * should be frozen if nothing holding it is.
+         *
+         * @param[in] result
+         *     This is the outcome of sweeping the value.
+         *
+         * @param[in] options
+         *     These are the options controlling what is frozen.
+         *
+         * @return
+         *     An indication of whether or not to freeze the value is
+         *     returned.
+         */
+        bool IsFreezable(
+            const SweepResult &result,
+            const FreezeOptions &options
+        ) const {
+            return (
+                result.cold
+                && !IsFrozen()
+                && !IsLazy()
+                && (
+                    (type == Type::Array)
+                    || (type == Type::Object)
+                )
+                && (result.values >= options.minimumValues)
+            );
+        }
+
+        /**
+         * This function parses the given text as one JSON value, parsing
+         * only the arrays and objects which the given profile node
+         * expects to be accessed, and setting the others aside as text.
+         * The top-level value is always parsed.
+         *
+         * @param[in] text
+         *     This is the text to parse.
+         *
+         * @param[in] node
+         *     This is the profile node for the top-level value, if the
+         *     profile has one.
+         *
+         * @param[in] profile
+         *     This is the profile with which the value is parsed, if any,
+         *     which values set aside remember.
+         *
+         * @param[in] path
+         *     This is the path of the top-level value in the document
+         *     parsed with the profile.
+         *
+         * @param[out] json
+         *     This is where to store the value parsed.
+         *
+         * @return
+         *     An indication of whether or not the text holds exactly one
+         *     valid JSON value is returned.
+         */
+        static bool ParseProfiled(
+            std::string_view text,
+            const std::shared_ptr<const ProfileNode> &node,
+            const std::shared_ptr<AccessProfile> &profile,
+            ProfilePath path,
+            BasicValue &json
+        ) {
+            if constexpr (Traits::freezeColdSubtrees) {
+                struct Container {
+                    const ProfileNode *node;
+                    bool isArray;
+                };
+                std::vector<Container> containers;
+                std::string key;
+                BasicBuilder<Traits> builder;
+                Reader reader;
+                Reader::Token token;
+
+                // These are the profile node and path step of the next
+                // array or object to begin.
+                auto next = node.get();
+                std::optional<std::string> step;
+                reader.Feed(text);
+                reader.Finish();
+                while (!builder.IsComplete()) {
+                    // Only a value can start with a bracket, so one next
+                    // within a container, past any separator the reader
+                    // hasn't yet read, starts an element or member.
+                    const auto start = text.find_first_not_of(" \t\r\n:,", reader.GetOffset());
+                    if (
+                        !containers.empty()
+                        && (start != std::string_view::npos)
+                        && (
+                            (text[start] == '[')
+                            || (text[start] == '{')
+                        )
+                    ) {
+                        const auto &container = containers.back();
+                        next = nullptr;
+                        step.reset();
+                        if (container.node != nullptr) {
+                            if (container.isArray) {
+                                next = container.node->elements.get();
+                            } else {
+                                const auto member = container.node->members.find(key);
+                                if (member != container.node->members.end()) {
+                                    next = member->second.get();
+                                }
+                            }
+                        }
+                        if (!container.isArray) {
+                            step = key;
+                        }
+                        if (next == nullptr) {
+                            if (reader.Skip() != Reader::Status::Token) {
+                                return false;
+                            }
+                            auto skipped = text.substr(start, reader.GetOffset() - start);
+                            skipped = skipped.substr(0, skipped.find_last_of("]}") + 1);
+                            path.push_back(std::move(step));
+                            BasicValue lazy;
+                            lazy.impl_->type = ((text[start] == '[') ? Type::Array : Type::Object);
+                            lazy.impl_->lazyValue = new LazyText{profile, path, std::string(skipped)};
+                            lazy.impl_->access.lazy = true;
+                            path.pop_back();
+                            if (!builder.PushValue(std::move(lazy))) {
+                                return false;
+                            }
+                            continue;
+                        }
+                    }
+                    if (
+                        (reader.Next(token) != Reader::Status::Token)
+                        || !builder.Push(token)
+                    ) {
+                        return false;
+                    }
+                    switch (token.type) {
+                        case Reader::TokenType::Key: {
+                            key.clear();
+                            if (!token.escaped) {
+                                key.assign(token.text);
+                            } else if (!Reader::DecodeString(token.text, key)) {
+                                return false;
+                            }
+                        } break;
+
+                        case Reader::TokenType::BeginObject:
+                        case Reader::TokenType::BeginArray: {
+                            if (!containers.empty()) {
+                                path.push_back(std::move(step));
+                            }
+                            containers.push_back(
+                                Container{next, (token.type == Reader::TokenType::BeginArray)}
+                            );
+                        } break;
+
+                        case Reader::TokenType::EndObject:
+                        case Reader::TokenType::EndArray: {
+                            containers.pop_back();
+                            if (!containers.empty()) {
+                                path.pop_back();
+                            }
+                        } break;
+
+                        default: break;
+                    }
+                }
+                if (reader.Next(token) != Reader::Status::End) {
+                    return false;
+                }
+                json = builder.Take();
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        /**
+         * This is where a value tracked for changes sits in the array
+         * or object holding it or, for the value on which tracking
+         * began, the changes recorded.
+         */
+        struct Link {
+            /**
+             * This is the array or object holding the value, or
+             * nullptr for the value on which tracking began.
+             */
+            const Impl *parent = nullptr;
+
+            /**
+             * This is the key of the value, if its parent is an object.
+             */
+            std::string key;
+
+            /**
+             * This is the index the value had when it was last found,
+             * if its parent is an array.  Insertions and removals
+             * before it leave it out of date, so it's only a hint.
+             */
+            size_t index = 0;
+
+            /**
+             * This holds the changes recorded, for the value on which
+             * tracking began.
+             */
+            std::unique_ptr<ArrayType> changes;
+        };
+
+        /**
+         * This holds the links of all values tracked for changes.
+         * Values don't point to their parents, so the links are kept
+         * aside, and only values flagged as tracked look for theirs.
+         */
+        struct Tracking {
+            std::mutex mutex;
+            std::unordered_map<const Impl *, Link> links;
+
+            /**
+             * This holds, for each tracked array or object, its
+             * members or elements linked to it, so that they can be
+             * let go of when it stops being tracked.  Otherwise their
+             * links would point to it after it's destroyed.
+             */
+            std::unordered_map<const Impl *, std::unordered_set<Impl *>> children;
+
+            /**
+             * This function sets the parent of the given value's link,
+             * keeping the children of both parents up to date.
+             *
+             * @param[in,out] link
+             *     This is the link of the value.
+             *
+             * @param[in] impl
+             *     This is the value.
+             *
+             * @param[in] parent
+             *     This is the new parent, or nullptr for none.
+             */
+            void SetParent(
+                Link &link,
+                Impl *impl,
+                const Impl *parent
+            ) {
+                if (link.parent == parent) {
+                    return;
+                }
+                if (link.parent != nullptr) {
+                    const auto siblings = children.find(link.parent);
+                    if (siblings != children.end()) {
+                        (void) siblings->second.erase(impl);
+                        if (siblings->second.empty()) {
+                            (void) children.erase(siblings);
+                        }
+                    }
+                }
+                link.parent = parent;
+                if (parent != nullptr) {
+                    (void) children[parent].insert(impl);
+                }
+            }
+
+            /**
+             * This function stops tracking the given value, as well as
+             * its members or elements linked to it.
+             *
+             * @param[in,out] impl
+             *     This is the value.
+             */
+            void Forget(Impl &impl) {
+                const auto entry = links.find(&impl);
+                if (entry != links.end()) {
+                    SetParent(entry->second, &impl, nullptr);
+                    (void) links.erase(entry);
+                }
+                impl.tracked = false;
+                const auto orphans = children.find(&impl);
+                if (orphans != children.end()) {
+                    // The orphans' own members and elements still point
+                    // to them, but they're alive, and no longer reached
+                    // from the value on which tracking began.
+                    for (const auto child: orphans->second) {
+                        (void) links.erase(child);
+                        child->tracked = false;
+                    }
+                    (void) children.erase(orphans);
+                }
+            }
+        };
+
+        /**
+         * This function returns the links of all values tracked for
+         * changes.
+         *
+         * @return
+         *     The links of all values tracked for changes are returned.
+         */
+        static Tracking &GetTracking() {
+            // This is never destroyed, since values may outlive it.
+            static const auto tracking = new Tracking;
+            return *tracking;
+        }
+
+        /**
+         * This function starts tracking the given member or element
+         * of the value for changes, if the value is tracked.
+         *
+         * @param[in] child
+         *     This is the member or element.
+         *
+         * @param[in] key
+         *     This is the key of the member, or nullptr for an element.
+         *
+         * @param[in] index
+         *     This is the index of the element.
+         */
+        void Track(
+            const BasicValue &child,
+            const std::string *key,
+            size_t index
+        ) const {
+            if (
+                !tracked
+                || (child.impl_ == nullptr)
+            ) {
+                return;
+            }
+            auto &tracking = GetTracking();
+            std::lock_guard lock(tracking.mutex);
+            auto &link = tracking.links[child.impl_.get()];
+            tracking.SetParent(link, child.impl_.get(), this);
+            if (key == nullptr) {
+                link.index = index;
+            } else {
+                link.key = *key;
+            }
+            link.changes.reset();
+            child.impl_->tracked = true;
+        }
+
+        /**
+         * This function stops tracking the value for changes, along
+         * with its members or elements.
+         */
+        void Untrack() {
+            if (!tracked) {
+                return;
+            }
+            auto &tracking = GetTracking();
+            std::lock_guard lock(tracking.mutex);
+            tracking.Forget(*this);
+        }
+
+        /**
+         * This function stops tracking the value for changes if it's
+         * tracked as a member or element, since it's leaving the array
+         * or object holding it.  The value on which tracking began
+         * keeps its changes wherever it goes.
+         */
+        void Detach() {
+            if (!tracked) {
+                return;
+            }
+            auto &tracking = GetTracking();
+            std::lock_guard lock(tracking.mutex);
+            const auto link = tracking.links.find(this);
+            if (
+                (link == tracking.links.end())
+                || (link->second.parent != nullptr)
+            ) {
+                tracking.Forget(*this);
+            }
+        }
+
+        /**
+         * This function finds the path from the value on which tracking
+         * began to the given value.  The tracking mutex must be held.
+         *
+         * @param[in] impl
+         *     This is the value whose path to find.
+         *
+         * @param[out] tokens
+         *     This is where to store the reference tokens of the path.
+         *
+         * @return
+         *     The changes recorded for the value on which tracking
+         *     began is returned, or nullptr if the value is no longer
+         *     reached from it.
+         */
+        static ArrayType *FindPath(
+            const Impl *impl,
+            std::vector<std::string> &tokens
+        ) {
+            auto &links = GetTracking().links;
+            while (true) {
+                const auto entry = links.find(impl);
+                if (entry == links.end()) {
+                    return nullptr;
+                }
+                auto &link = entry->second;
+                const auto parent = link.parent;
+                if (parent == nullptr) {
+                    std::reverse(tokens.begin(), tokens.end());
+                    return link.changes.get();
+                }
+                if (parent->type == Type::Array) {
+                    const auto &elements = *parent->arrayValue;
+                    if (
+                        (link.index >= elements.size())
+                        || (elements[link.index].impl_.get() != impl)
+                    ) {
+                        const auto element = std::find_if(
+                            elements.begin(),
+                            elements.end(),
+                            [impl](const BasicValue &value){
+                                return (value.impl_.get() == impl);
+                            }
+                        );
+                        if (element == elements.end()) {
+                            return nullptr;
+                        }
+                        link.index = (size_t) (element - elements.begin());
+                    }
+                    tokens.push_back(std::to_string(link.index));
+                } else if (parent->type == Type::Object) {
+                    const auto member = parent->objectValue->find(link.key);
+                    if (
+                        (member == parent->objectValue->end())
+                        || (member->second.impl_.get() != impl)
+                    ) {
+                        return nullptr;
+                    }
+                    tokens.push_back(link.key);
+                } else {
+                    return nullptr;
+                }
+                impl = parent;
+            }
+        }
+
+        /**
+         * This function records a change to the value, or to one of
+         * its members or elements, if the value is tracked.
+         *
+         * @param[in] operation
+         *     This is the name of the JSON Patch operation.
+         *
+         * @param[in] token
+         *     This is the key or index of the member or element
+         *     changed, or nullptr if the value itself changed.
+         *
+         * @param[in] value
+         *     This is the value set, or nullptr for a removal.
+         */
+        void Record(
+            const char *operation,
+            const std::string *token,
+            const BasicValue *value
+        ) {
+            if (!tracked) {
+                return;
+            }
+            auto &tracking = GetTracking();
+            std::lock_guard lock(tracking.mutex);
+            std::vector<std::string> tokens;
+            const auto changes = FindPath(this, tokens);
+            if (changes == nullptr) {
+                // The value has been taken out of the tracked value,
+                // so it needn't be tracked any longer.
+                tracking.Forget(*this);
+                return;
+            }
+            if (token != nullptr) {
+                tokens.push_back(*token);
+            }
+            BasicValue change(Type::Object);
+            (void) change.Set("op", operation);
+            (void) change.Set("path", Pointer::FromTokens(std::move(tokens)).ToString());
+            if (value != nullptr) {
+                (void) change.Set("value", *value);
+            }
+            changes->push_back(std::move(change));
+        }
+
+        /**
+         * This function records the replacement of the value by
+         * another, whose implementation takes the place of the value's
+         * in the tracking.
+         *
+         * @param[in,out] replacement
+         *     This is the implementation of the replacement.
+         *
+         * @param[in] value
+         *     This is the replacement.
+         */
+        void RecordReplacement(
+            Impl &replacement,
+            const BasicValue &value
+        ) {
+            Record("replace", nullptr, &value);
+            if (!tracked) {
+                return;
+            }
+            auto &tracking = GetTracking();
+            std::lock_guard lock(tracking.mutex);
+            const auto entry = tracking.links.find(this);
+            if (entry == tracking.links.end()) {
+                tracking.Forget(*this);
+                return;
+            }
+            auto link = std::move(entry->second);
+            const auto parent = link.parent;
+            tracking.Forget(*this);
+            tracking.Forget(replacement);
+            link.parent = nullptr;
+            tracking.SetParent(link, &replacement, parent);
+            tracking.links[&replacement] = std::move(link);
+            replacement.tracked = true;
+        }
+
+        /**
+         * This function finds the value at the path made of the given
+         * number of leading reference tokens, tracking each value on
+         * the way if the document is tracked.
+         *
+         * @param[in,out] document
+         *     This is the value in which to find the value.
+         *
+         * @param[in] tokens
+         *     These are the reference tokens of the path.
+         *
+         * @param[in] count
+         *     This is the number of tokens to follow.
+         *
+         * @return
+         *     The value found is returned, or nullptr if there's none.
+         */
+        static BasicValue *Resolve(
+            BasicValue &document,
+            const std::vector<std::string> &tokens,
+            size_t count
+        ) {
+            auto value = &document;
+            for (size_t i = 0; i < count; ++i) {
+                const auto &token = tokens[i];
+                auto &impl = *value->impl_;
+                impl.ClearSpan();
+                switch (value->GetType()) {
+                    case Type::Array: {
+                        size_t index;
+                        if (
+                            !Pointer::ParseIndex(token, index)
+                            || (index >= impl.arrayValue->size())
+                        ) {
+                            return nullptr;
+                        }
+                        value = &(*impl.arrayValue)[index];
+                        impl.Track(*value, nullptr, index);
+                    } break;
+
+                    case Type::Object: {
+                        const auto member = impl.objectValue->find(token);
+                        if (member == impl.objectValue->end()) {
+                            return nullptr;
+                        }
+                        value = &member->second;
+                        impl.Track(*value, &token, 0);
+                    } break;
+
+                    default: return nullptr;
+                }
+            }
+            return value;
+        }
+
+        /**
+         * This function removes the value at the given path.
+         *
+         * @param[in,out] document
+         *     This is the value from which to remove the value.
+         *
+         * @param[in] tokens
+         *     These are the reference tokens of the path.
+         *
+         * @return
+         *     An indication of whether or not the value was removed
+         *     is returned.
+         */
+        static bool RemoveAt(
+            BasicValue &document,
+            const std::vector<std::string> &tokens
+        ) {
+            if (tokens.empty()) {
+                return false;
+            }
+            const auto parent = Resolve(document, tokens, tokens.size() - 1);
+            if (parent == nullptr) {
+                return false;
+            }
+            const auto &token = tokens.back();
+            switch (parent->GetType()) {
+                case Type::Array: {
+                    size_t index;
+                    if (
+                        !Pointer::ParseIndex(token, index)
+                        || (index >= parent->GetSize())
+                    ) {
+                        return false;
+                    }
+                    parent->Remove(index);
+                } break;
+
+                case Type::Object: {
+                    if (parent->Find(std::string_view(token)) == nullptr) {
+                        return false;
+                    }
+                    parent->Remove(token);
+                } break;
+
+                default: return false;
+            }
+            return true;
+        }
+
+        /**
+         * This function adds a value at the given path, or replaces the
+         * value there.
+         *
+         * @param[in,out] document
+         *     This is the value to which to add the value.
+         *
+         * @param[in] tokens
+         *     These are the reference tokens of the path.
+         *
+         * @param[in] value
+         *     This is the value to add.
+         *
+         * @param[in] replace
+         *     This indicates whether a value must already be at the
+         *     path, and is replaced, rather than the value being added.
+         *
+         * @return
+         *     An indication of whether or not the value was added is
+         *     returned.
+         */
+        static bool AddAt(
+            BasicValue &document,
+            const std::vector<std::string> &tokens,
+            BasicValue &&value,
+            bool replace
+        ) {
+            if (tokens.empty()) {
+                document = std::move(value);
+                return true;
+            }
+            const auto parent = Resolve(document, tokens, tokens.size() - 1);
+            if (parent == nullptr) {
+                return false;
+            }
+            const auto &token = tokens.back();
+            switch (parent->GetType()) {
+                case Type::Array: {
+                    const auto size = parent->GetSize();
+                    size_t index = size;
+                    if (
+                        (replace || (token != "-"))
+                        && (
+                            !Pointer::ParseIndex(token, index)
+                            || (index > size)
+                            || (replace && (index == size))
+                        )
+                    ) {
+                        return false;
+                    }
+                    if (replace) {
+                        (*parent)[index] = std::move(value);
+                    } else {
+                        (void) parent->Insert(std::move(value), index);
+                    }
+                } break;
+
+                case Type::Object: {
+                    if (
+                        replace
+                        && (parent->Find(std::string_view(token)) == nullptr)
+                    ) {
+                        return false;
+                    }
+                    (void) parent->Set(token, std::move(value));
+                } break;
+
+                default: return false;
+            }
+            return true;
+        }
+
+        /**
+         * This function applies one JSON Patch operation to a value.
+         *
+         * @param[in,out] document
+         *     This is the value to which to apply the operation.
+         *
+         * @param[in] operation
+         *     This is the operation to apply.
+         *
+         * @return
+         *     An indication of whether or not the operation was
+         *     applied is returned.
+         */
+        static bool ApplyOperation(
+            BasicValue &document,
+            const BasicValue &operation
+        ) {
+            std::string_view name;
+            std::string_view pathText;
+            if (
+                !operation["op"].TryGet(name)
+                || !operation["path"].TryGet(pathText)
+            ) {
+                return false;
+            }
+            const Pointer path(pathText);
+            if (!path.IsValid()) {
+                return false;
+            }
+            const auto &tokens = path.GetTokens();
+            const auto given = operation.Find(std::string_view("value"));
+            if (name == "test") {
+                const auto target = document.Find(path);
+                return (
+                    (target != nullptr)
+                    && (given != nullptr)
+                    && (*target == *given)
+                );
+            } else if (name == "remove") {
+                return RemoveAt(document, tokens);
+            } else if (
+                (name == "add")
+                || (name == "replace")
+            ) {
+                if (given == nullptr) {
+                    return false;
+                }
+                return AddAt(document, tokens, BasicValue(*given), (name == "replace"));
+            } else if (
+                (name == "move")
+                || (name == "copy")
+            ) {
+                std::string_view fromText;
+                if (!operation["from"].TryGet(fromText)) {
+                    return false;
+                }
+                const Pointer from(fromText);
+                if (!from.IsValid()) {
+                    return false;
+                }
+                const auto source = document.Find(from);
+                if (source == nullptr) {
+                    return false;
+                }
+                BasicValue value(*source);
+                if (name == "move") {
+                    const auto &fromTokens = from.GetTokens();
+                    if (fromTokens == tokens) {
+                        return true;
+                    }
+                    if (
+                        (fromTokens.size() < tokens.size())
+                        && std::equal(fromTokens.begin(), fromTokens.end(), tokens.begin())
+                    ) {
+                        // A value can't be moved into itself.
+                        return false;
+                    }
+                    if (!RemoveAt(document, fromTokens)) {
+                        return false;
+                    }
+                }
+                return AddAt(document, tokens, std::move(value), false);
+            } else {
+                return false;
+            }
+        }
+
+        /**
+         * This method builds the JSON value up as a copy
+         * of another JSON value.
+         *
+         * @param[in] other
+         *     This is the other JSON value to copy.
+         */
+        void CopyFrom(const std::unique_ptr<Impl> &other) {
+            type = other->type;
+            span = other->span;
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (other->access.frozen) {
+                    stringValue = new std::string(*other->stringValue);
+                    access.frozen = true;
+                    return;
+                }
+                if (other->access.lazy) {
+                    lazyValue = new LazyText(*other->lazyValue);
+                    access.lazy = true;
+                    return;
+                }
+            }
+            switch (type) {
+                case Type::Boolean: {
+                    booleanValue = other->booleanValue;
+                }
+                break;
+
+                case Type::Integer: {
+                    integerValue = other->integerValue;
+                }
+                break;
+
+                case Type::FloatingPoint: {
+                    floatingPointValue = other->floatingPointValue;
+                }
+                break;
+
+                case Type::Invalid: {
+                    if (other->stringValue != nullptr) {
+                        stringValue = new std::string(*other->stringValue);
+                    }
+                }
+                break;
+
+                case Type::String: {
                     stringValue = new std::string(*other->stringValue);
                 }
                 break;
 
-                case Type::Array: {
-                    arrayValue = new std::vector<Value>;
-                    arrayValue->reserve(other->arrayValue->size());
-                    for (const auto &otherElement: *other->arrayValue) {
-                        arrayValue->emplace_back(otherElement);
-                    }
+                case Type::Array: {
+                    arrayValue = new ArrayType;
+                    arrayValue->reserve(other->arrayValue->size());
+                    for (const auto &otherElement: *other->arrayValue) {
+                        arrayValue->emplace_back(otherElement);
+                    }
+                }
+                break;
+
+                case Type::Object: {
+                    objectValue = new ObjectType;
+                    for (const auto &otherElement: *other->objectValue) {
+                        objectValue->insert({otherElement.first, otherElement.second});
+                    }
+                }
+                break;
+
+                default: break;
+            }
+        }
+
+        /**
+         * This function decodes the given code point sequence
+         * as an integer JSON value.
+         *
+         * @param[in] codePoints
+         *     This is the code point sequence to decode.
+         */
+        void DecodeAsInteger(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
+            Utf8::Utf8 encoder;
+            const auto s = encoder.Encode(codePoints);
+            intmax_t value;
+            if (
+                (
+                    StringExtensions::ToInteger(
+                        std::string(s.begin(), s.end()),
+                        value
+                    ) != StringExtensions::ToIntegerResult::Success
+                )
+                || !std::in_range<IntegerType>(value)
+            ) {
+                return;
+            }
+            type = Type::Integer;
+            integerValue = (IntegerType) value;
+        }
+
+        /**
+         * This function decodes the given code point sequence as
+         * a floating-point JSON value.
+         *
+         * @param[in] codePoints
+         *     This is the code point sequence to parse.
+         */
+        void DecodeAsFloatingPoint(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
+            size_t index = 0;
+            size_t state = 0;
+            double magnitude = 0.0;
+            double exponent = 0.0;
+            while (index < codePoints.size()) {
+                switch (state) {
+                    case 0: {
+                        // [ minus ]
+                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '-') {
+                            ++index;
+                        }
+                        state = 1;
+                    }
+                    break;
+
+                    case 1: {
+                        // zero / 1-9
+                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '0') {
+                            state = 2;
+                        } else if (
+                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '1')
+                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
+                        ) {
+                            state = 3;
+                            magnitude = (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
+                        } else {
+                            return;
+                        }
+                        ++index;
+                    }
+                    break;
+
+                    case 2: {
+                        // . / e / E
+                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '.') {
+                            state = 4;
+                        } else if (
+                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
+                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
+                        ) {
+                            state = 6;
+                        } else {
+                            return;
+                        }
+                        ++index;
+                    }
+                    break;
+
+                    case 3: {
+                        // *DIGIT / . / e / E
+                        if (
+                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
+                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
+                        ) {
+                            const auto oldMagnitude = (intmax_t) magnitude;
+                            magnitude *= 10.0;
+                            magnitude += (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
+                            if ((intmax_t) magnitude / 10 != oldMagnitude) {
+                                return;
+                            }
+                        } else if (codePoints[index] == (Utf8::UnicodeCodePoint) '.') {
+                            state = 4;
+                        } else if (
+                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
+                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
+                        ) {
+                            state = 6;
+                        } else {
+                            return;
+                        }
+                        ++index;
+                    }
+                    break;
+
+                    case 4: {
+                        // frac: DIGIT
+                        if (
+                            (codePoints[index] < (Utf8::UnicodeCodePoint) '0')
+                            || (codePoints[index] > (Utf8::UnicodeCodePoint) '9')
+                        ) {
+                            return;
+                        }
+                        state = 5;
+                        ++index;
+                    }
+                    break;
+
+                    case 5: {
+                        // frac: *DIGIT / e / E
+                        if (
+                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
+                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
+                        ) {
+                            state = 6;
+                        } else if (
+                            (codePoints[index] < (Utf8::UnicodeCodePoint) '0')
+                            || (codePoints[index] > (Utf8::UnicodeCodePoint) '9')
+                        ) {
+                            return;
+                        }
+                        ++index;
+                    }
+                    break;
+
+                    case 6: {
+                        // exp: [minus/plus] / DIGIT
+                        if (
+                            (codePoints[index] == (Utf8::UnicodeCodePoint) '-')
+                            || (codePoints[index] == (Utf8::UnicodeCodePoint) '+')
+                        ) {
+                            ++index;
+                        } else {
+                        }
+                        state = 7;
+                    }
+                    break;
+
+                    case 7: {
+                        // exp: DIGIT
+                        if (
+                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
+                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
+                        ) {
+                            const auto oldExponent = (intmax_t) exponent;
+                            exponent *= 10.0;
+                            exponent += (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
+                            if ((intmax_t) exponent / 10 != oldExponent) {
+                                return;
+                            }
+                        } else {
+                            return;
+                        }
+                        ++index;
+                    }
+                    break;
+                }
+            }
+            if (
+                (state >= 2)
+                && (state != 4)
+                && (state != 6)
+            ) {
+                // Only the grammar is checked above; the number is decoded
+                // by the reader, to round it correctly to the nearest
+                // double, as Json::Literal does at compile time.  Most
+                // numbers fit in the buffer, which saves allocating.
+                char buffer[64];
+                std::string longText;
+                std::string_view text;
+                if (codePoints.size() <= sizeof(buffer)) {
+                    std::copy(codePoints.begin(), codePoints.end(), buffer);
+                    text = std::string_view(buffer, codePoints.size());
+                } else {
+                    longText.assign(codePoints.begin(), codePoints.end());
+                    text = longText;
+                }
+                double number;
+                if (Reader::DecodeFloatingPoint(text, number)) {
+                    type = Type::FloatingPoint;
+                    floatingPointValue = (FloatingPointType) number;
+                }
+            }
+        }
+
+        /**
+         * This function extracts the encoding of the next JSON value
+         * in the given string, updating the given offset to indicate
+         * where the end of the value encoding was found, or whether
+         * the encoding was invalid.
+         *
+         * @param[in] codePoints
+         *     These are the Unicode code points to parse.
+         *
+         * @param[in,out] offset
+         *     On input, this is the position of the first character
+         *     of the encoded value in the string.
+         *
+         *     On ouput, this is the position of the first character
+         *     past the end of the encoded value in the string
+         *
+         * @param[in] delimiter
+         *     This is the character that marks the end of the value
+         *     if it's encountered.
+         *
+         * @return
+         *     The encoding of the next JSON value in the given
+         *     Unicode code points is returned.
+         *
+         * @return {}
+         *     This is returned if the encoded value was invalid.
+         */
+        std::vector<Utf8::UnicodeCodePoint> ParseValue(
+            const std::vector<Utf8::UnicodeCodePoint> &codePoints,
+            size_t &offset,
+            char delimiter
+        ) {
+            std::stack<char> expectedDelimiters;
+            std::vector<Utf8::UnicodeCodePoint> encodedValueCodePoints;
+            const std::vector<Utf8::UnicodeCodePoint> encodingCodePoints(
+                codePoints.begin() + offset,
+                codePoints.end()
+            );
+            if (encodingCodePoints.empty()) {
+                return {};
+            }
+            bool insideString = false;
+            bool escaping = false;
+            for (const auto cp: encodingCodePoints) {
+                encodedValueCodePoints.push_back(cp);
+                if (
+                    !escaping
+                    && !expectedDelimiters.empty()
+                    && (cp == expectedDelimiters.top())
+                ) {
+                    insideString = false;
+                    expectedDelimiters.pop();
+                    continue;
+                }
+                if (insideString) {
+                    if (escaping) {
+                        escaping = false;
+                    } else if (cp == (Utf8::UnicodeCodePoint) '\\') {
+                        escaping = true;
+                    }
+                } else {
+                    if (cp == (Utf8::UnicodeCodePoint) '\"') {
+                        insideString = true;
+                        expectedDelimiters.push('\"');
+                    } else if (cp == (Utf8::UnicodeCodePoint) '[') {
+                        expectedDelimiters.push(']');
+                    } else if (cp == (Utf8::UnicodeCodePoint) '{') {
+                        expectedDelimiters.push('}');
+                    } else if (
+                        (cp == (Utf8::UnicodeCodePoint) delimiter)
+                        && expectedDelimiters.empty()
+                    ) {
+                        break;
+                    }
+                }
+            }
+            if (expectedDelimiters.empty()) {
+                offset += encodedValueCodePoints.size();
+                if (encodedValueCodePoints.back() == (Utf8::UnicodeCodePoint) delimiter) {
+                    encodedValueCodePoints.pop_back();
+                }
+                return encodedValueCodePoints;
+            } else {
+                return {};
+            }
+        }
+
+        /**
+         * This function parses the given Unicode code points as an array
+         * JSON value.
+         *
+         * @param[in] codePoints
+         *     These are the Unicode code points to parse.
+         */
+        void ParseAsArray(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
+            ArrayType newArrayValue;
+            size_t offset = 0;
+            while (offset < codePoints.size()) {
+                const auto encodedValue = ParseValue(codePoints, offset, ',');
+                if (encodedValue.empty()) {
+                    return;
+                }
+                newArrayValue.emplace_back(FromEncoding(encodedValue));
+            }
+            type = Type::Array;
+            arrayValue = new decltype(newArrayValue)(newArrayValue);
+        }
+
+        /**
+         * This function parses the given Unicode code points as a
+         * JSON object.
+         *
+         * @param[in] codePoints
+         *     These are the Unicode code points to parse.
+         */
+        void ParseAsObject(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
+            ObjectType newObjectValue;
+            size_t offset = 0;
+            while (offset < codePoints.size()) {
+                const auto encodedKey = ParseValue(codePoints, offset, ':');
+                if (encodedKey.empty()) {
+                    return;
+                }
+                const auto key = FromEncoding(encodedKey);
+                if (key.GetType() != Type::String) {
+                    return;
+                }
+                const auto encodedValue = ParseValue(codePoints, offset, ',');
+                if (encodedValue.empty()) {
+                    return;
+                }
+                newObjectValue[(std::string) key] = FromEncoding(encodedValue);
+            }
+            type = Type::Object;
+            objectValue = new decltype(newObjectValue)(newObjectValue);
+        }
+
+        /**
+         * This function calls the given function with each element
+         * of an array, or each member of an object, until the
+         * function returns false.
+         *
+         * @param[in] function
+         *     This is the function to call.  It's given a pointer
+         *     to the key of the member, or nullptr for an array
+         *     element, and the element or member value.
+         */
+        template<typename Function>
+        void ForEachChild(Function &&function) const {
+            if (type == Type::Array) {
+                for (const auto &value: *arrayValue) {
+                    if (!function((const std::string *) nullptr, value)) {
+                        return;
+                    }
+                }
+            } else {
+                for (const auto &entry: *objectValue) {
+                    if (!function(&entry.first, entry.second)) {
+                        return;
+                    }
+                }
+            }
+        }
+
+        /**
+         * This function returns the length of the encoding of the
+         * given string, stopping early if it would exceed the given
+         * limit.
+         */
+        static size_t MeasureString(
+            const std::string &value,
+            const EncodingOptions &options,
+            size_t limit
+        ) {
+            // Escaping never makes a string shorter.
+            if (value.size() + 2 > limit) {
+                return value.size() + 2;
+            }
+            std::string encoding;
+            Detail::AppendEncodedString(encoding, value, options);
+            return encoding.size();
+        }
+
+        /**
+         * This function returns a quick estimate of the length of
+         * the text which ToEncoding would return for the given value.
+         * Strings are assumed to need no escaping, and when pretty
+         * printing, every array and object is assumed to be broken
+         * over lines.
+         */
+        static size_t EstimateEncoding(
+            const BasicValue &json,
+            const EncodingOptions &options
+        ) {
+            if (json.GetType() == Type::Invalid) {
+                return 0;
+            }
+            const auto &impl = *json.impl_;
+            if constexpr (Traits::cacheEncoding) {
+                if (
+                    !options.reencode
+                    && !impl.encoding.empty()
+                ) {
+                    return impl.encoding.size();
+                }
+            }
+            switch (impl.type) {
+                case Type::Null: return 4;
+                case Type::Boolean: return 5;
+                case Type::String: return impl.stringValue->size() + 2;
+
+                case Type::Integer: {
+                    char digits[32];
+                    const auto result = std::to_chars(
+                        digits,
+                        digits + sizeof(digits),
+                        (intmax_t) impl.integerValue
+                    );
+                    return (size_t) (result.ptr - digits);
+                }
+
+                case Type::FloatingPoint: return 17;
+
+                case Type::Array:
+                case Type::Object: {
+                    auto nestedOptions = options;
+                    ++nestedOptions.numIndentationLevels;
+                    const auto nestedIndentation = (
+                        options.pretty
+                        ? (
+                            nestedOptions.numIndentationLevels
+                            * nestedOptions.spacesPerIndentationLevel
+                            + 2
+                        )
+                        : 0
+                    );
+                    size_t length = 2;
+                    impl.ForEachChild(
+                        [&](const std::string *key, const BasicValue &value){
+                            length += 1 + nestedIndentation;
+                            if (key != nullptr) {
+                                length += key->size() + 3;
+                            }
+                            length += EstimateEncoding(value, nestedOptions);
+                            return true;
+                        }
+                    );
+                    return length;
+                }
+
+                default: return 3;
+            }
+        }
+
+        /**
+         * This function returns the length of the text which
+         * ToEncoding would return for the given value, without
+         * building it.
+         *
+         * @param[in] json
+         *     This is the value to measure.
+         *
+         * @param[in] options
+         *     These are the options given to ToEncoding.
+         *
+         * @param[in] limit
+         *     Measuring stops once the length is known to exceed
+         *     this limit.
+         *
+         * @return
+         *     The length of the encoding is returned, or some length
+         *     greater than the limit if the encoding is longer than
+         *     the limit.
+         */
+        static size_t MeasureEncoding(
+            const BasicValue &json,
+            const EncodingOptions &options,
+            size_t limit
+        ) {
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (
+                    (json.impl_ != nullptr)
+                    && json.impl_->IsLazy()
+                ) {
+                    return MeasureEncoding(ParseLazyText(*json.impl_), options, limit);
+                }
+            }
+            if (json.GetType() == Type::Invalid) {
+                return json.ToEncoding(options).size();
+            }
+            const auto &impl = *json.impl_;
+            if constexpr (Traits::cacheEncoding) {
+                if (
+                    !options.reencode
+                    && !impl.encoding.empty()
+                ) {
+                    return impl.encoding.size();
+                }
+            }
+            switch (impl.type) {
+                case Type::Null: return 4;
+                case Type::Boolean: return (impl.booleanValue ? 4 : 5);
+                case Type::String: return MeasureString(*impl.stringValue, options, limit);
+
+                case Type::Integer: {
+                    std::string encoding;
+                    Detail::AppendEncodedInteger(encoding, (intmax_t) impl.integerValue);
+                    return encoding.size();
+                }
+
+                case Type::FloatingPoint: {
+                    std::string encoding;
+                    Detail::AppendEncodedFloatingPoint(encoding, (double) impl.floatingPointValue);
+                    return encoding.size();
+                }
+
+                case Type::Array:
+                case Type::Object: {
+                    if (!impl.IsWrapped(options)) {
+                        return impl.MeasureInline(options, limit);
+                    }
+                    return impl.MeasureWrapped(options, limit);
+                }
+
+                default: return 3;
+            }
+        }
+
+        /**
+         * This function returns the length of the encoding of the
+         * array or object on a single line, stopping early if it
+         * would exceed the given limit.
+         */
+        size_t MeasureInline(
+            const EncodingOptions &options,
+            size_t limit
+        ) const {
+            auto nestedOptions = options;
+            ++nestedOptions.numIndentationLevels;
+            size_t length = 2;
+            bool isFirst = true;
+            ForEachChild(
+                [&](const std::string *key, const BasicValue &value){
+                    if (isFirst) {
+                        isFirst = false;
+                    } else {
+                        length += (options.pretty ? 2 : 1);
+                    }
+                    if (key != nullptr) {
+                        length += (options.pretty ? 2 : 1);
+                        if (length <= limit) {
+                            length += MeasureString(*key, nestedOptions, limit - length);
+                        }
+                    }
+                    if (length <= limit) {
+                        length += MeasureEncoding(value, nestedOptions, limit - length);
+                    }
+                    return (length <= limit);
+                }
+            );
+            return length;
+        }
+
+        /**
+         * This function returns the length of the encoding of the
+         * array or object broken over lines, stopping early if it
+         * would exceed the given limit.
+         */
+        size_t MeasureWrapped(
+            const EncodingOptions &options,
+            size_t limit
+        ) const {
+            auto nestedOptions = options;
+            ++nestedOptions.numIndentationLevels;
+            const auto nestedIndentation = (
+                nestedOptions.numIndentationLevels
+                * nestedOptions.spacesPerIndentationLevel
+            );
+            size_t length = 3 + 2 + options.numIndentationLevels * options.spacesPerIndentationLevel + 1;
+            bool isFirst = true;
+            ForEachChild(
+                [&](const std::string *key, const BasicValue &value){
+                    if (isFirst) {
+                        isFirst = false;
+                    } else {
+                        length += 3;
+                    }
+                    length += nestedIndentation;
+                    if (key != nullptr) {
+                        length += 2;
+                        if (length <= limit) {
+                            length += MeasureString(*key, nestedOptions, limit - length);
+                        }
+                    }
+                    if (length <= limit) {
+                        length += MeasureEncoding(value, nestedOptions, limit - length);
+                    }
+                    return (length <= limit);
+                }
+            );
+            return length;
+        }
+
+        /**
+         * This function returns an indication of whether or not
+         * ToEncoding breaks the array or object over lines, which it
+         * does when pretty printing and the single-line encoding
+         * would extend past the wrap threshold.
+         */
+        bool IsWrapped(const EncodingOptions &options) const {
+            if (!options.pretty) {
+                return false;
+            }
+            const auto indentation = options.numIndentationLevels * options.spacesPerIndentationLevel;
+            const auto limit = (
+                (options.wrapThreshold > indentation)
+                ? (options.wrapThreshold - indentation)
+                : 0
+            );
+            return (MeasureInline(options, limit) > limit);
+        }
+
+        /**
+         * This function writes the text which ToEncoding would
+         * return for the given value to the given buffer, passing
+         * the buffer on to its stream as it fills.  No encodings
+         * are cached.
+         *
+         * @param[in] json
+         *     This is the value to encode.
+         *
+         * @param[in] options
+         *     These are the options given to ToEncoding.
+         *
+         * @param[in,out] output
+         *     This is the buffer to which to append the encoding.
+         */
+        static void StreamEncoding(
+            const BasicValue &json,
+            const EncodingOptions &options,
+            StreamBuffer &output
+        ) {
+            if constexpr (Traits::freezeColdSubtrees) {
+                if (
+                    (json.impl_ != nullptr)
+                    && json.impl_->IsLazy()
+                ) {
+                    StreamEncoding(ParseLazyText(*json.impl_), options, output);
+                    return;
+                }
+            }
+            if (json.GetType() == Type::Invalid) {
+                output.text += json.ToEncoding(options);
+                return;
+            }
+            const auto &impl = *json.impl_;
+            if constexpr (Traits::cacheEncoding) {
+                if (
+                    !options.reencode
+                    && !impl.encoding.empty()
+                ) {
+                    output.text += impl.encoding;
+                    output.MaybeFlush();
+                    return;
+                }
+            }
+            switch (impl.type) {
+                case Type::Null: {
+                    output.text += "null";
+                }
+                break;
+
+                case Type::Boolean: {
+                    output.text += (impl.booleanValue ? "true" : "false");
+                }
+                break;
+
+                case Type::String: {
+                    Detail::AppendEncodedString(output.text, *impl.stringValue, options);
+                }
+                break;
+
+                case Type::Integer: {
+                    Detail::AppendEncodedInteger(output.text, (intmax_t) impl.integerValue);
+                }
+                break;
+
+                case Type::FloatingPoint: {
+                    Detail::AppendEncodedFloatingPoint(output.text, (double) impl.floatingPointValue);
                 }
                 break;
 
+                case Type::Array:
                 case Type::Object: {
-                    objectValue = new std::map<std::string, Value>;
-                    for (const auto &otherElement: *other->objectValue) {
-                        objectValue->insert({otherElement.first, otherElement.second});
+                    const auto isWrapped = impl.IsWrapped(options);
+                    auto nestedOptions = options;
+                    ++nestedOptions.numIndentationLevels;
+                    const auto nestedIndentation = (
+                        nestedOptions.numIndentationLevels
+                        * nestedOptions.spacesPerIndentationLevel
+                    );
+                    output.text += ((impl.type == Type::Array) ? '[' : '{');
+                    if (isWrapped) {
+                        output.text += "\r\n";
+                    }
+                    bool isFirst = true;
+                    impl.ForEachChild(
+                        [&](const std::string *key, const BasicValue &value){
+                            if (isFirst) {
+                                isFirst = false;
+                            } else if (isWrapped) {
+                                output.text += ",\r\n";
+                            } else {
+                                output.text += (options.pretty ? ", " : ",");
+                            }
+                            if (isWrapped) {
+                                output.text.append(nestedIndentation, ' ');
+                            }
+                            if (key != nullptr) {
+                                Detail::AppendEncodedString(output.text, *key, nestedOptions);
+                                output.text += (options.pretty ? ": " : ":");
+                            }
+                            StreamEncoding(value, nestedOptions, output);
+                            return true;
+                        }
+                    );
+                    if (isWrapped) {
+                        output.text += "\r\n";
+                        output.text.append(
+                            options.numIndentationLevels * options.spacesPerIndentationLevel,
+                            ' '
+                        );
                     }
+                    output.text += ((impl.type == Type::Array) ? ']' : '}');
                 }
                 break;
 
-                default: break;
+                default: {
+                    output.text += "???";
+                }
+                break;
             }
+            output.MaybeFlush();
         }
 
         /**
-         * This function decodes the given code point sequence
-         * as an integer JSON value.
+         * This is a value parsed from the old text which may take the
+         * place of parsing its text again in the new text.
+         */
+        struct Reusable {
+            /**
+             * This is the value in the previous parse.
+             */
+            BasicValue *value;
+
+            /**
+             * This is where the value's text starts in the new text.
+             */
+            size_t start;
+
+            /**
+             * This is the length of the value's text.
+             */
+            size_t length;
+        };
+
+        /**
+         * This function calls the given function with each element
+         * of the given array, or each member value of the given
+         * object, which it may modify.
          *
-         * @param[in] codePoints
-         *     This is the code point sequence to decode.
+         * @param[in] impl
+         *     This is the array or object.
+         *
+         * @param[in] function
+         *     This is the function to call.
          */
-        void DecodeAsInteger(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
-            Utf8::Utf8 encoder;
-            const auto s = encoder.Encode(codePoints);
-            if (
-                StringExtensions::ToInteger(
-                    std::string(s.begin(), s.end()),
-                    integerValue
-                ) != StringExtensions::ToIntegerResult::Success
-            ) {
-                return;
+        template<typename Function>
+        static void ForEachChildValue(
+            Impl &impl,
+            Function &&function
+        ) {
+            if (impl.type == Type::Array) {
+                for (auto &value: *impl.arrayValue) {
+                    function(value);
+                }
+            } else {
+                for (auto &entry: *impl.objectValue) {
+                    function(entry.second);
+                }
             }
-            type = Type::Integer;
         }
 
         /**
-         * This function decodes the given code point sequence as
-         * a floating-point JSON value.
+         * This function adds the given value to the values which may be
+         * reused after an edit, if its text lies wholly outside the edit.
          *
-         * @param[in] codePoints
-         *     This is the code point sequence to parse.
+         * @param[in] value
+         *     This is the value to consider.
+         *
+         * @param[in] start
+         *     This is where the value's text starts in the old text.
+         *
+         * @param[in] changed
+         *     This describes the edit.
+         *
+         * @param[in,out] reusable
+         *     This is where to add the value, if it may be reused.
          */
-        void DecodeAsFloatingPoint(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
-            size_t index = 0;
-            size_t state = 0;
-            bool negativeMagnitude = false;
-            bool negativeExponent = false;
-            double magnitude = 0.0;
-            double fraction = 0.0;
-            double exponent = 0.0;
-            size_t fractionDigits = 0;
-            while (index < codePoints.size()) {
-                switch (state) {
-                    case 0: {
-                        // [ minus ]
-                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '-') {
-                            negativeMagnitude = true;
-                            ++index;
+        static void AddIfReusable(
+            BasicValue &value,
+            size_t start,
+            const EditRange &changed,
+            std::vector<Reusable> &reusable
+        ) {
+            if constexpr (Traits::keepSourceSpans) {
+                const auto length = value.impl_->span.length;
+                if (length == 0) {
+                    return;
+                }
+
+                // A number followed directly by the edit might run on into
+                // the text inserted, so it isn't reused.
+                const auto isNumber = (
+                    (value.impl_->type == Type::Integer)
+                    || (value.impl_->type == Type::FloatingPoint)
+                );
+                if (
+                    (start + length < changed.offset)
+                    || (
+                        (start + length == changed.offset)
+                        && !isNumber
+                    )
+                ) {
+                    reusable.push_back(Reusable{&value, start, length});
+                } else if (start >= changed.offset + changed.oldLength) {
+                    reusable.push_back(
+                        Reusable{
+                            &value,
+                            start - changed.oldLength + changed.newLength,
+                            length
                         }
-                        state = 1;
-                    }
-                    break;
+                    );
+                }
+            }
+        }
 
-                    case 1: {
-                        // zero / 1-9
-                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '0') {
-                            state = 2;
-                        } else if (
-                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '1')
-                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
-                        ) {
-                            state = 3;
-                            magnitude = (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
+        /**
+         * This function parses the given part of the given text as one
+         * JSON value, recording where each value is in the text.  Each
+         * of the given reusable values found where a value is expected
+         * is stood in for by an invalid value whose span length is the
+         * index of the reusable value, to be swapped in by
+         * CommitReused() if the parse succeeds.
+         *
+         * A reusable value is stood in for by the literal "null" fed to
+         * the reader instead of its text, which leaves the reader in the
+         * same state as the text would, since the value's text is
+         * complete and is followed by the same text either way.
+         *
+         * @param[in] text
+         *     This is the whole text.
+         *
+         * @param[in] begin
+         *     This is where the part to parse starts.
+         *
+         * @param[in] end
+         *     This is where the part to parse ends.
+         *
+         * @param[in] reusable
+         *     These are the values which may be reused, in the order
+         *     in which they appear in the text.
+         *
+         * @param[out] json
+         *     This is where to store the value parsed.
+         *
+         * @return
+         *     An indication of whether or not the part of the text
+         *     holds exactly one valid JSON value is returned.
+         */
+        static bool ParseSpans(
+            std::string_view text,
+            size_t begin,
+            size_t end,
+            const std::vector<Reusable> &reusable,
+            BasicValue &json
+        ) {
+            if constexpr (Traits::keepSourceSpans) {
+                struct Container {
+                    BasicValue *value;
+                    size_t start;
+                };
+                std::vector<Container> containers;
+                bool complete = false;
+                std::string key;
+
+                // Trailing commas are allowed, as FromEncoding() allows
+                // them for other traits.
+                Reader reader(false, true);
+                Reader::Token token;
+
+                // This converts positions reported by the reader, which
+                // sees "null" in place of each value reused, to positions
+                // in the text.
+                auto shift = (ptrdiff_t) begin;
+
+                // This is the index of the reusable value whose stand-in
+                // has been fed to the reader but not yet read.
+                auto standIn = reusable.size();
+
+                const auto insert = [&](BasicValue &&value, size_t start, size_t length, bool isContainer) {
+                    BasicValue *inserted;
+                    if (containers.empty()) {
+                        value.impl_->span = SourceSpan{start, length};
+                        json = std::move(value);
+                        inserted = &json;
+                        complete = !isContainer;
+                    } else {
+                        const auto &parent = containers.back();
+                        value.impl_->span = SourceSpan{start - parent.start, length};
+                        if (parent.value->impl_->type == Type::Array) {
+                            auto &elements = *parent.value->impl_->arrayValue;
+                            elements.push_back(std::move(value));
+                            inserted = &elements.back();
                         } else {
-                            return;
+                            auto &member = (*parent.value->impl_->objectValue)[key];
+                            member = std::move(value);
+                            inserted = &member;
                         }
-                        ++index;
                     }
-                    break;
-
-                    case 2: {
-                        // . / e / E
-                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '.') {
-                            state = 4;
-                        } else if (
-                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
-                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
+                    if (isContainer) {
+                        containers.push_back(Container{inserted, start});
+                    }
+                };
+                const auto push = [&]() {
+                    const auto start = (size_t) ((ptrdiff_t) token.offset + shift);
+                    if (standIn < reusable.size()) {
+                        const auto &reused = reusable[standIn];
+                        if (
+                            (token.type != Reader::TokenType::Null)
+                            || (start != reused.start)
                         ) {
-                            state = 6;
-                        } else {
-                            return;
+                            return false;
                         }
-                        ++index;
+                        insert(BasicValue(), start, standIn, false);
+                        shift += (ptrdiff_t) reused.length - (ptrdiff_t) token.text.size();
+                        standIn = reusable.size();
+                        return true;
                     }
-                    break;
+                    switch (token.type) {
+                        case Reader::TokenType::BeginObject: {
+                            insert(BasicValue(Type::Object), start, 0, true);
+                        }
+                        break;
 
-                    case 3: {
-                        // *DIGIT / . / e / E
-                        if (
-                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
-                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
-                        ) {
-                            const auto oldMagnitude = (intmax_t) magnitude;
-                            magnitude *= 10.0;
-                            magnitude += (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
-                            if ((intmax_t) magnitude / 10 != oldMagnitude) {
-                                return;
+                        case Reader::TokenType::BeginArray: {
+                            insert(BasicValue(Type::Array), start, 0, true);
+                        }
+                        break;
+
+                        case Reader::TokenType::EndObject:
+                        case Reader::TokenType::EndArray: {
+                            const auto &container = containers.back();
+                            container.value->impl_->span.length = start + 1 - container.start;
+                            containers.pop_back();
+                            complete = containers.empty();
+                        }
+                        break;
+
+                        case Reader::TokenType::Key: {
+                            key.clear();
+                            if (!token.escaped) {
+                                key.assign(token.text);
+                            } else if (!Reader::DecodeString(token.text, key)) {
+                                return false;
                             }
-                        } else if (codePoints[index] == (Utf8::UnicodeCodePoint) '.') {
-                            state = 4;
-                        } else if (
-                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
-                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
-                        ) {
-                            state = 6;
-                        } else {
-                            return;
                         }
-                        ++index;
-                    }
-                    break;
+                        break;
 
-                    case 4: {
-                        // frac: DIGIT
-                        if (
-                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
-                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
-                        ) {
-                            ++fractionDigits;
-                            fraction += (
-                                (double) (
-                                    codePoints[index] - (Utf8::UnicodeCodePoint) '0'
-                                )
-                                / pow(10.0, (double) fractionDigits)
-                            );
-                        } else {
-                            return;
+                        case Reader::TokenType::String: {
+                            std::string decoded;
+                            if (!token.escaped) {
+                                decoded.assign(token.text);
+                            } else if (!Reader::DecodeString(token.text, decoded)) {
+                                return false;
+                            }
+                            insert(BasicValue(decoded), start, token.text.size() + 2, false);
                         }
-                        state = 5;
-                        ++index;
-                    }
-                    break;
+                        break;
 
-                    case 5: {
-                        // frac: *DIGIT / e / E
-                        if (
-                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
-                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
-                        ) {
-                            ++fractionDigits;
-                            fraction += (
-                                (double) (
-                                    codePoints[index] - (Utf8::UnicodeCodePoint) '0'
-                                )
-                                / pow(10.0, (double) fractionDigits)
+                        case Reader::TokenType::Integer: {
+                            intmax_t integer;
+                            if (
+                                !Reader::DecodeInteger(token.text, integer)
+                                || !std::in_range<IntegerType>(integer)
+                            ) {
+                                return false;
+                            }
+                            insert(BasicValue(integer), start, token.text.size(), false);
+                        }
+                        break;
+
+                        case Reader::TokenType::FloatingPoint: {
+                            double number;
+                            if (!Reader::DecodeFloatingPoint(token.text, number)) {
+                                return false;
+                            }
+                            insert(BasicValue(number), start, token.text.size(), false);
+                        }
+                        break;
+
+                        case Reader::TokenType::True:
+                        case Reader::TokenType::False: {
+                            insert(
+                                BasicValue(token.type == Reader::TokenType::True),
+                                start,
+                                token.text.size(),
+                                false
                             );
-                        } else if (
-                            (codePoints[index] == (Utf8::UnicodeCodePoint) 'e')
-                            || (codePoints[index] == (Utf8::UnicodeCodePoint) 'E')
-                        ) {
-                            state = 6;
-                        } else {
-                            return;
                         }
-                        ++index;
+                        break;
+
+                        default: {
+                            insert(BasicValue(nullptr), start, token.text.size(), false);
+                        }
+                        break;
+                    }
+                    return true;
+                };
+                const auto drain = [&]() {
+                    while (true) {
+                        const auto status = reader.Next(token);
+                        if (status != Reader::Status::Token) {
+                            return status;
+                        }
+                        if (!push()) {
+                            return Reader::Status::Error;
+                        }
+                    }
+                };
+
+                // A reusable value is stood in for only where the reader
+                // has read everything before it, and expects a value.
+                const auto expectsValue = [&](size_t position) {
+                    if (
+                        containers.empty()
+                        || ((ptrdiff_t) reader.GetOffset() + shift != (ptrdiff_t) position)
+                    ) {
+                        return false;
+                    }
+                    const auto last = text.substr(begin, position - begin).find_last_not_of(" \t\r\n");
+                    if (last == std::string_view::npos) {
+                        return false;
+                    }
+                    const auto c = text[begin + last];
+                    if (containers.back().value->impl_->type == Type::Array) {
+                        return (
+                            (c == '[')
+                            || (c == ',')
+                        );
+                    } else {
+                        return (c == ':');
+                    }
+                };
+                size_t position = begin;
+                for (size_t i = 0; i < reusable.size(); ++i) {
+                    const auto &reused = reusable[i];
+                    if (
+                        (reused.start < position)
+                        || (reused.start + reused.length > end)
+                    ) {
+                        continue;
+                    }
+                    reader.Feed(text.substr(position, reused.start - position));
+                    position = reused.start;
+                    if (drain() != Reader::Status::NeedInput) {
+                        return false;
+                    }
+                    if (!expectsValue(position)) {
+                        continue;
+                    }
+                    standIn = i;
+                    reader.Feed("null");
+                    if (
+                        (drain() != Reader::Status::NeedInput)
+                        || (standIn < reusable.size())
+                    ) {
+                        return false;
                     }
-                    break;
+                    position += reused.length;
+                }
+                reader.Feed(text.substr(position, end - position));
+                reader.Finish();
+                return (
+                    (drain() == Reader::Status::End)
+                    && complete
+                );
+            } else {
+                return false;
+            }
+        }
 
-                    case 6: {
-                        // exp: [minus/plus] / DIGIT
-                        if (codePoints[index] == (Utf8::UnicodeCodePoint) '-') {
-                            negativeExponent = true;
-                            ++index;
-                        } else if (codePoints[index] == (Utf8::UnicodeCodePoint) '+') {
-                            ++index;
-                        } else {
+        /**
+         * This function swaps the reusable values which the given
+         * value, newly parsed by ParseSpans(), stood in for, into it.
+         *
+         * @param[in,out] json
+         *     This is the value newly parsed.
+         *
+         * @param[in] reusable
+         *     These are the values which may have been reused.
+         */
+        static void CommitReused(
+            BasicValue &json,
+            const std::vector<Reusable> &reusable
+        ) {
+            if constexpr (Traits::keepSourceSpans) {
+                std::vector<BasicValue *> stack{&json};
+                while (!stack.empty()) {
+                    auto &value = *stack.back();
+                    stack.pop_back();
+                    switch (value.impl_->type) {
+                        case Type::Invalid: {
+                            const auto span = value.impl_->span;
+                            std::swap(value.impl_, reusable[span.length].value->impl_);
+                            value.impl_->span.offset = span.offset;
                         }
-                        state = 7;
-                    }
-                    break;
+                        break;
 
-                    case 7: {
-                        // exp: DIGIT
-                        if (
-                            (codePoints[index] >= (Utf8::UnicodeCodePoint) '0')
-                            && (codePoints[index] <= (Utf8::UnicodeCodePoint) '9')
-                        ) {
-                            const auto oldExponent = (intmax_t) exponent;
-                            exponent *= 10.0;
-                            exponent += (double) (codePoints[index] - (Utf8::UnicodeCodePoint) '0');
-                            if ((intmax_t) exponent / 10 != oldExponent) {
-                                return;
+                        case Type::Array: {
+                            for (auto &element: *value.impl_->arrayValue) {
+                                stack.push_back(&element);
                             }
-                        } else {
-                            return;
                         }
-                        ++index;
+                        break;
+
+                        case Type::Object: {
+                            for (auto &member: *value.impl_->objectValue) {
+                                stack.push_back(&member.second);
+                            }
+                        }
+                        break;
+
+                        default: break;
                     }
-                    break;
                 }
             }
-            if (
-                (state >= 2)
-                && (state != 4)
-                && (state != 6)
-            ) {
-                type = Type::FloatingPoint;
-                floatingPointValue = (
-                    (
-                        magnitude
-                        + fraction
-                    )
-                    * pow(10.0, exponent * (negativeExponent ? -1.0 : 1.0))
-                    * (negativeMagnitude ? -1.0 : 1.0)
-                );
-            }
         }
 
         /**
-         * This function extracts the encoding of the next JSON value
-         * in the given string, updating the given offset to indicate
-         * where the end of the value encoding was found, or whether
-         * the encoding was invalid.
-         *
-         * @param[in] codePoints
-         *     These are the Unicode code points to parse.
+         * This function finds the array or object in the given array
+         * or object whose text strictly encloses the given edit, not
+         * including its brackets.
          *
-         * @param[in,out] offset
-         *     On input, this is the position of the first character
-         *     of the encoded value in the string.
+         * @param[in] container
+         *     This is the array or object to search.
          *
-         *     On ouput, this is the position of the first character
-         *     past the end of the encoded value in the string
+         * @param[in] start
+         *     This is where the container's text starts in the old
+         *     text.
          *
-         * @param[in] delimiter
-         *     This is the character that marks the end of the value
-         *     if it's encountered.
+         * @param[in] changed
+         *     This describes the edit.
          *
          * @return
-         *     The encoding of the next JSON value in the given
-         *     Unicode code points is returned.
-         *
-         * @return {}
-         *     This is returned if the encoded value was invalid.
+         *     The enclosing array or object, and where its text starts,
+         *     is returned, or nullptr if there's none.
          */
-        std::vector<Utf8::UnicodeCodePoint> ParseValue(
-            const std::vector<Utf8::UnicodeCodePoint> &codePoints,
-            size_t &offset,
-            char delimiter
+        static std::pair<BasicValue *, size_t> FindEnclosing(
+            BasicValue &container,
+            size_t start,
+            const EditRange &changed
         ) {
-            std::stack<char> expectedDelimiters;
-            std::vector<Utf8::UnicodeCodePoint> encodedValueCodePoints;
-            const std::vector<Utf8::UnicodeCodePoint> encodingCodePoints(
-                codePoints.begin() + offset,
-                codePoints.end()
-            );
-            if (encodingCodePoints.empty()) {
-                return {};
-            }
-            bool insideString = false;
-            bool escaping = false;
-            for (const auto cp: encodingCodePoints) {
-                encodedValueCodePoints.push_back(cp);
-                if (
-                    !escaping
-                    && !expectedDelimiters.empty()
-                    && (cp == expectedDelimiters.top())
-                ) {
-                    insideString = false;
-                    expectedDelimiters.pop();
-                    continue;
-                }
-                if (insideString) {
-                    if (escaping) {
-                        escaping = false;
-                    } else if (cp == (Utf8::UnicodeCodePoint) '\\') {
-                        escaping = true;
+            if constexpr (Traits::keepSourceSpans) {
+                const auto encloses = [&](const BasicValue &value) {
+                    const auto &span = value.impl_->span;
+                    return (
+                        (
+                            (value.impl_->type == Type::Array)
+                            || (value.impl_->type == Type::Object)
+                        )
+                        && (start + span.offset < changed.offset)
+                        && (changed.offset + changed.oldLength < start + span.offset + span.length)
+                    );
+                };
+                if (container.impl_->type == Type::Array) {
+                    // Elements are in the order of their text, so the only
+                    // candidate is the last one starting before the edit.
+                    auto &elements = *container.impl_->arrayValue;
+                    auto candidate = std::partition_point(
+                        elements.begin(),
+                        elements.end(),
+                        [&](const BasicValue &element){
+                            return (start + element.impl_->span.offset < changed.offset);
+                        }
+                    );
+                    if (
+                        (candidate != elements.begin())
+                        && encloses(*--candidate)
+                    ) {
+                        return {&*candidate, start + candidate->impl_->span.offset};
                     }
                 } else {
-                    if (cp == (Utf8::UnicodeCodePoint) '\"') {
-                        insideString = true;
-                        expectedDelimiters.push('\"');
-                    } else if (cp == (Utf8::UnicodeCodePoint) '[') {
-                        expectedDelimiters.push(']');
-                    } else if (cp == (Utf8::UnicodeCodePoint) '{') {
-                        expectedDelimiters.push('}');
-                    } else if (
-                        (cp == (Utf8::UnicodeCodePoint) delimiter)
-                        && expectedDelimiters.empty()
-                    ) {
-                        break;
+                    for (auto &member: *container.impl_->objectValue) {
+                        if (encloses(member.second)) {
+                            return {&member.second, start + member.second.impl_->span.offset};
+                        }
                     }
                 }
-            }
-            if (expectedDelimiters.empty()) {
-                offset += encodedValueCodePoints.size();
-                if (encodedValueCodePoints.back() == (Utf8::UnicodeCodePoint) delimiter) {
-                    encodedValueCodePoints.pop_back();
-                }
-                return encodedValueCodePoints;
+                return {nullptr, 0};
             } else {
-                return {};
+                return {nullptr, 0};
             }
         }
 
         /**
-         * This function parses the given Unicode code points as an array
-         * JSON value.
+         * This function parses the given text again after the given
+         * edit, for configurations which keep source spans.
          *
-         * @param[in] codePoints
-         *     These are the Unicode code points to parse.
-         */
-        void ParseAsArray(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
-            std::vector<Value> newArrayValue;
-            size_t offset = 0;
-            while (offset < codePoints.size()) {
-                const auto encodedValue = ParseValue(codePoints, offset, ',');
-                if (encodedValue.empty()) {
-                    return;
-                }
-                newArrayValue.emplace_back(FromEncoding(encodedValue));
-            }
-            type = Type::Array;
-            arrayValue = new decltype(newArrayValue)(newArrayValue);
-        }
-
-        /**
-         * This function parses the given Unicode code points as a
-         * JSON object.
+         * @param[in,out] previous
+         *     This is the value parsed from the old text.
          *
-         * @param[in] codePoints
-         *     These are the Unicode code points to parse.
+         * @param[in] newText
+         *     This is the whole of the new text.
+         *
+         * @param[in] changed
+         *     This describes the edit.
+         *
+         * @return
+         *     The value parsed from the new text is returned, or an
+         *     invalid value if the new text isn't valid JSON.
          */
-        void ParseAsObject(const std::vector<Utf8::UnicodeCodePoint> &codePoints) {
-            std::map<std::string, Value> newObjectValue;
-            size_t offset = 0;
-            while (offset < codePoints.size()) {
-                const auto encodedKey = ParseValue(codePoints, offset, ':');
-                if (encodedKey.empty()) {
-                    return;
-                }
-                const auto key = FromEncoding(encodedKey);
-                if (key.GetType() != Type::String) {
-                    return;
+        static BasicValue Reparse(
+            BasicValue &previous,
+            std::string_view newText,
+            const EditRange &changed
+        ) {
+            if constexpr (Traits::keepSourceSpans) {
+                struct Level {
+                    BasicValue *value;
+                    size_t start;
+                };
+                std::vector<Level> path;
+                std::vector<Reusable> reusable;
+                const auto fits = (
+                    (previous.impl_ != nullptr)
+                    && (changed.offset <= newText.size())
+                    && (changed.newLength <= newText.size() - changed.offset)
+                    && (
+                        previous.impl_->span.offset + previous.impl_->span.length
+                        <= newText.size() - changed.newLength + changed.oldLength
+                    )
+                );
+                if (fits) {
+                    // Find the arrays and objects enclosing the edit, from
+                    // the top-level value in.
+                    BasicValue *value = &previous;
+                    size_t start = previous.impl_->span.offset;
+                    const auto &span = previous.impl_->span;
+                    if (
+                        (
+                            (value->impl_->type == Type::Array)
+                            || (value->impl_->type == Type::Object)
+                        )
+                        && (start < changed.offset)
+                        && (changed.offset + changed.oldLength < start + span.length)
+                    ) {
+                        while (value != nullptr) {
+                            path.push_back(Level{value, start});
+                            std::tie(value, start) = FindEnclosing(*value, start, changed);
+                        }
+                    }
+
+                    // Try the innermost enclosing array or object first, and
+                    // each one enclosing it in turn.
+                    const auto byStart = [](const Reusable &lhs, const Reusable &rhs){
+                        return (lhs.start < rhs.start);
+                    };
+                    while (!path.empty()) {
+                        const auto level = path.back();
+                        path.pop_back();
+                        auto &impl = *level.value->impl_;
+                        ForEachChildValue(
+                            impl,
+                            [&](BasicValue &child){
+                                AddIfReusable(
+                                    child,
+                                    level.start + child.impl_->span.offset,
+                                    changed,
+                                    reusable
+                                );
+                            }
+                        );
+                        std::sort(reusable.begin(), reusable.end(), byStart);
+                        BasicValue json;
+                        if (
+                            !ParseSpans(
+                                newText,
+                                level.start,
+                                level.start + impl.span.length - changed.oldLength + changed.newLength,
+                                reusable,
+                                json
+                            )
+                        ) {
+                            continue;
+                        }
+                        CommitReused(json, reusable);
+                        json.impl_->span.offset = impl.span.offset;
+                        std::swap(json.impl_, level.value->impl_);
+
+                        // Lengthen or shorten the enclosing arrays and
+                        // objects, and move what follows the edit in them.
+                        auto inner = level.value;
+                        while (!path.empty()) {
+                            const auto outer = path.back().value;
+                            path.pop_back();
+                            auto &outerSpan = outer->impl_->span;
+                            outerSpan.length = outerSpan.length + changed.newLength - changed.oldLength;
+                            const auto offset = inner->impl_->span.offset;
+                            ForEachChildValue(
+                                *outer->impl_,
+                                [&](BasicValue &child){
+                                    auto &childSpan = child.impl_->span;
+                                    if (childSpan.offset > offset) {
+                                        childSpan.offset = childSpan.offset + changed.newLength - changed.oldLength;
+                                    }
+                                }
+                            );
+                            inner = outer;
+                        }
+                        return std::move(previous);
+                    }
+                    AddIfReusable(previous, previous.impl_->span.offset, changed, reusable);
+                    std::sort(reusable.begin(), reusable.end(), byStart);
                 }
-                const auto encodedValue = ParseValue(codePoints, offset, ',');
-                if (encodedValue.empty()) {
-                    return;
+
+                // Parse the whole text, reusing what may be reused.
+                BasicValue json;
+                if (!ParseSpans(newText, 0, newText.size(), reusable, json)) {
+                    return BasicValue();
                 }
-                newObjectValue[(std::string) key] = FromEncoding(encodedValue);
+                CommitReused(json, reusable);
+                return json;
+            } else {
+                return BasicValue();
             }
-            type = Type::Object;
-            objectValue = new decltype(newObjectValue)(newObjectValue);
         }
     };
 
-    Value::~Value() noexcept = default;
+    template<typename Traits>
+    BasicValue<Traits>::~BasicValue() noexcept = default;
 
-    Value::Value(const Value &other)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(const BasicValue &other)
         : impl_(new Impl) {
         impl_->CopyFrom(other.impl_);
     }
 
-    Value::Value(Value &&other) noexcept
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(BasicValue &&other) noexcept
         : impl_(nullptr) {
-        if (&other != &null) {
+        if (&other != &NullValue<Traits>()) {
             impl_ = std::move(other.impl_);
+            if (impl_ != nullptr) {
+                impl_->Detach();
+            }
         }
     }
 
-    Value &Value::operator=(Value &&other) noexcept {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator=(BasicValue &&other) {
         if (
             (this != &other)
-            && (this != &null)
-            && (&other != &null)
+            && (this != &NullValue<Traits>())
+            && (&other != &NullValue<Traits>())
         ) {
+            if (other.impl_ != nullptr) {
+                other.impl_->Detach();
+                if (impl_ != nullptr) {
+                    impl_->RecordReplacement(*other.impl_, other);
+                }
+            }
             impl_ = std::move(other.impl_);
         }
         return *this;
     }
 
-    Value &Value::operator=(const Value &other) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator=(const BasicValue &other) {
         if (
             (this != &other)
-            && (this != &null)
+            && (this != &NullValue<Traits>())
         ) {
-            impl_.reset(new Impl());
-            impl_->CopyFrom(other.impl_);
+            // The copy is made before the value is replaced, in case the
+            // other value is part of this one.
+            std::unique_ptr<Impl> copy(new Impl());
+            copy->CopyFrom(other.impl_);
+            if (impl_ != nullptr) {
+                impl_->RecordReplacement(*copy, other);
+            }
+            impl_ = std::move(copy);
         }
         return *this;
     }
 
-    Value::Value(Type type)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(Type type)
         : impl_(new Impl) {
         impl_->type = type;
         switch (type) {
@@ -952,12 +3719,12 @@ namespace Json {
             break;
 
             case Type::Array: {
-                impl_->arrayValue = new std::vector<Value>;
+                impl_->arrayValue = new ArrayType;
             }
             break;
 
             case Type::Object: {
-                impl_->objectValue = new std::map<std::string, Value>;
+                impl_->objectValue = new ObjectType;
             }
             break;
 
@@ -965,54 +3732,77 @@ namespace Json {
         }
     }
 
-    Value::Value(std::nullptr_t)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(std::nullptr_t)
         : impl_(new Impl) {
         impl_->type = Type::Null;
     }
 
-    Value::Value(bool value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(bool value)
         : impl_(new Impl) {
         impl_->type = Type::Boolean;
         impl_->booleanValue = value;
     }
 
-    Value::Value(int value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(int value)
         : impl_(new Impl) {
         impl_->type = Type::Integer;
-        impl_->integerValue = (intmax_t) value;
+        impl_->integerValue = (IntegerType) value;
     }
 
-    Value::Value(intmax_t value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(intmax_t value)
         : impl_(new Impl) {
         impl_->type = Type::Integer;
-        impl_->integerValue = value;
+        impl_->integerValue = (IntegerType) value;
     }
 
-    Value::Value(size_t value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(size_t value)
         : impl_(new Impl) {
         impl_->type = Type::Integer;
-        impl_->integerValue = (intmax_t) value;
+        impl_->integerValue = (IntegerType) value;
     }
 
-    Value::Value(double value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(double value)
         : impl_(new Impl) {
         impl_->type = Type::FloatingPoint;
-        impl_->floatingPointValue = value;
+        impl_->floatingPointValue = (FloatingPointType) value;
     }
 
-    Value::Value(const char *value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(const char *value)
         : impl_(new Impl) {
         impl_->type = Type::String;
         impl_->stringValue = new std::string(value);
     }
 
-    Value::Value(const std::string &value)
+    template<typename Traits>
+    BasicValue<Traits>::BasicValue(const std::string &value)
         : impl_(new Impl) {
         impl_->type = Type::String;
         impl_->stringValue = new std::string(value);
     }
 
-    bool Value::operator==(const Value &other) const {
+    template<typename Traits>
+    bool BasicValue<Traits>::operator==(const BasicValue &other) const {
+        if constexpr (Traits::freezeColdSubtrees) {
+            if (
+                (impl_ != nullptr)
+                && impl_->IsLazy()
+            ) {
+                return Impl::ParseLazyText(*impl_) == other;
+            }
+            if (
+                (other.impl_ != nullptr)
+                && other.impl_->IsLazy()
+            ) {
+                return *this == Impl::ParseLazyText(*other.impl_);
+            }
+        }
         if (GetType() != other.GetType()) {
             return false;
         } else
@@ -1024,8 +3814,8 @@ namespace Json {
                 case Type::Integer: return impl_->integerValue == other.impl_->integerValue;
                 case Type::FloatingPoint: {
                     return (
-                        fabs(impl_->floatingPointValue - other.impl_->floatingPointValue)
-                        < std::numeric_limits<double>::epsilon()
+                        std::fabs(impl_->floatingPointValue - other.impl_->floatingPointValue)
+                        < std::numeric_limits<FloatingPointType>::epsilon()
                     );
                 }
                 case Type::Array: return CompareJsonArrays(*impl_->arrayValue, *other.impl_->arrayValue);
@@ -1034,11 +3824,13 @@ namespace Json {
             }
     }
 
-    bool Value::operator!=(const Value &other) const {
+    template<typename Traits>
+    bool BasicValue<Traits>::operator!=(const BasicValue &other) const {
         return !(*this == other);
     }
 
-    bool Value::operator<(const Value &other) const {
+    template<typename Traits>
+    bool BasicValue<Traits>::operator<(const BasicValue &other) const {
         if (GetType() != other.GetType()) {
             return (int) GetType() < (int) other.GetType();
         } else
@@ -1051,7 +3843,8 @@ namespace Json {
             }
     }
 
-    Value::operator bool() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator bool() const {
         if (GetType() == Type::Boolean) {
             return impl_->booleanValue;
         } else {
@@ -1059,7 +3852,8 @@ namespace Json {
         }
     }
 
-    Value::operator std::string() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator std::string() const {
         if (GetType() == Type::String) {
             return *impl_->stringValue;
         } else {
@@ -1067,7 +3861,8 @@ namespace Json {
         }
     }
 
-    Value::operator int() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator int() const {
         if (GetType() == Type::Integer) {
             if (
                 (impl_->integerValue < (decltype(impl_->integerValue)) std::numeric_limits<int>::lowest())
@@ -1089,9 +3884,10 @@ namespace Json {
         }
     }
 
-    Value::operator intmax_t() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator intmax_t() const {
         if (GetType() == Type::Integer) {
-            return impl_->integerValue;
+            return (intmax_t) impl_->integerValue;
         } else if (GetType() == Type::FloatingPoint) {
             if (
                 (impl_->floatingPointValue < (decltype(impl_->floatingPointValue)) std::numeric_limits<
@@ -1107,12 +3903,13 @@ namespace Json {
         }
     }
 
-    Value::operator size_t() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator size_t() const {
         if (GetType() == Type::Integer) {
             if (
                 (impl_->integerValue < 0)
                 || (
-                    (sizeof(size_t) < sizeof(intmax_t))
+                    (sizeof(size_t) < sizeof(IntegerType))
                     && (impl_->integerValue > (decltype(impl_->integerValue)) std::numeric_limits<size_t>::max())
                 )
             ) {
@@ -1133,24 +3930,28 @@ namespace Json {
         }
     }
 
-    Value::operator double() const {
+    template<typename Traits>
+    BasicValue<Traits>::operator double() const {
         if (GetType() == Type::Integer) {
             return (double) impl_->integerValue;
         } else if (GetType() == Type::FloatingPoint) {
-            return impl_->floatingPointValue;
+            return (double) impl_->floatingPointValue;
         } else {
             return 0.0;
         }
     }
 
-    auto Value::GetType() const -> Type {
+    template<typename Traits>
+    auto BasicValue<Traits>::GetType() const -> Type {
         if (impl_ == nullptr) {
             return Type::Invalid;
         }
+        impl_->Touch();
         return impl_->type;
     }
 
-    size_t Value::GetSize() const {
+    template<typename Traits>
+    size_t BasicValue<Traits>::GetSize() const {
         if (GetType() == Type::Array) {
             return impl_->arrayValue->size();
         } else if (GetType() == Type::Object) {
@@ -1160,7 +3961,8 @@ namespace Json {
         }
     }
 
-    bool Value::Has(const std::string &key) const {
+    template<typename Traits>
+    bool BasicValue<Traits>::Has(const std::string &key) const {
         if (GetType() == Type::Object) {
             return (impl_->objectValue->find(key) != impl_->objectValue->end());
         } else {
@@ -1168,7 +3970,8 @@ namespace Json {
         }
     }
 
-    std::vector<std::string> Value::GetKeys() const {
+    template<typename Traits>
+    std::vector<std::string> BasicValue<Traits>::GetKeys() const {
         std::vector<std::string> keys;
         if (GetType() == Type::Object) {
             keys.reserve(impl_->objectValue->size());
@@ -1179,155 +3982,337 @@ namespace Json {
         return keys;
     }
 
-    const Value &Value::operator[](size_t index) const {
+    template<typename Traits>
+    const BasicValue<Traits> &BasicValue<Traits>::operator[](size_t index) const {
         if (GetType() == Type::Array) {
             if (index >= impl_->arrayValue->size()) {
-                return null;
+                return NullValue<Traits>();
             }
             return (*impl_->arrayValue)[index];
         } else {
-            return null;
+            return NullValue<Traits>();
         }
     }
 
-    const Value &Value::operator[](int index) const {
+    template<typename Traits>
+    const BasicValue<Traits> &BasicValue<Traits>::operator[](int index) const {
         return (*this)[(size_t) index];
     }
 
-    const Value &Value::operator[](const std::string &key) const {
+    template<typename Traits>
+    const BasicValue<Traits> &BasicValue<Traits>::operator[](const std::string &key) const {
         if (GetType() == Type::Object) {
             const auto entry = impl_->objectValue->find(key);
             if (entry == impl_->objectValue->end()) {
-                return null;
+                return NullValue<Traits>();
             }
             return entry->second;
         } else {
-            return null;
+            return NullValue<Traits>();
         }
     }
 
-    const Value &Value::operator[](const char *key) const {
+    template<typename Traits>
+    const BasicValue<Traits> &BasicValue<Traits>::operator[](const char *key) const {
         if (key == nullptr) {
-            return null;
+            return NullValue<Traits>();
         }
         return (*this)[std::string(key)];
     }
 
-    Value &Value::operator[](size_t index) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator[](size_t index) {
         if (GetType() == Type::Array) {
+            // The element returned may be changed through the reference.
+            impl_->ClearSpan();
             if (index >= impl_->arrayValue->size()) {
+                if (impl_->tracked) {
+                    const BasicValue null(nullptr);
+                    for (auto i = impl_->arrayValue->size(); i <= index; ++i) {
+                        const auto token = std::to_string(i);
+                        impl_->Record("add", &token, &null);
+                    }
+                }
                 impl_->arrayValue->resize(index + 1, nullptr);
             }
-            return (*impl_->arrayValue)[index];
+            auto &element = (*impl_->arrayValue)[index];
+            impl_->Track(element, nullptr, index);
+            return element;
         } else {
-            return null;
+            return NullValue<Traits>();
         }
     }
 
-    Value &Value::operator[](int index) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator[](int index) {
         if (index < 0) {
-            return null;
+            return NullValue<Traits>();
         }
         return (*this)[(size_t) index];
     }
 
-    Value &Value::operator[](const std::string &key) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator[](const std::string &key) {
         if (GetType() == Type::Object) {
+            // The member returned may be changed through the reference.
+            impl_->ClearSpan();
             const auto entry = impl_->objectValue->find(key);
             if (entry == impl_->objectValue->end()) {
                 return Set(key, nullptr);
             } else {
+                impl_->Track(entry->second, &key, 0);
                 return entry->second;
             }
         } else {
-            return null;
+            return NullValue<Traits>();
+        }
+    }
+
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::operator[](const char *key) {
+        if (key == nullptr) {
+            return NullValue<Traits>();
+        }
+        return (*this)[std::string(key)];
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::Find(std::string_view key) const -> const BasicValue * {
+        if (GetType() != Type::Object) {
+            return nullptr;
+        }
+        typename ObjectType::const_iterator entry;
+        if constexpr (requires { impl_->objectValue->find(key); }) {
+            entry = impl_->objectValue->find(key);
+        } else {
+            entry = impl_->objectValue->find(std::string(key));
+        }
+        if (entry == impl_->objectValue->end()) {
+            return nullptr;
+        }
+        return &entry->second;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::Find(size_t index) const -> const BasicValue * {
+        if (
+            (GetType() != Type::Array)
+            || (index >= impl_->arrayValue->size())
+        ) {
+            return nullptr;
+        }
+        return &(*impl_->arrayValue)[index];
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::Find(const Pointer &pointer) const -> const BasicValue * {
+        if (!pointer.IsValid()) {
+            return nullptr;
+        }
+        auto value = this;
+        for (const auto &token: pointer.GetTokens()) {
+            if (value->GetType() == Type::Object) {
+                value = value->Find(std::string_view(token));
+            } else {
+                size_t index;
+                if (!Pointer::ParseIndex(token, index)) {
+                    return nullptr;
+                }
+                value = value->Find(index);
+            }
+            if (value == nullptr) {
+                return nullptr;
+            }
+        }
+        return value;
+    }
+
+    template<typename Traits>
+    bool BasicValue<Traits>::TryGet(bool &value) const {
+        if (GetType() != Type::Boolean) {
+            return false;
+        }
+        value = impl_->booleanValue;
+        return true;
+    }
+
+    template<typename Traits>
+    bool BasicValue<Traits>::TryGet(intmax_t &value) const {
+        if (
+            (GetType() != Type::Integer)
+            || !std::in_range<intmax_t>(impl_->integerValue)
+        ) {
+            return false;
+        }
+        value = (intmax_t) impl_->integerValue;
+        return true;
+    }
+
+    template<typename Traits>
+    bool BasicValue<Traits>::TryGet(double &value) const {
+        if (GetType() == Type::Integer) {
+            value = (double) impl_->integerValue;
+        } else if (GetType() == Type::FloatingPoint) {
+            value = (double) impl_->floatingPointValue;
+        } else {
+            return false;
         }
+        return true;
     }
 
-    Value &Value::operator[](const char *key) {
-        if (key == nullptr) {
-            return null;
+    template<typename Traits>
+    bool BasicValue<Traits>::TryGet(std::string_view &value) const {
+        if (GetType() != Type::String) {
+            return false;
         }
-        return (*this)[std::string(key)];
+        value = *impl_->stringValue;
+        return true;
     }
 
-    Value &Value::Add(const Value &value) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Add(const BasicValue &value) {
         if (GetType() != Type::Array) {
-            return null;
+            return NullValue<Traits>();
         }
         auto &inserted = Insert(value, impl_->arrayValue->size());
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
         return inserted;
     }
 
-    Value &Value::Add(Value &&value) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Add(BasicValue &&value) {
         if (this == &value) {
             return Add(value);
         }
         if (GetType() != Type::Array) {
-            return null;
+            return NullValue<Traits>();
         }
         auto &inserted = Insert(std::move(value), impl_->arrayValue->size());
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
         return inserted;
     }
 
-    Value &Value::Insert(const Value &value, size_t index) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Insert(const BasicValue &value, size_t index) {
         if (GetType() != Type::Array) {
-            return null;
+            return NullValue<Traits>();
+        }
+        index = std::min(index, impl_->arrayValue->size());
+        if (impl_->tracked) {
+            const auto token = std::to_string(index);
+            impl_->Record("add", &token, &value);
         }
         auto inserted = impl_->arrayValue->insert(
-            impl_->arrayValue->begin() + std::min(
-                index,
-                impl_->arrayValue->size()
-            ),
+            impl_->arrayValue->begin() + index,
             value
         );
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
+        impl_->Track(*inserted, nullptr, index);
         return *inserted;
     }
 
-    Value &Value::Insert(Value &&value, size_t index) {
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Insert(BasicValue &&value, size_t index) {
         if (GetType() != Type::Array) {
-            return null;
+            return NullValue<Traits>();
+        }
+        index = std::min(index, impl_->arrayValue->size());
+        if (impl_->tracked) {
+            const auto token = std::to_string(index);
+            impl_->Record("add", &token, &value);
         }
         auto inserted = impl_->arrayValue->insert(
-            impl_->arrayValue->begin() + std::min(
-                index,
-                impl_->arrayValue->size()
-            ),
+            impl_->arrayValue->begin() + index,
             std::move(value)
         );
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
+        impl_->Track(*inserted, nullptr, index);
         return *inserted;
     }
 
-    Value &Value::Set(
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Set(
         const std::string &key,
-        const Value &value
+        const BasicValue &value
     ) {
         if (GetType() != Type::Object) {
-            return null;
+            return NullValue<Traits>();
         }
+        const auto size = impl_->objectValue->size();
         auto &ref = (*impl_->objectValue)[key];
+        if (impl_->tracked) {
+            if (ref.impl_ != nullptr) {
+                // The member is recorded here, rather than by its own
+                // assignment below.
+                ref.impl_->Untrack();
+            }
+            impl_->Record(
+                (impl_->objectValue->size() == size) ? "replace" : "add",
+                &key,
+                &value
+            );
+        }
         ref = value;
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
+        impl_->Track(ref, &key, 0);
+        return ref;
+    }
+
+    template<typename Traits>
+    BasicValue<Traits> &BasicValue<Traits>::Set(
+        const std::string &key,
+        BasicValue &&value
+    ) {
+        if (GetType() != Type::Object) {
+            return NullValue<Traits>();
+        }
+        const auto size = impl_->objectValue->size();
+        auto &ref = (*impl_->objectValue)[key];
+        if (impl_->tracked) {
+            if (ref.impl_ != nullptr) {
+                // The member is recorded here, rather than by its own
+                // assignment below.
+                ref.impl_->Untrack();
+            }
+            impl_->Record(
+                (impl_->objectValue->size() == size) ? "replace" : "add",
+                &key,
+                &value
+            );
+        }
+        ref = std::move(value);
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
+        impl_->Track(ref, &key, 0);
         return ref;
     }
 
-    void Value::Remove(size_t index) {
+    template<typename Traits>
+    void BasicValue<Traits>::Remove(size_t index) {
         if (GetType() != Type::Array) {
             return;
         }
         if (index < impl_->arrayValue->size()) {
+            if (impl_->tracked) {
+                const auto token = std::to_string(index);
+                impl_->Record("remove", &token, nullptr);
+            }
             impl_->arrayValue->erase(
                 impl_->arrayValue->begin() + index
             );
-            impl_->encoding.clear();
+            impl_->ClearEncoding();
+            impl_->ClearSpan();
         }
     }
 
-    auto Value::begin() const -> Iterator {
+    template<typename Traits>
+    auto BasicValue<Traits>::begin() const -> Iterator {
+        impl_->Touch();
         if (impl_->type == Type::Array) {
             return Iterator(this, impl_->arrayValue->begin());
         } else {
@@ -1335,7 +4320,9 @@ namespace Json {
         }
     }
 
-    auto Value::end() const -> Iterator {
+    template<typename Traits>
+    auto BasicValue<Traits>::end() const -> Iterator {
+        impl_->Touch();
         if (impl_->type == Type::Array) {
             return Iterator(this, impl_->arrayValue->end());
         } else {
@@ -1343,169 +4330,290 @@ namespace Json {
         }
     }
 
-    void Value::Remove(const std::string &key) {
+    template<typename Traits>
+    bool BasicValue<Traits>::GetBooleanUnchecked() const {
+        return impl_->booleanValue;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::GetIntegerUnchecked() const -> IntegerType {
+        return impl_->integerValue;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::GetFloatingPointUnchecked() const -> FloatingPointType {
+        return impl_->floatingPointValue;
+    }
+
+    template<typename Traits>
+    std::string_view BasicValue<Traits>::GetStringUnchecked() const {
+        return *impl_->stringValue;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::GetArrayUnchecked() const -> const ArrayType & {
+        impl_->Touch();
+        return *impl_->arrayValue;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::GetObjectUnchecked() const -> const ObjectType & {
+        impl_->Touch();
+        return *impl_->objectValue;
+    }
+
+    template<typename Traits>
+    void BasicValue<Traits>::Remove(const std::string &key) {
         if (GetType() != Type::Object) {
             return;
         }
+        if (
+            impl_->tracked
+            && (impl_->objectValue->find(key) != impl_->objectValue->end())
+        ) {
+            impl_->Record("remove", &key, nullptr);
+        }
         (void) impl_->objectValue->erase(key);
-        impl_->encoding.clear();
+        impl_->ClearEncoding();
+        impl_->ClearSpan();
+    }
+
+    template<typename Traits>
+    void BasicValue<Traits>::BeginTracking() {
+        if (impl_ == nullptr) {
+            return;
+        }
+        auto &tracking = Impl::GetTracking();
+        std::lock_guard lock(tracking.mutex);
+        auto &link = tracking.links[impl_.get()];
+        tracking.SetParent(link, impl_.get(), nullptr);
+        link = typename Impl::Link();
+        link.changes.reset(new ArrayType);
+        impl_->tracked = true;
+    }
+
+    template<typename Traits>
+    auto BasicValue<Traits>::TakeChanges() -> BasicValue {
+        BasicValue changes(Type::Array);
+        if (
+            (impl_ == nullptr)
+            || !impl_->tracked
+        ) {
+            return changes;
+        }
+        auto &tracking = Impl::GetTracking();
+        std::lock_guard lock(tracking.mutex);
+        const auto link = tracking.links.find(impl_.get());
+        if (
+            (link != tracking.links.end())
+            && (link->second.changes != nullptr)
+        ) {
+            changes.impl_->arrayValue->swap(*link->second.changes);
+        }
+        return changes;
+    }
+
+    template<typename Traits>
+    void BasicValue<Traits>::EndTracking() {
+        if (impl_ != nullptr) {
+            impl_->Untrack();
+        }
+    }
+
+    template<typename Traits>
+    bool BasicValue<Traits>::ApplyPatch(const BasicValue &patch) {
+        if (patch.GetType() != Type::Array) {
+            return false;
+        }
+        for (const auto &operation: *patch.impl_->arrayValue) {
+            if (!Impl::ApplyOperation(*this, operation)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Traits>
+    size_t BasicValue<Traits>::FreezeColdSubtrees(const FreezeOptions &options) {
+        size_t frozen = 0;
+        if constexpr (Traits::freezeColdSubtrees) {
+            if (impl_ == nullptr) {
+                return 0;
+            }
+            const auto result = Impl::Sweep(*impl_, options, frozen);
+            if (impl_->IsFreezable(result, options)) {
+                impl_->Freeze();
+                ++frozen;
+            }
+        }
+        return frozen;
     }
 
-    std::string Value::ToEncoding(const EncodingOptions &options) const {
+    template<typename Traits>
+    std::string BasicValue<Traits>::ToEncoding(const EncodingOptions &options) const {
+        if constexpr (Traits::freezeColdSubtrees) {
+            if (
+                (impl_ != nullptr)
+                && impl_->IsLazy()
+            ) {
+                return Impl::ParseLazyText(*impl_).ToEncoding(options);
+            }
+        }
         if (GetType() == Type::Invalid) {
             return StringExtensions::sprintf(
                 "(Invalid JSON: %s)",
-                impl_->encoding.c_str()
+                (
+                    (
+                        (impl_ == nullptr)
+                        || (impl_->stringValue == nullptr)
+                    )
+                    ? ""
+                    : impl_->stringValue->c_str()
+                )
             );
         }
-        if (options.reencode) {
-            impl_->encoding.clear();
+        if constexpr (Traits::cacheEncoding) {
+            if (options.reencode) {
+                impl_->encoding.clear();
+            }
+            if (!impl_->encoding.empty()) {
+                return impl_->encoding;
+            }
         }
-        if (impl_->encoding.empty()) {
-            switch (GetType()) {
-                case Type::Null: {
-                    impl_->encoding = "null";
-                }
-                break;
+        std::string encoding;
+        switch (GetType()) {
+            case Type::Null: {
+                encoding = "null";
+            }
+            break;
 
-                case Type::Boolean: {
-                    impl_->encoding = impl_->booleanValue ? "true" : "false";
-                }
-                break;
+            case Type::Boolean: {
+                encoding = impl_->booleanValue ? "true" : "false";
+            }
+            break;
 
-                case Type::String: {
-                    impl_->encoding = (
-                        "\""
-                        + EncodeString(*impl_->stringValue, options)
-                        + "\""
-                    );
-                }
-                break;
+            case Type::String: {
+                Detail::AppendEncodedString(encoding, *impl_->stringValue, options);
+            }
+            break;
 
-                case Type::Integer: {
-                    impl_->encoding = StringExtensions::sprintf("%" PRIiMAX, impl_->integerValue);
-                }
-                break;
+            case Type::Integer: {
+                Detail::AppendEncodedInteger(encoding, (intmax_t) impl_->integerValue);
+            }
+            break;
 
-                case Type::FloatingPoint: {
-                    impl_->encoding = StringExtensions::sprintf("%.15lg", impl_->floatingPointValue);
-                    if (impl_->encoding.find_first_not_of("0123456789-") == std::string::npos) {
-                        impl_->encoding += ".0";
-                    }
-                    std::replace(
-                        impl_->encoding.begin(),
-                        impl_->encoding.end(),
-                        ',', '.'
-                    );
-                }
-                break;
+            case Type::FloatingPoint: {
+                Detail::AppendEncodedFloatingPoint(encoding, (double) impl_->floatingPointValue);
+            }
+            break;
 
-                case Type::Array: {
-                    impl_->encoding = '[';
-                    bool isFirst = true;
-                    auto nestedOptions = options;
-                    ++nestedOptions.numIndentationLevels;
-                    std::string nestedIndentation(
-                        (
-                            nestedOptions.numIndentationLevels
-                            * nestedOptions.spacesPerIndentationLevel
-                        ),
-                        ' '
-                    );
-                    std::string wrappedEncoding = "[\r\n";
-                    for (const auto value: *impl_->arrayValue) {
-                        if (isFirst) {
-                            isFirst = false;
-                        } else {
-                            impl_->encoding += (nestedOptions.pretty ? ", " : ",");
-                            wrappedEncoding += ",\r\n";
-                        }
-                        const auto encodedValue = value.ToEncoding(nestedOptions);
-                        impl_->encoding += encodedValue;
-                        wrappedEncoding += nestedIndentation;
-                        wrappedEncoding += encodedValue;
-                    }
-                    impl_->encoding += ']';
-                    std::string indentation(
-                        (
-                            options.numIndentationLevels
-                            * options.spacesPerIndentationLevel
-                        ),
-                        ' '
-                    );
-                    wrappedEncoding += "\r\n";
-                    wrappedEncoding += indentation;
-                    wrappedEncoding += "]";
-                    if (
-                        options.pretty
-                        && (indentation.length() + impl_->encoding.length() > options.wrapThreshold)
-                    ) {
-                        impl_->encoding = wrappedEncoding;
+            case Type::Array: {
+                encoding = '[';
+                bool isFirst = true;
+                auto nestedOptions = options;
+                ++nestedOptions.numIndentationLevels;
+                std::string nestedIndentation(
+                    (
+                        nestedOptions.numIndentationLevels
+                        * nestedOptions.spacesPerIndentationLevel
+                    ),
+                    ' '
+                );
+                std::string wrappedEncoding = "[\r\n";
+                for (const auto &value: *impl_->arrayValue) {
+                    if (isFirst) {
+                        isFirst = false;
+                    } else {
+                        encoding += (nestedOptions.pretty ? ", " : ",");
+                        wrappedEncoding += ",\r\n";
                     }
+                    const auto encodedValue = value.ToEncoding(nestedOptions);
+                    encoding += encodedValue;
+                    wrappedEncoding += nestedIndentation;
+                    wrappedEncoding += encodedValue;
                 }
-                break;
+                encoding += ']';
+                std::string indentation(
+                    (
+                        options.numIndentationLevels
+                        * options.spacesPerIndentationLevel
+                    ),
+                    ' '
+                );
+                wrappedEncoding += "\r\n";
+                wrappedEncoding += indentation;
+                wrappedEncoding += "]";
+                if (
+                    options.pretty
+                    && (indentation.length() + encoding.length() > options.wrapThreshold)
+                ) {
+                    encoding = wrappedEncoding;
+                }
+            }
+            break;
 
-                case Type::Object: {
-                    impl_->encoding = '{';
-                    bool isFirst = true;
-                    auto nestedOptions = options;
-                    ++nestedOptions.numIndentationLevels;
-                    std::string nestedIndentation(
-                        (
-                            nestedOptions.numIndentationLevels
-                            * nestedOptions.spacesPerIndentationLevel
-                        ),
-                        ' '
-                    );
-                    std::string wrappedEncoding = "{\r\n";
-                    for (const auto &entry: *impl_->objectValue) {
-                        if (isFirst) {
-                            isFirst = false;
-                        } else {
-                            impl_->encoding += (nestedOptions.pretty ? ", " : ",");
-                            wrappedEncoding += ",\r\n";
-                        }
-                        const Value keyAsJson(entry.first);
-                        const auto encodedValue = (
-                            keyAsJson.ToEncoding(nestedOptions)
-                            + (nestedOptions.pretty ? ": " : ":")
-                            + entry.second.ToEncoding(nestedOptions)
-                        );
-                        impl_->encoding += encodedValue;
-                        wrappedEncoding += nestedIndentation;
-                        wrappedEncoding += encodedValue;
-                    }
-                    impl_->encoding += '}';
-                    std::string indentation(
-                        (
-                            options.numIndentationLevels
-                            * options.spacesPerIndentationLevel
-                        ),
-                        ' '
-                    );
-                    wrappedEncoding += "\r\n";
-                    wrappedEncoding += indentation;
-                    wrappedEncoding += "}";
-                    if (
-                        options.pretty
-                        && (indentation.length() + impl_->encoding.length() > options.wrapThreshold)
-                    ) {
-                        impl_->encoding = wrappedEncoding;
+            case Type::Object: {
+                encoding = '{';
+                bool isFirst = true;
+                auto nestedOptions = options;
+                ++nestedOptions.numIndentationLevels;
+                std::string nestedIndentation(
+                    (
+                        nestedOptions.numIndentationLevels
+                        * nestedOptions.spacesPerIndentationLevel
+                    ),
+                    ' '
+                );
+                std::string wrappedEncoding = "{\r\n";
+                for (const auto &entry: *impl_->objectValue) {
+                    if (isFirst) {
+                        isFirst = false;
+                    } else {
+                        encoding += (nestedOptions.pretty ? ", " : ",");
+                        wrappedEncoding += ",\r\n";
                     }
+                    std::string encodedValue;
+                    Detail::AppendEncodedString(encodedValue, entry.first, nestedOptions);
+                    encodedValue += (nestedOptions.pretty ? ": " : ":");
+                    encodedValue += entry.second.ToEncoding(nestedOptions);
+                    encoding += encodedValue;
+                    wrappedEncoding += nestedIndentation;
+                    wrappedEncoding += encodedValue;
                 }
-                break;
-
-                default: {
-                    impl_->encoding = "???";
+                encoding += '}';
+                std::string indentation(
+                    (
+                        options.numIndentationLevels
+                        * options.spacesPerIndentationLevel
+                    ),
+                    ' '
+                );
+                wrappedEncoding += "\r\n";
+                wrappedEncoding += indentation;
+                wrappedEncoding += "}";
+                if (
+                    options.pretty
+                    && (indentation.length() + encoding.length() > options.wrapThreshold)
+                ) {
+                    encoding = wrappedEncoding;
                 }
-                break;
             }
+            break;
+
+            default: {
+                encoding = "???";
+            }
+            break;
+        }
+        if constexpr (Traits::cacheEncoding) {
+            impl_->encoding = encoding;
         }
-        return impl_->encoding;
+        return encoding;
     }
 
-    Value Value::FromEncoding(const std::vector<Utf8::UnicodeCodePoint> &encodingBeforeTrim) {
-        Value json;
+    template<typename Traits>
+    BasicValue<Traits> BasicValue<Traits>::FromEncoding(const std::vector<Utf8::UnicodeCodePoint> &encodingBeforeTrim) {
+        BasicValue json;
         const auto firstNonWhitespaceCharacter = FindFirstNotOf(
             encodingBeforeTrim,
             WHITESPACE_CHARACTERS,
@@ -1525,7 +4633,7 @@ namespace Json {
         );
         Utf8::Utf8 utf8;
         const auto encodingUtf8 = utf8.Encode(encoding);
-        json.impl_->encoding = std::string(
+        std::string text(
             encodingUtf8.begin(),
             encodingUtf8.end()
         );
@@ -1575,29 +4683,247 @@ namespace Json {
                 json.impl_->type = Type::String;
                 json.impl_->stringValue = new std::string(output);
             }
-        } else if (json.impl_->encoding == "null") {
+        } else if (text == "null") {
             json.impl_->type = Type::Null;
-        } else if (json.impl_->encoding == "true") {
+        } else if (text == "true") {
             json.impl_->type = Type::Boolean;
             json.impl_->booleanValue = true;
-        } else if (json.impl_->encoding == "false") {
+        } else if (text == "false") {
             json.impl_->type = Type::Boolean;
             json.impl_->booleanValue = false;
         } else {
-            if (json.impl_->encoding.find_first_of("+.eE") != std::string::npos) {
+            if (text.find_first_of("+.eE") != std::string::npos) {
                 json.impl_->DecodeAsFloatingPoint(encoding);
             } else {
                 json.impl_->DecodeAsInteger(encoding);
             }
         }
+        if (json.impl_->type == Type::Invalid) {
+            json.impl_->stringValue = new std::string(std::move(text));
+        } else if constexpr (Traits::cacheEncoding) {
+            json.impl_->encoding = std::move(text);
+        }
         return json;
     }
 
-    Value Value::FromEncoding(const std::string &encodingBeforeTrim) {
+    template<typename Traits>
+    BasicValue<Traits> BasicValue<Traits>::FromEncoding(const std::string &encodingBeforeTrim) {
+        if constexpr (Traits::keepSourceSpans) {
+            BasicValue json;
+            if (!Impl::ParseSpans(encodingBeforeTrim, 0, encodingBeforeTrim.size(), {}, json)) {
+                json = BasicValue();
+                const auto first = encodingBeforeTrim.find_first_not_of(" \t\r\n");
+                if (first != std::string::npos) {
+                    const auto last = encodingBeforeTrim.find_last_not_of(" \t\r\n");
+                    json.impl_->stringValue = new std::string(
+                        encodingBeforeTrim.substr(first, last + 1 - first)
+                    );
+                }
+            }
+            return json;
+        }
         Utf8::Utf8 decoder;
         return FromEncoding(decoder.Decode(encodingBeforeTrim));
     }
 
+    template<typename Traits>
+    BasicValue<Traits> BasicValue<Traits>::FromEncoding(
+        const std::string &encodingBeforeTrim,
+        const ProfileId &profile
+    ) {
+        if constexpr (Traits::freezeColdSubtrees) {
+            const auto accessProfile = GetAccessProfile(profile.name);
+            std::shared_ptr<const ProfileNode> root;
+            {
+                std::lock_guard<std::mutex> lock(accessProfile->mutex);
+                root = accessProfile->root;
+            }
+            BasicValue json;
+            if (Impl::ParseProfiled(encodingBeforeTrim, root, accessProfile, {}, json)) {
+                return json;
+            }
+        }
+
+        // Text which isn't valid is decoded again, for the invalid value
+        // to hold it as FromEncoding() would.
+        return FromEncoding(encodingBeforeTrim);
+    }
+
+    template<typename Traits>
+    void BasicValue<Traits>::Write(
+        std::ostream &stream,
+        const EncodingOptions &options
+    ) const {
+        StreamBuffer output{
+            [&stream](std::string_view chunk){
+                (void) stream.write(chunk.data(), (std::streamsize) chunk.size());
+            }
+        };
+        Impl::StreamEncoding(*this, options, output);
+        output.Flush();
+    }
+
+    template<typename Traits>
+    bool BasicValue<Traits>::ToFile(
+        const std::string &path,
+        const EncodingOptions &options,
+        const WriteOptions &writeOptions
+    ) const {
+        // The temporary file is in the same directory as the target,
+        // so that renaming it over the target is atomic.
+        const std::filesystem::path target(path);
+        auto temporary = target;
+        temporary += StringExtensions::sprintf(".%08x.tmp", (unsigned int) std::random_device()());
+        const auto file = fopen(temporary.string().c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        CopyFileMode(target, file);
+        (void) setvbuf(file, nullptr, _IONBF, 0);
+        const auto preallocated = (
+            writeOptions.preallocate
+            && PreallocateFile(file, Impl::EstimateEncoding(*this, options))
+        );
+        bool ok = true;
+        size_t written = 0;
+        StreamBuffer output{
+            [file, &ok, &written](std::string_view chunk){
+                if (
+                    ok
+                    && (fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size())
+                ) {
+                    ok = false;
+                }
+                written += chunk.size();
+            },
+            std::max(writeOptions.bufferSize, (size_t) 1)
+        };
+        output.text.reserve(output.size + STREAM_BUFFER_SIZE);
+        Impl::StreamEncoding(*this, options, output);
+        output.Flush();
+        if (
+            ok
+            && preallocated
+        ) {
+            // Space reserved past the end of the encoding is released.
+            std::error_code error;
+            (void) fflush(file);
+            std::filesystem::resize_file(temporary, written, error);
+            ok = !error;
+        }
+        ok = (
+            (fflush(file) == 0)
+            && ok
+        );
+        if (
+            ok
+            && writeOptions.sync
+        ) {
+            ok = SyncFile(file);
+        }
+        ok = (
+            (fclose(file) == 0)
+            && ok
+        );
+        std::error_code error;
+        if (ok) {
+            std::filesystem::rename(temporary, target, error);
+            ok = !error;
+        }
+        if (!ok) {
+            (void) std::filesystem::remove(temporary, error);
+            return false;
+        }
+        if (writeOptions.sync) {
+            SyncDirectory(target.parent_path());
+        }
+        return true;
+    }
+
+    template<typename Traits>
+    BasicValue<Traits> BasicValue<Traits>::Read(std::istream &stream) {
+        const std::istream::sentry sentry(stream, true);
+        if (!sentry) {
+            return BasicValue();
+        }
+        const auto source = stream.rdbuf();
+        std::vector<char> chunk(STREAM_BUFFER_SIZE);
+        Reader reader;
+        Reader::Token token;
+        BasicBuilder<Traits> builder;
+        while (!builder.IsComplete()) {
+            const auto status = reader.Next(token);
+            if (status == Reader::Status::Token) {
+                if (!builder.Push(token)) {
+                    break;
+                }
+                continue;
+            }
+            if (status != Reader::Status::NeedInput) {
+                break;
+            }
+
+            // Take only what the stream already has, so that reading
+            // from a pipe doesn't wait for text past the end of the
+            // value.  If it has nothing, wait for one character.
+            const auto available = source->in_avail();
+            if (available > 0) {
+                const auto amount = source->sgetn(
+                    chunk.data(),
+                    std::min((std::streamsize) chunk.size(), available)
+                );
+                reader.Feed(std::string_view(chunk.data(), (size_t) amount));
+            } else {
+                const auto c = source->sbumpc();
+                if (c == std::char_traits<char>::eof()) {
+                    stream.setstate(std::ios_base::eofbit);
+                    reader.Finish();
+                } else {
+                    chunk[0] = std::char_traits<char>::to_char_type(c);
+                    reader.Feed(std::string_view(chunk.data(), 1));
+                }
+            }
+        }
+        if (!builder.IsComplete()) {
+            return BasicValue();
+        }
+
+        // Whatever was read past the end of the value came from the
+        // stream's buffer in the last chunk, so it can be put back.
+        const auto unread = reader.GetUnread();
+        for (auto c = unread.rbegin(); c != unread.rend(); ++c) {
+            if (source->sputbackc(*c) == std::char_traits<char>::eof()) {
+                break;
+            }
+        }
+        return builder.Take();
+    }
+
+    template<typename Traits>
+    BasicValue<Traits> BasicValue<Traits>::Reparse(
+        BasicValue &&previous,
+        std::string_view newText,
+        const EditRange &changed
+    ) {
+        if constexpr (Traits::keepSourceSpans) {
+            return Impl::Reparse(previous, newText, changed);
+        } else {
+            return FromEncoding(std::string(newText));
+        }
+    }
+
+    EditRange EditRange::Then(const EditRange &next) const {
+        // The combined edit ends wherever the later of the two ends,
+        // measured in the text between them.
+        const auto begin = std::min(offset, next.offset);
+        const auto end = std::max(offset + newLength, next.offset + next.oldLength);
+        EditRange combined;
+        combined.offset = begin;
+        combined.oldLength = end - newLength + oldLength - begin;
+        combined.newLength = end - next.oldLength + next.newLength - begin;
+        return combined;
+    }
+
     Value Array(std::initializer_list<const Value> args) {
         Value json(Value::Type::Array);
         for (
@@ -1623,46 +4949,46 @@ namespace Json {
     }
 
     void PrintTo(
-        Value::Type type,
+        ValueType type,
         std::ostream *os
     ) {
         switch (type) {
-            case Value::Type::Invalid: {
+            case ValueType::Invalid: {
                 *os << "Invalid";
             }
             break;
 
-            case Value::Type::Null: {
+            case ValueType::Null: {
                 *os << "Null";
             }
             break;
 
-            case Value::Type::Boolean: {
+            case ValueType::Boolean: {
                 *os << "Boolean";
             }
             break;
 
-            case Value::Type::String: {
+            case ValueType::String: {
                 *os << "String";
             }
             break;
 
-            case Value::Type::Integer: {
+            case ValueType::Integer: {
                 *os << "Integer";
             }
             break;
 
-            case Value::Type::FloatingPoint: {
+            case ValueType::FloatingPoint: {
                 *os << "FloatingPoint";
             }
             break;
 
-            case Value::Type::Array: {
+            case ValueType::Array: {
                 *os << "Array";
             }
             break;
 
-            case Value::Type::Object: {
+            case ValueType::Object: {
                 *os << "Object";
             }
             break;
@@ -1674,8 +5000,9 @@ namespace Json {
         }
     }
 
+    template<typename Traits>
     void PrintTo(
-        const Value &json,
+        const BasicValue<Traits> &json,
         std::ostream *os
     ) {
         EncodingOptions options;
@@ -1683,4 +5010,78 @@ namespace Json {
         options.numIndentationLevels = 1;
         *os << json.ToEncoding(options);
     }
+
+    template<typename Traits>
+    std::ostream &operator<<(
+        std::ostream &stream,
+        const BasicValue<Traits> &json
+    ) {
+        json.Write(stream);
+        return stream;
+    }
+
+    template<typename Traits>
+    std::istream &operator>>(
+        std::istream &stream,
+        BasicValue<Traits> &json
+    ) {
+        json = BasicValue<Traits>::Read(stream);
+        if (json.GetType() == ValueType::Invalid) {
+            stream.setstate(std::ios_base::failbit);
+        }
+        return stream;
+    }
+
+    std::vector<std::string> GetProfiledPaths(const ProfileId &profile) {
+        const auto accessProfile = GetAccessProfile(profile.name);
+        std::shared_ptr<const ProfileNode> root;
+        {
+            std::lock_guard<std::mutex> lock(accessProfile->mutex);
+            root = accessProfile->root;
+        }
+        std::vector<std::string> paths;
+        if (root != nullptr) {
+            std::vector<std::string> tokens;
+            CollectProfiledPaths(*root, tokens, paths);
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    void ResetProfile(const ProfileId &profile) {
+        const auto accessProfile = GetAccessProfile(profile.name);
+        std::lock_guard<std::mutex> lock(accessProfile->mutex);
+        accessProfile->root = nullptr;
+    }
+
+    template class BasicValue<DefaultTraits>;
+    template class BasicValue<CompactTraits>;
+    template class BasicValue<HashedTraits>;
+    template class BasicValue<EditableTraits>;
+    template class BasicValue<TieredTraits>;
+
+    template void PrintTo(const BasicValue<DefaultTraits> &, std::ostream *);
+    template void PrintTo(const BasicValue<CompactTraits> &, std::ostream *);
+    template void PrintTo(const BasicValue<HashedTraits> &, std::ostream *);
+    template void PrintTo(const BasicValue<EditableTraits> &, std::ostream *);
+    template void PrintTo(const BasicValue<TieredTraits> &, std::ostream *);
+
+    template std::ostream &operator<<(std::ostream &, const BasicValue<DefaultTraits> &);
+    template std::ostream &operator<<(std::ostream &, const BasicValue<CompactTraits> &);
+    template std::ostream &operator<<(std::ostream &, const BasicValue<HashedTraits> &);
+    template std::ostream &operator<<(std::ostream &, const BasicValue<EditableTraits> &);
+    template std::ostream &operator<<(std::ostream &, const BasicValue<TieredTraits> &);
+
+    template std::istream &operator>>(std::istream &, BasicValue<DefaultTraits> &);
+    template std::istream &operator>>(std::istream &, BasicValue<CompactTraits> &);
+    template std::istream &operator>>(std::istream &, BasicValue<HashedTraits> &);
+    template std::istream &operator>>(std::istream &, BasicValue<EditableTraits> &);
+    template std::istream &operator>>(std::istream &, BasicValue<TieredTraits> &);
+
+#ifdef JSONKIT_CUSTOM_TRAITS
+    template class BasicValue<JSONKIT_CUSTOM_TRAITS>;
+    template void PrintTo(const BasicValue<JSONKIT_CUSTOM_TRAITS> &, std::ostream *);
+    template std::ostream &operator<<(std::ostream &, const BasicValue<JSONKIT_CUSTOM_TRAITS> &);
+    template std::istream &operator>>(std::istream &, BasicValue<JSONKIT_CUSTOM_TRAITS> &);
+#endif
 }
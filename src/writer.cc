@@ -0,0 +1,238 @@
+#include "encoding.h"
+
+#include <cassert>
+#include <utility>
+#include <writer.h>
+
+namespace Json {
+    Writer::Writer(
+        std::string &output,
+        const EncodingOptions &options
+    )
+        : output(&output)
+          , options(options) {
+    }
+
+    Writer::Writer(
+        Sink sink,
+        const EncodingOptions &options,
+        size_t bufferSize
+    )
+        : output(&buffer)
+          , sink(std::move(sink))
+          , bufferSize(bufferSize)
+          , options(options) {
+        buffer.reserve(bufferSize);
+    }
+
+    Writer::~Writer() noexcept {
+        Flush();
+    }
+
+    Writer &Writer::BeginObject() {
+        if (!BeginValue()) {
+            return *this;
+        }
+        *output += '{';
+        frames.push_back(Frame{true});
+        return *this;
+    }
+
+    Writer &Writer::EndObject() {
+        return EndContainer(true, '}');
+    }
+
+    Writer &Writer::BeginArray() {
+        if (!BeginValue()) {
+            return *this;
+        }
+        *output += '[';
+        frames.push_back(Frame{false});
+        return *this;
+    }
+
+    Writer &Writer::EndArray() {
+        return EndContainer(false, ']');
+    }
+
+    Writer &Writer::Key(std::string_view key) {
+        if (BeginKey()) {
+            Detail::AppendEncodedString(*output, key, options);
+            *output += (options.pretty ? ": " : ":");
+        }
+        return *this;
+    }
+
+    Writer &Writer::RawKey(std::string_view encoding) {
+        if (BeginKey()) {
+            *output += encoding;
+            *output += (options.pretty ? ": " : ":");
+        }
+        return *this;
+    }
+
+    Writer &Writer::Null() {
+        return RawValue("null");
+    }
+
+    Writer &Writer::Bool(bool value) {
+        return RawValue(value ? "true" : "false");
+    }
+
+    Writer &Writer::Int(intmax_t value) {
+        if (!BeginValue()) {
+            return *this;
+        }
+        Detail::AppendEncodedInteger(*output, value);
+        MaybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::Double(double value) {
+        if (!BeginValue()) {
+            return *this;
+        }
+        Detail::AppendEncodedFloatingPoint(*output, value);
+        MaybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::String(std::string_view value) {
+        if (!BeginValue()) {
+            return *this;
+        }
+        Detail::AppendEncodedString(*output, value, options);
+        MaybeFlush();
+        return *this;
+    }
+
+    Writer &Writer::RawValue(std::string_view encoding) {
+        if (!BeginValue()) {
+            return *this;
+        }
+        *output += encoding;
+        MaybeFlush();
+        return *this;
+    }
+
+    void Writer::Flush() {
+        if (
+            sink
+            && !buffer.empty()
+        ) {
+            sink(buffer);
+            buffer.clear();
+        }
+    }
+
+    bool Writer::IsComplete() const {
+        return (
+            complete
+            && frames.empty()
+            && !failed
+        );
+    }
+
+    bool Writer::BeginKey() {
+        if (failed) {
+            return false;
+        }
+        assert(!frames.empty() && frames.back().isObject && "Key() outside of an object");
+        assert(!frames.back().haveKey && "Key() called twice without a value");
+        if (
+            frames.empty()
+            || !frames.back().isObject
+            || frames.back().haveKey
+        ) {
+            failed = true;
+            return false;
+        }
+        auto &frame = frames.back();
+        if (frame.count > 0) {
+            *output += ',';
+        }
+        if (options.pretty) {
+            NewLine(options.numIndentationLevels + frames.size());
+        }
+        frame.haveKey = true;
+        return true;
+    }
+
+    bool Writer::BeginValue() {
+        if (failed) {
+            return false;
+        }
+        if (frames.empty()) {
+            assert(!complete && "more than one top-level value");
+            if (complete) {
+                failed = true;
+                return false;
+            }
+            complete = true;
+            return true;
+        }
+        auto &frame = frames.back();
+        if (frame.isObject) {
+            assert(frame.haveKey && "value in an object without a key");
+            if (!frame.haveKey) {
+                failed = true;
+                return false;
+            }
+            frame.haveKey = false;
+        } else {
+            if (frame.count > 0) {
+                *output += ',';
+            }
+            if (options.pretty) {
+                NewLine(options.numIndentationLevels + frames.size());
+            }
+        }
+        ++frame.count;
+        return true;
+    }
+
+    void Writer::NewLine(size_t levels) {
+        *output += "\r\n";
+        output->append(levels * options.spacesPerIndentationLevel, ' ');
+    }
+
+    Writer &Writer::EndContainer(
+        bool isObject,
+        char delimiter
+    ) {
+        if (failed) {
+            return *this;
+        }
+        assert(!frames.empty() && "end of a container which wasn't started");
+        assert((frames.back().isObject == isObject) && "mismatched end of container");
+        assert(!frames.back().haveKey && "object ended after a key without a value");
+        if (
+            frames.empty()
+            || (frames.back().isObject != isObject)
+            || frames.back().haveKey
+        ) {
+            failed = true;
+            return *this;
+        }
+        const auto count = frames.back().count;
+        frames.pop_back();
+        if (
+            options.pretty
+            && (count > 0)
+        ) {
+            NewLine(options.numIndentationLevels + frames.size());
+        }
+        *output += delimiter;
+        MaybeFlush();
+        return *this;
+    }
+
+    void Writer::MaybeFlush() {
+        if (
+            sink
+            && (buffer.size() >= bufferSize)
+        ) {
+            Flush();
+        }
+    }
+}
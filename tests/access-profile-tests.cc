@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is a document of which a consumer uses only a little.
+     */
+    const std::string DOCUMENT = R"({
+        "id": 7,
+        "user": {"name": "ann", "address": {"city": "Oslo", "lines": ["a", "b"]}},
+        "items": [
+            {"sku": "x", "price": 1.5, "history": [{"at": 1}, {"at": 2}]},
+            {"sku": "y", "price": 2.5, "history": []}
+        ],
+        "audit": {"entries": [[1, 2], [3, 4]], "escaped": {"a": 1}}
+    })";
+
+    /**
+     * This is a profile for one test, which begins knowing nothing.
+     */
+    struct TestProfile {
+        Json::ProfileId id;
+
+        TestProfile() {
+            id.name = (
+                std::string("access-profile-tests.")
+                + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+            );
+            Json::ResetProfile(id);
+        }
+    };
+}
+
+TEST(AccessProfileTests, ParsesSameValue) {
+    const TestProfile profile;
+    const auto expected = Json::TieredValue::FromEncoding(DOCUMENT);
+    for (int pass = 0; pass < 2; ++pass) {
+        const auto value = Json::TieredValue::FromEncoding(DOCUMENT, profile.id);
+        EXPECT_EQ(expected, value);
+        EXPECT_EQ(expected.ToEncoding(), value.ToEncoding());
+    }
+}
+
+TEST(AccessProfileTests, LearnsPathsAccessed) {
+    const TestProfile profile;
+    EXPECT_EQ(std::vector<std::string>(), Json::GetProfiledPaths(profile.id));
+    auto value = Json::TieredValue::FromEncoding(DOCUMENT, profile.id);
+    EXPECT_EQ(7, (int) value["id"]);
+    EXPECT_EQ(std::vector<std::string>(), Json::GetProfiledPaths(profile.id));
+    EXPECT_EQ("ann", (std::string) value["user"]["name"]);
+    EXPECT_EQ(2.5, (double) value["items"][1]["price"]);
+    EXPECT_EQ(1, (int) value["audit"]["escaped"]["a"]);
+    EXPECT_EQ(
+        std::vector<std::string>({"/audit", "/audit/escaped", "/items", "/items/*", "/user"}),
+        Json::GetProfiledPaths(profile.id)
+    );
+
+    // A document parsed with what the profile has learned needs nothing
+    // more for the same accesses.
+    value = Json::TieredValue::FromEncoding(DOCUMENT, profile.id);
+    EXPECT_EQ("ann", (std::string) value["user"]["name"]);
+    EXPECT_EQ(1.5, (double) value["items"][0]["price"]);
+    EXPECT_EQ(1, (int) value["audit"]["escaped"]["a"]);
+    EXPECT_EQ(5, Json::GetProfiledPaths(profile.id).size());
+    EXPECT_EQ(2, (int) value["items"][0]["history"][1]["at"]);
+    EXPECT_EQ(
+        std::vector<std::string>(
+            {"/audit", "/audit/escaped", "/items", "/items/*", "/items/*/history", "/items/*/history/*", "/user"}
+        ),
+        Json::GetProfiledPaths(profile.id)
+    );
+    Json::ResetProfile(profile.id);
+    EXPECT_EQ(std::vector<std::string>(), Json::GetProfiledPaths(profile.id));
+}
+
+TEST(AccessProfileTests, EncodingAndComparingTeachNothing) {
+    const TestProfile profile;
+    const auto expected = Json::TieredValue::FromEncoding(DOCUMENT);
+    auto value = Json::TieredValue::FromEncoding(DOCUMENT, profile.id);
+    EXPECT_EQ("ann", (std::string) value["user"]["name"]);
+    const auto learned = Json::GetProfiledPaths(profile.id);
+    EXPECT_EQ(std::vector<std::string>({"/user"}), learned);
+    Json::EncodingOptions pretty;
+    pretty.pretty = true;
+    pretty.wrapThreshold = 20;
+    EXPECT_EQ(expected.ToEncoding(), value.ToEncoding());
+    EXPECT_EQ(expected.ToEncoding(pretty), value.ToEncoding(pretty));
+    std::ostringstream stream;
+    stream << value;
+    EXPECT_EQ(expected.ToEncoding(), stream.str());
+    EXPECT_EQ(expected, value);
+    EXPECT_EQ(value, expected);
+    const auto copy = value;
+    EXPECT_EQ(learned, Json::GetProfiledPaths(profile.id));
+
+    // Looking things up still teaches the profile.
+    EXPECT_EQ(1, (int) copy["audit"]["escaped"]["a"]);
+    EXPECT_EQ(
+        std::vector<std::string>({"/audit", "/audit/escaped", "/user"}),
+        Json::GetProfiledPaths(profile.id)
+    );
+}
+
+TEST(AccessProfileTests, LazyValuesCopyMutateAndFreeze) {
+    const TestProfile profile;
+    const auto expected = Json::TieredValue::FromEncoding(DOCUMENT);
+    auto value = Json::TieredValue::FromEncoding(DOCUMENT, profile.id);
+    const auto copy = value;
+    (void) value.FreezeColdSubtrees();
+    EXPECT_EQ(1, value.FreezeColdSubtrees(Json::FreezeOptions{1, 2}));
+    EXPECT_EQ(expected, value);
+    value["user"]["address"]["city"] = "Bergen";
+    EXPECT_EQ("Bergen", (std::string) value["user"]["address"]["city"]);
+    EXPECT_EQ("Oslo", (std::string) copy["user"]["address"]["city"]);
+    EXPECT_EQ(expected, copy);
+}
+
+TEST(AccessProfileTests, InvalidText) {
+    const TestProfile profile;
+    for (const std::string text: {R"({"a": [1, 2)", R"({"a": [1, } ])", R"({"a": {}} x)", ""}) {
+        const auto value = Json::TieredValue::FromEncoding(text, profile.id);
+        EXPECT_EQ(Json::ValueType::Invalid, value.GetType()) << text;
+    }
+    EXPECT_EQ(Json::TieredValue(7), Json::TieredValue::FromEncoding(" 7 ", profile.id));
+}
+
+TEST(AccessProfileTests, OtherTraitsParseEverything) {
+    const TestProfile profile;
+    const auto value = Json::Value::FromEncoding(DOCUMENT, profile.id);
+    EXPECT_EQ(Json::Value::FromEncoding(DOCUMENT), value);
+    EXPECT_EQ(std::vector<std::string>(), Json::GetProfiledPaths(profile.id));
+}
@@ -0,0 +1,218 @@
+#include <async.h>
+#include <coroutine>
+#include <deque>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is a source of text for the coroutines under test, into
+     * which the test pushes chunks by hand, much as an event loop
+     * would when data arrives on a socket.
+     */
+    struct ManualSource {
+        std::deque<std::string> chunks;
+        std::string current;
+        bool closed = false;
+        std::coroutine_handle<> waiting;
+
+        struct Awaiter {
+            ManualSource &source;
+
+            bool await_ready() const noexcept {
+                return (
+                    !source.chunks.empty()
+                    || source.closed
+                );
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                source.waiting = handle;
+            }
+
+            std::string_view await_resume() {
+                if (source.chunks.empty()) {
+                    return {};
+                }
+                source.current = std::move(source.chunks.front());
+                source.chunks.pop_front();
+                return source.current;
+            }
+        };
+
+        Awaiter Read() {
+            return Awaiter{*this};
+        }
+
+        void Push(std::string chunk) {
+            chunks.push_back(std::move(chunk));
+            Wake();
+        }
+
+        void Close() {
+            closed = true;
+            Wake();
+        }
+
+        void Wake() {
+            if (waiting) {
+                std::exchange(waiting, nullptr).resume();
+            }
+        }
+    };
+
+    /**
+     * This is a source of text whose chunks are always ready, and are
+     * returned by value, so that each is a temporary which goes away
+     * unless the coroutine reading it keeps it.
+     */
+    struct OwningSource {
+        std::deque<std::string> chunks;
+
+        struct Awaiter {
+            OwningSource &source;
+
+            bool await_ready() const noexcept {
+                return true;
+            }
+
+            void await_suspend(std::coroutine_handle<>) noexcept {
+            }
+
+            std::string await_resume() {
+                if (source.chunks.empty()) {
+                    return {};
+                }
+                auto chunk = std::move(source.chunks.front());
+                source.chunks.pop_front();
+                return chunk;
+            }
+        };
+
+        Awaiter Read() {
+            return Awaiter{*this};
+        }
+    };
+
+    /**
+     * This coroutine collects the elements produced from the given
+     * source, returning how many there were.
+     */
+    template<typename Source>
+    Json::Task<size_t> CollectElements(
+        Source &source,
+        std::vector<Json::Value> &elements
+    ) {
+        auto generator = Json::Elements(source);
+        while (auto element = co_await generator.Next()) {
+            elements.push_back(std::move(*element));
+        }
+        co_return elements.size();
+    }
+
+    /**
+     * This coroutine awaits the parse of the given source, to check
+     * that tasks can be awaited by other coroutines.
+     */
+    Json::Task<std::string> ParseAndEncode(ManualSource &source) {
+        const auto json = co_await Json::ParseAsync(source);
+        co_return json.ToEncoding();
+    }
+}
+
+TEST(AsyncTests, ParseAsyncInterleaved) {
+    ManualSource first;
+    ManualSource second;
+    auto firstTask = Json::ParseAsync(first);
+    auto secondTask = Json::ParseAsync<Json::CompactTraits>(second);
+    firstTask.Start();
+    secondTask.Start();
+    EXPECT_FALSE(firstTask.IsDone());
+    EXPECT_FALSE(secondTask.IsDone());
+    first.Push(R"({"a": [1, )");
+    second.Push("[true, ");
+    first.Push(R"(2]})");
+    second.Push(R"("x"])");
+    EXPECT_FALSE(firstTask.IsDone());
+    first.Close();
+    second.Close();
+    ASSERT_TRUE(firstTask.IsDone());
+    ASSERT_TRUE(secondTask.IsDone());
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": [1, 2]})"), firstTask.TakeResult());
+    EXPECT_EQ(Json::CompactValue::FromEncoding(R"([true, "x"])"), secondTask.TakeResult());
+}
+
+TEST(AsyncTests, ParseAsyncInvalid) {
+    ManualSource source;
+    auto task = Json::ParseAsync(source);
+    task.Start();
+    source.Push("[1, 2");
+    source.Close();
+    ASSERT_TRUE(task.IsDone());
+    EXPECT_EQ(Json::ValueType::Invalid, task.TakeResult().GetType());
+}
+
+TEST(AsyncTests, AwaitedByAnotherCoroutine) {
+    ManualSource source;
+    auto task = ParseAndEncode(source);
+    task.Start();
+    source.Push(R"({ "b" : null })");
+    source.Close();
+    ASSERT_TRUE(task.IsDone());
+    EXPECT_EQ(R"({"b":null})", task.TakeResult());
+}
+
+TEST(AsyncTests, ElementsArriveBeforeEndOfInput) {
+    ManualSource source;
+    std::vector<Json::Value> elements;
+    auto task = CollectElements(source, elements);
+    task.Start();
+    source.Push(R"([{"id": 1}, )");
+    ASSERT_EQ(1, elements.size());
+    EXPECT_EQ(Json::Value(1), elements[0]["id"]);
+    source.Push(R"("two", [3, )");
+    EXPECT_EQ(2, elements.size());
+    source.Push(R"(4], 5)");
+    EXPECT_EQ(3, elements.size());
+    source.Push("]");
+    EXPECT_FALSE(task.IsDone());
+    source.Close();
+    ASSERT_TRUE(task.IsDone());
+    EXPECT_EQ(4, task.TakeResult());
+    EXPECT_EQ(Json::Value(5), elements[3]);
+}
+
+TEST(AsyncTests, ElementsOfInvalidArray) {
+    ManualSource source;
+    std::vector<Json::Value> elements;
+    auto task = CollectElements(source, elements);
+    task.Start();
+    source.Push("[1, }");
+    ASSERT_TRUE(task.IsDone());
+    ASSERT_EQ(2, elements.size());
+    EXPECT_EQ(Json::Value(1), elements[0]);
+    EXPECT_EQ(Json::ValueType::Invalid, elements[1].GetType());
+}
+
+TEST(AsyncTests, SourceReturningStrings) {
+    const std::string padding(100, ' ');
+    OwningSource source;
+    source.chunks = {"{\"long key name\":" + padding, "[\"a string value\", " + padding, "2]}"};
+    auto task = Json::ParseAsync(source);
+    task.Start();
+    ASSERT_TRUE(task.IsDone());
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"long key name": ["a string value", 2]})"), task.TakeResult());
+
+    source.chunks = {"[\"first element\"," + padding, "{\"second\": true}" + padding, "]"};
+    std::vector<Json::Value> elements;
+    auto elementsTask = CollectElements(source, elements);
+    elementsTask.Start();
+    ASSERT_TRUE(elementsTask.IsDone());
+    EXPECT_EQ(2, elementsTask.TakeResult());
+    EXPECT_EQ(Json::Value("first element"), elements[0]);
+    EXPECT_EQ(Json::Value(true), elements[1]["second"]);
+}
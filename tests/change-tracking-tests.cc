@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <value.h>
+
+TEST(ChangeTrackingTests, MutationsAreRecordedAsPatch) {
+    auto value = Json::Value::FromEncoding(R"({"a": {"b": [1, 2]}, "c": "x"})");
+    const auto before = value;
+    value.BeginTracking();
+    (void) value.Set("d", true);
+    value["a"]["b"][1] = 20;
+    (void) value["a"]["b"].Add(3);
+    (void) value["a"]["b"].Insert(0, 0);
+    value["a"].Remove("missing");
+    value.Remove("c");
+    (void) value.Set("d", false);
+    value["e"] = "new";
+    const auto changes = value.TakeChanges();
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"([
+            {"op": "add", "path": "/d", "value": true},
+            {"op": "replace", "path": "/a/b/1", "value": 20},
+            {"op": "add", "path": "/a/b/2", "value": 3},
+            {"op": "add", "path": "/a/b/0", "value": 0},
+            {"op": "remove", "path": "/c"},
+            {"op": "replace", "path": "/d", "value": false},
+            {"op": "add", "path": "/e", "value": null},
+            {"op": "replace", "path": "/e", "value": "new"}
+        ])"),
+        changes
+    );
+    EXPECT_EQ(Json::Value(Json::ValueType::Array), value.TakeChanges());
+    auto follower = before;
+    ASSERT_TRUE(follower.ApplyPatch(changes));
+    EXPECT_EQ(value, follower);
+}
+
+TEST(ChangeTrackingTests, FollowerAppliesChanges) {
+    auto value = Json::Value::FromEncoding(R"({"users": [{"name": "a"}], "count": 1})");
+    auto follower = value;
+    value.BeginTracking();
+    auto &user = value["users"].Add(Json::Value::FromEncoding(R"({"name": "b"})"));
+    user["tags"] = Json::Value(Json::ValueType::Array);
+    (void) user["tags"].Add("x");
+    value["users"][3] = "padded";
+    value["users"].Remove(0);
+    value["count"] = 3;
+    value["a/b~c"] = 1;
+    const auto changes = value.TakeChanges();
+    EXPECT_EQ(Json::Value("/a~1b~0c"), changes[changes.GetSize() - 1]["path"]);
+    ASSERT_TRUE(follower.ApplyPatch(changes));
+    EXPECT_EQ(value, follower);
+}
+
+TEST(ChangeTrackingTests, ReplacingTheWholeValue) {
+    Json::Value value(Json::ValueType::Object);
+    value.BeginTracking();
+    value = Json::Value::FromEncoding("[1]");
+    (void) value.Add(2);
+    value = value[0];
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"([
+            {"op": "replace", "path": "", "value": [1]},
+            {"op": "add", "path": "/1", "value": 2},
+            {"op": "replace", "path": "", "value": 1}
+        ])"),
+        value.TakeChanges()
+    );
+    EXPECT_EQ(Json::Value(1), value);
+}
+
+TEST(ChangeTrackingTests, DetachedValuesAreNotRecorded) {
+    auto value = Json::Value::FromEncoding(R"({"a": {"b": 1}})");
+    value.BeginTracking();
+    auto taken = std::move(value["a"]);
+    value.Remove("a");
+    taken["b"] = 3;
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"([{"op": "remove", "path": "/a"}])"),
+        value.TakeChanges()
+    );
+}
+
+TEST(ChangeTrackingTests, DetachedValuesOutliveTheirDocument) {
+    auto value = std::make_unique<Json::Value>(Json::Value::FromEncoding(R"({"a": {"b": 1}, "c": [{}]})"));
+    value->BeginTracking();
+    auto taken = std::move((*value)["a"]);
+    Json::Value element;
+    element = std::move((*value)["c"][0]);
+    value.reset();
+    taken.Set("y", 2);
+    element.Set("z", 3);
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"b": 1, "y": 2})"), taken);
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"z": 3})"), element);
+    EXPECT_EQ(Json::Value(Json::ValueType::Array), taken.TakeChanges());
+}
+
+TEST(ChangeTrackingTests, UntrackedValuesRecordNothing) {
+    auto value = Json::Value::FromEncoding(R"({"a": [1]})");
+    value["a"][0] = 2;
+    EXPECT_EQ(Json::Value(Json::ValueType::Array), value.TakeChanges());
+    value.BeginTracking();
+    value["a"][0] = 3;
+    value.EndTracking();
+    value["a"][0] = 4;
+    EXPECT_EQ(Json::Value(Json::ValueType::Array), value.TakeChanges());
+}
+
+TEST(ChangeTrackingTests, ApplyPatchOperations) {
+    auto value = Json::Value::FromEncoding(R"({"a": {"b": [1, 2]}, "c": "x"})");
+    EXPECT_TRUE(
+        value.ApplyPatch(
+            Json::Value::FromEncoding(R"([
+                {"op": "test", "path": "/a/b/1", "value": 2},
+                {"op": "move", "from": "/c", "path": "/a/b/-"},
+                {"op": "copy", "from": "/a/b", "path": "/d"},
+                {"op": "add", "path": "/d/0", "value": 0},
+                {"op": "replace", "path": "/a/b/0", "value": {"n": null}},
+                {"op": "move", "from": "/d", "path": "/d"}
+            ])")
+        )
+    );
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"a": {"b": [{"n": null}, 2, "x"]}, "d": [0, 1, 2, "x"]})"),
+        value
+    );
+    const auto before = value;
+    for (const auto *operation: {
+        R"({"op": "test", "path": "/a/b/1", "value": 3})",
+        R"({"op": "remove", "path": "/a/b/3"})",
+        R"({"op": "remove", "path": ""})",
+        R"({"op": "replace", "path": "/e", "value": 1})",
+        R"({"op": "replace", "path": "/d/-", "value": 1})",
+        R"({"op": "add", "path": "/d/5", "value": 1})",
+        R"({"op": "add", "path": "/e/f", "value": 1})",
+        R"({"op": "add", "path": "/d/01", "value": 1})",
+        R"({"op": "add", "path": "/d"})",
+        R"({"op": "move", "from": "/a", "path": "/a/c"})",
+        R"({"op": "copy", "from": "/missing", "path": "/e"})",
+        R"({"op": "frobnicate", "path": "/d"})",
+        R"({"path": "/d"})",
+        R"({"op": "add", "path": "d", "value": 1})",
+    }) {
+        EXPECT_FALSE(value.ApplyPatch(Json::Value::FromEncoding(std::string("[") + operation + "]"))) << operation;
+        EXPECT_EQ(before, value) << operation;
+    }
+    EXPECT_FALSE(value.ApplyPatch(Json::Value::FromEncoding(R"({"op": "remove", "path": "/d"})")));
+    EXPECT_TRUE(value.ApplyPatch(Json::Value::FromEncoding(R"([{"op": "add", "path": "", "value": 5}])")));
+    EXPECT_EQ(Json::Value(5), value);
+}
+
+TEST(ChangeTrackingTests, ApplyPatchIsRecorded) {
+    auto value = Json::Value::FromEncoding(R"({"a": [1, 2], "b": {}})");
+    auto follower = value;
+    value.BeginTracking();
+    ASSERT_TRUE(
+        value.ApplyPatch(
+            Json::Value::FromEncoding(R"([
+                {"op": "move", "from": "/a/0", "path": "/b/x"},
+                {"op": "replace", "path": "/a/0", "value": 7}
+            ])")
+        )
+    );
+    ASSERT_TRUE(follower.ApplyPatch(value.TakeChanges()));
+    EXPECT_EQ(value, follower);
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": [7], "b": {"x": 1}})"), follower);
+}
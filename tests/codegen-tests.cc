@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <order.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is an order with every property of the schema, and some which
+     * aren't in it.
+     */
+    const std::string ORDER = R"({
+        "id": 1234567890123,
+        "unknown": {"nested": [1, {"deep": "yes"}], "more": null},
+        "customer": {"name": "Ann \"A\" Åberg", "email": null, "vip": true},
+        "lines": [
+            {"sku": "x-1", "quantity": 2, "price": 9.5, "gift": true},
+            {"sku": "y-2", "quantity": -3, "price": 10}
+        ],
+        "note": "leave at door",
+        "express": false,
+        "discount": 0.25,
+        "tags": ["a", "b"],
+        "metadata": {"source": ["web", 1, null]},
+        "class": "priority",
+        "shipping address": {"city": "Oslo", "lines": ["Main St 1", null]}
+    })";
+}
+
+TEST(CodegenTests, ParsesIntoStructs) {
+    Wire::Order order;
+    ASSERT_TRUE(Wire::Parse(ORDER, order));
+    EXPECT_EQ(1234567890123, order.id);
+    EXPECT_EQ("Ann \"A\" \xc3\x85" "berg", order.customer.name);
+    EXPECT_FALSE(order.customer.email.has_value());
+    ASSERT_EQ(2, order.lines.size());
+    EXPECT_EQ("x-1", order.lines[0].sku);
+    EXPECT_EQ(2, order.lines[0].quantity);
+    EXPECT_EQ(9.5, order.lines[0].price);
+    EXPECT_EQ(true, order.lines[0].gift);
+    EXPECT_EQ(-3, order.lines[1].quantity);
+    EXPECT_EQ(10.0, order.lines[1].price);
+    EXPECT_FALSE(order.lines[1].gift.has_value());
+    EXPECT_EQ("leave at door", order.note);
+    EXPECT_EQ(false, order.express);
+    EXPECT_EQ(0.25, order.discount);
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), order.tags);
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"source": ["web", 1, null]})"), order.metadata);
+    EXPECT_EQ("priority", order.field_class);
+    ASSERT_TRUE(order.shipping_address.has_value());
+    EXPECT_EQ("Oslo", order.shipping_address->city);
+    ASSERT_TRUE(order.shipping_address->lines.has_value());
+    EXPECT_EQ(
+        std::vector<std::optional<std::string>>({"Main St 1", std::nullopt}),
+        *order.shipping_address->lines
+    );
+}
+
+TEST(CodegenTests, EncodesWhatWasParsed) {
+    Wire::Order order;
+    ASSERT_TRUE(Wire::Parse(ORDER, order));
+    auto expected = Json::Value::FromEncoding(ORDER);
+    expected.Remove("unknown");
+    expected["customer"].Remove("vip");
+    expected["lines"][1]["price"] = 10.0;
+    EXPECT_EQ(expected, Json::Value::FromEncoding(Wire::Encode(order)));
+    Wire::Order again;
+    ASSERT_TRUE(Wire::Parse(Wire::Encode(order), again));
+    EXPECT_EQ(Wire::Encode(order), Wire::Encode(again));
+}
+
+TEST(CodegenTests, AbsentAndNullProperties) {
+    Wire::Order order;
+    ASSERT_TRUE(Wire::Parse(R"({"id": 1, "customer": {"name": "b", "email": "b@c"}, "lines": [], "note": null})", order));
+    EXPECT_EQ("b@c", order.customer.email);
+    EXPECT_FALSE(order.note.has_value());
+    EXPECT_FALSE(order.express.has_value());
+    EXPECT_FALSE(order.metadata.has_value());
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"id": 1, "customer": {"name": "b", "email": "b@c"}, "lines": []})"),
+        Json::Value::FromEncoding(Wire::Encode(order))
+    );
+    order.customer.email.reset();
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"id": 1, "customer": {"name": "b", "email": null}, "lines": []})"),
+        Json::Value::FromEncoding(Wire::Encode(order))
+    );
+}
+
+TEST(CodegenTests, RejectsWhatDoesNotMatch) {
+    const std::string customer = R"("customer": {"name": "b", "email": null})";
+    for (
+        const auto &text: std::vector<std::string>{
+            R"({"customer": {"name": "b", "email": null}, "lines": []})",
+            R"({"id": 1, "customer": {"name": "b"}, "lines": []})",
+            R"({"id": "1", )" + customer + R"(, "lines": []})",
+            R"({"id": 1.5, )" + customer + R"(, "lines": []})",
+            R"({"id": 99999999999999999999, )" + customer + R"(, "lines": []})",
+            R"({"id": 1, )" + customer + R"(, "lines": {}})",
+            R"({"id": 1, )" + customer + R"(, "lines": [], "express": null})",
+            R"({"id": 1, )" + customer + R"(, "lines": [], "tags": [1]})",
+            R"({"id": 1, )" + customer + R"(, "lines": [], "unknown": [})",
+            R"({"id": 1, )" + customer + R"(, "lines": []} [])",
+            R"({"id": 1, )" + customer + R"(, "lines": [])",
+            R"([])",
+            "",
+        }
+    ) {
+        Wire::Order order;
+        EXPECT_FALSE(Wire::Parse(text, order)) << text;
+    }
+}
+
+TEST(CodegenTests, NestedStructsStandAlone) {
+    Wire::Line line;
+    ASSERT_TRUE(Wire::Parse(R"({"sku": "z", "quantity": 1, "price": 2})", line));
+    EXPECT_EQ("z", line.sku);
+    Json::EncodingOptions options;
+    options.pretty = true;
+    const auto encoding = Wire::Encode(line, options);
+    EXPECT_NE(std::string::npos, encoding.find('\n'));
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"sku": "z", "quantity": 1, "price": 2.0})"),
+        Json::Value::FromEncoding(encoding)
+    );
+}
@@ -0,0 +1,93 @@
+#include <document-stream.h>
+#include <gtest/gtest.h>
+#include <reader.h>
+#include <sstream>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * These are the values the tests expect from the texts they read.
+     */
+    std::vector<Json::Value> ExpectedValues() {
+        return {
+            Json::Object({{"a", 1}}),
+            Json::Array({1, 2}),
+            Json::Value("x"),
+            Json::Value(true),
+            Json::Value(nullptr),
+            Json::Value(42),
+            Json::Value(Json::ValueType::Object),
+        };
+    }
+}
+
+TEST(DocumentStreamTests, ConcatenatedWithoutSeparators) {
+    const std::string text = R"({"a":1}[1,2]"x"true null 42{})";
+    Json::DocumentStream documents(text);
+    std::vector<Json::Value> values;
+    for (const auto &document: documents) {
+        values.push_back(document);
+    }
+    EXPECT_EQ(ExpectedValues(), values);
+    EXPECT_FALSE(documents.HasFailed());
+    EXPECT_EQ(7, documents.GetCount());
+}
+
+TEST(DocumentStreamTests, NewlineDelimited) {
+    std::istringstream input("{\"a\": 1}\n[1, 2]\n\"x\"\ntrue\nnull\n42\n{}\n\n");
+    Json::DocumentStream documents(input);
+    std::vector<Json::Value> values;
+    Json::Value value;
+    while (documents.Next(value)) {
+        values.push_back(value);
+    }
+    EXPECT_EQ(ExpectedValues(), values);
+    EXPECT_FALSE(documents.HasFailed());
+}
+
+TEST(DocumentStreamTests, Empty) {
+    Json::DocumentStream documents("  \n ");
+    Json::Value value;
+    EXPECT_FALSE(documents.Next(value));
+    EXPECT_FALSE(documents.HasFailed());
+    EXPECT_EQ(0, documents.GetCount());
+}
+
+TEST(DocumentStreamTests, StopsAtInvalidText) {
+    const std::string text = "[1]\n[2, ]\n[3]";
+    Json::DocumentStream documents(text);
+    Json::Value value;
+    ASSERT_TRUE(documents.Next(value));
+    EXPECT_EQ(Json::Array({1}), value);
+    EXPECT_FALSE(documents.Next(value));
+    EXPECT_TRUE(documents.HasFailed());
+    EXPECT_EQ(8, documents.GetOffset());
+    EXPECT_FALSE(documents.Next(value));
+}
+
+TEST(DocumentStreamTests, ManyDocumentsAcrossChunks) {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += R"({"index": )" + std::to_string(i) + R"(, "padding": "abcdefghijklmnop"})";
+    }
+    std::istringstream input(text);
+    Json::BasicDocumentStream<Json::CompactTraits> documents(input);
+    int expected = 0;
+    for (const auto &document: documents) {
+        EXPECT_EQ(expected, document.Get<int>("index"));
+        ++expected;
+    }
+    EXPECT_EQ(10000, expected);
+    EXPECT_FALSE(documents.HasFailed());
+}
+
+TEST(DocumentStreamTests, SingleValueReaderRejectsSecondValue) {
+    Json::Reader reader;
+    Json::Reader::Token token;
+    reader.Feed("1 2");
+    reader.Finish();
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    EXPECT_EQ(Json::Reader::Status::Error, reader.Next(token));
+}
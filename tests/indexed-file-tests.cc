@@ -0,0 +1,170 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <indexed-file.h>
+#include <pointer.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is a JSON file, and its index, which exist for the duration
+     * of a test.
+     */
+    struct TemporaryFile {
+        std::string path;
+
+        explicit TemporaryFile(const std::string &contents) {
+            path = (
+                std::filesystem::temp_directory_path() / (
+                    std::string("jsonkit-indexed-file-")
+                    + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+                    + ".json"
+                )
+            ).string();
+            Write(contents);
+        }
+
+        ~TemporaryFile() {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+            std::filesystem::remove(path + ".idx", error);
+        }
+
+        void Write(const std::string &contents) const {
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+        }
+    };
+
+    /**
+     * This returns the text of a document with large and small arrays
+     * and objects.
+     */
+    std::string MakeDocument() {
+        std::string text = "  {\"users\": [";
+        for (int i = 0; i < 300; ++i) {
+            if (i > 0) {
+                text += ",\n";
+            }
+            text += (
+                R"({"id": )" + std::to_string(i)
+                + R"(, "name": "user )" + std::to_string(i)
+                + R"(", "tags": ["a", {"deep": )" + std::to_string(i * 2)
+                + R"(}], "padding": ")" + std::string((size_t) (i % 7) * 20, 'x') + "\"}"
+            );
+        }
+        text += R"(], "a\/b": {"x": 1}, "dup": 1, "esc\u0041ped": [true, null], "dup": 2, "n": 3.5})";
+        return text;
+    }
+}
+
+TEST(IndexedFileTests, SingleValue) {
+    const TemporaryFile file(MakeDocument());
+    Json::IndexOptions options;
+    options.minimumContainerSize = 64;
+    ASSERT_TRUE(Json::IndexFile(file.path, options));
+    Json::IndexedFile indexed;
+    ASSERT_TRUE(indexed.Open(file.path));
+    EXPECT_TRUE(indexed.IsOpen());
+    EXPECT_EQ(0, indexed.GetRecordCount());
+    const auto whole = Json::Value::FromEncoding(MakeDocument());
+    for (const auto *path: {
+        "",
+        "/users",
+        "/users/0",
+        "/users/17/name",
+        "/users/299/tags/1/deep",
+        "/users/150/padding",
+        "/a~1b",
+        "/a~1b/x",
+        "/dup",
+        "/escAped/0",
+        "/escAped/1",
+        "/n",
+    }) {
+        const Json::Pointer pointer(path);
+        const auto expected = whole.Find(pointer);
+        ASSERT_NE(nullptr, expected) << path;
+        EXPECT_EQ(*expected, indexed.Get(pointer)) << path;
+    }
+    EXPECT_EQ(Json::Value(2), indexed.Get(Json::Pointer("/dup")));
+    for (const auto *path: {
+        "/missing",
+        "/users/300",
+        "/users/01",
+        "/users/-",
+        "/users/5/nope",
+        "/n/0",
+        "/a~1b/y",
+    }) {
+        EXPECT_EQ(Json::ValueType::Invalid, indexed.Get(Json::Pointer(path)).GetType()) << path;
+    }
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.GetRecord(0).GetType());
+}
+
+TEST(IndexedFileTests, Records) {
+    std::string text;
+    std::vector<std::string> lines;
+    for (int i = 0; i < 20000; ++i) {
+        lines.push_back(
+            R"({"seq": )" + std::to_string(i)
+            + R"(, "items": [)" + std::to_string(i) + ", " + std::to_string(i + 1)
+            + R"(], "blob": ")" + std::string(150, 'b') + "\"}"
+        );
+        text += lines.back() + ((i % 1000 == 0) ? "\r\n\n" : "\n");
+    }
+    text += "  [1, 2]";
+    lines.push_back("[1, 2]");
+    const TemporaryFile file(text);
+    Json::IndexOptions options;
+    options.lines = true;
+    options.threads = 3;
+    options.minimumContainerSize = 100;
+    ASSERT_TRUE(Json::IndexFile(file.path, options));
+    Json::IndexedFile indexed;
+    ASSERT_TRUE(indexed.Open(file.path));
+    ASSERT_EQ(lines.size(), indexed.GetRecordCount());
+    for (size_t i = 0; i < lines.size(); i += 997) {
+        EXPECT_EQ(Json::Value::FromEncoding(lines[i]), indexed.GetRecord(i)) << i;
+    }
+    EXPECT_EQ(Json::Value::FromEncoding(lines.back()), indexed.GetRecord(lines.size() - 1));
+    EXPECT_EQ(Json::Value(12346), indexed.Get(Json::Pointer("/12345/items/1")));
+    EXPECT_EQ(Json::Value(2), indexed.Get(Json::Pointer("/20000/1")));
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.Get(Json::Pointer("")).GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.Get(Json::Pointer("/20001")).GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.GetRecord(20001).GetType());
+}
+
+TEST(IndexedFileTests, InvalidRecordsStayInTheirLines) {
+    const TemporaryFile file("{\"a\": 1}\n{\"b\": \n{\"c\": 3}\n");
+    Json::IndexOptions options;
+    options.lines = true;
+    ASSERT_TRUE(Json::IndexFile(file.path, options));
+    Json::IndexedFile indexed;
+    ASSERT_TRUE(indexed.Open(file.path));
+    ASSERT_EQ(3, indexed.GetRecordCount());
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.GetRecord(1).GetType());
+    EXPECT_EQ(Json::Value(3), indexed.Get(Json::Pointer("/2/c")));
+}
+
+TEST(IndexedFileTests, StaleOrMissingIndex) {
+    const TemporaryFile file(R"({"a": [1, 2, 3]})");
+    Json::IndexedFile indexed;
+    EXPECT_FALSE(indexed.Open(file.path));
+    EXPECT_FALSE(indexed.IsOpen());
+    EXPECT_EQ(Json::ValueType::Invalid, indexed.Get(Json::Pointer("/a")).GetType());
+    ASSERT_TRUE(Json::IndexFile(file.path));
+    ASSERT_TRUE(indexed.Open(file.path));
+    EXPECT_EQ(Json::Value(2), indexed.Get(Json::Pointer("/a/1")));
+    file.Write(R"({"a": [1, 2, 3, 4]})");
+    EXPECT_FALSE(indexed.Open(file.path));
+    EXPECT_FALSE(indexed.IsOpen());
+}
+
+TEST(IndexedFileTests, InvalidFiles) {
+    const TemporaryFile file(R"({"a": [1, 2, 3])");
+    EXPECT_FALSE(Json::IndexFile(file.path));
+    EXPECT_FALSE(std::filesystem::exists(file.path + ".idx"));
+    EXPECT_FALSE(Json::IndexFile(file.path + ".missing"));
+}
@@ -0,0 +1,187 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <journaled-document.h>
+#include <string>
+#include <utility>
+#include <value.h>
+
+namespace {
+    /**
+     * This is a directory holding the files of a document, which exists
+     * for the duration of a test.
+     */
+    struct TemporaryDirectory {
+        std::filesystem::path directory;
+        std::string path;
+
+        TemporaryDirectory() {
+            directory = (
+                std::filesystem::temp_directory_path() / (
+                    std::string("jsonkit-journaled-document-")
+                    + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+                )
+            );
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            path = (directory / "state.json").string();
+        }
+
+        ~TemporaryDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(directory, error);
+        }
+
+        size_t CountFiles(const std::string &suffix) const {
+            size_t count = 0;
+            for (const auto &entry: std::filesystem::directory_iterator(directory)) {
+                if (entry.path().filename().string().find(suffix) != std::string::npos) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+    };
+}
+
+TEST(JournaledDocumentTests, ChangesSurviveReopening) {
+    const TemporaryDirectory files;
+    Json::Value expected;
+    {
+        Json::JournaledDocument document;
+        ASSERT_TRUE(document.Open(files.path));
+        EXPECT_TRUE(document.IsOpen());
+        EXPECT_EQ(Json::Value(Json::ValueType::Object), document.GetValue());
+        auto &value = document.GetValue();
+        value["users"] = Json::Value::FromEncoding(R"([{"name": "a"}])");
+        EXPECT_TRUE(document.Commit());
+        (void) value["users"].Add(Json::Value::FromEncoding(R"({"name": "b"})"));
+        value["users"][0]["name"] = "A";
+        value["count"] = 2;
+        EXPECT_TRUE(document.Commit());
+        value.Remove("count");
+
+        // Changes not yet committed are committed on closing.
+        expected = value;
+    }
+    EXPECT_EQ(0, files.CountFiles(".snapshot."));
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path));
+    EXPECT_EQ(expected, document.GetValue());
+    document.GetValue()["more"] = true;
+    document.Close();
+    EXPECT_FALSE(document.IsOpen());
+    ASSERT_TRUE(document.Open(files.path));
+    EXPECT_EQ(true, (bool) document.GetValue()["more"]);
+}
+
+TEST(JournaledDocumentTests, CompactionReplacesJournals) {
+    const TemporaryDirectory files;
+    Json::JournalOptions options;
+    options.compactionThreshold = 200;
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path, options));
+    auto &value = document.GetValue();
+    value["items"] = Json::Value(Json::ValueType::Array);
+    for (int i = 0; i < 100; ++i) {
+        (void) value["items"].Add(Json::Value::FromEncoding(R"({"n": )" + std::to_string(i) + "}"));
+        if (i % 3 == 0) {
+            value["items"].Remove(0);
+        }
+        ASSERT_TRUE(document.Commit());
+    }
+    const auto expected = value;
+    document.Close();
+    EXPECT_EQ(1, files.CountFiles(".snapshot."));
+    EXPECT_GE(1, files.CountFiles(".journal."));
+    ASSERT_TRUE(document.Open(files.path, options));
+    EXPECT_EQ(expected, document.GetValue());
+}
+
+TEST(JournaledDocumentTests, CompactNow) {
+    const TemporaryDirectory files;
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path));
+    document.GetValue()["a"] = 1;
+    ASSERT_TRUE(document.Commit());
+    document.GetValue()["b"] = 2;
+    ASSERT_TRUE(document.Compact());
+    EXPECT_EQ(1, files.CountFiles(".snapshot."));
+    EXPECT_EQ(0, files.CountFiles(".journal."));
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"a": 1, "b": 2})"),
+        Json::Value::FromEncoding(
+            std::string(
+                std::istreambuf_iterator<char>(std::ifstream(files.path + ".snapshot.1").rdbuf()),
+                std::istreambuf_iterator<char>()
+            )
+        )
+    );
+    document.GetValue()["c"] = 3;
+    document.Close();
+    ASSERT_TRUE(document.Open(files.path));
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 1, "b": 2, "c": 3})"), document.GetValue());
+}
+
+TEST(JournaledDocumentTests, LineCutShortIsIgnored) {
+    const TemporaryDirectory files;
+    {
+        Json::JournaledDocument document;
+        ASSERT_TRUE(document.Open(files.path));
+        document.GetValue()["a"] = 1;
+    }
+    std::ofstream(files.path + ".journal.0", std::ios::binary | std::ios::app) << R"([{"op": "add", "pa)";
+    {
+        Json::JournaledDocument document;
+        ASSERT_TRUE(document.Open(files.path));
+        EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 1})"), document.GetValue());
+        document.GetValue()["b"] = 2;
+    }
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path));
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 1, "b": 2})"), document.GetValue());
+}
+
+TEST(JournaledDocumentTests, InvalidJournalFailsToOpen) {
+    const TemporaryDirectory files;
+    std::ofstream(files.path + ".journal.0", std::ios::binary) << "[{\"op\": \"remove\", \"path\": \"/x\"}]\n";
+    Json::JournaledDocument document;
+    EXPECT_FALSE(document.Open(files.path));
+    EXPECT_FALSE(document.IsOpen());
+    EXPECT_FALSE(document.Commit());
+}
+
+TEST(JournaledDocumentTests, FailedCommitStopsCommitsUntilCompacted) {
+    const TemporaryDirectory files;
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path));
+    document.GetValue()["a"] = 1;
+
+    // With its directory gone, neither the journal nor a snapshot can be
+    // written.
+    std::filesystem::remove_all(files.directory);
+    EXPECT_FALSE(document.Commit());
+    std::filesystem::create_directories(files.directory);
+    document.GetValue()["b"] = 2;
+    EXPECT_FALSE(document.Commit());
+    EXPECT_EQ(0, files.CountFiles(".journal."));
+    ASSERT_TRUE(document.Compact());
+    document.GetValue()["c"] = 3;
+    EXPECT_TRUE(document.Commit());
+    document.Close();
+    ASSERT_TRUE(document.Open(files.path));
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 1, "b": 2, "c": 3})"), document.GetValue());
+}
+
+TEST(JournaledDocumentTests, MovedFromDocumentIsNotOpen) {
+    const TemporaryDirectory files;
+    Json::JournaledDocument document;
+    ASSERT_TRUE(document.Open(files.path));
+    document.GetValue()["a"] = 1;
+    auto other = std::move(document);
+    EXPECT_FALSE(document.IsOpen());
+    EXPECT_EQ(Json::Value(), static_cast<const Json::JournaledDocument &>(document).GetValue());
+    EXPECT_EQ(Json::Value(), document.GetValue());
+    EXPECT_FALSE(document.Commit());
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 1})"), other.GetValue());
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <key-set.h>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+    using MessageFields = Json::KeySet<"id", "type", "ts", "payload">;
+}
+
+TEST(KeySetTests, FindKnownKeys) {
+    EXPECT_EQ(4, MessageFields::size);
+    EXPECT_EQ(0, MessageFields::Find("id"));
+    EXPECT_EQ(1, MessageFields::Find("type"));
+    EXPECT_EQ(2, MessageFields::Find("ts"));
+    EXPECT_EQ(3, MessageFields::Find("payload"));
+}
+
+TEST(KeySetTests, FindUnknownKeys) {
+    EXPECT_EQ(MessageFields::npos, MessageFields::Find(""));
+    EXPECT_EQ(MessageFields::npos, MessageFields::Find("i"));
+    EXPECT_EQ(MessageFields::npos, MessageFields::Find("idx"));
+    EXPECT_EQ(MessageFields::npos, MessageFields::Find("Type"));
+    EXPECT_EQ(MessageFields::npos, MessageFields::Find("payload "));
+}
+
+TEST(KeySetTests, LookupAtCompileTime) {
+    static_assert(MessageFields::Find("ts") == 2);
+    static_assert(MessageFields::Find("nope") == MessageFields::npos);
+    static_assert(MessageFields::IndexOf("payload") == 3);
+    static_assert(MessageFields::GetKey(1) == "type");
+}
+
+TEST(KeySetTests, ManyKeys) {
+    using Keys = Json::KeySet<
+        "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+        "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z",
+        "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"
+    >;
+    for (size_t i = 0; i < Keys::size; ++i) {
+        EXPECT_EQ(i, Keys::Find(Keys::GetKey(i)));
+    }
+    EXPECT_EQ(Keys::npos, Keys::Find("iota"));
+}
+
+TEST(KeySetTests, DispatchVisitsKnownMembers) {
+    const auto message = Json::Object({
+        {"id", 42},
+        {"type", "update"},
+        {"ignored", true},
+        {"ts", 1.5},
+    });
+    std::map<size_t, Json::Value> seen;
+    MessageFields::Dispatch(
+        message,
+        [&seen](size_t field, const Json::Value &value) {
+            seen[field] = value;
+        }
+    );
+    EXPECT_EQ(
+        (std::map<size_t, Json::Value>{
+            {MessageFields::IndexOf("id"), 42},
+            {MessageFields::IndexOf("type"), "update"},
+            {MessageFields::IndexOf("ts"), 1.5},
+        }),
+        seen
+    );
+}
+
+TEST(KeySetTests, DispatchIgnoresNonObjects) {
+    size_t calls = 0;
+    const auto count = [&calls](size_t, const Json::Value &) {
+        ++calls;
+    };
+    MessageFields::Dispatch(Json::Array({1, 2, 3}), count);
+    MessageFields::Dispatch(Json::Value(42), count);
+    MessageFields::Dispatch(Json::Value(), count);
+    EXPECT_EQ(0, calls);
+}
+
+namespace {
+    /**
+     * This returns the key "kNNN" for the given index.
+     */
+    template<size_t Index>
+    constexpr Json::FixedString<5> MakeKey() {
+        const char text[5] = {
+            'k',
+            (char) ('0' + Index / 100),
+            (char) ('0' + Index / 10 % 10),
+            (char) ('0' + Index % 10),
+            '\0',
+        };
+        return Json::FixedString<5>(text);
+    }
+
+    template<size_t... Indices>
+    Json::KeySet<MakeKey<Indices>()...> MakeKeySet(std::index_sequence<Indices...>);
+}
+
+TEST(KeySetTests, MostKeysSupported) {
+    using Keys = decltype(MakeKeySet(std::make_index_sequence<255>()));
+    static_assert(Keys::IndexOf("k000") == 0);
+    static_assert(Keys::IndexOf("k254") == 254);
+    for (size_t i = 0; i < Keys::size; ++i) {
+        EXPECT_EQ(i, Keys::Find(Keys::GetKey(i)));
+    }
+    EXPECT_EQ(Keys::npos, Keys::Find("k255"));
+    EXPECT_EQ(Keys::npos, Keys::Find("k00"));
+}
@@ -0,0 +1,121 @@
+#include <bit>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <literal.h>
+
+using namespace Json::Literals;
+
+TEST(LiteralTests, Scalars) {
+    EXPECT_EQ(Json::Value(nullptr), Json::Literal<"null">::Build());
+    EXPECT_EQ(Json::Value(true), Json::Literal<"true">::Build());
+    EXPECT_EQ(Json::Value(false), Json::Literal<" false ">::Build());
+    EXPECT_EQ(Json::Value(42), Json::Literal<"42">::Build());
+    EXPECT_EQ(Json::Value(-256), Json::Literal<"-256">::Build());
+    EXPECT_EQ(Json::Value("Hello, World!"), Json::Literal<"\"Hello, World!\"">::Build());
+}
+
+TEST(LiteralTests, Integers) {
+    const auto json = Json::Literal<"[0, -0, 9223372036854775807, -9223372036854775808]">::Build();
+    ASSERT_EQ(4, json.GetSize());
+    EXPECT_EQ(Json::Value::Type::Integer, json[0].GetType());
+    EXPECT_EQ(0, (intmax_t) json[1]);
+    EXPECT_EQ(std::numeric_limits<intmax_t>::max(), (intmax_t) json[2]);
+    EXPECT_EQ(std::numeric_limits<intmax_t>::lowest(), (intmax_t) json[3]);
+}
+
+TEST(LiteralTests, FloatingPoint) {
+    const auto json = Json::Literal<"[3.14159, -17.03, 5.3e-4, 5.012E+12, 32.0, 1e2]">::Build();
+    ASSERT_EQ(6, json.GetSize());
+    for (size_t i = 0; i < json.GetSize(); ++i) {
+        EXPECT_EQ(Json::Value::Type::FloatingPoint, json[i].GetType());
+    }
+    EXPECT_DOUBLE_EQ(3.14159, (double) json[0]);
+    EXPECT_DOUBLE_EQ(-17.03, (double) json[1]);
+    EXPECT_DOUBLE_EQ(5.3e-4, (double) json[2]);
+    EXPECT_DOUBLE_EQ(5.012e+12, (double) json[3]);
+    EXPECT_DOUBLE_EQ(32.0, (double) json[4]);
+    EXPECT_DOUBLE_EQ(100.0, (double) json[5]);
+}
+
+TEST(LiteralTests, FloatingPointIsCorrectlyRounded) {
+    constexpr const char text[] = (
+        "[1e23, 1.7976931348623157e308, 2.2250738585072014e-308, 1e-320, 4.9e-324, 2.4e-324,"
+        " 8.98846567431158e307, 0.1, 3.14159265358979323846264338327950288419716939937510582097494459,"
+        " 9007199254740993.0, 2.2250738585072011e-308, 7.2057594037927933e16, -0.0, 1e-400, -1e400,"
+        " 0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001]"
+    );
+    const auto literal = Json::Literal<text>::Build();
+    const auto decoded = Json::Value::FromEncoding(text);
+    ASSERT_EQ(decoded.GetSize(), literal.GetSize());
+    for (size_t i = 0; i < literal.GetSize(); ++i) {
+        EXPECT_EQ(Json::Value::Type::FloatingPoint, literal[i].GetType()) << i;
+        EXPECT_EQ(
+            std::bit_cast<uint64_t>((double) decoded[i]),
+            std::bit_cast<uint64_t>((double) literal[i])
+        ) << i;
+    }
+    EXPECT_EQ(1e23, (double) literal[0]);
+    EXPECT_EQ(std::numeric_limits<double>::max(), (double) literal[1]);
+    EXPECT_EQ(std::numeric_limits<double>::min(), (double) literal[2]);
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), (double) literal[14]);
+}
+
+TEST(LiteralTests, EscapedStrings) {
+    EXPECT_EQ(
+        Json::Value("These need to be escaped: \", \\, /, \b, \f, \n, \r, \t"),
+        Json::Literal<R"("These need to be escaped: \", \\, \/, \b, \f, \n, \r, \t")">::Build()
+    );
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"("Greek word 'kosme': \u03BA\u1F79\u03C3\u03BC\u03B5")"),
+        Json::Literal<R"("Greek word 'kosme': \u03BA\u1F79\u03C3\u03BC\u03B5")">::Build()
+    );
+    EXPECT_EQ(
+        Json::Value("Surrogate pair: 𣎴"),
+        Json::Literal<R"("Surrogate pair: \uD84C\uDFB4")">::Build()
+    );
+    EXPECT_EQ(
+        Json::Value("Raw UTF-8: κόσμε"),
+        Json::Literal<"\"Raw UTF-8: κόσμε\"">::Build()
+    );
+}
+
+TEST(LiteralTests, MatchesRuntimeDecoding) {
+    constexpr const char text[] = (
+        R"({"value": 42, "": "Pepe", "the handles":[3,7], "is,live": true,)"
+        R"( "nested": {"empty": {}, "none": [], "list": [1, [2, 3], {"x": null}]}})"
+    );
+    EXPECT_EQ(Json::Value::FromEncoding(text), Json::Literal<text>::Build());
+}
+
+TEST(LiteralTests, DuplicateKeysKeepLastValue) {
+    const auto json = Json::Literal<R"({"key": 3, "key": true})">::Build();
+    ASSERT_EQ(1, json.GetSize());
+    EXPECT_EQ(Json::Value(true), json["key"]);
+}
+
+TEST(LiteralTests, GetReturnsSharedValue) {
+    const auto &first = Json::Literal<R"({"retries": 3})">::Get();
+    const auto &second = Json::Literal<R"({"retries": 3})">::Get();
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(3, (int) first["retries"]);
+}
+
+TEST(LiteralTests, BuildReturnsIndependentValue) {
+    auto json = Json::Literal<"[1, 2]">::Build();
+    json.Add(3);
+    EXPECT_EQ(Json::Array({1, 2, 3}), json);
+    EXPECT_EQ(Json::Array({1, 2}), Json::Literal<"[1, 2]">::Build());
+}
+
+TEST(LiteralTests, UserDefinedLiteral) {
+    const auto json = R"({"Answer": 42, "List": [1, 2, 3]})"_json;
+    EXPECT_EQ(
+        Json::Object({
+            {"Answer", 42},
+            {"List", Json::Array({1, 2, 3})},
+        }),
+        json
+    );
+    EXPECT_EQ("[true,null]", "[ true , null ]"_json.ToEncoding());
+}
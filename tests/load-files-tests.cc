@@ -0,0 +1,85 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <load-files.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is a directory of JSON files which exists for the duration
+     * of a test.
+     */
+    struct TemporaryDirectory {
+        std::filesystem::path path;
+
+        TemporaryDirectory() {
+            const auto name = (
+                std::string("jsonkit-load-files-")
+                + ::testing::UnitTest::GetInstance()->current_test_info()->name()
+            );
+            path = std::filesystem::temp_directory_path() / name;
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+
+        ~TemporaryDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(path, error);
+        }
+
+        std::string Write(
+            const std::string &name,
+            const std::string &contents
+        ) const {
+            const auto filePath = (path / name).string();
+            std::ofstream(filePath, std::ios::binary) << contents;
+            return filePath;
+        }
+    };
+}
+
+TEST(LoadFilesTests, ManyFiles) {
+    const TemporaryDirectory directory;
+    std::vector<std::string> paths;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 500; ++i) {
+        texts.push_back(
+            R"({"index": )" + std::to_string(i)
+            + R"(, "tags": ["a", "b"], "padding": ")" + std::string((size_t) i * 7, 'x') + "\"}"
+        );
+        paths.push_back(directory.Write(std::to_string(i) + ".json", texts.back()));
+    }
+    Json::LoadOptions options;
+    options.readThreads = 8;
+    options.parseThreads = 3;
+    options.maxPendingFiles = 5;
+    const auto values = Json::LoadFiles(paths, options);
+    ASSERT_EQ(paths.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(Json::Value::FromEncoding(texts[i]), values[i]) << i;
+    }
+}
+
+TEST(LoadFilesTests, MissingAndInvalidFiles) {
+    const TemporaryDirectory directory;
+    const std::vector<std::string> paths{
+        directory.Write("good.json", "[1, 2, 3]"),
+        (directory.path / "missing.json").string(),
+        directory.Write("bad.json", "[1, 2,"),
+        directory.Write("empty.json", ""),
+        directory.Write("scalar.json", " 42 "),
+    };
+    const auto values = Json::LoadFiles<Json::CompactTraits>(paths);
+    ASSERT_EQ(5, values.size());
+    EXPECT_EQ(Json::CompactValue::FromEncoding("[1, 2, 3]"), values[0]);
+    EXPECT_EQ(Json::ValueType::Invalid, values[1].GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, values[2].GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, values[3].GetType());
+    EXPECT_EQ(Json::CompactValue(42), values[4]);
+}
+
+TEST(LoadFilesTests, NoFiles) {
+    EXPECT_TRUE(Json::LoadFiles({}).empty());
+}
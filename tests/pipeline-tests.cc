@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <pipeline.h>
+#include <sstream>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This returns newline-delimited records with the given number of
+     * lines, some blank and some invalid.
+     */
+    std::string MakeRecords(size_t count) {
+        std::string text;
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 50 == 7) {
+                text += "\n";
+            } else if (i % 50 == 9) {
+                text += "{\"broken\": \n";
+            } else {
+                text += R"({"id": )" + std::to_string(i) + R"(, "debug": {"x": [1, 2]}, "ok": true})" + "\n";
+            }
+        }
+        return text;
+    }
+
+    /**
+     * This returns what the transforms in the tests make of the given
+     * records, computed without a pipeline.
+     */
+    std::vector<std::string> ExpectedLines(const std::string &text) {
+        std::vector<std::string> lines;
+        std::istringstream input(text);
+        std::string line;
+        while (std::getline(input, line)) {
+            auto record = Json::Value::FromEncoding(line);
+            if (
+                (record.GetType() == Json::ValueType::Invalid)
+                || ((int) record["id"] % 3 == 0)
+            ) {
+                continue;
+            }
+            record.Remove("debug");
+            record.Set("double", (int) record["id"] * 2);
+            lines.push_back(record.ToEncoding());
+        }
+        return lines;
+    }
+
+    /**
+     * This adds the transforms in the tests to the given pipeline.
+     */
+    Json::Pipeline &AddTransforms(Json::Pipeline &pipeline) {
+        return pipeline
+            .Transform(
+                [](Json::Value &record){
+                    return ((int) record["id"] % 3 != 0);
+                },
+                3
+            )
+            .Transform(
+                [](Json::Value &record){
+                    record.Remove("debug");
+                    record.Set("double", (int) record["id"] * 2);
+                    return true;
+                },
+                2
+            );
+    }
+
+    /**
+     * This splits the given text into lines.
+     */
+    std::vector<std::string> SplitLines(const std::string &text) {
+        std::vector<std::string> lines;
+        std::istringstream input(text);
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+TEST(PipelineTests, OrderPreserved) {
+    const auto text = MakeRecords(5000);
+    Json::PipelineOptions options;
+    options.batchSize = 7;
+    options.queueCapacity = 2;
+    std::ostringstream output;
+    Json::Pipeline pipeline(options);
+    pipeline.ReadLines(text).Parse(4);
+    const auto result = AddTransforms(pipeline).Encode(3).WriteLines(output).Run();
+    EXPECT_TRUE(result.succeeded);
+    EXPECT_EQ(4900, result.recordsRead);
+    EXPECT_EQ(100, result.recordsInvalid);
+    const auto expected = ExpectedLines(text);
+    EXPECT_EQ(4800 - expected.size(), result.recordsDropped);
+    EXPECT_EQ(expected.size(), result.recordsWritten);
+    EXPECT_EQ(expected, SplitLines(output.str()));
+}
+
+TEST(PipelineTests, UnorderedFromStream) {
+    const auto text = MakeRecords(3000);
+    Json::PipelineOptions options;
+    options.batchSize = 16;
+    options.preserveOrder = false;
+    std::istringstream input(text);
+    std::ostringstream output;
+    Json::Pipeline pipeline(options);
+    pipeline.ReadLines(input).Parse(0);
+    const auto result = AddTransforms(pipeline).Encode(0).WriteLines(output).Run();
+    EXPECT_TRUE(result.succeeded);
+    auto expected = ExpectedLines(text);
+    auto lines = SplitLines(output.str());
+    std::sort(expected.begin(), expected.end());
+    std::sort(lines.begin(), lines.end());
+    EXPECT_EQ(expected, lines);
+}
+
+TEST(PipelineTests, ForEachValue) {
+    std::vector<Json::Value> records;
+    const auto result = Json::Pipeline()
+        .ReadLines("[1]\n\n{\"a\": 2}\r\nnope\n3")
+        .Parse(2)
+        .ForEach(
+            [&records](Json::Value &&record){
+                records.push_back(std::move(record));
+            }
+        )
+        .Run();
+    EXPECT_TRUE(result.succeeded);
+    EXPECT_EQ(4, result.recordsRead);
+    EXPECT_EQ(1, result.recordsInvalid);
+    ASSERT_EQ(3, records.size());
+    EXPECT_EQ(Json::Value::FromEncoding("[1]"), records[0]);
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"a": 2})"), records[1]);
+    EXPECT_EQ(Json::Value(3), records[2]);
+}
+
+TEST(PipelineTests, WriteFile) {
+    const auto path = (
+        std::filesystem::temp_directory_path() / "jsonkit-pipeline-test.ndjson"
+    ).string();
+    Json::EncodingOptions encodingOptions;
+    encodingOptions.reencode = true;
+    const auto result = Json::Pipeline()
+        .ReadLines("{ \"b\" : [ 1 , 2 ] }\n{\"c\": null}\n")
+        .Parse()
+        .Encode(1, encodingOptions)
+        .WriteFile(path)
+        .Run();
+    EXPECT_TRUE(result.succeeded);
+    EXPECT_EQ(2, result.recordsWritten);
+    std::ifstream file(path, std::ios::binary);
+    const std::string contents(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>()
+    );
+    EXPECT_EQ("{\"b\":[1,2]}\n{\"c\":null}\n", contents);
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(PipelineTests, LinesPassedThrough) {
+    std::ostringstream output;
+    const auto result = Json::Pipeline().ReadLines("a\n\nb").WriteLines(output).Run();
+    EXPECT_TRUE(result.succeeded);
+    EXPECT_EQ("a\nb\n", output.str());
+}
+
+TEST(PipelineTests, IncompletePipelines) {
+    std::ostringstream output;
+    const auto keep = [](Json::Value &){ return true; };
+    EXPECT_FALSE(Json::Pipeline().Parse().Encode().WriteLines(output).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").Parse().Encode().Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").Transform(keep).Encode().WriteLines(output).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").Parse().WriteLines(output).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").Parse().Parse().Encode().WriteLines(output).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").Parse().Encode().ForEach([](Json::Value &&){}).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").WriteLines(output).WriteLines(output).Run().succeeded);
+    EXPECT_FALSE(Json::Pipeline().ReadLines("1").WriteFile("/nonexistent-directory/out.ndjson").Run().succeeded);
+    EXPECT_TRUE(output.str().empty());
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <pointer.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+TEST(PointerTests, ParseTokens) {
+    EXPECT_EQ(std::vector<std::string>(), Json::Pointer("").GetTokens());
+    EXPECT_EQ(std::vector<std::string>({""}), Json::Pointer("/").GetTokens());
+    EXPECT_EQ(std::vector<std::string>({"a", "b", "0"}), Json::Pointer("/a/b/0").GetTokens());
+    EXPECT_EQ(std::vector<std::string>({"a/b", "m~n"}), Json::Pointer("/a~1b/m~0n").GetTokens());
+    EXPECT_EQ(std::vector<std::string>({"~1"}), Json::Pointer("/~01").GetTokens());
+}
+
+TEST(PointerTests, InvalidPointers) {
+    EXPECT_FALSE(Json::Pointer("a").IsValid());
+    EXPECT_FALSE(Json::Pointer("/a~").IsValid());
+    EXPECT_FALSE(Json::Pointer("/a~2").IsValid());
+    EXPECT_TRUE(Json::Pointer("/a~0").IsValid());
+}
+
+TEST(PointerTests, ToStringRoundTrips) {
+    for (const auto text: {"", "/", "/a/b/0", "/a~1b/m~0n", "//x/"}) {
+        EXPECT_EQ(text, Json::Pointer(text).ToString());
+    }
+    EXPECT_EQ("/x~1y/3", Json::Pointer().Append("x/y").Append(3).ToString());
+    EXPECT_EQ(Json::Pointer("/a/b"), Json::Pointer::FromTokens({"a", "b"}));
+}
+
+TEST(PointerTests, ParseIndex) {
+    size_t index = 99;
+    EXPECT_TRUE(Json::Pointer::ParseIndex("0", index));
+    EXPECT_EQ(0, index);
+    EXPECT_TRUE(Json::Pointer::ParseIndex("120", index));
+    EXPECT_EQ(120, index);
+    EXPECT_FALSE(Json::Pointer::ParseIndex("01", index));
+    EXPECT_FALSE(Json::Pointer::ParseIndex("-", index));
+    EXPECT_FALSE(Json::Pointer::ParseIndex("", index));
+    EXPECT_FALSE(Json::Pointer::ParseIndex("1a", index));
+    EXPECT_FALSE(Json::Pointer::ParseIndex("99999999999999999999999", index));
+}
+
+TEST(PointerTests, ResolveRfc6901Examples) {
+    const auto json = Json::Value::FromEncoding(R"({
+        "foo": ["bar", "baz"],
+        "": 0,
+        "a/b": 1,
+        "c%d": 2,
+        "e^f": 3,
+        "g|h": 4,
+        "i\\j": 5,
+        "k\"l": 6,
+        " ": 7,
+        "m~n": 8
+    })");
+    EXPECT_EQ(&json, json.Find(Json::Pointer("")));
+    EXPECT_EQ(Json::Array({"bar", "baz"}), *json.Find(Json::Pointer("/foo")));
+    EXPECT_EQ(std::optional<std::string>("bar"), json.Get<std::string>(Json::Pointer("/foo/0")));
+    EXPECT_EQ(std::optional<int>(0), json.Get<int>(Json::Pointer("/")));
+    EXPECT_EQ(std::optional<int>(1), json.Get<int>(Json::Pointer("/a~1b")));
+    EXPECT_EQ(std::optional<int>(2), json.Get<int>(Json::Pointer("/c%d")));
+    EXPECT_EQ(std::optional<int>(3), json.Get<int>(Json::Pointer("/e^f")));
+    EXPECT_EQ(std::optional<int>(4), json.Get<int>(Json::Pointer("/g|h")));
+    EXPECT_EQ(std::optional<int>(5), json.Get<int>(Json::Pointer("/i\\j")));
+    EXPECT_EQ(std::optional<int>(6), json.Get<int>(Json::Pointer("/k\"l")));
+    EXPECT_EQ(std::optional<int>(7), json.Get<int>(Json::Pointer("/ ")));
+    EXPECT_EQ(std::optional<int>(8), json.Get<int>(Json::Pointer("/m~0n")));
+}
+
+TEST(PointerTests, ResolveMissing) {
+    const auto json = Json::Value::FromEncoding(R"({"list": [1, 2], "n": 3})");
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("/list/2")));
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("/list/-")));
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("/list/01")));
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("/n/0")));
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("/nope")));
+    EXPECT_EQ(nullptr, json.Find(Json::Pointer("list")));
+}
+
+TEST(PointerTests, ResolveInOtherConfigurations) {
+    const auto text = R"({"a": {"b": [10, 20]}})";
+    const Json::Pointer pointer("/a/b/1");
+    EXPECT_EQ(std::optional<int>(20), Json::CompactValue::FromEncoding(text).Get<int>(pointer));
+    EXPECT_EQ(std::optional<int>(20), Json::HashedValue::FromEncoding(text).Get<int>(pointer));
+}
@@ -0,0 +1,382 @@
+#include <builder.h>
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+#include <reader.h>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is one token as recorded by the tests, with its text
+     * copied out of the reader.
+     */
+    struct RecordedToken {
+        Json::Reader::TokenType type;
+        std::string text;
+
+        bool operator==(const RecordedToken &) const = default;
+    };
+
+    /**
+     * This feeds the given text to a reader in chunks of the given
+     * size, and returns the tokens read, along with the final status.
+     */
+    std::vector<RecordedToken> ReadTokens(
+        std::string_view text,
+        size_t chunkSize,
+        Json::Reader::Status &finalStatus
+    ) {
+        Json::Reader reader;
+        Json::Reader::Token token;
+        std::vector<RecordedToken> tokens;
+        size_t fed = 0;
+        while (true) {
+            finalStatus = reader.Next(token);
+            if (finalStatus == Json::Reader::Status::Token) {
+                tokens.push_back(RecordedToken{token.type, std::string(token.text)});
+            } else if (finalStatus == Json::Reader::Status::NeedInput) {
+                if (fed < text.size()) {
+                    reader.Feed(text.substr(fed, chunkSize));
+                    fed += chunkSize;
+                } else {
+                    reader.Finish();
+                }
+            } else {
+                break;
+            }
+        }
+        return tokens;
+    }
+
+    /**
+     * This reads the given text with a reader and builder, feeding it
+     * in chunks of the given size.
+     */
+    template<typename Traits>
+    Json::BasicValue<Traits> Build(
+        std::string_view text,
+        size_t chunkSize
+    ) {
+        Json::Reader reader;
+        Json::BasicBuilder<Traits> builder;
+        Json::Reader::Token token;
+        size_t fed = 0;
+        while (!builder.IsComplete()) {
+            const auto status = reader.Next(token);
+            if (status == Json::Reader::Status::Token) {
+                if (!builder.Push(token)) {
+                    break;
+                }
+            } else if (status == Json::Reader::Status::NeedInput) {
+                if (fed < text.size()) {
+                    reader.Feed(text.substr(fed, chunkSize));
+                    fed += chunkSize;
+                } else {
+                    reader.Finish();
+                }
+            } else {
+                break;
+            }
+        }
+        return builder.Take();
+    }
+}
+
+TEST(ReaderTests, Tokens) {
+    using Type = Json::Reader::TokenType;
+    const std::string text = R"( {"a": [1, -2.5e3, "x\"y", true, false, null], "b": {}} )";
+    const std::vector<RecordedToken> expected{
+        {Type::BeginObject, "{"},
+        {Type::Key, "a"},
+        {Type::BeginArray, "["},
+        {Type::Integer, "1"},
+        {Type::FloatingPoint, "-2.5e3"},
+        {Type::String, R"(x\"y)"},
+        {Type::True, "true"},
+        {Type::False, "false"},
+        {Type::Null, "null"},
+        {Type::EndArray, "]"},
+        {Type::Key, "b"},
+        {Type::BeginObject, "{"},
+        {Type::EndObject, "}"},
+        {Type::EndObject, "}"},
+    };
+    for (size_t chunkSize: {1, 2, 3, 7, 1000}) {
+        Json::Reader::Status status;
+        EXPECT_EQ(expected, ReadTokens(text, chunkSize, status)) << chunkSize;
+        EXPECT_EQ(Json::Reader::Status::End, status) << chunkSize;
+    }
+}
+
+TEST(ReaderTests, TopLevelNumberNeedsEndOfInput) {
+    Json::Reader reader;
+    Json::Reader::Token token;
+    reader.Feed("123");
+    EXPECT_EQ(Json::Reader::Status::NeedInput, reader.Next(token));
+    reader.Feed("4");
+    reader.Finish();
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    EXPECT_EQ(Json::Reader::TokenType::Integer, token.type);
+    EXPECT_EQ("1234", token.text);
+    EXPECT_TRUE(reader.IsComplete());
+    EXPECT_EQ(Json::Reader::Status::End, reader.Next(token));
+}
+
+TEST(ReaderTests, Errors) {
+    for (const auto text: {
+        "", "[1,]", "[1 2]", "{\"a\" 1}", "{1: 2}", "[}", "]", "01", "1.", "-", "tru",
+        "nul", "\"abc", "[1] 2", "{\"a\": }", "+1", "1e", ".5",
+    }) {
+        Json::Reader::Status status;
+        (void) ReadTokens(text, 1, status);
+        EXPECT_EQ(Json::Reader::Status::Error, status) << text;
+    }
+}
+
+TEST(ReaderTests, TrailingCommas) {
+    const auto read = [](std::string_view text) {
+        Json::Reader reader(false, true);
+        Json::Reader::Token token;
+        reader.Feed(text);
+        reader.Finish();
+        size_t count = 0;
+        auto status = Json::Reader::Status::Token;
+        while ((status = reader.Next(token)) == Json::Reader::Status::Token) {
+            ++count;
+        }
+        return std::make_pair(status, count);
+    };
+    EXPECT_EQ(std::make_pair(Json::Reader::Status::End, (size_t) 4), read("[1, 2,]"));
+    EXPECT_EQ(std::make_pair(Json::Reader::Status::End, (size_t) 6), read("{\"a\": [1,],}"));
+    for (const auto text: {"[,]", "{,}", "[1,,]", "{\"a\": 1,,}", "[1,}"}) {
+        EXPECT_EQ(Json::Reader::Status::Error, read(text).first) << text;
+    }
+}
+
+TEST(ReaderTests, ErrorOffset) {
+    Json::Reader reader;
+    Json::Reader::Token token;
+    reader.Feed("[1, 2 x]");
+    reader.Finish();
+    while (reader.Next(token) == Json::Reader::Status::Token) {
+    }
+    EXPECT_EQ(6, reader.GetOffset());
+}
+
+TEST(ReaderTests, Skip) {
+    Json::Reader reader;
+    Json::Reader::Token token;
+    reader.Feed(R"({"skip": {"deep": [1, {"x": [2]}]}, "keep": 3})");
+    reader.Finish();
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    EXPECT_EQ(Json::Reader::Status::Token, reader.Skip());
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    EXPECT_EQ(Json::Reader::TokenType::Key, token.type);
+    EXPECT_EQ("keep", token.text);
+    EXPECT_EQ(1, reader.GetDepth());
+}
+
+TEST(ReaderTests, SkipAcrossChunks) {
+    const std::string text = R"([["a", "b", [1, 2]], 7])";
+    Json::Reader reader;
+    Json::Reader::Token token;
+    reader.Feed(text.substr(0, 1));
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    size_t fed = 1;
+    auto status = reader.Skip();
+    while (status == Json::Reader::Status::NeedInput) {
+        reader.Feed(text.substr(fed, 2));
+        fed += 2;
+        status = reader.Skip();
+    }
+    EXPECT_EQ(Json::Reader::Status::Token, status);
+    reader.Feed(text.substr(fed));
+    reader.Finish();
+    ASSERT_EQ(Json::Reader::Status::Token, reader.Next(token));
+    EXPECT_EQ("7", token.text);
+}
+
+TEST(ReaderTests, DecodeString) {
+    std::string output;
+    EXPECT_TRUE(Json::Reader::DecodeString(R"(a\"\\\/\b\f\n\r\té😀)", output));
+    EXPECT_EQ("a\"\\/\b\f\n\r\t\xC3\xA9\xF0\x9F\x98\x80", output);
+    for (const auto text: {R"(\x)", R"(\u12)", R"(\ud83d)", R"(\ude00)", "\\"}) {
+        output.clear();
+        EXPECT_FALSE(Json::Reader::DecodeString(text, output)) << text;
+    }
+}
+
+TEST(ReaderTests, DecodeNumbers) {
+    intmax_t integer;
+    EXPECT_TRUE(Json::Reader::DecodeInteger("-42", integer));
+    EXPECT_EQ(-42, integer);
+    EXPECT_FALSE(Json::Reader::DecodeInteger("99999999999999999999", integer));
+    double number;
+    EXPECT_TRUE(Json::Reader::DecodeFloatingPoint("2.5e-1", number));
+    EXPECT_EQ(0.25, number);
+}
+
+TEST(ReaderTests, DecodeNumbersOutOfRange) {
+    const auto inf = std::numeric_limits<double>::infinity();
+    for (
+        const auto &[text, expected]: std::vector<std::pair<std::string, double>>{
+            {"1e400", inf},
+            {"-1e400", -inf},
+            {"1E+400", inf},
+            {"0.0001e309", 0.0001e309},
+            {"123456789e99999999999999999999", inf},
+            {"1e-400", 0.0},
+            {"-1e-400", -0.0},
+            {"0.00001e-320", 0.0},
+            {"1" + std::string(400, '0'), inf},
+            {"1" + std::string(400, '0') + "e-390", 1e10},
+            {"0." + std::string(400, '0') + "1", 0.0},
+            {"1e-99999999999999999999", 0.0},
+        }
+    ) {
+        double number = 1.0;
+        EXPECT_TRUE(Json::Reader::DecodeFloatingPoint(text, number)) << text;
+        EXPECT_EQ(expected, number) << text;
+        EXPECT_EQ(std::signbit(expected), std::signbit(number)) << text;
+    }
+    double number;
+    EXPECT_FALSE(Json::Reader::DecodeFloatingPoint("1e", number));
+    EXPECT_FALSE(Json::Reader::DecodeFloatingPoint("1e400x", number));
+}
+
+TEST(ReaderTests, ReadNumbersOutOfRange) {
+    const std::string text = R"([1e400, -1e400, 1e-400, {"a": -1e-400}])";
+    const auto expected = Json::Value::FromEncoding(text);
+    ASSERT_EQ(Json::ValueType::Array, expected.GetType());
+    std::istringstream input(text);
+    Json::Value read;
+    input >> read;
+    EXPECT_FALSE(input.fail());
+    for (const auto &json: {Build<Json::DefaultTraits>(text, 3), read}) {
+        ASSERT_EQ(4, json.GetSize());
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(Json::ValueType::FloatingPoint, json[i].GetType());
+            EXPECT_EQ((double) expected[i], (double) json[i]) << i;
+        }
+        EXPECT_EQ((double) expected[3]["a"], (double) json[3]["a"]);
+    }
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), (double) read[0]);
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), (double) read[1]);
+    EXPECT_EQ(0.0, (double) read[2]);
+}
+
+TEST(ReaderTests, BuilderMatchesFromEncoding) {
+    const std::string text = R"({"a": [1, 2.5, "é\n", true, null, []], "b": {"c": {}}, "d": -7})";
+    const auto expected = Json::Value::FromEncoding(text);
+    for (size_t chunkSize: {1, 5, 1000}) {
+        const auto json = Build<Json::DefaultTraits>(text, chunkSize);
+        EXPECT_EQ(expected, json) << chunkSize;
+        EXPECT_EQ(expected.ToEncoding({.reencode = true}), json.ToEncoding()) << chunkSize;
+    }
+    EXPECT_EQ(
+        Json::CompactValue::FromEncoding(text),
+        Build<Json::CompactTraits>(text, 3)
+    );
+}
+
+TEST(ReaderTests, BuilderScalarAndDuplicateKeys) {
+    EXPECT_EQ(Json::Value("x"), Build<Json::DefaultTraits>(R"("x")", 1));
+    EXPECT_EQ(Json::Value(3), Build<Json::DefaultTraits>("3", 1));
+    EXPECT_EQ(
+        Json::Value(2),
+        Build<Json::DefaultTraits>(R"({"k": 1, "k": 2})", 4)["k"]
+    );
+}
+
+TEST(ReaderTests, BuilderRejectsBadText) {
+    EXPECT_EQ(Json::ValueType::Invalid, Build<Json::DefaultTraits>(R"(["\q"])", 1).GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, Build<Json::DefaultTraits>("[99999999999999999999]", 1).GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, Build<Json::DefaultTraits>("[1, 2", 1).GetType());
+}
+
+TEST(ReaderTests, StreamRoundTrip) {
+    std::istringstream input(R"( {"x": [1, 2, {"y": "z"}]} [true] "tail")");
+    Json::Value first;
+    Json::Value second;
+    Json::Value third;
+    input >> first >> second >> third;
+    EXPECT_FALSE(input.fail());
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"x": [1, 2, {"y": "z"}]})"), first);
+    EXPECT_EQ(Json::Value::FromEncoding("[true]"), second);
+    EXPECT_EQ(Json::Value("tail"), third);
+    Json::Value fourth;
+    input >> fourth;
+    EXPECT_TRUE(input.fail());
+    EXPECT_EQ(Json::ValueType::Invalid, fourth.GetType());
+
+    std::ostringstream output;
+    output << first;
+    EXPECT_EQ(R"({"x":[1,2,{"y":"z"}]})", output.str());
+}
+
+TEST(ReaderTests, StreamReadLeavesRestOfStream) {
+    std::istringstream input("[1, 2]   rest");
+    const auto json = Json::Value::Read(input);
+    EXPECT_EQ(Json::Value::FromEncoding("[1, 2]"), json);
+    std::string rest;
+    std::getline(input, rest);
+    EXPECT_EQ("   rest", rest);
+}
+
+TEST(ReaderTests, StreamReadInvalid) {
+    std::istringstream input("[1, ");
+    Json::Value json;
+    input >> json;
+    EXPECT_TRUE(input.fail());
+    EXPECT_EQ(Json::ValueType::Invalid, json.GetType());
+}
+
+TEST(ReaderTests, StreamLargeDocument) {
+    Json::Value json(Json::ValueType::Array);
+    for (int i = 0; i < 20000; ++i) {
+        json.Add(Json::Object({{"index", i}, {"name", "element"}}));
+    }
+    std::stringstream stream;
+    json.Write(stream);
+    EXPECT_GT(stream.str().size(), 65536);
+    EXPECT_EQ(json.ToEncoding(), stream.str());
+    EXPECT_EQ(json, Json::Value::Read(stream));
+}
+
+TEST(ReaderTests, StreamWriteMatchesToEncoding) {
+    const std::string text = (
+        R"({"short": [1, 2], "long": ["aaaaaaaaaaaaaaaaaaaa", "bbbbbbbbbbbbbbbbbbbb", "cccccccccccccccccccc"],)"
+        R"( "nested": {"a": {"b": [{"c": "dddddddddddddddddddddddddddddddddddddddd"}], "e": []}},)"
+        R"( "empty": {}, "unicode": "é", "number": 1.5})"
+    );
+    std::vector<Json::EncodingOptions> optionSets(5);
+    optionSets[1].pretty = true;
+    optionSets[2].pretty = true;
+    optionSets[2].wrapThreshold = 20;
+    optionSets[2].spacesPerIndentationLevel = 2;
+    optionSets[3].pretty = true;
+    optionSets[3].reencode = true;
+    optionSets[3].escapeNonAscii = true;
+    optionSets[4].pretty = true;
+    optionSets[4].wrapThreshold = 0;
+    optionSets[4].numIndentationLevels = 1;
+    for (const auto &options: optionSets) {
+        // The members of parsed values still cache their source text.
+        auto parsed = Json::Value::FromEncoding(text);
+        (void) parsed.Set("extra", Json::Value(true));
+        std::ostringstream parsedOutput;
+        parsed.Write(parsedOutput, options);
+        EXPECT_EQ(parsed.ToEncoding(options), parsedOutput.str());
+
+        // Values with nothing cached.
+        const auto compact = Json::CompactValue::FromEncoding(text);
+        std::ostringstream compactOutput;
+        compact.Write(compactOutput, options);
+        EXPECT_EQ(compact.ToEncoding(options), compactOutput.str());
+    }
+}
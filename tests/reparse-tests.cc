@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <value.h>
+
+namespace {
+    /**
+     * This is a document being edited as text, with the value parsed
+     * from it kept up to date by Reparse().
+     */
+    struct Editor {
+        std::string text;
+        Json::EditableValue value;
+
+        /**
+         * This is the edit made since the value was last valid, if the
+         * text isn't valid now.
+         */
+        Json::EditRange pending;
+        bool isPending = false;
+
+        explicit Editor(std::string initialText)
+            : text(std::move(initialText))
+            , value(Json::EditableValue::FromEncoding(text))
+        {
+        }
+
+        /**
+         * This replaces the given part of the text, and returns the value
+         * Reparse() returns for the new text.
+         */
+        Json::EditableValue Replace(
+            size_t offset,
+            size_t length,
+            const std::string &replacement
+        ) {
+            text.replace(offset, length, replacement);
+            Json::EditRange edit;
+            edit.offset = offset;
+            edit.oldLength = length;
+            edit.newLength = replacement.size();
+            if (isPending) {
+                edit = pending.Then(edit);
+            }
+            auto reparsed = Json::EditableValue::Reparse(std::move(value), text, edit);
+            if (reparsed.GetType() == Json::ValueType::Invalid) {
+                pending = edit;
+                isPending = true;
+                return reparsed;
+            }
+            isPending = false;
+            value = std::move(reparsed);
+            return value;
+        }
+    };
+
+    /**
+     * This returns the address of the characters of the given string
+     * value, which stays the same as long as the value is reused rather
+     * than parsed again.
+     */
+    const char *StringData(const Json::EditableValue &value) {
+        std::string_view string;
+        EXPECT_TRUE(value.TryGet(string));
+        return string.data();
+    }
+}
+
+TEST(ReparseTests, EditInsideNestedObjectReusesTheRest) {
+    Editor editor(
+        R"({"big": ")" + std::string(1000, 'x') + R"(", "config": {"a": 1, "b": [true]}, "list": [")"
+        + std::string(500, 'y') + R"("]})"
+    );
+    ASSERT_EQ(Json::ValueType::Object, editor.value.GetType());
+
+    // Reading through a const reference leaves the value reusable.
+    const auto &value = editor.value;
+    const auto big = StringData(value["big"]);
+    const auto listed = StringData(value["list"][0]);
+    const auto offset = editor.text.find("1,");
+    const auto reparsed = editor.Replace(offset, 1, "42");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), reparsed);
+    EXPECT_EQ(42, (int) value["config"]["a"]);
+    EXPECT_EQ(big, StringData(value["big"]));
+    EXPECT_EQ(listed, StringData(value["list"][0]));
+
+    // Edits after the first are placed using the spans the first one
+    // updated.
+    editor.Replace(editor.text.find("true"), 4, "false, \"n\"");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), editor.value);
+    editor.Replace(editor.text.find("\"big\""), 0, "\"new\": {}, ");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), editor.value);
+    EXPECT_EQ(big, StringData(value["big"]));
+    EXPECT_EQ(listed, StringData(value["list"][0]));
+}
+
+TEST(ReparseTests, InvalidTextLeavesPreviousValue) {
+    Editor editor(R"({"a": [1, 2, 3], "b": {"c": "d"}})");
+    const auto offset = editor.text.find("\"c\"");
+    EXPECT_EQ(Json::ValueType::Invalid, editor.Replace(offset, 0, "\"").GetType());
+    EXPECT_EQ(Json::ValueType::Invalid, editor.Replace(offset + 1, 0, "x\": 5").GetType());
+    EXPECT_EQ(Json::ValueType::Object, editor.Replace(offset + 6, 0, ",").GetType());
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), editor.value);
+    EXPECT_EQ(5, (int) editor.value["b"]["x"]);
+}
+
+TEST(ReparseTests, EditsWhichChangeStructure) {
+    Editor editor(R"({"a": [1, 2], "b": 3})");
+
+    // Closing the array early, and opening another, moves members from
+    // one container to another.
+    editor.Replace(editor.text.find("2]"), 0, "1], \"c\": [");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(R"({"a": [1, 1], "c": [2], "b": 3})"), editor.value);
+
+    // Duplicate keys take the last value, even when an earlier one is
+    // reused.
+    editor.Replace(editor.text.find("\"b\""), 0, "\"a\": null, ");
+    EXPECT_EQ(Json::ValueType::Null, editor.value["a"].GetType());
+    editor.Replace(editor.text.find("\"a\": null, "), 11, "");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), editor.value);
+
+    // A number directly before the edit runs on into it.
+    editor.Replace(editor.text.find("3}") + 1, 0, "4");
+    EXPECT_EQ(34, (int) editor.value["b"]);
+
+    // Replacing the top-level value.
+    editor.Replace(0, editor.text.size(), "  [\"x\"]\n");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(editor.text), editor.value);
+}
+
+TEST(ReparseTests, EditsOutsideTheTopLevelValue) {
+    Editor editor("  {\"a\": [1]}");
+    editor.Replace(editor.text.size(), 0, "\n");
+    editor.Replace(0, 1, "");
+    EXPECT_EQ(Json::EditableValue::FromEncoding("{\"a\": [1]}"), editor.value);
+    editor.Replace(0, 0, "\t\n");
+    EXPECT_EQ(1, (int) editor.value["a"][0]);
+    EXPECT_EQ(Json::ValueType::Invalid, editor.Replace(editor.text.size(), 0, "x").GetType());
+    editor.Replace(editor.text.size() - 1, 1, "");
+    EXPECT_EQ(1, (int) editor.value["a"][0]);
+}
+
+TEST(ReparseTests, RandomEditsMatchParsingInFull) {
+    std::string text = "{\"items\": [";
+    for (int i = 0; i < 40; ++i) {
+        if (i > 0) {
+            text += ", ";
+        }
+        text += (
+            "{\"id\": " + std::to_string(i)
+            + ", \"name\": \"item " + std::to_string(i)
+            + "\", \"tags\": [\"a\", [1.5, null]], \"on\": true}"
+        );
+    }
+    text += "], \"meta\": {\"count\": 40}}";
+    Editor editor(text);
+    std::mt19937 generator(12345);
+    const std::string_view pieces[] = {
+        "1", "-", ".5", "e", "\"", "\\", "x", " ", "\n", ",", ":",
+        "[", "]", "{", "}", "null", "tru", "\"k\": ", "[2, {\"z\": 3}]",
+    };
+    const auto check = [&](const Json::EditableValue &reparsed) {
+        const auto parsed = Json::EditableValue::FromEncoding(editor.text);
+        if (parsed.GetType() == Json::ValueType::Invalid) {
+            EXPECT_EQ(Json::ValueType::Invalid, reparsed.GetType()) << editor.text;
+            return false;
+        }
+        EXPECT_EQ(parsed, reparsed) << editor.text;
+        return true;
+    };
+    for (int i = 0; i < 1000; ++i) {
+        std::uniform_int_distribution<size_t> offsets(0, editor.text.size());
+        const auto offset = offsets(generator);
+        const auto length = std::min(
+            (size_t) std::uniform_int_distribution<int>(0, 3)(generator),
+            editor.text.size() - offset
+        );
+        std::string replacement;
+        for (auto n = std::uniform_int_distribution<int>(0, 2)(generator); n > 0; --n) {
+            replacement += pieces[std::uniform_int_distribution<size_t>(0, std::size(pieces) - 1)(generator)];
+        }
+        const auto removed = editor.text.substr(offset, length);
+        if (check(editor.Replace(offset, length, replacement))) {
+            continue;
+        }
+
+        // Most edits which break the text are undone, so that the
+        // value isn't left behind by too many edits.
+        if (i % 8 != 0) {
+            check(editor.Replace(offset, replacement.size(), removed));
+        }
+        if (
+            editor.isPending
+            && (i % 10 == 0)
+        ) {
+            editor = Editor(text);
+        }
+    }
+}
+
+TEST(ReparseTests, EditRangeThen) {
+    Json::EditRange first;
+    first.offset = 10;
+    first.oldLength = 2;
+    first.newLength = 5;
+    Json::EditRange second;
+    second.offset = 4;
+    second.oldLength = 8;
+    second.newLength = 1;
+    const auto combined = first.Then(second);
+    EXPECT_EQ(4, combined.offset);
+    EXPECT_EQ(8, combined.oldLength);
+    EXPECT_EQ(4, combined.newLength);
+}
+
+TEST(ReparseTests, OtherTraitsParseInFull) {
+    auto value = Json::Value::FromEncoding(R"({"a": 1})");
+    Json::EditRange edit;
+    edit.offset = 6;
+    edit.oldLength = 1;
+    edit.newLength = 1;
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"({"a": 2})"),
+        Json::Value::Reparse(std::move(value), R"({"a": 2})", edit)
+    );
+}
+
+TEST(ReparseTests, SameGrammarAsOtherTraits) {
+    Json::EncodingOptions options;
+    options.reencode = true;
+    for (const auto text: {"[1, 2,]", "{\"a\": 1,}", "{\"a\": [{\"b\": 1e-400,},],}", "[1e400, -1e-400]"}) {
+        const auto expected = Json::Value::FromEncoding(text);
+        const auto editable = Json::EditableValue::FromEncoding(text);
+        ASSERT_NE(Json::ValueType::Invalid, editable.GetType()) << text;
+        EXPECT_EQ(expected.ToEncoding(options), editable.ToEncoding(options)) << text;
+    }
+    for (const auto text: {"[,]", "[1,,]", "{,}", "[1, 2,,]"}) {
+        EXPECT_EQ(Json::ValueType::Invalid, Json::Value::FromEncoding(text).GetType()) << text;
+        EXPECT_EQ(Json::ValueType::Invalid, Json::EditableValue::FromEncoding(text).GetType()) << text;
+    }
+
+    // Reparsing keeps what the trailing comma follows.
+    Editor editor(R"({"a": [1, 2,], "b": 3,})");
+    editor.Replace(editor.text.find('3'), 1, "4");
+    EXPECT_EQ(Json::EditableValue::FromEncoding(R"({"a": [1, 2], "b": 4})"), editor.value);
+}
+
+TEST(ReparseTests, ChangesMadeToThePreviousValueAreNotKept) {
+    const auto edit = [](Json::EditableValue &value, const std::string &newText) {
+        Json::EditRange changed;
+        changed.offset = newText.find('4');
+        changed.oldLength = 1;
+        changed.newLength = 1;
+        return Json::EditableValue::Reparse(std::move(value), newText, changed);
+    };
+    const std::string text = R"({"a": {"b": [1, 2]}, "c": 3})";
+    const std::string newText = R"({"a": {"b": [1, 2]}, "c": 4})";
+    const auto expected = Json::EditableValue::FromEncoding(newText);
+
+    auto assigned = Json::EditableValue::FromEncoding(text);
+    assigned["a"]["b"][0] = 5;
+    EXPECT_EQ(expected, edit(assigned, newText));
+
+    auto added = Json::EditableValue::FromEncoding(text);
+    (void) added["a"]["b"].Add(6);
+    EXPECT_EQ(expected, edit(added, newText));
+
+    auto set = Json::EditableValue::FromEncoding(text);
+    (void) set["a"].Set("d", true);
+    EXPECT_EQ(expected, edit(set, newText));
+
+    auto removed = Json::EditableValue::FromEncoding(text);
+    removed["a"].Remove("b");
+    EXPECT_EQ(expected, edit(removed, newText));
+
+    auto patched = Json::EditableValue::FromEncoding(text);
+    ASSERT_TRUE(patched.ApplyPatch(Json::EditableValue::FromEncoding(R"([{"op": "replace", "path": "/a/b/1", "value": 7}])")));
+    EXPECT_EQ(expected, edit(patched, newText));
+}
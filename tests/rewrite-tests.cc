@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <pointer.h>
+#include <rewrite.h>
+#include <sstream>
+#include <string>
+#include <transcode.h>
+#include <value.h>
+
+namespace {
+    /**
+     * This rewrites the given text with the given rules, returning the
+     * result, or "(invalid)" if the text isn't valid JSON.
+     */
+    std::string RewriteText(
+        const std::string &input,
+        const Json::RewriteRules &rules
+    ) {
+        std::string output;
+        if (!Json::Rewrite(input, output, rules)) {
+            return "(invalid)";
+        }
+        return output;
+    }
+}
+
+TEST(RewriteTests, NoRules) {
+    EXPECT_EQ(
+        R"({"a":[1,2,{"b":null}],"c":"é"})",
+        RewriteText(R"({ "a": [1, 2, {"b": null}], "c": "é" })", Json::RewriteRules())
+    );
+}
+
+TEST(RewriteTests, DropKeyAtAnyDepth) {
+    Json::RewriteRules rules;
+    rules.DropKey("password");
+    EXPECT_EQ(
+        R"({"user":"bob","nested":[{"x":1},{}]})",
+        RewriteText(
+            R"({"password": {"old": [1, 2], "new": "x"}, "user": "bob", "nested": [{"x": 1, "password": "y"}, {"password": 3}]})",
+            rules
+        )
+    );
+}
+
+TEST(RewriteTests, DropByPointer) {
+    Json::RewriteRules rules;
+    rules.Drop(Json::Pointer("/items/1")).Drop(Json::Pointer("/meta/secret"));
+    EXPECT_EQ(
+        R"({"items":[10,[30]],"meta":{"public":true},"secret":1})",
+        RewriteText(
+            R"({"items": [10, {"a": [20]}, [30]], "meta": {"secret": [1], "public": true}, "secret": 1})",
+            rules
+        )
+    );
+}
+
+TEST(RewriteTests, DropRootHasNoEffect) {
+    Json::RewriteRules rules;
+    rules.Drop(Json::Pointer(""));
+    EXPECT_EQ("[1]", RewriteText("[1]", rules));
+}
+
+TEST(RewriteTests, ReplaceValues) {
+    Json::RewriteRules rules;
+    rules.ReplaceKey("email", "***").Replace(Json::Pointer("/list/0"), Json::Value(0));
+    EXPECT_EQ(
+        R"({"email":"***","list":[0,2],"inner":{"email":"***"}})",
+        RewriteText(
+            R"({"email": "a@b.c", "list": [{"big": [1, 2, 3]}, 2], "inner": {"email": ["x"]}})",
+            rules
+        )
+    );
+}
+
+TEST(RewriteTests, RenameMembers) {
+    Json::RewriteRules rules;
+    rules.RenameKey("ssn", "taxId").Rename(Json::Pointer("/a/b"), "c").Rename(Json::Pointer("/list/0"), "z");
+    EXPECT_EQ(
+        R"({"a":{"c":[1],"taxId":"1"},"list":[5]})",
+        RewriteText(R"({"a": {"b": [1], "ssn": "1"}, "list": [5]})", rules)
+    );
+}
+
+TEST(RewriteTests, EscapedKeysAreDecodedForMatching) {
+    Json::RewriteRules rules;
+    rules.DropKey("a/b").Drop(Json::Pointer("/c~1d"));
+    EXPECT_EQ(
+        R"({"e":1})",
+        RewriteText(R"({"a\/b": 1, "c/d": 2, "e": 1})", rules)
+    );
+}
+
+TEST(RewriteTests, TransformValues) {
+    Json::RewriteRules rules;
+    rules.TransformKey(
+        "card",
+        [](const Json::Value &value){
+            const auto digits = (std::string) value["number"];
+            return Json::Value(std::string("****") + digits.substr(digits.length() - 4));
+        }
+    );
+    EXPECT_EQ(
+        R"([{"card":"****4242"},{"card":"****0005"}])",
+        RewriteText(
+            R"([{"card": {"number": "4242424242424242"}}, {"card": {"number": "5555555555550005"}}])",
+            rules
+        )
+    );
+}
+
+TEST(RewriteTests, FirstRuleWins) {
+    Json::RewriteRules rules;
+    rules.ReplaceKey("x", 1).DropKey("x");
+    EXPECT_EQ(R"({"x":1})", RewriteText(R"({"x": 2})", rules));
+}
+
+TEST(RewriteTests, Pretty) {
+    Json::RewriteRules rules;
+    rules.DropKey("b");
+    Json::EncodingOptions options;
+    options.pretty = true;
+    std::string output;
+    ASSERT_TRUE(Json::Rewrite(R"({"a": 1, "b": 2, "c": [3]})", output, rules, options));
+    std::string expected;
+    ASSERT_TRUE(Json::Reformat(R"({"a": 1, "c": [3]})", expected, options));
+    EXPECT_EQ(expected, output);
+}
+
+TEST(RewriteTests, Streams) {
+    std::string input = "[";
+    for (int i = 0; i < 20000; ++i) {
+        if (i > 0) {
+            input += ", ";
+        }
+        input += R"({"id": )" + std::to_string(i) + R"(, "token": "secret"})";
+    }
+    input += "]";
+    Json::RewriteRules rules;
+    rules.ReplaceKey("token", nullptr);
+    std::istringstream in(input);
+    std::ostringstream out;
+    ASSERT_TRUE(Json::Rewrite(in, out, rules));
+    const auto json = Json::Value::FromEncoding(out.str());
+    ASSERT_EQ(20000, json.GetSize());
+    EXPECT_EQ(Json::Value::FromEncoding(R"({"id": 19999, "token": null})"), json[19999]);
+}
+
+TEST(RewriteTests, InvalidInput) {
+    Json::RewriteRules rules;
+    rules.DropKey("a").TransformKey("b", [](const Json::Value &value){ return value; });
+    EXPECT_EQ("(invalid)", RewriteText(R"({"a": [1, })", rules));
+    EXPECT_EQ("(invalid)", RewriteText(R"({"b": {"c" 1}})", rules));
+    EXPECT_EQ("(invalid)", RewriteText(R"({"c": 1} 2)", rules));
+    EXPECT_EQ("(invalid)", RewriteText("", rules));
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <pointer.h>
+#include <scan-lines.h>
+#include <string>
+#include <utility>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This scans the given text, returning the line numbers of the
+     * records which match.
+     */
+    std::vector<size_t> MatchingLines(
+        const std::string &text,
+        const Json::Filter &filter,
+        const Json::ScanOptions &options = Json::ScanOptions()
+    ) {
+        std::vector<size_t> lines;
+        (void) Json::ScanLines(
+            text,
+            filter,
+            [&lines](size_t lineNumber, Json::Value &&){
+                lines.push_back(lineNumber);
+            },
+            options
+        );
+        return lines;
+    }
+}
+
+TEST(ScanLinesTests, ParseFilter) {
+    const auto filter = Json::Filter::Parse(R"(/level == "error" && /latency_ms>500 && /a~1b/0 != null)");
+    ASSERT_TRUE(filter.IsValid());
+    const auto &conditions = filter.GetConditions();
+    ASSERT_EQ(3, conditions.size());
+    EXPECT_EQ("/level", conditions[0].pointer.ToString());
+    EXPECT_EQ(Json::Filter::Operator::Equal, conditions[0].op);
+    EXPECT_EQ(Json::Value("error"), conditions[0].operand);
+    EXPECT_EQ("/latency_ms", conditions[1].pointer.ToString());
+    EXPECT_EQ(Json::Filter::Operator::Greater, conditions[1].op);
+    EXPECT_EQ(Json::Value(500), conditions[1].operand);
+    EXPECT_EQ(std::vector<std::string>({"a/b", "0"}), conditions[2].pointer.GetTokens());
+    EXPECT_EQ(Json::Filter::Operator::NotEqual, conditions[2].op);
+    EXPECT_EQ(Json::Value(nullptr), conditions[2].operand);
+}
+
+TEST(ScanLinesTests, ParseStringWithOperators) {
+    const auto filter = Json::Filter::Parse(R"(/msg >= "a && \"b\" <= c")");
+    ASSERT_TRUE(filter.IsValid());
+    ASSERT_EQ(1, filter.GetConditions().size());
+    EXPECT_EQ(Json::Value(R"(a && "b" <= c)"), filter.GetConditions()[0].operand);
+}
+
+TEST(ScanLinesTests, ParseInvalidFilters) {
+    EXPECT_FALSE(Json::Filter::Parse("/a = 1").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("/a == ").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("/a == [1]").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("/a == 1 /b == 2").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("/a == 1 &&").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("a == 1").IsValid());
+    EXPECT_FALSE(Json::Filter::Parse("/a~2 == 1").IsValid());
+}
+
+TEST(ScanLinesTests, MatchesComparisons) {
+    const auto latency = Json::Filter::Parse("/latency_ms > 500");
+    EXPECT_TRUE(latency.Matches(R"({"latency_ms": 501})"));
+    EXPECT_TRUE(latency.Matches(R"({"latency_ms": 500.5})"));
+    EXPECT_FALSE(latency.Matches(R"({"latency_ms": 500})"));
+    EXPECT_FALSE(latency.Matches(R"({"latency_ms": "900"})"));
+    EXPECT_FALSE(latency.Matches(R"({"other": 900})"));
+    EXPECT_FALSE(latency.Matches(R"({"latency_ms": 900)"));
+    const auto level = Json::Filter::Parse(R"(/level != "info" && /level < "warn")");
+    EXPECT_TRUE(level.Matches(R"({"level": "error"})"));
+    EXPECT_FALSE(level.Matches(R"({"level": "info"})"));
+    EXPECT_FALSE(level.Matches(R"({"level": "warn"})"));
+    EXPECT_FALSE(level.Matches(R"({})"));
+    const auto mismatch = Json::Filter::Parse("/x != 1");
+    EXPECT_TRUE(mismatch.Matches(R"({"x": [1]})"));
+    EXPECT_TRUE(mismatch.Matches(R"({"x": true})"));
+    EXPECT_FALSE(mismatch.Matches(R"({"x": 1.0})"));
+    const auto flags = Json::Filter::Parse("/ok == true && /note == null && /n >= -2.5");
+    EXPECT_TRUE(flags.Matches(R"({"n": -2, "ok": true, "note": null})"));
+    EXPECT_FALSE(flags.Matches(R"({"n": -3, "ok": true, "note": null})"));
+    EXPECT_FALSE(flags.Matches(R"({"n": 0, "ok": false, "note": null})"));
+}
+
+TEST(ScanLinesTests, MatchesNestedAndEscaped) {
+    const auto filter = Json::Filter::Parse(R"(/req/headers/1 == "gzip" && /user/name == "é")");
+    EXPECT_TRUE(
+        filter.Matches(
+            R"({"skip": {"deep": [1, {"req": 2}]}, "req": {"headers": ["a", "gzip"]}, "user": {"name": "é"}})"
+        )
+    );
+    EXPECT_TRUE(filter.Matches(R"({"user": {"name": "é"}, "req": {"headers": [{}, "gzip"]}})"));
+    EXPECT_FALSE(filter.Matches(R"({"user": {"name": "é"}, "req": {"headers": ["gzip"]}})"));
+    EXPECT_TRUE(Json::Filter().Where(Json::Pointer("/a\"b"), Json::Filter::Operator::Equal, 1).Matches(R"({"a\"b": 1})"));
+    EXPECT_TRUE(Json::Filter::Parse("== 5").Matches("5"));
+}
+
+TEST(ScanLinesTests, ScanInOrder) {
+    std::string text;
+    std::vector<size_t> expected;
+    for (size_t i = 1; i <= 20000; ++i) {
+        if (i % 97 == 0) {
+            text += R"({"level": "error", "latency_ms": )" + std::to_string(i) + "}\n";
+            if (i > 5000) {
+                expected.push_back(i);
+            }
+        } else if (i % 1000 == 0) {
+            text += "\n";
+        } else if (i % 1001 == 0) {
+            text += "{not json, \"level\": \"error\"}\n";
+        } else {
+            text += R"({"level": "info", "latency_ms": )" + std::to_string(i) + R"(, "tags": ["error"]})" + "\n";
+        }
+    }
+    text += R"({"latency_ms": 99999, "level": "error"})";
+    expected.push_back(20001);
+    const auto filter = Json::Filter::Parse(R"(/level == "error" && /latency_ms > 5000)");
+    Json::ScanOptions options;
+    options.threads = 4;
+    options.chunkSize = 1000;
+    EXPECT_EQ(expected, MatchingLines(text, filter, options));
+    options.threads = 1;
+    EXPECT_EQ(expected, MatchingLines(text, filter, options));
+}
+
+TEST(ScanLinesTests, RecordsAreParsed) {
+    const std::string text = (
+        "{\"id\": 1, \"level\": \"error\", \"detail\": {\"code\": 7}}\r\n"
+        "{\"id\": 2, \"level\": \"info\"}\r\n"
+    );
+    std::vector<std::pair<size_t, Json::CompactValue>> records;
+    const auto matches = Json::ScanLines<Json::CompactTraits>(
+        text,
+        Json::Filter::Parse(R"(/level == "error")"),
+        [&records](size_t lineNumber, Json::CompactValue &&record){
+            records.emplace_back(lineNumber, std::move(record));
+        }
+    );
+    EXPECT_EQ(1, matches);
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ(1, records[0].first);
+    EXPECT_EQ(Json::CompactValue::FromEncoding(R"({"id": 1, "level": "error", "detail": {"code": 7}})"), records[0].second);
+}
+
+TEST(ScanLinesTests, InvalidFilterMatchesNothing) {
+    EXPECT_TRUE(MatchingLines("{}\n{}", Json::Filter::Parse("/a =")).empty());
+    EXPECT_EQ(std::vector<size_t>({1, 3}), MatchingLines("{}\n\n[1]\n", Json::Filter()));
+}
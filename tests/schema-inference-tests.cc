@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <schema-inference.h>
+#include <sstream>
+#include <string>
+
+namespace {
+    /**
+     * This function returns newline-delimited records with a mix of
+     * shapes, long enough to be split among several threads when read
+     * in small chunks.
+     */
+    std::string MakeRecords(size_t count) {
+        std::string text;
+        for (size_t i = 0; i < count; ++i) {
+            text += "{\"id\": " + std::to_string(i);
+            text += ", \"level\": \"" + std::string((i % 3 == 0) ? "error" : "info") + "\"";
+            text += ", \"user\": \"user-" + std::to_string(i % 500) + "\"";
+            if (i % 4 == 0) {
+                text += ", \"latency\": " + std::to_string(i % 100) + ".5";
+            }
+            if (i % 10 == 0) {
+                text += ", \"tags\": [\"a\", 1]";
+            } else {
+                text += ", \"tags\": [\"a\", \"b\"]";
+            }
+            text += ", \"extra\": " + std::string((i % 2 == 0) ? "null" : "{\"nested\": true}");
+            text += "}\n";
+        }
+        return text;
+    }
+}
+
+TEST(SchemaInferenceTests, SummarizesTypesAndOptionality) {
+    const auto sketch = Json::InferSchema(MakeRecords(1000), 1);
+    const auto summary = sketch.ToValue();
+    EXPECT_EQ(Json::Value(1000), summary["count"]);
+    EXPECT_EQ(Json::Value(1000), summary["types"]["object"]);
+    EXPECT_EQ(Json::Value(0), summary["invalidRecords"]);
+    const auto &objects = summary["objects"];
+    EXPECT_EQ(
+        Json::Value::FromEncoding(R"(["extra", "id", "level", "tags", "user"])"),
+        objects["required"]
+    );
+    EXPECT_EQ(Json::Value(250), objects["properties"]["latency"]["count"]);
+    EXPECT_EQ(Json::Value(250), objects["properties"]["latency"]["types"]["number"]);
+    EXPECT_EQ(Json::Value(500), objects["properties"]["extra"]["types"]["null"]);
+    EXPECT_EQ(Json::Value(500), objects["properties"]["extra"]["types"]["object"]);
+    EXPECT_EQ(
+        Json::Value(500),
+        objects["properties"]["extra"]["objects"]["properties"]["nested"]["types"]["boolean"]
+    );
+}
+
+TEST(SchemaInferenceTests, RangesAndCardinality) {
+    const auto sketch = Json::InferSchema(MakeRecords(1000), 1);
+    const auto &members = sketch.root.members;
+    const auto &id = members.at("id");
+    EXPECT_EQ(0, id.minimumInteger);
+    EXPECT_EQ(999, id.maximumInteger);
+    const auto &latency = members.at("latency");
+    EXPECT_EQ(0.5, latency.minimumNumber);
+    EXPECT_EQ(96.5, latency.maximumNumber);
+    EXPECT_EQ(2, members.at("level").distinctStrings.Estimate());
+    const auto users = members.at("user").distinctStrings.Estimate();
+    EXPECT_GE(users, 485);
+    EXPECT_LE(users, 515);
+    EXPECT_EQ(6, members.at("user").minimumStringLength);
+    EXPECT_EQ(8, members.at("user").maximumStringLength);
+
+    Json::CardinalitySketch many;
+    for (size_t i = 0; i < 100000; ++i) {
+        many.Add("key-" + std::to_string(i));
+    }
+    EXPECT_NEAR(100000.0, (double) many.Estimate(), 5000.0);
+}
+
+TEST(SchemaInferenceTests, ArrayHomogeneity) {
+    const auto sketch = Json::InferSchema(MakeRecords(1000), 1);
+    const auto &tags = sketch.root.members.at("tags");
+    EXPECT_EQ(1000, tags.arrays);
+    EXPECT_EQ(900, tags.homogeneousArrays);
+    EXPECT_EQ(2, tags.minimumArrayLength);
+    EXPECT_EQ(2, tags.maximumArrayLength);
+    ASSERT_NE(nullptr, tags.elements);
+    EXPECT_EQ(2000, tags.elements->count);
+    EXPECT_EQ(1900, tags.elements->strings);
+    EXPECT_EQ(100, tags.elements->integers);
+    const auto empty = Json::InferSchema("[]\n[[1, 2.5], [null]]\n", 1);
+    EXPECT_EQ(2, empty.root.homogeneousArrays);
+    EXPECT_EQ(1, empty.root.elements->homogeneousArrays);
+    EXPECT_EQ(0, empty.root.minimumArrayLength);
+}
+
+TEST(SchemaInferenceTests, ThreadsAndStreamsAgree) {
+    const auto text = MakeRecords(5000);
+    const auto expected = Json::InferSchema(text, 1).ToValue();
+    Json::InferenceOptions options;
+    options.threads = 4;
+    options.chunkSize = 1000;
+    EXPECT_EQ(expected, Json::InferSchema(text, options).ToValue());
+    std::istringstream stream(text);
+    EXPECT_EQ(expected, Json::InferSchema(stream, options).ToValue());
+    options.threads = 1;
+    std::istringstream again(text);
+    EXPECT_EQ(expected, Json::InferSchema(again, options).ToValue());
+}
+
+TEST(SchemaInferenceTests, InvalidRecordsAndManyKeys) {
+    const auto sketch = Json::InferSchema("{\"a\": 1}\n{\"a\": \n{\"a\": 2} oops\n{\"a\": 3}\n[1,", 1);
+    EXPECT_EQ(3, sketch.invalidRecords);
+    EXPECT_EQ(3, sketch.root.objects);
+    EXPECT_EQ(0, sketch.root.arrays);
+    EXPECT_EQ(1, sketch.root.members.at("a").minimumInteger);
+    EXPECT_EQ(3, sketch.root.members.at("a").maximumInteger);
+
+    std::string text;
+    for (size_t i = 0; i < 100; ++i) {
+        text += "{\"k" + std::to_string(i) + "\": " + std::to_string(i) + "}\n";
+    }
+    Json::InferenceOptions options;
+    options.threads = 3;
+    options.chunkSize = 64;
+    options.maxMembers = 10;
+    const auto map = Json::InferSchema(text, options);
+    EXPECT_EQ(10, map.root.members.size());
+    ASSERT_NE(nullptr, map.root.otherMembers);
+    EXPECT_EQ(90, map.root.otherMembers->integers);
+    EXPECT_NEAR(90.0, (double) map.root.otherKeys.Estimate(), 2.0);
+    EXPECT_EQ(Json::Value(Json::Value::Type::Array), map.ToValue()["objects"]["required"]);
+}
+
+TEST(SchemaInferenceTests, OneThreadReadsDocumentsSpanningLines) {
+    std::string text;
+    for (size_t i = 0; i < 200; ++i) {
+        text += "{\n    \"id\": " + std::to_string(i) + ",\n    \"tags\": [\n        \"a\",\n        \"b\"\n    ]\n}\n";
+    }
+    text += "[" + std::string(1000, ' ') + "\"long\"]";
+    Json::InferenceOptions options;
+    options.threads = 1;
+    options.chunkSize = text.size();
+    const auto expected = Json::InferSchema(text, options).ToValue();
+    options.chunkSize = 64;
+    const auto sketch = Json::InferSchema(text, options);
+    EXPECT_EQ(0, sketch.invalidRecords);
+    EXPECT_EQ(200, sketch.root.objects);
+    EXPECT_EQ(1, sketch.root.arrays);
+    EXPECT_EQ(199, sketch.root.members.at("id").maximumInteger);
+    EXPECT_EQ(expected, sketch.ToValue());
+    std::istringstream stream(text);
+    EXPECT_EQ(expected, Json::InferSchema(stream, options).ToValue());
+}
+
+TEST(SchemaInferenceTests, InvalidLineSpanningChunks) {
+    const auto text = "{\"a\": 1}\n{\"a\": }" + std::string(200, 'x') + "\n{\"a\": 2}\n";
+    Json::InferenceOptions options;
+    options.threads = 1;
+    options.chunkSize = 16;
+    const auto sketch = Json::InferSchema(text, options);
+    EXPECT_EQ(1, sketch.invalidRecords);
+    EXPECT_EQ(2, sketch.root.objects);
+    std::istringstream stream(text);
+    EXPECT_EQ(sketch.ToValue(), Json::InferSchema(stream, options).ToValue());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <value.h>
+
+namespace {
+    /**
+     * This returns the text of a document with a branch which is used
+     * and one which isn't, each holding a few hundred values of every
+     * type.
+     */
+    std::string MakeDocument() {
+        std::string branch = "[";
+        for (int i = 0; i < 50; ++i) {
+            if (i > 0) {
+                branch += ", ";
+            }
+            branch += (
+                R"({"id": )" + std::to_string(i * 1000003 - 25000000)
+                + R"(, "name": "item \u0000 )" + std::to_string(i)
+                + R"(", "price": )" + std::to_string(i) + R"(.25, "tags": ["a", [], {}], "on": true, "off": false, "none": null})"
+            );
+        }
+        branch += "]";
+        return R"({"hot": )" + branch + R"(, "cold": {"items": )" + branch + R"(, "count": 9223372036854775807}})";
+    }
+}
+
+TEST(TieredValueTests, ColdBranchIsFrozenAndThawedOnAccess) {
+    const auto expected = Json::TieredValue::FromEncoding(MakeDocument());
+    auto value = expected;
+    EXPECT_EQ(0, value.FreezeColdSubtrees());
+    EXPECT_EQ(Json::ValueType::Array, value["hot"].GetType());
+    EXPECT_EQ(1, value.FreezeColdSubtrees());
+
+    // Frozen branches stay frozen through further sweeps.
+    EXPECT_EQ(50, value["hot"].GetSize());
+    EXPECT_EQ(0, value.FreezeColdSubtrees());
+    EXPECT_EQ(Json::ValueType::Object, value["cold"].GetType());
+    EXPECT_EQ(-25000000, (int) value["cold"]["items"][0]["id"]);
+    EXPECT_EQ(expected, value);
+    EXPECT_EQ(expected.ToEncoding(), value.ToEncoding());
+}
+
+TEST(TieredValueTests, WholeValueFrozenWhenIdle) {
+    const auto expected = Json::TieredValue::FromEncoding(MakeDocument());
+    auto value = expected;
+    (void) value.FreezeColdSubtrees();
+    EXPECT_EQ(1, value.FreezeColdSubtrees());
+    EXPECT_EQ(2, value.GetSize());
+    EXPECT_EQ(expected, value);
+}
+
+TEST(TieredValueTests, FrozenBranchesNestInColderOnes) {
+    const auto expected = Json::TieredValue::FromEncoding(MakeDocument());
+    auto value = expected;
+    (void) value.FreezeColdSubtrees();
+    (void) value["hot"][0].GetType();
+    EXPECT_EQ(1, value.FreezeColdSubtrees());
+    (void) value["hot"][0].GetType();
+    EXPECT_EQ(49, value.FreezeColdSubtrees(Json::FreezeOptions{1, 8}));
+    EXPECT_EQ(1, value.FreezeColdSubtrees());
+    const auto copy = value;
+    EXPECT_EQ(expected, copy);
+    size_t count = 0;
+    for (const auto &element: value["hot"]) {
+        EXPECT_EQ(expected["hot"][count], element.value());
+        ++count;
+    }
+    EXPECT_EQ(50, count);
+    EXPECT_EQ(expected, value);
+}
+
+TEST(TieredValueTests, IdleSweepsAndMinimumValues) {
+    auto value = Json::TieredValue::FromEncoding(MakeDocument());
+    Json::FreezeOptions options;
+    options.idleSweeps = 3;
+    EXPECT_EQ(0, value.FreezeColdSubtrees(options));
+    EXPECT_EQ(0, value.FreezeColdSubtrees(options));
+    EXPECT_EQ(0, value.FreezeColdSubtrees(options));
+    options.minimumValues = 100000;
+    EXPECT_EQ(0, value.FreezeColdSubtrees(options));
+    options.minimumValues = 64;
+    EXPECT_EQ(1, value.FreezeColdSubtrees(options));
+}
+
+TEST(TieredValueTests, DocumentsAgeSeparately) {
+    const auto expected = Json::TieredValue::FromEncoding(MakeDocument());
+    auto a = expected;
+    auto b = expected;
+    EXPECT_EQ(0, a.FreezeColdSubtrees());
+    (void) a["hot"].GetType();
+    EXPECT_EQ(0, b.FreezeColdSubtrees());
+    EXPECT_EQ(1, a.FreezeColdSubtrees());
+
+    // Sweeping b doesn't make what a just accessed cold.
+    (void) a["hot"].GetType();
+    EXPECT_EQ(1, b.FreezeColdSubtrees());
+    EXPECT_EQ(0, a.FreezeColdSubtrees());
+    EXPECT_EQ(expected, a);
+    EXPECT_EQ(expected, b);
+}
+
+TEST(TieredValueTests, OtherTraitsFreezeNothing) {
+    auto value = Json::Value::FromEncoding(MakeDocument());
+    (void) value.FreezeColdSubtrees();
+    EXPECT_EQ(0, value.FreezeColdSubtrees());
+    EXPECT_EQ(Json::Value::FromEncoding(MakeDocument()), value);
+}
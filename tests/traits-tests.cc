@@ -0,0 +1,86 @@
+#include <flat-map.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+TEST(TraitsTests, FlatMapKeepsKeysSorted) {
+    Json::FlatMap<int> map;
+    map["c"] = 3;
+    map["a"] = 1;
+    EXPECT_TRUE(map.insert({"b", 2}).second);
+    EXPECT_FALSE(map.insert({"a", 10}).second);
+    std::vector<std::string> keys;
+    for (const auto &entry: map) {
+        keys.push_back(entry.first);
+    }
+    EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), keys);
+    EXPECT_EQ(1, map["a"]);
+    EXPECT_EQ(3, map.size());
+}
+
+TEST(TraitsTests, FlatMapFindAndErase) {
+    Json::FlatMap<int> map;
+    map["x"] = 1;
+    map["y"] = 2;
+    EXPECT_NE(map.end(), map.find("x"));
+    EXPECT_EQ(map.end(), map.find("z"));
+    EXPECT_EQ(1, map.erase("x"));
+    EXPECT_EQ(0, map.erase("x"));
+    EXPECT_EQ(map.end(), map.find("x"));
+    EXPECT_EQ(1, map.size());
+}
+
+TEST(TraitsTests, CompactValueParsesAndEncodes) {
+    const auto json = Json::CompactValue::FromEncoding(
+        R"({ "b": [1, 2.5, "x"], "a": {"n": null, "t": true} })"
+    );
+    ASSERT_EQ(Json::ValueType::Object, json.GetType());
+    EXPECT_EQ(2, json.GetSize());
+    EXPECT_EQ(2.5, (double) json["b"][1]);
+    EXPECT_EQ("x", (std::string) json["b"][2]);
+    EXPECT_TRUE((bool) json["a"]["t"]);
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), json.GetKeys());
+
+    // Compact values don't cache their source text, so they always
+    // encode canonically.
+    EXPECT_EQ(R"({"a":{"n":null,"t":true},"b":[1,2.5,"x"]})", json.ToEncoding());
+}
+
+TEST(TraitsTests, CompactValueBuildAndModify) {
+    Json::CompactValue json(Json::ValueType::Object);
+    json.Set("z", 1);
+    json.Set("m", "middle");
+    json["a"] = Json::CompactValue(Json::ValueType::Array);
+    json["a"].Add(true);
+    EXPECT_EQ(R"({"a":[true],"m":"middle","z":1})", json.ToEncoding());
+    json.Remove("m");
+    EXPECT_EQ(R"({"a":[true],"z":1})", json.ToEncoding());
+    EXPECT_EQ(json, Json::CompactValue::FromEncoding(R"({"z":1,"a":[true]})"));
+}
+
+TEST(TraitsTests, CompactValueInvalidKeepsSourceText) {
+    const auto json = Json::CompactValue::FromEncoding("[1, 2");
+    EXPECT_EQ(Json::ValueType::Invalid, json.GetType());
+    EXPECT_EQ("(Invalid JSON: [1, 2)", json.ToEncoding());
+    const auto copy = json;
+    EXPECT_EQ("(Invalid JSON: [1, 2)", copy.ToEncoding());
+}
+
+TEST(TraitsTests, HashedValueLookups) {
+    const auto json = Json::HashedValue::FromEncoding(R"({"one": 1, "two": 2, "three": 3})");
+    ASSERT_EQ(Json::ValueType::Object, json.GetType());
+    EXPECT_TRUE(json.Has("two"));
+    EXPECT_FALSE(json.Has("four"));
+    EXPECT_EQ(3, (int) json["three"]);
+    EXPECT_EQ(Json::ValueType::Null, json["four"].GetType());
+    EXPECT_EQ(json, Json::HashedValue::FromEncoding(R"({"three": 3, "two": 2, "one": 1})"));
+}
+
+TEST(TraitsTests, DefaultValueStillCachesSourceText) {
+    const auto json = Json::Value::FromEncoding(R"({ "b": 1, "a": 2 })");
+    EXPECT_EQ(R"({ "b": 1, "a": 2 })", json.ToEncoding());
+    Json::EncodingOptions options;
+    options.reencode = true;
+    EXPECT_EQ(R"({"a":2,"b":1})", json.ToEncoding(options));
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <transcode.h>
+#include <value.h>
+
+TEST(TranscodeTests, Minify) {
+    std::string output;
+    EXPECT_TRUE(Json::Minify(
+        " {\r\n  \"a\" : [ 1 , -2.5e3 , \"x\\u00e9 y\" ],\n  \"b\\n\": { },\t\"c\": [true, false, null] }\n",
+        output
+    ));
+    EXPECT_EQ(R"({"a":[1,-2.5e3,"x\u00e9 y"],"b\n":{},"c":[true,false,null]})", output);
+}
+
+TEST(TranscodeTests, MinifyStreams) {
+    std::string text = "[";
+    for (int i = 0; i < 20000; ++i) {
+        text += (i == 0 ? " " : " , ");
+        text += R"({ "id" : )" + std::to_string(i) + " }";
+    }
+    text += " ]";
+    std::istringstream input(text);
+    std::ostringstream output;
+    ASSERT_TRUE(Json::Minify(input, output));
+    EXPECT_EQ(Json::Value::FromEncoding(text).ToEncoding({.reencode = true}), output.str());
+}
+
+TEST(TranscodeTests, ReformatPretty) {
+    Json::EncodingOptions options;
+    options.pretty = true;
+    options.spacesPerIndentationLevel = 2;
+    std::string output;
+    EXPECT_TRUE(Json::Reformat(R"({"list":[1,2],"empty":{}})", output, options));
+    EXPECT_EQ(
+        "{\r\n"
+        "  \"list\": [\r\n"
+        "    1,\r\n"
+        "    2\r\n"
+        "  ],\r\n"
+        "  \"empty\": {}\r\n"
+        "}",
+        output
+    );
+}
+
+TEST(TranscodeTests, ReformatEscapesNonAscii) {
+    Json::EncodingOptions options;
+    options.escapeNonAscii = true;
+    std::string output;
+    EXPECT_TRUE(Json::Reformat("{\"\xC3\xA9\": \"caf\xC3\xA9\", \"k\": \"\\t\"}", output, options));
+    EXPECT_EQ(R"({"\u00E9":"caf\u00E9","k":"\t"})", output);
+}
+
+TEST(TranscodeTests, RejectsInvalidText) {
+    for (const auto text: {"", "[1,]", "{\"a\" 1}", "[\"\\q\"]", "[1] 2", "{\"a\": tru}"}) {
+        std::string output;
+        EXPECT_FALSE(Json::Minify(text, output)) << text;
+    }
+}
@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
 #include <value.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <locale.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 TEST(ValueTests, FromNull) {
     Json::Value json(nullptr);
@@ -782,3 +791,200 @@ TEST(ValueTests, ObjectIteratorProtocol) {
 TEST(ValueTests, BadEncodings) {
     EXPECT_EQ(Json::Value(), Json::Value::FromEncoding("\""));
 }
+
+TEST(ValueTests, TypedGetByKey) {
+    const auto json = Json::Value::FromEncoding(
+        R"({"n": 42, "big": 100000, "x": 1.5, "s": "text", "b": true, "z": null})"
+    );
+    EXPECT_EQ(std::optional<int>(42), json.Get<int>("n"));
+    EXPECT_EQ(std::optional<double>(42.0), json.Get<double>("n"));
+    EXPECT_EQ(std::optional<double>(1.5), json.Get<double>("x"));
+    EXPECT_EQ(std::optional<bool>(true), json.Get<bool>("b"));
+    EXPECT_EQ(std::optional<std::string>("text"), json.Get<std::string>("s"));
+    EXPECT_EQ(std::optional<std::string_view>("text"), json.Get<std::string_view>("s"));
+
+    // Type mismatches, out-of-range integers and missing keys give no value.
+    EXPECT_EQ(std::nullopt, json.Get<int>("x"));
+    EXPECT_EQ(std::nullopt, json.Get<int16_t>("big"));
+    EXPECT_EQ(std::nullopt, json.Get<std::string>("n"));
+    EXPECT_EQ(std::nullopt, json.Get<bool>("z"));
+    EXPECT_EQ(std::nullopt, json.Get<int>("missing"));
+}
+
+TEST(ValueTests, TypedGetByIndex) {
+    const auto json = Json::Value::FromEncoding(R"([-1, "two", false])");
+    EXPECT_EQ(std::optional<intmax_t>(-1), json.Get<intmax_t>(0));
+    EXPECT_EQ(std::nullopt, json.Get<size_t>(0));
+    EXPECT_EQ(std::optional<std::string_view>("two"), json.Get<std::string_view>(1));
+    EXPECT_EQ(std::optional<bool>(false), json.Get<bool>(2));
+    EXPECT_EQ(std::nullopt, json.Get<bool>(3));
+    EXPECT_EQ(std::nullopt, json.Get<int>("key"));
+}
+
+TEST(ValueTests, StringViewRefersToHeldString) {
+    const auto json = Json::Object({{"name", "value"}});
+    const auto view = json.Get<std::string_view>("name");
+    ASSERT_TRUE(view.has_value());
+    std::string_view direct;
+    ASSERT_TRUE(json.Find("name")->TryGet(direct));
+    EXPECT_EQ(direct.data(), view->data());
+}
+
+TEST(ValueTests, VisitCallsMatchingOverload) {
+    const auto describe = [](const Json::Value &json) {
+        return json.Visit([](const auto &content) -> std::string {
+            using T = std::decay_t<decltype(content)>;
+            if constexpr (std::is_same_v<T, std::nullptr_t>) {
+                return "null";
+            } else if constexpr (std::is_same_v<T, bool>) {
+                return content ? "bool:true" : "bool:false";
+            } else if constexpr (std::is_same_v<T, Json::Value::IntegerType>) {
+                return "integer:" + std::to_string(content);
+            } else if constexpr (std::is_same_v<T, Json::Value::FloatingPointType>) {
+                return "float:" + std::to_string(content);
+            } else if constexpr (std::is_same_v<T, std::string_view>) {
+                return "string:" + std::string(content);
+            } else if constexpr (std::is_same_v<T, Json::Value::ArrayView>) {
+                return "array:" + std::to_string(content.size());
+            } else if constexpr (std::is_same_v<T, Json::Value::ObjectView>) {
+                std::string keys;
+                for (const auto &member: content) {
+                    keys += member.first;
+                }
+                return "object:" + keys;
+            } else {
+                return "invalid";
+            }
+        });
+    };
+    EXPECT_EQ("null", describe(nullptr));
+    EXPECT_EQ("bool:true", describe(true));
+    EXPECT_EQ("integer:-7", describe(-7));
+    EXPECT_EQ("float:0.500000", describe(0.5));
+    EXPECT_EQ("string:hi", describe("hi"));
+    EXPECT_EQ("array:3", describe(Json::Array({1, 2, 3})));
+    EXPECT_EQ("object:ab", describe(Json::Object({{"b", 1}, {"a", 2}})));
+    EXPECT_EQ("invalid", describe(Json::Value()));
+}
+
+TEST(ValueTests, WalkVisitsInDocumentOrder) {
+    const auto json = Json::Value::FromEncoding(R"({"a": [1, {"b": null}], "c": "x"})");
+    std::vector<std::string> visits;
+    json.Walk([&visits](const Json::Value::WalkEntry &entry) {
+        visits.push_back(
+            std::string(entry.key)
+            + "#" + std::to_string(entry.index)
+            + "@" + std::to_string(entry.depth)
+            + "=" + entry.value.ToEncoding(Json::EncodingOptions{.reencode = true})
+        );
+    });
+    EXPECT_EQ(
+        (std::vector<std::string>{
+            R"(#0@0={"a":[1,{"b":null}],"c":"x"})",
+            R"(a#0@1=[1,{"b":null}])",
+            R"(#0@2=1)",
+            R"(#1@2={"b":null})",
+            R"(b#0@3=null)",
+            R"(c#1@1="x")",
+        }),
+        visits
+    );
+}
+
+TEST(ValueTests, WalkCanSkipChildren) {
+    const auto json = Json::Value::FromEncoding(R"({"skip": [1, 2, 3], "keep": [4]})");
+    intmax_t sum = 0;
+    json.Walk([&sum](const Json::Value::WalkEntry &entry) {
+        if (entry.key == "skip") {
+            return false;
+        }
+        sum += entry.value.Get<intmax_t>(Json::Pointer()).value_or(0);
+        return true;
+    });
+    EXPECT_EQ(4, sum);
+}
+
+TEST(ValueTests, WalkHandlesDeepNesting) {
+    Json::Value json(Json::Value::Type::Array);
+    auto *innermost = &json;
+    for (size_t i = 0; i < 10000; ++i) {
+        innermost = &innermost->Add(Json::Value(Json::Value::Type::Array));
+    }
+    size_t deepest = 0;
+    json.Walk([&deepest](const Json::Value::WalkEntry &entry) {
+        deepest = std::max(deepest, entry.depth);
+    });
+    EXPECT_EQ(10000, deepest);
+}
+
+namespace {
+    /**
+     * This returns the contents of the given file.
+     */
+    std::string ReadWholeFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST(ValueTests, ToFileReplacesAtomically) {
+    const auto directory = std::filesystem::temp_directory_path() / "jsonkit-to-file";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const auto path = (directory / "snapshot.json").string();
+    std::ofstream(path) << "old contents";
+
+    Json::Value json(Json::Value::Type::Array);
+    for (int i = 0; i < 5000; ++i) {
+        json.Add(Json::Object({{"id", i}, {"name", "item\n"}, {"ratio", 0.5}}));
+    }
+    Json::EncodingOptions options;
+    options.pretty = true;
+    Json::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    writeOptions.preallocate = true;
+    writeOptions.bufferSize = 4096;
+    ASSERT_TRUE(json.ToFile(path, options, writeOptions));
+    EXPECT_EQ(json.ToEncoding(options), ReadWholeFile(path));
+
+    // Only the target is left in the directory.
+    EXPECT_EQ(1, std::distance(
+        std::filesystem::directory_iterator(directory),
+        std::filesystem::directory_iterator()
+    ));
+
+    // Writing fails without touching anything if the directory is missing.
+    EXPECT_FALSE(json.ToFile((directory / "missing" / "x.json").string()));
+    std::filesystem::remove_all(directory);
+}
+
+#ifndef _WIN32
+TEST(ValueTests, ToFileKeepsPermissions) {
+    const auto path = std::filesystem::temp_directory_path() / "jsonkit-to-file-mode.json";
+    std::ofstream(path) << "old contents";
+    const auto mode = (
+        std::filesystem::perms::owner_read
+        | std::filesystem::perms::owner_write
+        | std::filesystem::perms::group_read
+    );
+    std::filesystem::permissions(path, mode);
+    ASSERT_TRUE(Json::Value(42).ToFile(path.string()));
+    EXPECT_EQ("42", ReadWholeFile(path));
+    EXPECT_EQ(mode, std::filesystem::status(path).permissions());
+
+    // A read-only file is replaced, and stays read-only.
+    std::filesystem::permissions(path, std::filesystem::perms::owner_read);
+    ASSERT_TRUE(Json::Value(43).ToFile(path.string()));
+    EXPECT_EQ("43", ReadWholeFile(path));
+    EXPECT_EQ(std::filesystem::perms::owner_read, std::filesystem::status(path).permissions());
+    std::filesystem::remove(path);
+}
+#endif
+
+TEST(ValueTests, ToFileUsesCachedEncoding) {
+    const auto path = std::filesystem::temp_directory_path() / "jsonkit-to-file-cached.json";
+    const auto json = Json::Value::FromEncoding(R"({ "a" : [1, 2] })");
+    ASSERT_TRUE(json.ToFile(path.string()));
+    EXPECT_EQ(R"({ "a" : [1, 2] })", ReadWholeFile(path));
+    std::filesystem::remove(path);
+}
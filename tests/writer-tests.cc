@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <value.h>
+#include <vector>
+#include <writer.h>
+
+TEST(WriterTests, CompactDocument) {
+    std::string text;
+    Json::Writer writer(text);
+    writer.BeginObject()
+        .Key("id").Int(42)
+        .Key("name").String("Bob \"B\"")
+        .Key("score").Double(2.5)
+        .Key("whole").Double(3.0)
+        .Key("ok").Bool(true)
+        .Key("none").Null()
+        .Key("tags").BeginArray().String("a").Int(-1).BeginObject().EndObject().EndArray()
+        .Key("empty").BeginArray().EndArray()
+        .EndObject();
+    EXPECT_TRUE(writer.IsComplete());
+    EXPECT_EQ(
+        R"({"id":42,"name":"Bob \"B\"","score":2.5,"whole":3.0,"ok":true,"none":null,"tags":["a",-1,{}],"empty":[]})",
+        text
+    );
+    EXPECT_EQ(Json::Value::FromEncoding(text)["tags"][1], Json::Value(-1));
+}
+
+TEST(WriterTests, MatchesToEncoding) {
+    const auto json = Json::Value::FromEncoding(
+        R"({"a": [1, 2.25, "é\n", true, null], "b": {"c": -9223372036854775807}})"
+    );
+    Json::EncodingOptions options;
+    options.reencode = true;
+    options.escapeNonAscii = true;
+    std::string text;
+    Json::Writer writer(text, options);
+    writer.BeginObject()
+        .Key("a").BeginArray().Int(1).Double(2.25).String("\xC3\xA9\n").Bool(true).Null().EndArray()
+        .Key("b").BeginObject().Key("c").Int(-9223372036854775807).EndObject()
+        .EndObject();
+    EXPECT_EQ(json.ToEncoding(options), text);
+}
+
+TEST(WriterTests, PrettyPrinting) {
+    Json::EncodingOptions options;
+    options.pretty = true;
+    options.spacesPerIndentationLevel = 2;
+    std::string text;
+    Json::Writer writer(text, options);
+    writer.BeginObject()
+        .Key("list").BeginArray().Int(1).Int(2).EndArray()
+        .Key("empty").BeginObject().EndObject()
+        .EndObject();
+    EXPECT_EQ(
+        "{\r\n"
+        "  \"list\": [\r\n"
+        "    1,\r\n"
+        "    2\r\n"
+        "  ],\r\n"
+        "  \"empty\": {}\r\n"
+        "}",
+        text
+    );
+}
+
+TEST(WriterTests, WriteValue) {
+    std::string text;
+    Json::Writer writer(text);
+    writer.BeginArray()
+        .Write(Json::Object({{"x", 1}}))
+        .Write(Json::CompactValue::FromEncoding("[true]"))
+        .RawValue("123")
+        .EndArray();
+    EXPECT_EQ(R"([{"x":1},[true],123])", text);
+}
+
+TEST(WriterTests, SinkReceivesChunks) {
+    std::vector<std::string> chunks;
+    {
+        Json::Writer writer(
+            [&chunks](std::string_view chunk) {
+                chunks.emplace_back(chunk);
+            },
+            Json::EncodingOptions(),
+            16
+        );
+        writer.BeginArray();
+        for (int i = 0; i < 100; ++i) {
+            writer.Int(i);
+        }
+        writer.EndArray();
+    }
+    ASSERT_GT(chunks.size(), 1);
+    std::string text;
+    for (const auto &chunk: chunks) {
+        EXPECT_LT(chunk.size(), 32);
+        text += chunk;
+    }
+    const auto json = Json::Value::FromEncoding(text);
+    ASSERT_EQ(Json::Value::Type::Array, json.GetType());
+    EXPECT_EQ(100, json.GetSize());
+    EXPECT_EQ(99, (int) json[99]);
+}
+
+TEST(WriterTests, IncompleteDocument) {
+    std::string text;
+    Json::Writer writer(text);
+    EXPECT_FALSE(writer.IsComplete());
+    writer.BeginArray().Int(1);
+    EXPECT_FALSE(writer.IsComplete());
+    writer.EndArray();
+    EXPECT_TRUE(writer.IsComplete());
+    EXPECT_FALSE(writer.HasFailed());
+}
+
+TEST(WriterTests, InvalidNestingFailsInDebugBuilds) {
+    std::string text;
+    EXPECT_DEBUG_DEATH(
+        {
+            Json::Writer writer(text);
+            writer.BeginObject().Int(1);
+        },
+        "without a key"
+    );
+    EXPECT_DEBUG_DEATH(
+        {
+            Json::Writer writer(text);
+            writer.BeginArray().EndObject();
+        },
+        "mismatched"
+    );
+}
+
+TEST(WriterTests, InvalidNestingRefusedInReleaseBuilds) {
+#ifndef NDEBUG
+    GTEST_SKIP() << "invalid nesting fails an assertion in debug builds";
+#else
+    std::string text;
+    Json::Writer valueWithoutKey(text);
+    valueWithoutKey.BeginObject().Int(1).Key("a").Int(2).EndObject();
+    EXPECT_EQ("{", text);
+    EXPECT_TRUE(valueWithoutKey.HasFailed());
+    EXPECT_FALSE(valueWithoutKey.IsComplete());
+
+    text.clear();
+    Json::Writer mismatched(text);
+    mismatched.BeginArray().EndObject().Int(1).EndArray();
+    EXPECT_EQ("[", text);
+    EXPECT_TRUE(mismatched.HasFailed());
+
+    text.clear();
+    Json::Writer unstarted(text);
+    unstarted.EndArray().Null().EndObject();
+    EXPECT_EQ("", text);
+    EXPECT_TRUE(unstarted.HasFailed());
+
+    text.clear();
+    Json::Writer pendingKey(text);
+    pendingKey.BeginObject().Key("a").Key("b").EndObject().Bool(true).EndObject();
+    EXPECT_EQ("{\"a\":", text);
+    EXPECT_TRUE(pendingKey.HasFailed());
+
+    text.clear();
+    Json::Writer twoValues(text);
+    twoValues.Int(1).Int(2);
+    EXPECT_EQ("1", text);
+    EXPECT_TRUE(twoValues.HasFailed());
+
+    // Nothing at all is written after the first refused call, whatever
+    // it is, through any of the writing functions.
+    text.clear();
+    Json::Writer afterFailure(text);
+    afterFailure.BeginArray().Key("a");
+    ASSERT_TRUE(afterFailure.HasFailed());
+    afterFailure.Null().Bool(false).Int(1).Double(2.5).String("x").RawValue("3");
+    afterFailure.BeginObject().Key("b").RawKey("\"c\"").EndObject();
+    afterFailure.BeginArray().EndArray().EndArray();
+    afterFailure.Write(Json::Value::FromEncoding(R"({"d": [4]})"));
+    EXPECT_EQ("[", text);
+    EXPECT_FALSE(afterFailure.IsComplete());
+#endif
+}
@@ -0,0 +1,656 @@
+#include "generator.h"
+
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This is the text of the helpers which parse and encode values of
+     * each kind without a type of its own in the generated code.
+     */
+    const std::map<Codegen::TypeModel::Kind, std::string> SCALAR_HELPERS = {
+        {
+            Codegen::TypeModel::Kind::String,
+            (
+                "    bool ParseValue(Json::Reader &, const Json::Reader::Token &token, std::string &value) {\n"
+                "        if (token.type != Json::Reader::TokenType::String) {\n"
+                "            return false;\n"
+                "        }\n"
+                "        value.clear();\n"
+                "        if (!token.escaped) {\n"
+                "            value.assign(token.text);\n"
+                "            return true;\n"
+                "        }\n"
+                "        return Json::Reader::DecodeString(token.text, value);\n"
+                "    }\n"
+                "\n"
+                "    void EncodeValue(Json::Writer &writer, const std::string &value) {\n"
+                "        (void) writer.String(value);\n"
+                "    }\n"
+            )
+        },
+        {
+            Codegen::TypeModel::Kind::Integer,
+            (
+                "    bool ParseValue(Json::Reader &, const Json::Reader::Token &token, int64_t &value) {\n"
+                "        intmax_t integer;\n"
+                "        if (\n"
+                "            (token.type != Json::Reader::TokenType::Integer)\n"
+                "            || !Json::Reader::DecodeInteger(token.text, integer)\n"
+                "            || !std::in_range<int64_t>(integer)\n"
+                "        ) {\n"
+                "            return false;\n"
+                "        }\n"
+                "        value = (int64_t) integer;\n"
+                "        return true;\n"
+                "    }\n"
+                "\n"
+                "    void EncodeValue(Json::Writer &writer, int64_t value) {\n"
+                "        (void) writer.Int((intmax_t) value);\n"
+                "    }\n"
+            )
+        },
+        {
+            Codegen::TypeModel::Kind::Number,
+            (
+                "    bool ParseValue(Json::Reader &, const Json::Reader::Token &token, double &value) {\n"
+                "        return (\n"
+                "            (\n"
+                "                (token.type == Json::Reader::TokenType::Integer)\n"
+                "                || (token.type == Json::Reader::TokenType::FloatingPoint)\n"
+                "            )\n"
+                "            && Json::Reader::DecodeFloatingPoint(token.text, value)\n"
+                "        );\n"
+                "    }\n"
+                "\n"
+                "    void EncodeValue(Json::Writer &writer, double value) {\n"
+                "        (void) writer.Double(value);\n"
+                "    }\n"
+            )
+        },
+        {
+            Codegen::TypeModel::Kind::Boolean,
+            (
+                "    bool ParseValue(Json::Reader &, const Json::Reader::Token &token, bool &value) {\n"
+                "        if (token.type == Json::Reader::TokenType::True) {\n"
+                "            value = true;\n"
+                "        } else if (token.type == Json::Reader::TokenType::False) {\n"
+                "            value = false;\n"
+                "        } else {\n"
+                "            return false;\n"
+                "        }\n"
+                "        return true;\n"
+                "    }\n"
+                "\n"
+                "    void EncodeValue(Json::Writer &writer, bool value) {\n"
+                "        (void) writer.Bool(value);\n"
+                "    }\n"
+            )
+        },
+        {
+            Codegen::TypeModel::Kind::Value,
+            (
+                "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, Json::Value &value) {\n"
+                "        Json::Builder builder;\n"
+                "        if (!builder.Push(token)) {\n"
+                "            return false;\n"
+                "        }\n"
+                "        Json::Reader::Token next;\n"
+                "        while (!builder.IsComplete()) {\n"
+                "            if (\n"
+                "                (reader.Next(next) != Json::Reader::Status::Token)\n"
+                "                || !builder.Push(next)\n"
+                "            ) {\n"
+                "                return false;\n"
+                "            }\n"
+                "        }\n"
+                "        value = builder.Take();\n"
+                "        return true;\n"
+                "    }\n"
+                "\n"
+                "    void EncodeValue(Json::Writer &writer, const Json::Value &value) {\n"
+                "        (void) writer.Write(value);\n"
+                "    }\n"
+            )
+        },
+    };
+
+    /**
+     * This is the text of the helpers for arrays and nullable values,
+     * declared first since they may hold each other.
+     */
+    const std::string TEMPLATE_HELPERS = (
+        "    template<typename T>\n"
+        "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, std::vector<T> &value);\n"
+        "    template<typename T>\n"
+        "    void EncodeValue(Json::Writer &writer, const std::vector<T> &value);\n"
+        "    template<typename T>\n"
+        "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, std::optional<T> &value);\n"
+        "    template<typename T>\n"
+        "    void EncodeValue(Json::Writer &writer, const std::optional<T> &value);\n"
+        "\n"
+        "    template<typename T>\n"
+        "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, std::vector<T> &value) {\n"
+        "        if (token.type != Json::Reader::TokenType::BeginArray) {\n"
+        "            return false;\n"
+        "        }\n"
+        "        value.clear();\n"
+        "        Json::Reader::Token next;\n"
+        "        while (true) {\n"
+        "            if (reader.Next(next) != Json::Reader::Status::Token) {\n"
+        "                return false;\n"
+        "            }\n"
+        "            if (next.type == Json::Reader::TokenType::EndArray) {\n"
+        "                return true;\n"
+        "            }\n"
+        "            T element;\n"
+        "            if (!ParseValue(reader, next, element)) {\n"
+        "                return false;\n"
+        "            }\n"
+        "            value.push_back(std::move(element));\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    template<typename T>\n"
+        "    void EncodeValue(Json::Writer &writer, const std::vector<T> &value) {\n"
+        "        (void) writer.BeginArray();\n"
+        "        for (const auto &element: value) {\n"
+        "            EncodeValue(writer, element);\n"
+        "        }\n"
+        "        (void) writer.EndArray();\n"
+        "    }\n"
+        "\n"
+        "    template<typename T>\n"
+        "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, std::optional<T> &value) {\n"
+        "        if (token.type == Json::Reader::TokenType::Null) {\n"
+        "            value.reset();\n"
+        "            return true;\n"
+        "        }\n"
+        "        return ParseValue(reader, token, value.emplace());\n"
+        "    }\n"
+        "\n"
+        "    template<typename T>\n"
+        "    void EncodeValue(Json::Writer &writer, const std::optional<T> &value) {\n"
+        "        if (value.has_value()) {\n"
+        "            EncodeValue(writer, *value);\n"
+        "        } else {\n"
+        "            (void) writer.Null();\n"
+        "        }\n"
+        "    }\n"
+    );
+
+    /**
+     * This is the text of the helpers for whole documents.
+     */
+    const std::string DOCUMENT_HELPERS = (
+        "    template<typename T>\n"
+        "    bool ParseDocument(std::string_view text, T &value) {\n"
+        "        Json::Reader reader;\n"
+        "        Json::Reader::Token token;\n"
+        "        reader.Feed(text);\n"
+        "        reader.Finish();\n"
+        "        return (\n"
+        "            (reader.Next(token) == Json::Reader::Status::Token)\n"
+        "            && ParseValue(reader, token, value)\n"
+        "            && (reader.Next(token) == Json::Reader::Status::End)\n"
+        "        );\n"
+        "    }\n"
+        "\n"
+        "    template<typename T>\n"
+        "    std::string EncodeDocument(const T &value, const Json::EncodingOptions &options) {\n"
+        "        std::string text;\n"
+        "        {\n"
+        "            Json::Writer writer(text, options);\n"
+        "            EncodeValue(writer, value);\n"
+        "        }\n"
+        "        return text;\n"
+        "    }\n"
+    );
+
+    /**
+     * This returns a C++ string literal holding the given text.
+     * Characters other than printable ASCII are written as octal
+     * escapes, which, unlike hexadecimal ones, can't run into the
+     * characters after them.
+     */
+    std::string MakeStringLiteral(const std::string &text) {
+        std::string literal = "\"";
+        for (const auto c: text) {
+            if (
+                (c == '"')
+                || (c == '\\')
+            ) {
+                literal += '\\';
+                literal += c;
+            } else if (
+                (c >= 0x20)
+                && (c < 0x7F)
+            ) {
+                literal += c;
+            } else {
+                char escape[5];
+                (void) snprintf(escape, sizeof(escape), "\\%03o", (unsigned int) (unsigned char) c);
+                literal += escape;
+            }
+        }
+        literal += '"';
+        return literal;
+    }
+
+    /**
+     * This returns the C++ type for the given type model.
+     *
+     * @param[in] type
+     *     This is the type model.
+     *
+     * @param[in] qualifier
+     *     This is put in front of the names of generated structs.
+     *
+     * @return
+     *     The C++ type is returned.
+     */
+    std::string MakeCppType(
+        const Codegen::TypeModel &type,
+        const std::string &qualifier
+    ) {
+        std::string cppType;
+        switch (type.kind) {
+            case Codegen::TypeModel::Kind::String: {
+                cppType = "std::string";
+            } break;
+
+            case Codegen::TypeModel::Kind::Integer: {
+                cppType = "int64_t";
+            } break;
+
+            case Codegen::TypeModel::Kind::Number: {
+                cppType = "double";
+            } break;
+
+            case Codegen::TypeModel::Kind::Boolean: {
+                cppType = "bool";
+            } break;
+
+            case Codegen::TypeModel::Kind::Array: {
+                cppType = "std::vector<" + MakeCppType(*type.items, qualifier) + ">";
+            } break;
+
+            case Codegen::TypeModel::Kind::Struct: {
+                cppType = qualifier + type.structName;
+            } break;
+
+            default: {
+                cppType = "Json::Value";
+            } break;
+        }
+        if (type.nullable) {
+            cppType = "std::optional<" + cppType + ">";
+        }
+        return cppType;
+    }
+
+    /**
+     * This indicates whether the member for the given field is wrapped
+     * in std::optional to tell whether the property was present, in
+     * which case the property is left out of the encoding if it wasn't.
+     * A nullable property which isn't required is instead left out if
+     * it's null.
+     */
+    bool IsOptionalField(const Codegen::FieldModel &field) {
+        return (
+            !field.required
+            && !field.type.nullable
+        );
+    }
+
+    /**
+     * This adds the kinds of values without types of their own which
+     * are held in the given type to the given set.
+     */
+    void CollectScalarKinds(
+        const Codegen::TypeModel &type,
+        std::set<Codegen::TypeModel::Kind> &kinds
+    ) {
+        if (type.kind == Codegen::TypeModel::Kind::Array) {
+            CollectScalarKinds(*type.items, kinds);
+        } else if (type.kind != Codegen::TypeModel::Kind::Struct) {
+            (void) kinds.insert(type.kind);
+        }
+    }
+
+    /**
+     * This returns the comment at the top of a generated file.
+     */
+    std::string MakeFileComment(
+        const std::string &fileName,
+        const Codegen::GeneratorOptions &options
+    ) {
+        return (
+            "/**\n"
+            " * @file " + fileName + "\n"
+            " *\n"
+            " * This was generated by jsonkit-codegen from " + options.schemaName + ".\n"
+            " * Don't edit it; change the schema and generate it again.\n"
+            " */\n"
+        );
+    }
+
+    /**
+     * This returns the prefix which qualifies the names of the
+     * generated structs.
+     */
+    std::string MakeQualifier(const Codegen::GeneratorOptions &options) {
+        return (
+            options.nameSpace.empty()
+            ? "::"
+            : "::" + options.nameSpace + "::"
+        );
+    }
+
+    /**
+     * This returns the definition of the function which parses the
+     * given struct.
+     */
+    std::string MakeParseFunction(
+        const Codegen::StructModel &structModel,
+        const std::string &qualifier
+    ) {
+        std::string text = (
+            "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, "
+            + qualifier + structModel.name + " &value) {\n"
+            "        if (token.type != Json::Reader::TokenType::BeginObject) {\n"
+            "            return false;\n"
+            "        }\n"
+            "        value = " + qualifier + structModel.name + "();\n"
+        );
+        std::map<size_t, std::vector<size_t>> fieldsByKeySize;
+        std::map<size_t, size_t> requiredIndexes;
+        for (size_t i = 0; i < structModel.fields.size(); ++i) {
+            const auto &field = structModel.fields[i];
+            fieldsByKeySize[field.key.size()].push_back(i);
+            if (field.required) {
+                const auto requiredIndex = requiredIndexes.size();
+                requiredIndexes[i] = requiredIndex;
+            }
+        }
+        if (!requiredIndexes.empty()) {
+            text += "        bool found[" + std::to_string(requiredIndexes.size()) + "] = {};\n";
+        }
+        text += (
+            "        std::string decoded;\n"
+            "        Json::Reader::Token next;\n"
+            "        while (true) {\n"
+            "            if (reader.Next(next) != Json::Reader::Status::Token) {\n"
+            "                return false;\n"
+            "            }\n"
+            "            if (next.type == Json::Reader::TokenType::EndObject) {\n"
+            "                break;\n"
+            "            }\n"
+            "            auto key = next.text;\n"
+            "            if (next.escaped) {\n"
+            "                decoded.clear();\n"
+            "                if (!Json::Reader::DecodeString(next.text, decoded)) {\n"
+            "                    return false;\n"
+            "                }\n"
+            "                key = decoded;\n"
+            "            }\n"
+        );
+        if (!fieldsByKeySize.empty()) {
+            text += "            switch (key.size()) {\n";
+            for (const auto &group: fieldsByKeySize) {
+                text += "                case " + std::to_string(group.first) + ": {\n";
+                for (const auto i: group.second) {
+                    const auto &field = structModel.fields[i];
+                    const auto target = (
+                        IsOptionalField(field)
+                        ? "value." + field.name + ".emplace()"
+                        : "value." + field.name
+                    );
+                    std::string indent = "                    ";
+                    if (group.first > 0) {
+                        text += (
+                            indent + "if (memcmp(key.data(), " + MakeStringLiteral(field.key)
+                            + ", " + std::to_string(group.first) + ") == 0) {\n"
+                        );
+                        indent += "    ";
+                    }
+                    text += (
+                        indent + "if (\n"
+                        + indent + "    (reader.Next(next) != Json::Reader::Status::Token)\n"
+                        + indent + "    || !ParseValue(reader, next, " + target + ")\n"
+                        + indent + ") {\n"
+                        + indent + "    return false;\n"
+                        + indent + "}\n"
+                    );
+                    const auto required = requiredIndexes.find(i);
+                    if (required != requiredIndexes.end()) {
+                        text += indent + "found[" + std::to_string(required->second) + "] = true;\n";
+                    }
+                    text += indent + "continue;\n";
+                    if (group.first > 0) {
+                        text += "                    }\n";
+                    } else {
+                        // A key can't be empty twice, so nothing else
+                        // in this case can be reached.
+                        break;
+                    }
+                }
+                text += "                } break;\n\n";
+            }
+            text += "                default: break;\n";
+            text += "            }\n";
+        }
+        text += (
+            "            if (reader.Skip() != Json::Reader::Status::Token) {\n"
+            "                return false;\n"
+            "            }\n"
+            "        }\n"
+        );
+        if (requiredIndexes.empty()) {
+            text += "        return true;\n";
+        } else {
+            text += "        return (\n";
+            for (size_t i = 0; i < requiredIndexes.size(); ++i) {
+                text += (
+                    std::string(i == 0 ? "            " : "            && ")
+                    + "found[" + std::to_string(i) + "]\n"
+                );
+            }
+            text += "        );\n";
+        }
+        text += "    }\n";
+        return text;
+    }
+
+    /**
+     * This returns the definition of the function which encodes the
+     * given struct.
+     */
+    std::string MakeEncodeFunction(
+        const Codegen::StructModel &structModel,
+        const std::string &qualifier
+    ) {
+        std::string text = (
+            "    void EncodeValue(Json::Writer &writer, const " + qualifier + structModel.name + " &value) {\n"
+            "        (void) writer.BeginObject();\n"
+        );
+        for (const auto &field: structModel.fields) {
+            const auto key = MakeStringLiteral(Json::Value(field.key).ToEncoding());
+            if (field.required) {
+                text += (
+                    "        (void) writer.RawKey(" + key + ");\n"
+                    "        EncodeValue(writer, value." + field.name + ");\n"
+                );
+            } else {
+                text += (
+                    "        if (value." + field.name + ".has_value()) {\n"
+                    "            (void) writer.RawKey(" + key + ");\n"
+                    "            EncodeValue(writer, *value." + field.name + ");\n"
+                    "        }\n"
+                );
+            }
+        }
+        text += (
+            "        (void) writer.EndObject();\n"
+            "    }\n"
+        );
+        return text;
+    }
+}
+
+namespace Codegen {
+    std::string GenerateHeader(
+        const SchemaModel &model,
+        const GeneratorOptions &options
+    ) {
+        std::string text = MakeFileComment(options.headerName, options);
+        text += (
+            "\n"
+            "#pragma once\n"
+            "\n"
+            "#include <cstdint>\n"
+            "#include <optional>\n"
+            "#include <string>\n"
+            "#include <string_view>\n"
+            "#include <value.h>\n"
+            "#include <vector>\n"
+            "\n"
+        );
+        std::string indent;
+        if (!options.nameSpace.empty()) {
+            text += "namespace " + options.nameSpace + " {\n";
+            indent = "    ";
+        }
+        for (const auto &structModel: model.structs) {
+            text += indent + "struct " + structModel.name + " {\n";
+            for (const auto &field: structModel.fields) {
+                auto cppType = MakeCppType(field.type, "");
+                if (IsOptionalField(field)) {
+                    cppType = "std::optional<" + cppType + ">";
+                }
+                std::string initializer;
+                if (
+                    !IsOptionalField(field)
+                    && !field.type.nullable
+                ) {
+                    switch (field.type.kind) {
+                        case TypeModel::Kind::Integer: {
+                            initializer = " = 0";
+                        } break;
+
+                        case TypeModel::Kind::Number: {
+                            initializer = " = 0.0";
+                        } break;
+
+                        case TypeModel::Kind::Boolean: {
+                            initializer = " = false";
+                        } break;
+
+                        default: break;
+                    }
+                }
+                text += indent + "    " + cppType + " " + field.name + initializer + ";\n";
+            }
+            text += indent + "};\n\n";
+        }
+        for (const auto &structModel: model.structs) {
+            text += (
+                indent + "/**\n"
+                + indent + " * @brief Parses an object of type " + structModel.name + " from JSON text.\n"
+                + indent + " *\n"
+                + indent + " * @return True if the text held exactly one object with every\n"
+                + indent + " * required property, and properties of the right types.\n"
+                + indent + " */\n"
+                + indent + "bool Parse(std::string_view text, " + structModel.name + " &value);\n"
+                "\n"
+                + indent + "/**\n"
+                + indent + " * @brief Encodes an object of type " + structModel.name + " as JSON text.\n"
+                + indent + " */\n"
+                + indent + "std::string Encode(\n"
+                + indent + "    const " + structModel.name + " &value,\n"
+                + indent + "    const Json::EncodingOptions &options = Json::EncodingOptions()\n"
+                + indent + ");\n"
+                "\n"
+            );
+        }
+        text.pop_back();
+        if (!options.nameSpace.empty()) {
+            text += "}\n";
+        }
+        return text;
+    }
+
+    std::string GenerateSource(
+        const SchemaModel &model,
+        const GeneratorOptions &options
+    ) {
+        const auto qualifier = MakeQualifier(options);
+        std::set<TypeModel::Kind> kinds;
+        for (const auto &structModel: model.structs) {
+            for (const auto &field: structModel.fields) {
+                CollectScalarKinds(field.type, kinds);
+            }
+        }
+        std::string text = MakeFileComment(options.sourceName, options);
+        text += "\n#include \"" + options.headerName + "\"\n\n";
+        if (kinds.count(TypeModel::Kind::Value) > 0) {
+            text += "#include <builder.h>\n";
+        }
+        text += (
+            "#include <cstring>\n"
+            "#include <reader.h>\n"
+            "#include <utility>\n"
+            "#include <writer.h>\n"
+            "\n"
+            "namespace {\n"
+        );
+        for (const auto &structModel: model.structs) {
+            text += (
+                "    bool ParseValue(Json::Reader &reader, const Json::Reader::Token &token, "
+                + qualifier + structModel.name + " &value);\n"
+                "    void EncodeValue(Json::Writer &writer, const " + qualifier + structModel.name + " &value);\n"
+            );
+        }
+        text += "\n";
+        for (const auto &helper: SCALAR_HELPERS) {
+            if (kinds.count(helper.first) > 0) {
+                text += helper.second + "\n";
+            }
+        }
+        text += TEMPLATE_HELPERS + "\n";
+        for (const auto &structModel: model.structs) {
+            text += MakeParseFunction(structModel, qualifier) + "\n";
+            text += MakeEncodeFunction(structModel, qualifier) + "\n";
+        }
+        text += DOCUMENT_HELPERS + "}\n\n";
+        std::string indent;
+        if (!options.nameSpace.empty()) {
+            text += "namespace " + options.nameSpace + " {\n";
+            indent = "    ";
+        }
+        for (const auto &structModel: model.structs) {
+            text += (
+                indent + "bool Parse(std::string_view text, " + structModel.name + " &value) {\n"
+                + indent + "    return ParseDocument(text, value);\n"
+                + indent + "}\n"
+                "\n"
+                + indent + "std::string Encode(\n"
+                + indent + "    const " + structModel.name + " &value,\n"
+                + indent + "    const Json::EncodingOptions &options\n"
+                + indent + ") {\n"
+                + indent + "    return EncodeDocument(value, options);\n"
+                + indent + "}\n"
+                "\n"
+            );
+        }
+        text.pop_back();
+        if (!options.nameSpace.empty()) {
+            text += "}\n";
+        }
+        return text;
+    }
+}
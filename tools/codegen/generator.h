@@ -0,0 +1,74 @@
+#pragma once
+
+#include "schema.h"
+
+#include <string>
+
+namespace Codegen {
+    /**
+     * @brief Settings for the code generated from a schema.
+     */
+    struct GeneratorOptions {
+        /**
+         * @brief The namespace in which to put the generated code, such
+         * as "Wire" or "Wire::V2".  If empty, the global namespace is
+         * used.
+         */
+        std::string nameSpace;
+
+        /**
+         * @brief The name by which the generated source includes the
+         * generated header.
+         */
+        std::string headerName;
+
+        /**
+         * @brief The name of the generated source, noted in it.
+         */
+        std::string sourceName;
+
+        /**
+         * @brief The name of the schema, noted in the generated files.
+         */
+        std::string schemaName;
+    };
+
+    /**
+     * This generates the header declaring the structs of the given
+     * model, and a Parse() and an Encode() function for each.
+     *
+     * @param[in] model
+     *     This is the model of the code to generate.
+     *
+     * @param[in] options
+     *     These are the settings for the code to generate.
+     *
+     * @return
+     *     The text of the header is returned.
+     */
+    std::string GenerateHeader(
+        const SchemaModel &model,
+        const GeneratorOptions &options
+    );
+
+    /**
+     * This generates the source defining the functions declared by the
+     * header generated for the given model.  The functions parse with
+     * Json::Reader and encode with Json::Writer, matching keys by length
+     * and then by content, and storing each value straight into its
+     * member.  Unknown keys are skipped.
+     *
+     * @param[in] model
+     *     This is the model of the code to generate.
+     *
+     * @param[in] options
+     *     These are the settings for the code to generate.
+     *
+     * @return
+     *     The text of the source is returned.
+     */
+    std::string GenerateSource(
+        const SchemaModel &model,
+        const GeneratorOptions &options
+    );
+}
@@ -0,0 +1,151 @@
+/**
+ * @file main.cc
+ *
+ * This is the entry point of jsonkit-codegen, which generates C++ structs
+ * from a JSON Schema, along with functions which parse and encode them
+ * directly, without building Json::Value objects.
+ *
+ * Usage: jsonkit-codegen [OPTION...] SCHEMA HEADER SOURCE
+ *
+ *   --namespace NS           Namespace of the generated code (default:
+ *                            the global namespace).
+ *   --name NAME              Name of the top-level struct, if the schema
+ *                            has no title (default: the schema's file
+ *                            name, up to its first dot).
+ *
+ * The header is included by the source by its file name, so the
+ * directory holding it must be on the include path.
+ */
+
+#include "generator.h"
+#include "schema.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace {
+    /**
+     * This prints how to run the program.
+     */
+    void PrintUsageInformation() {
+        fprintf(
+            stderr,
+            (
+                "Usage: jsonkit-codegen [OPTION...] SCHEMA HEADER SOURCE\n"
+                "\n"
+                "Generate C++ structs, with functions which parse and encode\n"
+                "them, from a JSON Schema.\n"
+                "\n"
+                "  --namespace NS  namespace of the generated code\n"
+                "  --name NAME     name of the top-level struct, if the schema has no title\n"
+            )
+        );
+    }
+
+    /**
+     * @brief Settings parsed from the command line.
+     */
+    struct Environment {
+        std::string nameSpace;
+        std::string name;
+        std::vector<std::string> paths;
+    };
+
+    /**
+     * This parses the command-line arguments of the program.
+     *
+     * @return
+     *     An indication of whether or not the arguments were valid
+     *     is returned.
+     */
+    bool ProcessCommandLineArguments(
+        int argc,
+        char *argv[],
+        Environment &environment
+    ) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            const auto hasValue = (i + 1 < argc);
+            if ((arg == "--namespace") && hasValue) {
+                environment.nameSpace = argv[++i];
+            } else if ((arg == "--name") && hasValue) {
+                environment.name = argv[++i];
+            } else if (
+                !arg.empty()
+                && (arg[0] == '-')
+            ) {
+                return false;
+            } else {
+                environment.paths.push_back(arg);
+            }
+        }
+        return (environment.paths.size() == 3);
+    }
+
+    /**
+     * This writes the given text to the file with the given path.
+     *
+     * @return
+     *     An indication of whether or not the file was written is
+     *     returned.
+     */
+    bool WriteFile(
+        const std::string &path,
+        const std::string &text
+    ) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        return (
+            file.write(text.data(), (std::streamsize) text.size())
+            && file.flush()
+        );
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Environment environment;
+    if (!ProcessCommandLineArguments(argc, argv, environment)) {
+        PrintUsageInformation();
+        return EXIT_FAILURE;
+    }
+    const auto &schemaPath = environment.paths[0];
+    const auto &headerPath = environment.paths[1];
+    const auto &sourcePath = environment.paths[2];
+    std::ifstream schemaFile(schemaPath, std::ios::binary);
+    if (!schemaFile) {
+        fprintf(stderr, "error: unable to read '%s'\n", schemaPath.c_str());
+        return EXIT_FAILURE;
+    }
+    const auto schema = Json::Value::Read(schemaFile);
+    if (schema.GetType() == Json::Value::Type::Invalid) {
+        fprintf(stderr, "error: '%s' isn't valid JSON\n", schemaPath.c_str());
+        return EXIT_FAILURE;
+    }
+    const auto schemaName = std::filesystem::path(schemaPath).filename().string();
+    if (environment.name.empty()) {
+        environment.name = schemaName.substr(0, schemaName.find('.'));
+    }
+    Codegen::SchemaModel model;
+    std::string error;
+    if (!Codegen::LoadSchema(schema, environment.name, model, error)) {
+        fprintf(stderr, "error: %s: %s\n", schemaPath.c_str(), error.c_str());
+        return EXIT_FAILURE;
+    }
+    Codegen::GeneratorOptions options;
+    options.nameSpace = environment.nameSpace;
+    options.headerName = std::filesystem::path(headerPath).filename().string();
+    options.sourceName = std::filesystem::path(sourcePath).filename().string();
+    options.schemaName = schemaName;
+    if (!WriteFile(headerPath, Codegen::GenerateHeader(model, options))) {
+        fprintf(stderr, "error: unable to write '%s'\n", headerPath.c_str());
+        return EXIT_FAILURE;
+    }
+    if (!WriteFile(sourcePath, Codegen::GenerateSource(model, options))) {
+        fprintf(stderr, "error: unable to write '%s'\n", sourcePath.c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
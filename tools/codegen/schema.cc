@@ -0,0 +1,354 @@
+#include "schema.h"
+
+#include <ctype.h>
+#include <map>
+#include <pointer.h>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace {
+    /**
+     * These are the words which can't name members in C++.
+     */
+    const std::set<std::string, std::less<>> RESERVED_WORDS = {
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand",
+        "bitor", "bool", "break", "case", "catch", "char", "char8_t",
+        "char16_t", "char32_t", "class", "co_await", "co_return",
+        "co_yield", "compl", "concept", "const", "const_cast", "consteval",
+        "constexpr", "constinit", "continue", "decltype", "default",
+        "delete", "do", "double", "dynamic_cast", "else", "enum",
+        "explicit", "export", "extern", "false", "float", "for", "friend",
+        "goto", "if", "inline", "int", "long", "mutable", "namespace",
+        "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+        "or_eq", "private", "protected", "public", "register",
+        "reinterpret_cast", "requires", "return", "short", "signed",
+        "sizeof", "static", "static_assert", "static_cast", "struct",
+        "switch", "template", "this", "thread_local", "throw", "true",
+        "try", "typedef", "typeid", "typename", "union", "unsigned",
+        "using", "virtual", "void", "volatile", "wchar_t", "while", "xor",
+        "xor_eq",
+    };
+
+    /**
+     * This makes a C++ identifier from the given text, replacing what
+     * can't be part of one with underscores.
+     */
+    std::string MakeIdentifier(std::string_view text) {
+        std::string identifier;
+        for (const auto c: text) {
+            identifier += (isalnum((unsigned char) c) ? c : '_');
+        }
+        if (
+            identifier.empty()
+            || isdigit((unsigned char) identifier[0])
+        ) {
+            identifier.insert(0, "_");
+        }
+        if (
+            (RESERVED_WORDS.find(identifier) != RESERVED_WORDS.end())
+            || (identifier.find("__") != std::string::npos)
+            || (
+                (identifier[0] == '_')
+                && isupper((unsigned char) identifier[1])
+            )
+        ) {
+            // What the implementation reserves gets a prefix of its own.
+            identifier.insert(0, "field_");
+        }
+        return identifier;
+    }
+
+    /**
+     * This makes the name of a C++ type from the given text, by joining
+     * its words, each starting with a capital letter.
+     */
+    std::string MakeTypeName(std::string_view text) {
+        std::string name;
+        bool wordStart = true;
+        for (const auto c: text) {
+            if (!isalnum((unsigned char) c)) {
+                wordStart = true;
+                continue;
+            }
+            name += (wordStart ? (char) toupper((unsigned char) c) : c);
+            wordStart = false;
+        }
+        if (
+            name.empty()
+            || isdigit((unsigned char) name[0])
+        ) {
+            name.insert(0, "Type");
+        }
+        return name;
+    }
+
+    /**
+     * This builds the model of a schema, one part at a time.
+     */
+    struct Loader {
+        /**
+         * This is the whole schema, against which references are
+         * resolved.
+         */
+        const Json::Value &root;
+
+        /**
+         * This is where the structs are stored as they're completed.
+         */
+        Codegen::SchemaModel &model;
+
+        /**
+         * This is where to store what's wrong with the schema.
+         */
+        std::string &error;
+
+        /**
+         * These are the names of the structs made for the references
+         * followed so far, so that each is made only once.
+         */
+        std::map<std::string, std::string> referencedStructs;
+
+        /**
+         * These are the references whose structs are being made, to
+         * catch schemas which refer to themselves.
+         */
+        std::set<std::string> referencesInProgress;
+
+        /**
+         * These are the names taken by structs.
+         */
+        std::set<std::string> structNames;
+
+        /**
+         * This constructs a loader for the given schema, storing the
+         * model in the given place, and what's wrong with the schema in
+         * the given string.
+         */
+        Loader(
+            const Json::Value &root,
+            Codegen::SchemaModel &model,
+            std::string &error
+        )
+            : root(root)
+              , model(model)
+              , error(error) {
+        }
+
+        /**
+         * This function returns the given name for a struct, or a
+         * variant of it if it's taken, and takes it.
+         */
+        std::string TakeStructName(const std::string &name) {
+            auto unique = name;
+            for (size_t suffix = 2; structNames.find(unique) != structNames.end(); ++suffix) {
+                unique = name + std::to_string(suffix);
+            }
+            (void) structNames.insert(unique);
+            return unique;
+        }
+
+        /**
+         * This function builds the model of the type of the values which
+         * the given schema describes.
+         *
+         * @param[in] schema
+         *     This is the schema.
+         *
+         * @param[in] name
+         *     This is the name to give a struct made for the schema, if
+         *     it has no title.
+         *
+         * @param[out] type
+         *     This is where to store the model.
+         *
+         * @return
+         *     An indication of whether or not the model was built is
+         *     returned.
+         */
+        bool LoadType(
+            const Json::Value &schema,
+            const std::string &name,
+            Codegen::TypeModel &type
+        ) {
+            if (schema.GetType() != Json::Value::Type::Object) {
+                type.kind = Codegen::TypeModel::Kind::Value;
+                return true;
+            }
+            if (schema.Has("$ref")) {
+                return LoadReference(schema["$ref"], type);
+            }
+            std::string typeName;
+            const auto &types = schema["type"];
+            if (types.GetType() == Json::Value::Type::String) {
+                typeName = (std::string) types;
+            } else if (types.GetType() == Json::Value::Type::Array) {
+                for (size_t i = 0; i < types.GetSize(); ++i) {
+                    const auto alternative = (std::string) types[i];
+                    if (alternative == "null") {
+                        type.nullable = true;
+                    } else if (typeName.empty()) {
+                        typeName = alternative;
+                    } else {
+                        typeName = "any";
+                    }
+                }
+            }
+            if (typeName == "string") {
+                type.kind = Codegen::TypeModel::Kind::String;
+            } else if (typeName == "integer") {
+                type.kind = Codegen::TypeModel::Kind::Integer;
+            } else if (typeName == "number") {
+                type.kind = Codegen::TypeModel::Kind::Number;
+            } else if (typeName == "boolean") {
+                type.kind = Codegen::TypeModel::Kind::Boolean;
+            } else if (typeName == "array") {
+                type.kind = Codegen::TypeModel::Kind::Array;
+                type.items = std::make_shared<Codegen::TypeModel>();
+                if (!LoadType(schema["items"], name + "Item", *type.items)) {
+                    return false;
+                }
+            } else if (
+                (typeName == "object")
+                && (schema["properties"].GetType() == Json::Value::Type::Object)
+            ) {
+                type.kind = Codegen::TypeModel::Kind::Struct;
+                const auto title = (std::string) schema["title"];
+                type.structName = TakeStructName(title.empty() ? name : MakeTypeName(title));
+                if (!LoadStruct(schema, type.structName)) {
+                    return false;
+                }
+            } else {
+                type.kind = Codegen::TypeModel::Kind::Value;
+            }
+            if (type.kind == Codegen::TypeModel::Kind::Value) {
+                type.nullable = false;
+            }
+            return true;
+        }
+
+        /**
+         * This function builds the model of the type of the values which
+         * the schema to which the given reference refers describes.
+         *
+         * @param[in] reference
+         *     This is the reference, a JSON Pointer into the schema in
+         *     the fragment of a URI.
+         *
+         * @param[out] type
+         *     This is where to store the model.
+         *
+         * @return
+         *     An indication of whether or not the model was built is
+         *     returned.
+         */
+        bool LoadReference(
+            const Json::Value &reference,
+            Codegen::TypeModel &type
+        ) {
+            const auto text = (std::string) reference;
+            if (
+                text.empty()
+                || (text[0] != '#')
+            ) {
+                error = "only references within the schema are supported: \"" + text + "\"";
+                return false;
+            }
+            const Json::Pointer pointer(std::string_view(text).substr(1));
+            const auto target = root.Find(pointer);
+            if (target == nullptr) {
+                error = "reference to nothing: \"" + text + "\"";
+                return false;
+            }
+            if (referencesInProgress.find(text) != referencesInProgress.end()) {
+                error = "schemas which refer to themselves aren't supported: \"" + text + "\"";
+                return false;
+            }
+            const auto existing = referencedStructs.find(text);
+            if (existing != referencedStructs.end()) {
+                type.kind = Codegen::TypeModel::Kind::Struct;
+                type.structName = existing->second;
+                return true;
+            }
+            const auto &tokens = pointer.GetTokens();
+            (void) referencesInProgress.insert(text);
+            const auto loaded = LoadType(*target, MakeTypeName(tokens.empty() ? "Root" : tokens.back()), type);
+            (void) referencesInProgress.erase(text);
+            if (
+                loaded
+                && (type.kind == Codegen::TypeModel::Kind::Struct)
+            ) {
+                referencedStructs[text] = type.structName;
+            }
+            return loaded;
+        }
+
+        /**
+         * This function makes the struct for the given schema of an
+         * object with known properties, after those it holds.
+         *
+         * @param[in] schema
+         *     This is the schema.
+         *
+         * @param[in] name
+         *     This is the name of the struct.
+         *
+         * @return
+         *     An indication of whether or not the struct was made is
+         *     returned.
+         */
+        bool LoadStruct(
+            const Json::Value &schema,
+            const std::string &name
+        ) {
+            Codegen::StructModel structModel;
+            structModel.name = name;
+            std::set<std::string> required;
+            const auto &requiredKeys = schema["required"];
+            for (size_t i = 0; i < requiredKeys.GetSize(); ++i) {
+                (void) required.insert((std::string) requiredKeys[i]);
+            }
+            std::set<std::string> fieldNames;
+            for (const auto &property: schema["properties"]) {
+                Codegen::FieldModel field;
+                field.key = property.key();
+                field.required = (required.find(field.key) != required.end());
+                field.name = MakeIdentifier(field.key);
+                for (size_t suffix = 2; fieldNames.find(field.name) != fieldNames.end(); ++suffix) {
+                    field.name = MakeIdentifier(field.key) + "_" + std::to_string(suffix);
+                }
+                (void) fieldNames.insert(field.name);
+                if (!LoadType(property.value(), name + MakeTypeName(field.key), field.type)) {
+                    return false;
+                }
+                structModel.fields.push_back(std::move(field));
+            }
+            model.structs.push_back(std::move(structModel));
+            return true;
+        }
+    };
+}
+
+namespace Codegen {
+    bool LoadSchema(
+        const Json::Value &schema,
+        const std::string &defaultName,
+        SchemaModel &model,
+        std::string &error
+    ) {
+        model = SchemaModel();
+        Loader loader(schema, model, error);
+        TypeModel type;
+        if (!loader.LoadType(schema, MakeTypeName(defaultName), type)) {
+            return false;
+        }
+        if (
+            (type.kind != TypeModel::Kind::Struct)
+            || type.nullable
+        ) {
+            error = "the top-level value must be an object with \"properties\"";
+            return false;
+        }
+        return true;
+    }
+}
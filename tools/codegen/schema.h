@@ -0,0 +1,133 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <value.h>
+#include <vector>
+
+namespace Codegen {
+    /**
+     * @brief The C++ type generated for a value described by a schema.
+     */
+    struct TypeModel {
+        /**
+         * @brief The kinds of values which have types of their own.
+         */
+        enum class Kind {
+            /** @brief A string, held as std::string. */
+            String,
+
+            /** @brief An integer, held as int64_t. */
+            Integer,
+
+            /** @brief A number, held as double. */
+            Number,
+
+            /** @brief A boolean, held as bool. */
+            Boolean,
+
+            /** @brief An array, held as std::vector of its items' type. */
+            Array,
+
+            /** @brief An object with known properties, held as a struct. */
+            Struct,
+
+            /**
+             * @brief Anything else, held as Json::Value.  This is the only
+             * kind for which values are built while parsing.
+             */
+            Value,
+        };
+
+        /** @brief The kind of value. */
+        Kind kind = Kind::Value;
+
+        /** @brief For a struct, the name of the struct. */
+        std::string structName;
+
+        /** @brief For an array, the type of its items. */
+        std::shared_ptr<TypeModel> items;
+
+        /**
+         * @brief Whether null is allowed as well, in which case the type
+         * is wrapped in std::optional.  Never set for Kind::Value, which
+         * holds null itself.
+         */
+        bool nullable = false;
+    };
+
+    /**
+     * @brief A member of a generated struct, for a property of an object.
+     */
+    struct FieldModel {
+        /** @brief The key of the property. */
+        std::string key;
+
+        /** @brief The name of the member, made from the key. */
+        std::string name;
+
+        /** @brief The type of the property's value. */
+        TypeModel type;
+
+        /** @brief Whether the property must be present. */
+        bool required = false;
+    };
+
+    /**
+     * @brief A struct generated for an object with known properties.
+     */
+    struct StructModel {
+        /** @brief The name of the struct. */
+        std::string name;
+
+        /** @brief The members of the struct, in the order of their keys. */
+        std::vector<FieldModel> fields;
+    };
+
+    /**
+     * @brief Everything generated from a schema.
+     */
+    struct SchemaModel {
+        /**
+         * @brief The structs, each after those it holds, so the last is
+         * the one for the top-level value.
+         */
+        std::vector<StructModel> structs;
+    };
+
+    /**
+     * This builds the model of the code to generate from a JSON Schema.
+     *
+     * The top-level value, and every object in it with "properties",
+     * becomes a struct, named after its "title", or else after the
+     * definition or property holding it.  Only the keywords which give
+     * values their shapes are used: "type" (including a list of types
+     * with "null"), "properties", "required", "items", and "$ref" to
+     * other parts of the same schema.  Anything which isn't a single
+     * type is held as Json::Value.  Other constraints aren't checked.
+     *
+     * @param[in] schema
+     *     This is the schema.
+     *
+     * @param[in] defaultName
+     *     This is the name of the top-level struct, if the schema has no
+     *     title.
+     *
+     * @param[out] model
+     *     This is where to store the model.
+     *
+     * @param[out] error
+     *     This is where to store what's wrong with the schema, if
+     *     anything.
+     *
+     * @return
+     *     An indication of whether or not the model was built is
+     *     returned.
+     */
+    bool LoadSchema(
+        const Json::Value &schema,
+        const std::string &defaultName,
+        SchemaModel &model,
+        std::string &error
+    );
+}